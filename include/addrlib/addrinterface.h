@@ -40,6 +40,7 @@
 
 using ADDR_CLIENT_HANDLE = void *;
 using ADDR_HANDLE = void *;
+using ADDR_SURFACE_PLAN = void *;
 
 
 /**
@@ -128,12 +129,38 @@ using ADDR_FREESYSMEM = ADDR_E_RETURNCODE(*)(const ADDR_FREESYSMEM_INPUT *pInput
 using ADDR_DEBUGPRINT = ADDR_E_RETURNCODE(*)(const ADDR_DEBUGPRINT_INPUT *pInput);
 
 
+/**
+***************************************************************************************************
+* ADDR_COPY_TASK
+*   @brief
+*       Runs task taskIndex of a surface copy, tasks of the same copy write disjoint memory.
+***************************************************************************************************
+*/
+using ADDR_COPY_TASK = void(*)(void *pTaskData, uint32_t taskIndex);
+
+
+/**
+***************************************************************************************************
+* ADDR_COPY_EXECUTOR
+*   @brief
+*       Client executor for multithreaded surface copies. Must call pfnTask once for every
+*       taskIndex in [0, numTasks), from any threads, and return once all of them finished.
+***************************************************************************************************
+*/
+using ADDR_COPY_EXECUTOR = void(*)(void *pExecutorData, ADDR_COPY_TASK pfnTask, void *pTaskData, uint32_t numTasks);
+
+
 /**
 ***************************************************************************************************
 * ADDR_CALLBACKS
 *
 *   @brief
 *       Address Library needs client to provide system memory alloc/free routines.
+*   @note
+*       allocSysMem and freeSysMem back the AddrLib object with its caches, statistics and
+*       trace buffers, and every surface plan. The threads a copy creates when it is given
+*       numThreads > 1 but no pExecutor allocate through the C++ runtime, a client whose
+*       memory must all go through these callbacks passes its own pExecutor.
 ***************************************************************************************************
 */
 struct ADDR_CALLBACKS
@@ -151,6 +178,9 @@ struct ADDR_CALLBACKS
 *   @brief
 *       This structure is used to pass some setup in creation of AddrLib
 *   @note
+*       noSse2, noAvx2 and noAvx512 keep the copy and batch kernels of that instruction set
+*       from being used even when the CPU supports it, so every kernel tier can be checked on
+*       one machine.
 ***************************************************************************************************
 */
 union ADDR_CREATE_FLAGS
@@ -163,6 +193,11 @@ union ADDR_CREATE_FLAGS
       uint32_t fillSizeFields : 1;
       uint32_t useTileIndex : 1;
       uint32_t useTileCaps : 1;
+      uint32_t surfaceInfoCache : 1;
+      uint32_t collectStats : 1;
+      uint32_t noSse2 : 1;
+      uint32_t noAvx2 : 1;
+      uint32_t noAvx512 : 1;
    };
 
    uint32_t value;
@@ -255,6 +290,47 @@ struct ADDR_CREATE_OUTPUT
 };
 
 
+/**
+***************************************************************************************************
+* ADDR_GET_INSTANCE_SIZE_OUTPUT
+*
+*   @brief
+*       Storage AddrCreateInPlace needs for a given ADDR_CREATE_INPUT
+*
+***************************************************************************************************
+*/
+struct ADDR_GET_INSTANCE_SIZE_OUTPUT
+{
+   uint32_t size;
+   uint64_t instanceSize;        ///< Bytes of storage
+   uint32_t instanceAlignment;   ///< Required alignment of the storage in bytes
+};
+
+
+/**
+***************************************************************************************************
+* ADDR_GET_STATS_OUTPUT
+*
+*   @brief
+*       Counters of a library created with createFlags.collectStats, summed over the threads
+*       which called it
+*
+***************************************************************************************************
+*/
+struct ADDR_GET_STATS_OUTPUT
+{
+   uint32_t size;
+   uint32_t numThreads;                                  ///< Threads which recorded counters
+   uint64_t entryCalls[ADDR_STATS_ENTRY_COUNT];          ///< Calls of each entry point
+   uint64_t entryNs[ADDR_STATS_ENTRY_COUNT];             ///< Nanoseconds spent in each entry point
+   uint64_t surfaceTileModes[ADDR_TM_COUNT];             ///< AddrComputeSurfaceInfo results by output tile mode
+   uint64_t addrTileModes[ADDR_TM_COUNT];                ///< Elements addressed by AddrComputeSurfaceAddrFromCoord
+                                                         ///  and its batch variant, by tile mode
+   uint64_t mipTileModeDegrades;                         ///< Mip levels whose 2D/3D tile mode was reduced to 1D
+   uint64_t bankSwappedLookups;                          ///< Elements addressed through bank swapping
+};
+
+
 /**
 ***************************************************************************************************
 *   ADDR_SURFACE_FLAGS
@@ -398,6 +474,100 @@ struct ADDR_COMPUTE_SURFACE_INFO_OUTPUT
 };
 
 
+/**
+***************************************************************************************************
+*   ADDR_COMPUTE_MIPCHAIN_INFO_INPUT
+*
+*   @brief
+*       Input structure for AddrComputeMipChainInfo
+*   @note
+*       width/height/numSlices describe the base level, every level is computed as if
+*       flags.inputBaseMap was set.
+***************************************************************************************************
+*/
+struct ADDR_COMPUTE_MIPCHAIN_INFO_INPUT
+{
+   uint32_t size;
+   AddrTileMode tileMode;
+   AddrFormat format;
+   uint32_t bpp;
+   uint32_t numSamples;
+   uint32_t width;
+   uint32_t height;
+   uint32_t numSlices;
+   uint32_t numMipLevels;
+   ADDR_SURFACE_FLAGS flags;
+   uint32_t numFrags;
+   ADDR_TILEINFO *pTileInfo;
+   AddrTileType tileType;
+   int32_t tileIndex;
+};
+
+
+/**
+***************************************************************************************************
+*   ADDR_MIP_LEVEL_INFO
+*
+*   @brief
+*       Layout of one mip level, offset is in bytes from the start of the base level
+***************************************************************************************************
+*/
+struct ADDR_MIP_LEVEL_INFO
+{
+   uint32_t pitch;
+   uint32_t height;
+   uint32_t depth;
+   AddrTileMode tileMode;
+   uint32_t baseAlign;
+   uint32_t pitchAlign;
+   uint32_t heightAlign;
+   uint32_t depthAlign;
+   uint32_t pixelPitch;
+   uint32_t pixelHeight;
+   uint32_t sliceSize;
+   uint64_t surfSize;
+   uint64_t offset;
+};
+
+
+/**
+***************************************************************************************************
+*   ADDR_COMPUTE_MIPCHAIN_INFO_OUTPUT
+*
+*   @brief
+*       Output structure for AddrComputeMipChainInfo
+*   @note
+*       pMipInfo is provided by the client and must hold numMipLevels entries. Each level
+*       starts at the end of the previous one aligned to its own baseAlign.
+***************************************************************************************************
+*/
+struct ADDR_COMPUTE_MIPCHAIN_INFO_OUTPUT
+{
+   uint32_t size;
+   ADDR_MIP_LEVEL_INFO *pMipInfo;
+   uint64_t mipChainSize;
+   uint32_t baseAlign;
+};
+
+
+/**
+***************************************************************************************************
+*   ADDR_GET_SURFACE_INFO_CACHE_STATS_OUTPUT
+*
+*   @brief
+*       Output structure for AddrGetSurfaceInfoCacheStats
+*   @note
+*       Calls passing pTileInfo bypass the cache and are counted in neither hits nor misses.
+***************************************************************************************************
+*/
+struct ADDR_GET_SURFACE_INFO_CACHE_STATS_OUTPUT
+{
+   uint32_t size;
+   uint64_t hits;
+   uint64_t misses;
+};
+
+
 /**
 ***************************************************************************************************
 *   ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_INPUT
@@ -451,55 +621,82 @@ struct ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_OUTPUT
 
 /**
 ***************************************************************************************************
-*   ADDR_EXTRACT_BANKPIPE_SWIZZLE_INPUT
+*   ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_INPUT
 *
 *   @brief
-*       Input structure of AddrExtractBankPipeSwizzle
+*       Input structure for AddrComputeSurfaceAddrFromCoordBatch
+*   @note
+*       The coordinates are passed as numCoords entries long arrays, pSlice and pSample
+*       may be nullptr when every coordinate has slice / sample 0.
 ***************************************************************************************************
 */
-struct ADDR_EXTRACT_BANKPIPE_SWIZZLE_INPUT
+struct ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_INPUT
 {
    uint32_t size;
-   uint32_t base256b;
+   uint32_t bpp;
+   uint32_t pitch;
+   uint32_t height;
+   uint32_t numSlices;
+   uint32_t numSamples;
+   AddrTileMode tileMode;
+   bool isDepth;
+   uint32_t tileBase;
+   uint32_t compBits;
+   uint32_t pipeSwizzle;
+   uint32_t bankSwizzle;
+   AddrTileType tileType;
    ADDR_TILEINFO *pTileInfo;
    int32_t tileIndex;
+   uint32_t numCoords;
+   const uint32_t *pX;
+   const uint32_t *pY;
+   const uint32_t *pSlice;
+   const uint32_t *pSample;
 };
 
 
 /**
 ***************************************************************************************************
-*   ADDR_EXTRACT_BANKPIPE_SWIZZLE_OUTPUT
+*   ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_OUTPUT
 *
 *   @brief
-*       Output structure of AddrExtractBankPipeSwizzle
+*       Output structure for AddrComputeSurfaceAddrFromCoordBatch
+*   @note
+*       pAddr and pBitPosition hold numCoords entries, pBitPosition may be nullptr.
 ***************************************************************************************************
 */
-struct ADDR_EXTRACT_BANKPIPE_SWIZZLE_OUTPUT
+struct ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_OUTPUT
 {
    uint32_t size;
-   uint32_t bankSwizzle;
-   uint32_t pipeSwizzle;
+   uint64_t *pAddr;
+   uint32_t *pBitPosition;
 };
 
 
-
 /**
 ***************************************************************************************************
-*   ADDR_COMPUTE_HTILE_INFO_INPUT
+*   ADDR_CREATE_SURFACE_PLAN_INPUT
 *
 *   @brief
-*       Input structure of AddrComputeHtileInfo
+*       Input structure for AddrCreateSurfacePlan
 ***************************************************************************************************
 */
-struct ADDR_COMPUTE_HTILE_INFO_INPUT
+struct ADDR_CREATE_SURFACE_PLAN_INPUT
 {
    uint32_t size;
+   uint32_t bpp;
    uint32_t pitch;
    uint32_t height;
    uint32_t numSlices;
-   bool isLinear;
-   AddrHtileBlockSize blockWidth;
-   AddrHtileBlockSize blockHeight;
+   uint32_t numSamples;
+   AddrTileMode tileMode;
+   bool isDepth;
+   uint32_t tileBase;
+   uint32_t compBits;
+   uint32_t pipeSwizzle;
+   uint32_t bankSwizzle;
+   uint32_t numFrags;
+   AddrTileType tileType;
    ADDR_TILEINFO *pTileInfo;
    int32_t tileIndex;
 };
@@ -507,40 +704,45 @@ struct ADDR_COMPUTE_HTILE_INFO_INPUT
 
 /**
 ***************************************************************************************************
-*   ADDR_COMPUTE_HTILE_INFO_OUTPUT
+*   ADDR_CREATE_SURFACE_PLAN_OUTPUT
 *
 *   @brief
-*       Output structure of AddrComputeHtileInfo
+*       Output structure for AddrCreateSurfacePlan
 ***************************************************************************************************
 */
-struct ADDR_COMPUTE_HTILE_INFO_OUTPUT
+struct ADDR_CREATE_SURFACE_PLAN_OUTPUT
 {
    uint32_t size;
-   uint32_t pitch;
-   uint32_t height;
-   uint64_t htileBytes;
-   uint32_t baseAlign;
-   uint32_t bpp;
-   uint32_t macroWidth;
-   uint32_t macroHeight;
+   ADDR_SURFACE_PLAN hPlan;
 };
 
 
 /**
 ***************************************************************************************************
-*   ADDR_COMPUTE_SLICESWIZZLE_INPUT
+*   ADDR_COMPUTE_SURFACE_COORDFROMADDR_INPUT
 *
 *   @brief
-*       Input structure of AddrComputeSliceSwizzle
+*       Input structure for AddrComputeSurfaceCoordFromAddr
 ***************************************************************************************************
 */
-struct ADDR_COMPUTE_SLICESWIZZLE_INPUT
+struct ADDR_COMPUTE_SURFACE_COORDFROMADDR_INPUT
 {
    uint32_t size;
+   uint64_t addr;
+   uint32_t bitPosition;
+   uint32_t bpp;
+   uint32_t pitch;
+   uint32_t height;
+   uint32_t numSlices;
+   uint32_t numSamples;
    AddrTileMode tileMode;
-   uint32_t baseSwizzle;
-   uint32_t slice;
-   size_t baseAddr;
+   bool isDepth;
+   uint32_t tileBase;
+   uint32_t compBits;
+   uint32_t pipeSwizzle;
+   uint32_t bankSwizzle;
+   uint32_t numFrags;
+   AddrTileType tileType;
    ADDR_TILEINFO *pTileInfo;
    int32_t tileIndex;
 };
@@ -548,80 +750,1314 @@ struct ADDR_COMPUTE_SLICESWIZZLE_INPUT
 
 /**
 ***************************************************************************************************
-*   ADDR_COMPUTE_SLICESWIZZLE_OUTPUT
+*   ADDR_COMPUTE_SURFACE_COORDFROMADDR_OUTPUT
 *
 *   @brief
-*       Output structure of AddrComputeSliceSwizzle
+*       Output structure for AddrComputeSurfaceCoordFromAddr
+*   @note
+*       The coordinate of the element containing the addressed bit. Every sample of a 1D
+*       tiled surface shares the same memory, sample is always 0 for those.
 ***************************************************************************************************
 */
-struct ADDR_COMPUTE_SLICESWIZZLE_OUTPUT
+struct ADDR_COMPUTE_SURFACE_COORDFROMADDR_OUTPUT
 {
    uint32_t size;
-   uint32_t tileSwizzle;
+   uint32_t x;
+   uint32_t y;
+   uint32_t slice;
+   uint32_t sample;
 };
 
 
 /**
 ***************************************************************************************************
-*   AddrCreate
+*   ADDR_COMPUTE_SURFACE_COORDFROMADDR_RANGE_INPUT
 *
 *   @brief
-*       Create AddrLib object, must be called before any interface calls
-*
-*   @return
-*       ADDR_OK if successful
+*       Input structure for AddrComputeSurfaceCoordFromAddrRange
 ***************************************************************************************************
 */
-ADDR_E_RETURNCODE
-AddrCreate(const ADDR_CREATE_INPUT *pCreateIn, ADDR_CREATE_OUTPUT *pCreateOut);
+struct ADDR_COMPUTE_SURFACE_COORDFROMADDR_RANGE_INPUT
+{
+   uint32_t size;
+   uint64_t addr;
+   uint64_t numBytes;
+   uint32_t bpp;
+   uint32_t pitch;
+   uint32_t height;
+   uint32_t numSlices;
+   uint32_t numSamples;
+   AddrTileMode tileMode;
+   bool isDepth;
+   uint32_t tileBase;
+   uint32_t compBits;
+   uint32_t pipeSwizzle;
+   uint32_t bankSwizzle;
+   uint32_t numFrags;
+   AddrTileType tileType;
+   ADDR_TILEINFO *pTileInfo;
+   int32_t tileIndex;
+};
 
 
 /**
 ***************************************************************************************************
-*   AddrDestroy
+*   ADDR_COMPUTE_SURFACE_COORDFROMADDR_RANGE_OUTPUT
 *
 *   @brief
-*       Destroy AddrLib object, must be called to free internally allocated resources.
-*
-*   @return
-*      ADDR_OK if successful
+*       Output structure for AddrComputeSurfaceCoordFromAddrRange
+*   @note
+*       The client provides maxCoords entries long pX / pY / pSlice / pSample arrays,
+*       numCoords returns how many elements the byte range touches even when that is more
+*       than maxCoords. Bytes outside of the surface are skipped. An element split across
+*       pipe interleave groups (24, 48 and 96 bpp) can be reported once per piece in range.
 ***************************************************************************************************
 */
-ADDR_E_RETURNCODE
-AddrDestroy(ADDR_HANDLE hLib);
+struct ADDR_COMPUTE_SURFACE_COORDFROMADDR_RANGE_OUTPUT
+{
+   uint32_t size;
+   uint32_t maxCoords;
+   uint32_t *pX;
+   uint32_t *pY;
+   uint32_t *pSlice;
+   uint32_t *pSample;
+   uint32_t numCoords;
+};
 
 
 /**
 ***************************************************************************************************
-*   AddrComputeSurfaceInfo
+*   ADDR_EXTRACT_BANKPIPE_SWIZZLE_INPUT
 *
 *   @brief
-*       Compute surface width/height/depth/alignments and suitable tiling mode
+*       Input structure of AddrExtractBankPipeSwizzle
 ***************************************************************************************************
 */
-ADDR_E_RETURNCODE
-AddrComputeSurfaceInfo(ADDR_HANDLE hLib, ADDR_COMPUTE_SURFACE_INFO_INPUT *pIn, ADDR_COMPUTE_SURFACE_INFO_OUTPUT *pOut);
+struct ADDR_EXTRACT_BANKPIPE_SWIZZLE_INPUT
+{
+   uint32_t size;
+   uint32_t base256b;
+   ADDR_TILEINFO *pTileInfo;
+   int32_t tileIndex;
+};
 
 
 /**
 ***************************************************************************************************
-*   AddrComputeSurfaceAddrFromCoord
+*   ADDR_EXTRACT_BANKPIPE_SWIZZLE_OUTPUT
 *
 *   @brief
-*       Compute surface address from a given coordinate.
+*       Output structure of AddrExtractBankPipeSwizzle
 ***************************************************************************************************
 */
-ADDR_E_RETURNCODE
-AddrComputeSurfaceAddrFromCoord(ADDR_HANDLE hLib, ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_INPUT *pIn, ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_OUTPUT *pOut);
+struct ADDR_EXTRACT_BANKPIPE_SWIZZLE_OUTPUT
+{
+   uint32_t size;
+   uint32_t bankSwizzle;
+   uint32_t pipeSwizzle;
+};
+
 
 
 /**
 ***************************************************************************************************
-*   AddrExtractBankPipeSwizzle
+*   ADDR_COMPUTE_HTILE_INFO_INPUT
 *
 *   @brief
-*       Extract Bank and Pipe swizzle from base256b
-*   @return
+*       Input structure of AddrComputeHtileInfo
+***************************************************************************************************
+*/
+struct ADDR_COMPUTE_HTILE_INFO_INPUT
+{
+   uint32_t size;
+   uint32_t pitch;
+   uint32_t height;
+   uint32_t numSlices;
+   bool isLinear;
+   AddrHtileBlockSize blockWidth;
+   AddrHtileBlockSize blockHeight;
+   ADDR_TILEINFO *pTileInfo;
+   int32_t tileIndex;
+};
+
+
+/**
+***************************************************************************************************
+*   ADDR_COMPUTE_HTILE_INFO_OUTPUT
+*
+*   @brief
+*       Output structure of AddrComputeHtileInfo
+***************************************************************************************************
+*/
+struct ADDR_COMPUTE_HTILE_INFO_OUTPUT
+{
+   uint32_t size;
+   uint32_t pitch;
+   uint32_t height;
+   uint64_t htileBytes;
+   uint32_t baseAlign;
+   uint32_t bpp;
+   uint32_t macroWidth;
+   uint32_t macroHeight;
+};
+
+
+/**
+***************************************************************************************************
+*   ADDR_COMPUTE_HTILE_ADDRFROMCOORD_INPUT
+*
+*   @brief
+*       Input structure of AddrComputeHtileAddrFromCoord
+*   @note
+*       The surface fields are those of AddrComputeHtileInfo, (x, y) is a pixel of the depth
+*       surface and must lie within the pitch and height AddrComputeHtileInfo pads to.
+***************************************************************************************************
+*/
+struct ADDR_COMPUTE_HTILE_ADDRFROMCOORD_INPUT
+{
+   uint32_t size;
+   uint32_t pitch;
+   uint32_t height;
+   uint32_t numSlices;
+   uint32_t x;
+   uint32_t y;
+   uint32_t slice;
+   bool isLinear;
+   AddrHtileBlockSize blockWidth;
+   AddrHtileBlockSize blockHeight;
+   ADDR_TILEINFO *pTileInfo;
+   int32_t tileIndex;
+};
+
+
+/**
+***************************************************************************************************
+*   ADDR_COMPUTE_HTILE_ADDRFROMCOORD_OUTPUT
+*
+*   @brief
+*       Output structure of AddrComputeHtileAddrFromCoord
+*   @note
+*       addr is the byte offset of the 32 bit HTILE word of the block holding (x, y), HTILE
+*       words never share a byte so bitPosition is always 0.
+***************************************************************************************************
+*/
+struct ADDR_COMPUTE_HTILE_ADDRFROMCOORD_OUTPUT
+{
+   uint32_t size;
+   uint64_t addr;
+   uint32_t bitPosition;
+};
+
+
+/**
+***************************************************************************************************
+*   ADDR_COMPUTE_FMASK_INFO_INPUT
+*
+*   @brief
+*       Input structure of AddrComputeFmaskInfo
+*   @note
+*       tileMode, pitch, height and numSlices are those of the MSAA color surface, in pixels.
+*       numFrags is the number of color fragments stored per pixel, 0 means numSamples.
+***************************************************************************************************
+*/
+struct ADDR_COMPUTE_FMASK_INFO_INPUT
+{
+   uint32_t size;
+   AddrTileMode tileMode;
+   uint32_t pitch;
+   uint32_t height;
+   uint32_t numSlices;
+   uint32_t numSamples;
+   uint32_t numFrags;
+   ADDR_TILEINFO *pTileInfo;
+   int32_t tileIndex;
+};
+
+
+/**
+***************************************************************************************************
+*   ADDR_COMPUTE_FMASK_INFO_OUTPUT
+*
+*   @brief
+*       Output structure of AddrComputeFmaskInfo
+*   @note
+*       The FMASK is a single sample surface of bpp bits per pixel and tile mode tileMode.
+*       Every pixel holds for each sample the bitsPerSample bits index of the fragment storing
+*       the color of the sample, sample s at bit s * bitsPerSample. When numFrags is smaller
+*       than numSamples an index of numFrags or more means no fragment covers the sample.
+***************************************************************************************************
+*/
+struct ADDR_COMPUTE_FMASK_INFO_OUTPUT
+{
+   uint32_t size;
+   uint32_t pitch;
+   uint32_t height;
+   uint32_t numSlices;
+   uint64_t fmaskBytes;
+   uint32_t baseAlign;
+   uint32_t pitchAlign;
+   uint32_t heightAlign;
+   uint32_t bpp;
+   uint32_t bitsPerSample;
+   AddrTileMode tileMode;
+};
+
+
+/**
+***************************************************************************************************
+*   ADDR_COMPUTE_FMASK_ADDRFROMCOORD_INPUT
+*
+*   @brief
+*       Input structure of AddrComputeFmaskAddrFromCoord
+*   @note
+*       The surface fields are those of AddrComputeFmaskInfo, (x, y) must lie within the
+*       FMASK pitch and height it returns.
+***************************************************************************************************
+*/
+struct ADDR_COMPUTE_FMASK_ADDRFROMCOORD_INPUT
+{
+   uint32_t size;
+   uint32_t x;
+   uint32_t y;
+   uint32_t slice;
+   uint32_t sample;
+   AddrTileMode tileMode;
+   uint32_t pitch;
+   uint32_t height;
+   uint32_t numSlices;
+   uint32_t numSamples;
+   uint32_t numFrags;
+   uint32_t pipeSwizzle;
+   uint32_t bankSwizzle;
+   ADDR_TILEINFO *pTileInfo;
+   int32_t tileIndex;
+};
+
+
+/**
+***************************************************************************************************
+*   ADDR_COMPUTE_FMASK_ADDRFROMCOORD_OUTPUT
+*
+*   @brief
+*       Output structure of AddrComputeFmaskAddrFromCoord
+*   @note
+*       The bitsPerSample bits of the sample start at bit bitPosition of byte addr, they never
+*       straddle a byte.
+***************************************************************************************************
+*/
+struct ADDR_COMPUTE_FMASK_ADDRFROMCOORD_OUTPUT
+{
+   uint32_t size;
+   uint64_t addr;
+   uint32_t bitPosition;
+};
+
+
+/**
+***************************************************************************************************
+*   ADDR_COMPUTE_FMASK_ADDRFROMCOORD_BATCH_INPUT
+*
+*   @brief
+*       Input structure of AddrComputeFmaskAddrFromCoordBatch
+*   @note
+*       The coordinates are passed as numCoords entries long arrays, pSlice and pSample
+*       may be nullptr when every coordinate has slice / sample 0.
+***************************************************************************************************
+*/
+struct ADDR_COMPUTE_FMASK_ADDRFROMCOORD_BATCH_INPUT
+{
+   uint32_t size;
+   AddrTileMode tileMode;
+   uint32_t pitch;
+   uint32_t height;
+   uint32_t numSlices;
+   uint32_t numSamples;
+   uint32_t numFrags;
+   uint32_t pipeSwizzle;
+   uint32_t bankSwizzle;
+   ADDR_TILEINFO *pTileInfo;
+   int32_t tileIndex;
+   uint32_t numCoords;
+   const uint32_t *pX;
+   const uint32_t *pY;
+   const uint32_t *pSlice;
+   const uint32_t *pSample;
+};
+
+
+/**
+***************************************************************************************************
+*   ADDR_COMPUTE_FMASK_ADDRFROMCOORD_BATCH_OUTPUT
+*
+*   @brief
+*       Output structure of AddrComputeFmaskAddrFromCoordBatch
+*   @note
+*       pAddr and pBitPosition hold numCoords entries, pBitPosition may be nullptr.
+***************************************************************************************************
+*/
+struct ADDR_COMPUTE_FMASK_ADDRFROMCOORD_BATCH_OUTPUT
+{
+   uint32_t size;
+   uint64_t *pAddr;
+   uint32_t *pBitPosition;
+};
+
+
+/**
+***************************************************************************************************
+*   ADDR_COMPUTE_CMASK_INFO_INPUT
+*
+*   @brief
+*       Input structure of AddrComputeCmaskInfo
+***************************************************************************************************
+*/
+struct ADDR_COMPUTE_CMASK_INFO_INPUT
+{
+   uint32_t size;
+   uint32_t pitch;
+   uint32_t height;
+   uint32_t numSlices;
+   bool isLinear;
+   ADDR_TILEINFO *pTileInfo;
+   int32_t tileIndex;
+};
+
+
+/**
+***************************************************************************************************
+*   ADDR_COMPUTE_CMASK_INFO_OUTPUT
+*
+*   @brief
+*       Output structure of AddrComputeCmaskInfo
+*   @note
+*       Every 8x8 tile of the padded surface has a bpp bits CMASK entry. blockMax is the
+*       index of the last 128x128 pixel block of a slice, as programmed in CMASK_BLOCK_MAX.
+***************************************************************************************************
+*/
+struct ADDR_COMPUTE_CMASK_INFO_OUTPUT
+{
+   uint32_t size;
+   uint32_t pitch;
+   uint32_t height;
+   uint64_t cmaskBytes;
+   uint32_t baseAlign;
+   uint32_t blockMax;
+   uint32_t bpp;
+   uint32_t macroWidth;
+   uint32_t macroHeight;
+};
+
+
+/**
+***************************************************************************************************
+*   ADDR_COMPUTE_CMASK_ADDRFROMCOORD_INPUT
+*
+*   @brief
+*       Input structure of AddrComputeCmaskAddrFromCoord
+*   @note
+*       The surface fields are those of AddrComputeCmaskInfo, (x, y) is a pixel of the color
+*       surface and must lie within the pitch and height AddrComputeCmaskInfo pads to.
+***************************************************************************************************
+*/
+struct ADDR_COMPUTE_CMASK_ADDRFROMCOORD_INPUT
+{
+   uint32_t size;
+   uint32_t pitch;
+   uint32_t height;
+   uint32_t numSlices;
+   uint32_t x;
+   uint32_t y;
+   uint32_t slice;
+   bool isLinear;
+   ADDR_TILEINFO *pTileInfo;
+   int32_t tileIndex;
+};
+
+
+/**
+***************************************************************************************************
+*   ADDR_COMPUTE_CMASK_ADDRFROMCOORD_OUTPUT
+*
+*   @brief
+*       Output structure of AddrComputeCmaskAddrFromCoord
+*   @note
+*       addr is the byte holding the 4 bit CMASK entry of the tile of (x, y) and bitPosition
+*       its lowest bit within that byte, 0 or 4.
+***************************************************************************************************
+*/
+struct ADDR_COMPUTE_CMASK_ADDRFROMCOORD_OUTPUT
+{
+   uint32_t size;
+   uint64_t addr;
+   uint32_t bitPosition;
+};
+
+
+/**
+***************************************************************************************************
+*   ADDR_COMPUTE_SLICESWIZZLE_INPUT
+*
+*   @brief
+*       Input structure of AddrComputeSliceSwizzle
+***************************************************************************************************
+*/
+struct ADDR_COMPUTE_SLICESWIZZLE_INPUT
+{
+   uint32_t size;
+   AddrTileMode tileMode;
+   uint32_t baseSwizzle;
+   uint32_t slice;
+   size_t baseAddr;
+   ADDR_TILEINFO *pTileInfo;
+   int32_t tileIndex;
+};
+
+
+/**
+***************************************************************************************************
+*   ADDR_COMPUTE_SLICESWIZZLE_OUTPUT
+*
+*   @brief
+*       Output structure of AddrComputeSliceSwizzle
+***************************************************************************************************
+*/
+struct ADDR_COMPUTE_SLICESWIZZLE_OUTPUT
+{
+   uint32_t size;
+   uint32_t tileSwizzle;
+};
+
+
+/**
+***************************************************************************************************
+*   ADDR_COMPUTE_PIXEL_INDEX_TABLE_INPUT
+*
+*   @brief
+*       Input structure for AddrComputePixelIndexTable
+***************************************************************************************************
+*/
+struct ADDR_COMPUTE_PIXEL_INDEX_TABLE_INPUT
+{
+   uint32_t size;
+   uint32_t bpp;
+   AddrTileMode tileMode;
+   AddrTileType tileType;
+   uint32_t slice;
+};
+
+
+/**
+***************************************************************************************************
+*   ADDR_COMPUTE_PIXEL_INDEX_TABLE_OUTPUT
+*
+*   @brief
+*       Output structure for AddrComputePixelIndexTable
+*   @note
+*       pPixelIndex points to 64 pixel indices owned by the library, the index of the pixel at
+*       (x, y) within a micro tile is pPixelIndex[y * 8 + x]. It stays valid until the library
+*       is destroyed.
+***************************************************************************************************
+*/
+struct ADDR_COMPUTE_PIXEL_INDEX_TABLE_OUTPUT
+{
+   uint32_t size;
+   const uint16_t *pPixelIndex;
+};
+
+
+/**
+***************************************************************************************************
+*   ADDR_COPY_REGION
+*
+*   @brief
+*       Box of a surface, in elements and slices, for AddrCopySurfaceTiledToLinear,
+*       AddrCopySurfaceLinearToTiled and the depth plane copies, in pixels and slices for the
+*       HTILE and CMASK copies
+***************************************************************************************************
+*/
+struct ADDR_COPY_REGION
+{
+   uint32_t x;
+   uint32_t y;
+   uint32_t slice;
+   uint32_t width;
+   uint32_t height;
+   uint32_t depth;
+};
+
+
+/**
+***************************************************************************************************
+*   ADDR_COPY_SURFACE_INPUT
+*
+*   @brief
+*       Input structure for AddrCopySurfaceTiledToLinear and AddrCopySurfaceLinearToTiled
+*   @note
+*       pTiled must point to a buffer of at least the surfSize returned by
+*       AddrComputeSurfaceInfo for the surface.
+*
+*       The linear buffer stores (slice + sample * numSlices) images of pitch x height elements,
+*       linearPitch is the size of a row in bytes and linearSliceSize the size of an image in
+*       bytes, when left 0 they default to the tightly packed values.
+*
+*       When pRegion is set only the micro tiles overlapping the region are touched, and the
+*       linear buffer stores (slice - pRegion->slice + sample * pRegion->depth) images of
+*       pRegion->width x pRegion->height elements instead.
+*
+*       Elements of 24, 48 and 96 bpp macro tiled surfaces can straddle pipe interleave groups
+*       and overlap each other, when tiling these the last micro tile written wins.
+*
+*       numThreads > 1 splits the copy into that many tasks of whole macro tile rows. They run
+*       on pExecutor when one is given, otherwise on threads created by the library.
+***************************************************************************************************
+*/
+struct ADDR_COPY_SURFACE_INPUT
+{
+   uint32_t size;
+   uint32_t bpp;
+   uint32_t pitch;
+   uint32_t height;
+   uint32_t numSlices;
+   uint32_t numSamples;
+   AddrTileMode tileMode;
+   bool isDepth;
+   uint32_t tileBase;
+   uint32_t compBits;
+   uint32_t pipeSwizzle;
+   uint32_t bankSwizzle;
+   ADDR_TILEINFO *pTileInfo;
+   int32_t tileIndex;
+   void *pTiled;
+   void *pLinear;
+   uint32_t linearPitch;
+   uint64_t linearSliceSize;
+   const ADDR_COPY_REGION *pRegion;
+   uint32_t numThreads;
+   ADDR_COPY_EXECUTOR pExecutor;
+   void *pExecutorData;
+};
+
+
+static const uint32_t ADDR_MAX_DEPTH_PLANES = 2;
+
+
+/**
+***************************************************************************************************
+*   ADDR_COPY_DEPTH_PLANE
+*
+*   @brief
+*       One plane of a depth surface for AddrCopyDepthPlanesToLinear and
+*       AddrCopyLinearToDepthPlanes
+*   @note
+*       tileBase and compBits are those AddrComputeSurfaceAddrFromCoord takes for the plane,
+*       compBits 0 or equal to bpp is the whole pixel. The plane's element of pixel i and
+*       sample s of a 2D/3D tiled micro tile starts at bit
+*       tileBase + compBits * s + numSamples * compBits * i, for example an 8_24 surface
+*       stored depth first has planes { 0, 24 } and { 1536 * numSamples, 8 }. 1D tiled micro
+*       tiles have one sample, at bit tileBase + compBits * i.
+*
+*       An element is the compBits / 8 bytes at the address AddrComputeSurfaceAddrFromCoord
+*       returns for it. The linear buffer stores images of these elements laid out as for
+*       AddrCopySurfaceTiledToLinear, linearPitch and linearSliceSize default to the tightly
+*       packed values when left 0.
+***************************************************************************************************
+*/
+struct ADDR_COPY_DEPTH_PLANE
+{
+   uint32_t tileBase;
+   uint32_t compBits;
+   void *pLinear;
+   uint32_t linearPitch;
+   uint64_t linearSliceSize;
+};
+
+
+/**
+***************************************************************************************************
+*   ADDR_COPY_DEPTH_PLANES_INPUT
+*
+*   @brief
+*       Input structure for AddrCopyDepthPlanesToLinear and AddrCopyLinearToDepthPlanes
+*   @note
+*       The surface fields are those of AddrCopySurfaceTiledToLinear for a depth surface.
+*       Every micro tile is read once and all numPlanes planes of all its samples are copied
+*       from it, so a depth and a stencil plane come out in one pass. When writing, the bits
+*       of a micro tile outside the planes are kept.
+*
+*       Linear tile modes are not supported, linear depth surfaces have no planes.
+***************************************************************************************************
+*/
+struct ADDR_COPY_DEPTH_PLANES_INPUT
+{
+   uint32_t size;
+   uint32_t bpp;
+   uint32_t pitch;
+   uint32_t height;
+   uint32_t numSlices;
+   uint32_t numSamples;
+   AddrTileMode tileMode;
+   uint32_t pipeSwizzle;
+   uint32_t bankSwizzle;
+   ADDR_TILEINFO *pTileInfo;
+   int32_t tileIndex;
+   void *pTiled;
+   uint32_t numPlanes;
+   const ADDR_COPY_DEPTH_PLANE *pPlanes;
+   const ADDR_COPY_REGION *pRegion;
+   uint32_t numThreads;
+   ADDR_COPY_EXECUTOR pExecutor;
+   void *pExecutorData;
+};
+
+
+/**
+***************************************************************************************************
+*   ADDR_COPY_HTILE_INPUT
+*
+*   @brief
+*       Input structure for AddrCopyHtileToLinear and AddrCopyLinearToHtile
+*   @note
+*       pHtile must point to a buffer of at least the htileBytes returned by
+*       AddrComputeHtileInfo for the surface.
+*
+*       The linear buffer stores one image per slice of the HTILE of every 8x8 tile of the
+*       padded surface in row-major order, bpp / 8 bytes per tile where bpp is the one
+*       AddrComputeHtileInfo returns, with the 4x4 blocks of a tile in row-major order.
+*       linearPitch is the size of a row of tiles in bytes and linearSliceSize the size of
+*       an image in bytes, when left 0 they default to the tightly packed values.
+*
+*       When pRegion is set, in pixels for these copies, only the tiles overlapping it are
+*       touched and the linear buffer stores (slice - pRegion->slice) images of those tiles.
+*
+*       The HTILE buffer is walked in address order, so every cache line is touched once.
+***************************************************************************************************
+*/
+struct ADDR_COPY_HTILE_INPUT
+{
+   uint32_t size;
+   uint32_t pitch;
+   uint32_t height;
+   uint32_t numSlices;
+   bool isLinear;
+   AddrHtileBlockSize blockWidth;
+   AddrHtileBlockSize blockHeight;
+   ADDR_TILEINFO *pTileInfo;
+   int32_t tileIndex;
+   void *pHtile;
+   void *pLinear;
+   uint32_t linearPitch;
+   uint64_t linearSliceSize;
+   const ADDR_COPY_REGION *pRegion;
+};
+
+
+/**
+***************************************************************************************************
+*   ADDR_COPY_FMASK_INPUT
+*
+*   @brief
+*       Input structure for AddrCopyFmaskToLinear and AddrCopyLinearToFmask
+*   @note
+*       The surface fields are those of AddrComputeFmaskInfo, pFmask must point to a buffer
+*       of at least the fmaskBytes it returns.
+*
+*       The linear buffer stores one image per slice of the bpp / 8 bytes FMASK value of
+*       every pixel, pRegion, linearPitch, linearSliceSize and the threading fields work as
+*       for AddrCopySurfaceTiledToLinear with the FMASK as a single sample surface.
+***************************************************************************************************
+*/
+struct ADDR_COPY_FMASK_INPUT
+{
+   uint32_t size;
+   AddrTileMode tileMode;
+   uint32_t pitch;
+   uint32_t height;
+   uint32_t numSlices;
+   uint32_t numSamples;
+   uint32_t numFrags;
+   uint32_t pipeSwizzle;
+   uint32_t bankSwizzle;
+   ADDR_TILEINFO *pTileInfo;
+   int32_t tileIndex;
+   void *pFmask;
+   void *pLinear;
+   uint32_t linearPitch;
+   uint64_t linearSliceSize;
+   const ADDR_COPY_REGION *pRegion;
+   uint32_t numThreads;
+   ADDR_COPY_EXECUTOR pExecutor;
+   void *pExecutorData;
+};
+
+
+/**
+***************************************************************************************************
+*   ADDR_COPY_CMASK_INPUT
+*
+*   @brief
+*       Input structure for AddrCopyCmaskToLinear and AddrCopyLinearToCmask
+*   @note
+*       pCmask must point to a buffer of at least the cmaskBytes returned by
+*       AddrComputeCmaskInfo for the surface.
+*
+*       The linear buffer stores one image per slice of the CMASK of every 8x8 tile of the
+*       padded surface in row-major order, one byte per tile holding the entry in its low 4
+*       bits, the high bits are ignored when writing and read as 0. linearPitch, pRegion and
+*       linearSliceSize work as for AddrCopyHtileToLinear.
+*
+*       A fast clear writes the clear code of every tile of a region this way, touching 4 bits
+*       of CMASK per 8x8 tile instead of the pixels of the tile.
+***************************************************************************************************
+*/
+struct ADDR_COPY_CMASK_INPUT
+{
+   uint32_t size;
+   uint32_t pitch;
+   uint32_t height;
+   uint32_t numSlices;
+   bool isLinear;
+   ADDR_TILEINFO *pTileInfo;
+   int32_t tileIndex;
+   void *pCmask;
+   void *pLinear;
+   uint32_t linearPitch;
+   uint64_t linearSliceSize;
+   const ADDR_COPY_REGION *pRegion;
+};
+
+
+/**
+***************************************************************************************************
+*   ADDR_COMPUTE_SURFACE_DIRTY_REGIONS_INPUT
+*
+*   @brief
+*       Input structure for AddrComputeSurfaceDirtyRegions
+*   @note
+*       When pMipInfo is set it holds the numMipLevels levels returned by
+*       AddrComputeMipChainInfo, addr is then relative to the start of the mip chain and the
+*       pitch, height, depth and tileMode of each level replace pitch, height, numSlices and
+*       tileMode.
+***************************************************************************************************
+*/
+struct ADDR_COMPUTE_SURFACE_DIRTY_REGIONS_INPUT
+{
+   uint32_t size;
+   uint64_t addr;
+   uint64_t numBytes;
+   uint32_t bpp;
+   uint32_t pitch;
+   uint32_t height;
+   uint32_t numSlices;
+   uint32_t numSamples;
+   AddrTileMode tileMode;
+   bool isDepth;
+   uint32_t tileBase;
+   uint32_t compBits;
+   uint32_t pipeSwizzle;
+   uint32_t bankSwizzle;
+   uint32_t numFrags;
+   AddrTileType tileType;
+   ADDR_TILEINFO *pTileInfo;
+   int32_t tileIndex;
+   uint32_t numMipLevels;
+   const ADDR_MIP_LEVEL_INFO *pMipInfo;
+};
+
+
+/**
+***************************************************************************************************
+*   ADDR_COMPUTE_SURFACE_DIRTY_REGIONS_OUTPUT
+*
+*   @brief
+*       Output structure for AddrComputeSurfaceDirtyRegions
+*   @note
+*       The client provides maxRegions entries long pRegions and, optionally, pMipLevels
+*       arrays, numRegions returns how many regions there are even when that is more than
+*       maxRegions. Regions are whole micro tiles of tiled surfaces and whole macro tiles
+*       where the range covers every pipe and bank of them, so they can be passed as is to
+*       AddrCopySurfaceTiledToLinear. Multisampled regions cover every sample.
+***************************************************************************************************
+*/
+struct ADDR_COMPUTE_SURFACE_DIRTY_REGIONS_OUTPUT
+{
+   uint32_t size;
+   uint32_t maxRegions;
+   ADDR_COPY_REGION *pRegions;
+   uint32_t *pMipLevels;
+   uint32_t numRegions;
+};
+
+
+/**
+***************************************************************************************************
+* ADDR_TRACE_WRITE
+*   @brief
+*       Client sink of a call trace, receives the stream in order from one thread at a time.
+*       Returning an error stops the recording, AddrStopTrace then reports ADDR_ERROR.
+***************************************************************************************************
+*/
+using ADDR_TRACE_WRITE = ADDR_E_RETURNCODE(*)(void *pWriteData, const void *pData, uint64_t numBytes);
+
+
+/**
+***************************************************************************************************
+* Call trace stream, version ADDR_TRACE_VERSION
+*
+*   The stream is a sequence of blocks which all start on a multiple of 8 bytes:
+*
+*   ADDR_TRACE_HEADER, followed by the ADDR_CREATE_INPUT the library was created with
+*   (createInputBytes, padded to 8 bytes).
+*
+*   Then any number of chunks, each an ADDR_TRACE_CHUNK_HEADER followed by chunk.bytes of
+*   records made by one thread, in the order that thread made the calls. Chunks of different
+*   threads interleave in the order their buffers filled, sort the records by startNs for a
+*   global order.
+*
+*   A record is an ADDR_TRACE_RECORD_HEADER followed by numSegments segments, each a uint64_t
+*   byte count followed by the bytes padded to 8. Segment 0 is the input structure and
+*   segment 1 the output structure as they are in memory, the input as passed, the output as
+*   returned. Pointers inside them are recorded as values and not followed, except for the
+*   arrays listed below which follow as extra segments, empty when the pointer is nullptr:
+*
+*       ADDR_STATS_MIPCHAIN_INFO                 2: pOut->pMipInfo
+*       ADDR_STATS_SURFACE_ADDRFROMCOORD_BATCH   2-5: pIn->pX, pY, pSlice, pSample
+*                                                6-7: pOut->pAddr, pBitPosition
+*       ADDR_STATS_SURFACE_COORDFROMADDR_RANGE   2-5: pOut->pX, pY, pSlice, pSample
+*       ADDR_STATS_SURFACE_DIRTY_REGIONS         2: pIn->pMipInfo, 3-4: pOut->pRegions, pMipLevels
+*       ADDR_STATS_COPY_TILED_TO_LINEAR and
+*       ADDR_STATS_COPY_LINEAR_TO_TILED          1: pIn->pRegion, there is no output structure
+*                                                and the surface contents are not recorded
+*       ADDR_STATS_COPY_HTILE_TO_LINEAR and
+*       ADDR_STATS_COPY_LINEAR_TO_HTILE          the same as the surface copies
+*       ADDR_STATS_FMASK_ADDRFROMCOORD_BATCH     the same as ADDR_STATS_SURFACE_ADDRFROMCOORD_BATCH
+*       ADDR_STATS_COPY_FMASK_TO_LINEAR and
+*       ADDR_STATS_COPY_LINEAR_TO_FMASK          the same as the surface copies
+*       ADDR_STATS_COPY_CMASK_TO_LINEAR and
+*       ADDR_STATS_COPY_LINEAR_TO_CMASK          the same as the surface copies
+*       ADDR_STATS_COPY_DEPTH_PLANES_TO_LINEAR and
+*       ADDR_STATS_COPY_LINEAR_TO_DEPTH_PLANES   1: pIn->pRegion, 2: pIn->pPlanes, no output
+*
+*   Output arrays hold the elements the call wrote and are empty when it failed. Structures
+*   are stored with the layout of the recording build, pointerBytes tells readers built
+*   differently apart.
+*
+*   Only the entry points of AddrStatsEntry are recorded. AddrPlanAddrFromCoord is left out
+*   as it is the per element lookup a plan exists to keep cheap, and AddrDestroySurfacePlan
+*   as it has no output, so a trace holds the ADDR_STATS_CREATE_SURFACE_PLAN records but not
+*   the lookups made through those plans.
+***************************************************************************************************
+*/
+static const uint32_t ADDR_TRACE_MAGIC = 0x52544441;           ///< "ADTR"
+static const uint32_t ADDR_TRACE_CHUNK_MAGIC = 0x43544441;     ///< "ADTC"
+static const uint32_t ADDR_TRACE_VERSION = 1;
+static const uint32_t ADDR_TRACE_MAX_SEGMENTS = 8;
+static const uint32_t ADDR_TRACE_SHARED_THREAD = 0xFFFFFFFF;   ///< threadIndex of threads past the buffered ones
+
+
+/**
+***************************************************************************************************
+* ADDR_TRACE_HEADER
+*
+*   @brief
+*       First block of a call trace stream
+***************************************************************************************************
+*/
+struct ADDR_TRACE_HEADER
+{
+   uint32_t magic;               ///< ADDR_TRACE_MAGIC
+   uint32_t version;             ///< ADDR_TRACE_VERSION
+   uint32_t pointerBytes;        ///< sizeof(void *) of the recording build
+   uint32_t createInputBytes;    ///< sizeof(ADDR_CREATE_INPUT) of the recording build
+   uint64_t startTime;           ///< Nanoseconds since the system clock epoch when recording started
+};
+
+
+/**
+***************************************************************************************************
+* ADDR_TRACE_CHUNK_HEADER
+*
+*   @brief
+*       Header of the records of one thread buffer
+***************************************************************************************************
+*/
+struct ADDR_TRACE_CHUNK_HEADER
+{
+   uint32_t magic;               ///< ADDR_TRACE_CHUNK_MAGIC
+   uint32_t threadIndex;         ///< Order in which the thread first called the library
+   uint64_t threadId;            ///< Hash of the thread id
+   uint64_t bytes;               ///< Bytes of records following the header
+};
+
+
+/**
+***************************************************************************************************
+* ADDR_TRACE_RECORD_HEADER
+*
+*   @brief
+*       Header of one recorded call
+***************************************************************************************************
+*/
+struct ADDR_TRACE_RECORD_HEADER
+{
+   uint32_t entry;               ///< AddrStatsEntry of the call
+   uint32_t returnCode;          ///< ADDR_E_RETURNCODE of the call
+   uint64_t startNs;             ///< Nanoseconds since recording started
+   uint64_t durationNs;
+   uint32_t numSegments;
+   uint32_t reserved;
+   uint64_t bytes;               ///< Bytes of the record including this header
+};
+
+
+/**
+***************************************************************************************************
+* ADDR_START_TRACE_INPUT
+*
+*   @brief
+*       Input structure for AddrStartTrace
+***************************************************************************************************
+*/
+struct ADDR_START_TRACE_INPUT
+{
+   uint32_t size;
+   ADDR_TRACE_WRITE pfnWrite;
+   void *pWriteData;
+   uint32_t threadBufferSize;    ///< Bytes buffered per thread before they are written, 0 for 64 KiB
+};
+
+
+/**
+***************************************************************************************************
+* ADDR_TRACE_RECORD
+*
+*   @brief
+*       One call decoded by AddrReadTrace, the segments point into the stream
+***************************************************************************************************
+*/
+struct ADDR_TRACE_RECORD
+{
+   AddrStatsEntry entry;
+   ADDR_E_RETURNCODE returnCode;
+   uint32_t threadIndex;
+   uint64_t threadId;
+   uint64_t startNs;
+   uint64_t durationNs;
+   uint32_t numSegments;
+   const void *pSegments[ADDR_TRACE_MAX_SEGMENTS];
+   uint64_t segmentBytes[ADDR_TRACE_MAX_SEGMENTS];
+};
+
+
+/**
+***************************************************************************************************
+* ADDR_TRACE_RECORD_CALLBACK
+*   @brief
+*       Receives the records of AddrReadTrace in stream order, returns false to stop reading
+***************************************************************************************************
+*/
+using ADDR_TRACE_RECORD_CALLBACK = bool(*)(void *pRecordData, const ADDR_TRACE_RECORD *pRecord);
+
+
+/**
+***************************************************************************************************
+* ADDR_READ_TRACE_INPUT
+*
+*   @brief
+*       Input structure for AddrReadTrace
+***************************************************************************************************
+*/
+struct ADDR_READ_TRACE_INPUT
+{
+   uint32_t size;
+   const void *pData;            ///< Whole stream, 8 byte aligned so segments can be used in place
+   uint64_t dataSize;
+   ADDR_TRACE_RECORD_CALLBACK pfnRecord;
+   void *pRecordData;
+};
+
+
+/**
+***************************************************************************************************
+* ADDR_READ_TRACE_OUTPUT
+*
+*   @brief
+*       Output structure for AddrReadTrace
+***************************************************************************************************
+*/
+struct ADDR_READ_TRACE_OUTPUT
+{
+   uint32_t size;
+   uint64_t startTime;
+   const ADDR_CREATE_INPUT *pCreateIn;    ///< Points into the stream
+   uint32_t numThreads;                   ///< Buffered threads, 1 + the largest threadIndex
+   uint64_t numChunks;
+   uint64_t numRecords;
+};
+
+
+/**
+***************************************************************************************************
+*   AddrCreate
+*
+*   @brief
+*       Create AddrLib object, must be called before any interface calls
+*
+*   @return
+*       ADDR_OK if successful
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrCreate(const ADDR_CREATE_INPUT *pCreateIn, ADDR_CREATE_OUTPUT *pCreateOut);
+
+
+/**
+***************************************************************************************************
+*   AddrDestroy
+*
+*   @brief
+*       Destroy AddrLib object, must be called to free internally allocated resources.
+*
+*   @return
+*      ADDR_OK if successful
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrDestroy(ADDR_HANDLE hLib);
+
+
+/**
+***************************************************************************************************
+*   AddrGetInstanceSize
+*
+*   @brief
+*       Returns the size and alignment of the storage AddrCreateInPlace needs to create a
+*       library from pCreateIn
+*
+*   @return
+*       ADDR_OK if successful
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrGetInstanceSize(const ADDR_CREATE_INPUT *pCreateIn, ADDR_GET_INSTANCE_SIZE_OUTPUT *pOut);
+
+
+/**
+***************************************************************************************************
+*   AddrCreateInPlace
+*
+*   @brief
+*       Create AddrLib object in caller provided storage, without any client allocation.
+*
+*   @note
+*       pStorage must be at least AddrGetInstanceSize bytes aligned to its instanceAlignment
+*       and must outlive the library. The allocation callbacks are optional, without them
+*       AddrCreateSurfacePlan returns ADDR_OUTOFMEMORY.
+*
+*   @return
+*       ADDR_OK if successful
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrCreateInPlace(const ADDR_CREATE_INPUT *pCreateIn, void *pStorage, uint64_t storageSize, ADDR_CREATE_OUTPUT *pCreateOut);
+
+
+/**
+***************************************************************************************************
+*   AddrDestroyInPlace
+*
+*   @brief
+*       Destroy an AddrLib object created by AddrCreateInPlace, the storage is left to the
+*       caller.
+*
+*   @return
+*      ADDR_OK if successful
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrDestroyInPlace(ADDR_HANDLE hLib);
+
+
+/**
+***************************************************************************************************
+*   AddrComputeSurfaceInfo
+*
+*   @brief
+*       Compute surface width/height/depth/alignments and suitable tiling mode
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrComputeSurfaceInfo(ADDR_HANDLE hLib, ADDR_COMPUTE_SURFACE_INFO_INPUT *pIn, ADDR_COMPUTE_SURFACE_INFO_OUTPUT *pOut);
+
+
+/**
+***************************************************************************************************
+*   AddrComputeMipChainInfo
+*
+*   @brief
+*       Compute the layout of every level of a mip chain and the size of the whole chain
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrComputeMipChainInfo(ADDR_HANDLE hLib, const ADDR_COMPUTE_MIPCHAIN_INFO_INPUT *pIn, ADDR_COMPUTE_MIPCHAIN_INFO_OUTPUT *pOut);
+
+
+/**
+***************************************************************************************************
+*   AddrGetSurfaceInfoCacheStats
+*
+*   @brief
+*       Get the hit and miss counts of the AddrComputeSurfaceInfo cache enabled by
+*       ADDR_CREATE_FLAGS::surfaceInfoCache
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrGetSurfaceInfoCacheStats(ADDR_HANDLE hLib, ADDR_GET_SURFACE_INFO_CACHE_STATS_OUTPUT *pOut);
+
+
+/**
+***************************************************************************************************
+*   AddrGetStats
+*
+*   @brief
+*       Get the performance counters enabled by ADDR_CREATE_FLAGS::collectStats, summed over
+*       every thread which called the library
+*
+*   @return
+*       ADDR_OK if successful, ADDR_NOTSUPPORTED if the library does not collect them
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrGetStats(ADDR_HANDLE hLib, ADDR_GET_STATS_OUTPUT *pOut);
+
+
+/**
+***************************************************************************************************
+*   AddrResetStats
+*
+*   @brief
+*       Clear the performance counters enabled by ADDR_CREATE_FLAGS::collectStats
+*
+*   @note
+*       Counts added by calls running concurrently with the reset may survive it.
+*
+*   @return
+*       ADDR_OK if successful, ADDR_NOTSUPPORTED if the library does not collect them
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrResetStats(ADDR_HANDLE hLib);
+
+
+/**
+***************************************************************************************************
+*   AddrComputeSurfaceAddrFromCoord
+*
+*   @brief
+*       Compute surface address from a given coordinate.
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrComputeSurfaceAddrFromCoord(ADDR_HANDLE hLib, ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_INPUT *pIn, ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_OUTPUT *pOut);
+
+
+/**
+***************************************************************************************************
+*   AddrComputeSurfaceAddrFromCoordBatch
+*
+*   @brief
+*       Compute surface addresses of many coordinates of one surface.
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrComputeSurfaceAddrFromCoordBatch(ADDR_HANDLE hLib, const ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_INPUT *pIn, ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_OUTPUT *pOut);
+
+
+/**
+***************************************************************************************************
+*   AddrCreateSurfacePlan
+*
+*   @brief
+*       Precompute everything about a surface which AddrPlanAddrFromCoord needs
+*   @note
+*       A plan must be destroyed with AddrDestroySurfacePlan before its AddrLib is destroyed.
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrCreateSurfacePlan(ADDR_HANDLE hLib, const ADDR_CREATE_SURFACE_PLAN_INPUT *pIn, ADDR_CREATE_SURFACE_PLAN_OUTPUT *pOut);
+
+
+/**
+***************************************************************************************************
+*   AddrDestroySurfacePlan
+*
+*   @brief
+*       Destroy a surface plan created by AddrCreateSurfacePlan
+*   @note
+*       Not recorded by AddrStartTrace.
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrDestroySurfacePlan(ADDR_HANDLE hLib, ADDR_SURFACE_PLAN hPlan);
+
+
+/**
+***************************************************************************************************
+*   AddrPlanAddrFromCoord
+*
+*   @brief
+*       Compute the same address as AddrComputeSurfaceAddrFromCoord for the surface of a plan
+*   @note
+*       The coordinate is not validated. pBitPosition may be nullptr. Not recorded by
+*       AddrStartTrace.
+***************************************************************************************************
+*/
+uint64_t
+AddrPlanAddrFromCoord(ADDR_SURFACE_PLAN hPlan, uint32_t x, uint32_t y, uint32_t slice, uint32_t sample, uint32_t *pBitPosition);
+
+
+/**
+***************************************************************************************************
+*   AddrComputeSurfaceCoordFromAddr
+*
+*   @brief
+*       Compute the coordinate of the element at a given surface address.
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrComputeSurfaceCoordFromAddr(ADDR_HANDLE hLib, const ADDR_COMPUTE_SURFACE_COORDFROMADDR_INPUT *pIn, ADDR_COMPUTE_SURFACE_COORDFROMADDR_OUTPUT *pOut);
+
+
+/**
+***************************************************************************************************
+*   AddrComputeSurfaceCoordFromAddrRange
+*
+*   @brief
+*       Compute the coordinates of every element touched by a byte range of a surface.
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrComputeSurfaceCoordFromAddrRange(ADDR_HANDLE hLib, const ADDR_COMPUTE_SURFACE_COORDFROMADDR_RANGE_INPUT *pIn, ADDR_COMPUTE_SURFACE_COORDFROMADDR_RANGE_OUTPUT *pOut);
+
+
+/**
+***************************************************************************************************
+*   AddrComputeSurfaceDirtyRegions
+*
+*   @brief
+*       Compute the tile aligned regions of a surface whose bytes intersect a byte range
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrComputeSurfaceDirtyRegions(ADDR_HANDLE hLib, const ADDR_COMPUTE_SURFACE_DIRTY_REGIONS_INPUT *pIn, ADDR_COMPUTE_SURFACE_DIRTY_REGIONS_OUTPUT *pOut);
+
+
+/**
+***************************************************************************************************
+*   AddrExtractBankPipeSwizzle
+*
+*   @brief
+*       Extract Bank and Pipe swizzle from base256b
+*   @return
 *       ADDR_OK if no error
 ***************************************************************************************************
 */
@@ -641,6 +2077,177 @@ ADDR_E_RETURNCODE
 AddrComputeHtileInfo(ADDR_HANDLE hLib, ADDR_COMPUTE_HTILE_INFO_INPUT *pIn, ADDR_COMPUTE_HTILE_INFO_OUTPUT *pOut);
 
 
+/**
+***************************************************************************************************
+*   AddrComputeHtileAddrFromCoord
+*
+*   @brief
+*       Compute the address of the HTILE word of a depth surface pixel
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrComputeHtileAddrFromCoord(ADDR_HANDLE hLib, const ADDR_COMPUTE_HTILE_ADDRFROMCOORD_INPUT *pIn, ADDR_COMPUTE_HTILE_ADDRFROMCOORD_OUTPUT *pOut);
+
+
+/**
+***************************************************************************************************
+*   AddrCopyHtileToLinear
+*
+*   @brief
+*       Read the HTILE of a surface or region into a linear array of tiles
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrCopyHtileToLinear(ADDR_HANDLE hLib, const ADDR_COPY_HTILE_INPUT *pIn);
+
+
+/**
+***************************************************************************************************
+*   AddrCopyLinearToHtile
+*
+*   @brief
+*       Write the HTILE of a surface or region from a linear array of tiles
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrCopyLinearToHtile(ADDR_HANDLE hLib, const ADDR_COPY_HTILE_INPUT *pIn);
+
+
+/**
+***************************************************************************************************
+*   AddrComputeFmaskInfo
+*
+*   @brief
+*       Compute the FMASK bits per sample, pitch, height, tile mode, alignment and size of an
+*       MSAA color surface
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrComputeFmaskInfo(ADDR_HANDLE hLib, const ADDR_COMPUTE_FMASK_INFO_INPUT *pIn, ADDR_COMPUTE_FMASK_INFO_OUTPUT *pOut);
+
+
+/**
+***************************************************************************************************
+*   AddrComputeFmaskAddrFromCoord
+*
+*   @brief
+*       Compute the address of the FMASK bits of a sample
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrComputeFmaskAddrFromCoord(ADDR_HANDLE hLib, const ADDR_COMPUTE_FMASK_ADDRFROMCOORD_INPUT *pIn, ADDR_COMPUTE_FMASK_ADDRFROMCOORD_OUTPUT *pOut);
+
+
+/**
+***************************************************************************************************
+*   AddrComputeFmaskAddrFromCoordBatch
+*
+*   @brief
+*       Compute the address of the FMASK bits of many samples of one surface
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrComputeFmaskAddrFromCoordBatch(ADDR_HANDLE hLib, const ADDR_COMPUTE_FMASK_ADDRFROMCOORD_BATCH_INPUT *pIn, ADDR_COMPUTE_FMASK_ADDRFROMCOORD_BATCH_OUTPUT *pOut);
+
+
+/**
+***************************************************************************************************
+*   AddrCopyFmaskToLinear
+*
+*   @brief
+*       Read the FMASK of a surface or region into a linear array of pixels
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrCopyFmaskToLinear(ADDR_HANDLE hLib, const ADDR_COPY_FMASK_INPUT *pIn);
+
+
+/**
+***************************************************************************************************
+*   AddrCopyLinearToFmask
+*
+*   @brief
+*       Write the FMASK of a surface or region from a linear array of pixels
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrCopyLinearToFmask(ADDR_HANDLE hLib, const ADDR_COPY_FMASK_INPUT *pIn);
+
+
+/**
+***************************************************************************************************
+*   AddrComputeCmaskInfo
+*
+*   @brief
+*       Compute the CMASK pitch, height, base alignment and size in bytes of a color surface
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrComputeCmaskInfo(ADDR_HANDLE hLib, const ADDR_COMPUTE_CMASK_INFO_INPUT *pIn, ADDR_COMPUTE_CMASK_INFO_OUTPUT *pOut);
+
+
+/**
+***************************************************************************************************
+*   AddrComputeCmaskAddrFromCoord
+*
+*   @brief
+*       Compute the address of the CMASK entry of a color surface pixel
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrComputeCmaskAddrFromCoord(ADDR_HANDLE hLib, const ADDR_COMPUTE_CMASK_ADDRFROMCOORD_INPUT *pIn, ADDR_COMPUTE_CMASK_ADDRFROMCOORD_OUTPUT *pOut);
+
+
+/**
+***************************************************************************************************
+*   AddrCopyCmaskToLinear
+*
+*   @brief
+*       Read the CMASK of a surface or region into a linear array of tiles
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrCopyCmaskToLinear(ADDR_HANDLE hLib, const ADDR_COPY_CMASK_INPUT *pIn);
+
+
+/**
+***************************************************************************************************
+*   AddrCopyLinearToCmask
+*
+*   @brief
+*       Write the CMASK of a surface or region from a linear array of tiles
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrCopyLinearToCmask(ADDR_HANDLE hLib, const ADDR_COPY_CMASK_INPUT *pIn);
+
+
+/**
+***************************************************************************************************
+*   AddrCopyDepthPlanesToLinear
+*
+*   @brief
+*       Read the depth and stencil planes of a depth surface or region into separate linear
+*       buffers in one pass
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrCopyDepthPlanesToLinear(ADDR_HANDLE hLib, const ADDR_COPY_DEPTH_PLANES_INPUT *pIn);
+
+
+/**
+***************************************************************************************************
+*   AddrCopyLinearToDepthPlanes
+*
+*   @brief
+*       Write the depth and stencil planes of a depth surface or region from separate linear
+*       buffers in one pass
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrCopyLinearToDepthPlanes(ADDR_HANDLE hLib, const ADDR_COPY_DEPTH_PLANES_INPUT *pIn);
+
+
 /**
 ***************************************************************************************************
 *   AddrComputeSliceSwizzle
@@ -653,3 +2260,99 @@ AddrComputeHtileInfo(ADDR_HANDLE hLib, ADDR_COMPUTE_HTILE_INFO_INPUT *pIn, ADDR_
 */
 ADDR_E_RETURNCODE
 AddrComputeSliceSwizzle(ADDR_HANDLE hLib, ADDR_COMPUTE_SLICESWIZZLE_INPUT *pIn, ADDR_COMPUTE_SLICESWIZZLE_OUTPUT *pOut);
+
+
+/**
+***************************************************************************************************
+*   AddrComputePixelIndexTable
+*
+*   @brief
+*       Get the pixel index of every x, y position within one slice of a micro tile
+*   @return
+*       ADDR_OK if no error
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrComputePixelIndexTable(ADDR_HANDLE hLib, ADDR_COMPUTE_PIXEL_INDEX_TABLE_INPUT *pIn, ADDR_COMPUTE_PIXEL_INDEX_TABLE_OUTPUT *pOut);
+
+
+/**
+***************************************************************************************************
+*   AddrCopySurfaceTiledToLinear
+*
+*   @brief
+*       Copy every slice and sample of a tiled surface into a linear buffer
+*   @return
+*       ADDR_OK if no error
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrCopySurfaceTiledToLinear(ADDR_HANDLE hLib, ADDR_COPY_SURFACE_INPUT *pIn);
+
+
+/**
+***************************************************************************************************
+*   AddrCopySurfaceLinearToTiled
+*
+*   @brief
+*       Copy every slice and sample of a linear buffer into a tiled surface
+*   @return
+*       ADDR_OK if no error
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrCopySurfaceLinearToTiled(ADDR_HANDLE hLib, ADDR_COPY_SURFACE_INPUT *pIn);
+
+
+/**
+***************************************************************************************************
+*   AddrStartTrace
+*
+*   @brief
+*       Start recording every call of the library to pIn->pfnWrite, see ADDR_TRACE_HEADER for
+*       the stream format
+*
+*   @note
+*       Calls append to a buffer of their own thread without locking, a full buffer is written
+*       out under a lock. Must not run concurrently with other calls of the library.
+*
+*   @return
+*       ADDR_OK if successful
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrStartTrace(ADDR_HANDLE hLib, const ADDR_START_TRACE_INPUT *pIn);
+
+
+/**
+***************************************************************************************************
+*   AddrStopTrace
+*
+*   @brief
+*       Write out the buffered records and stop recording, AddrDestroy does the same
+*
+*   @note
+*       Must not run concurrently with other calls of the library.
+*
+*   @return
+*       ADDR_OK if the whole trace was written
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrStopTrace(ADDR_HANDLE hLib);
+
+
+/**
+***************************************************************************************************
+*   AddrReadTrace
+*
+*   @brief
+*       Validate a call trace stream and pass each of its records to pIn->pfnRecord
+*
+*   @return
+*       ADDR_OK if the stream is valid, ADDR_INVALIDPARAMS if it is truncated or corrupt, the
+*       records before the damage have then been passed on
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrReadTrace(const ADDR_READ_TRACE_INPUT *pIn, ADDR_READ_TRACE_OUTPUT *pOut);
@@ -249,3 +249,45 @@ enum AddrHtileBlockSize : uint32_t
    ADDR_HTILE_BLOCKSIZE_4 = 0x4,
    ADDR_HTILE_BLOCKSIZE_8 = 0x8,
 };
+
+
+/**
+***************************************************************************************************
+*   AddrStatsEntry
+*
+*   @brief
+*       Entry points counted and timed by AddrGetStats
+***************************************************************************************************
+*/
+enum AddrStatsEntry : uint32_t
+{
+   ADDR_STATS_SURFACE_INFO = 0x0,
+   ADDR_STATS_MIPCHAIN_INFO = 0x1,
+   ADDR_STATS_SURFACE_ADDRFROMCOORD = 0x2,
+   ADDR_STATS_SURFACE_ADDRFROMCOORD_BATCH = 0x3,
+   ADDR_STATS_CREATE_SURFACE_PLAN = 0x4,
+   ADDR_STATS_SURFACE_COORDFROMADDR = 0x5,
+   ADDR_STATS_SURFACE_COORDFROMADDR_RANGE = 0x6,
+   ADDR_STATS_SURFACE_DIRTY_REGIONS = 0x7,
+   ADDR_STATS_EXTRACT_BANKPIPE_SWIZZLE = 0x8,
+   ADDR_STATS_HTILE_INFO = 0x9,
+   ADDR_STATS_SLICE_SWIZZLE = 0xA,
+   ADDR_STATS_PIXEL_INDEX_TABLE = 0xB,
+   ADDR_STATS_COPY_TILED_TO_LINEAR = 0xC,
+   ADDR_STATS_COPY_LINEAR_TO_TILED = 0xD,
+   ADDR_STATS_HTILE_ADDRFROMCOORD = 0xE,
+   ADDR_STATS_COPY_HTILE_TO_LINEAR = 0xF,
+   ADDR_STATS_COPY_LINEAR_TO_HTILE = 0x10,
+   ADDR_STATS_FMASK_INFO = 0x11,
+   ADDR_STATS_FMASK_ADDRFROMCOORD = 0x12,
+   ADDR_STATS_FMASK_ADDRFROMCOORD_BATCH = 0x13,
+   ADDR_STATS_COPY_FMASK_TO_LINEAR = 0x14,
+   ADDR_STATS_COPY_LINEAR_TO_FMASK = 0x15,
+   ADDR_STATS_CMASK_INFO = 0x16,
+   ADDR_STATS_CMASK_ADDRFROMCOORD = 0x17,
+   ADDR_STATS_COPY_CMASK_TO_LINEAR = 0x18,
+   ADDR_STATS_COPY_LINEAR_TO_CMASK = 0x19,
+   ADDR_STATS_COPY_DEPTH_PLANES_TO_LINEAR = 0x1A,
+   ADDR_STATS_COPY_LINEAR_TO_DEPTH_PLANES = 0x1B,
+   ADDR_STATS_ENTRY_COUNT = 0x1C,
+};
@@ -33,6 +33,7 @@
 
 #include "addrlib/addrinterface.h"
 #include "core/addrlib.h"
+#include "core/addrsurfaceplan.h"
 
 
 /**
@@ -78,6 +79,66 @@ AddrDestroy(ADDR_HANDLE hLib)
 }
 
 
+/**
+***************************************************************************************************
+*   AddrGetInstanceSize
+*
+*   @brief
+*       Get the storage AddrCreateInPlace needs
+*
+*   @return
+*       ADDR_OK if successful, otherwise an error code of ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrGetInstanceSize(const ADDR_CREATE_INPUT *pCreateIn, ADDR_GET_INSTANCE_SIZE_OUTPUT *pOut)
+{
+   return AddrLib::GetInstanceSize(pCreateIn, pOut);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrCreateInPlace
+*
+*   @brief
+*       Create address lib object in caller provided storage
+*
+*   @return
+*       ADDR_OK if successful, otherwise an error code of ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrCreateInPlace(const ADDR_CREATE_INPUT *pCreateIn, void *pStorage, uint64_t storageSize, ADDR_CREATE_OUTPUT *pCreateOut)
+{
+   return AddrLib::CreateInPlace(pCreateIn, pStorage, storageSize, pCreateOut);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrDestroyInPlace
+*
+*   @brief
+*       Destroy address lib object created in place
+*
+*   @return
+*       ADDR_OK if successful, otherwise an error code of ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrDestroyInPlace(ADDR_HANDLE hLib)
+{
+   auto pLib = AddrLib::GetAddrLib(hLib);
+
+   if (!pLib) {
+      return ADDR_ERROR;
+   }
+
+   return pLib->DestroyInPlace();
+}
+
+
 /**
 ***************************************************************************************************
 *   AddrComputeSurfaceInfo
@@ -102,6 +163,168 @@ AddrComputeSurfaceInfo(ADDR_HANDLE hLib, ADDR_COMPUTE_SURFACE_INFO_INPUT *pIn, A
 }
 
 
+/**
+***************************************************************************************************
+*   AddrComputeMipChainInfo
+*
+*   @brief
+*       Compute the layout of every level of a mip chain and the size of the whole chain
+*
+*   @return
+*       ADDR_OK if successful, otherwise an error code of ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrComputeMipChainInfo(ADDR_HANDLE hLib, const ADDR_COMPUTE_MIPCHAIN_INFO_INPUT *pIn, ADDR_COMPUTE_MIPCHAIN_INFO_OUTPUT *pOut)
+{
+   auto pLib = AddrLib::GetAddrLib(hLib);
+
+   if (!pLib) {
+      return ADDR_ERROR;
+   }
+
+   return pLib->ComputeMipChainInfo(pIn, pOut);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrGetSurfaceInfoCacheStats
+*
+*   @brief
+*       Get the hit and miss counts of the AddrComputeSurfaceInfo cache
+*
+*   @return
+*       ADDR_OK if successful, ADDR_NOTSUPPORTED if the cache was not enabled at creation
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrGetSurfaceInfoCacheStats(ADDR_HANDLE hLib, ADDR_GET_SURFACE_INFO_CACHE_STATS_OUTPUT *pOut)
+{
+   auto pLib = AddrLib::GetAddrLib(hLib);
+
+   if (!pLib) {
+      return ADDR_ERROR;
+   }
+
+   return pLib->GetSurfaceInfoCacheStats(pOut);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrGetStats
+*
+*   @brief
+*       Get the performance counters of the library
+*
+*   @return
+*       ADDR_OK if successful, otherwise an error code of ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrGetStats(ADDR_HANDLE hLib, ADDR_GET_STATS_OUTPUT *pOut)
+{
+   auto pLib = AddrLib::GetAddrLib(hLib);
+
+   if (!pLib) {
+      return ADDR_ERROR;
+   }
+
+   return pLib->GetStats(pOut);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrResetStats
+*
+*   @brief
+*       Clear the performance counters of the library
+*
+*   @return
+*       ADDR_OK if successful, otherwise an error code of ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrResetStats(ADDR_HANDLE hLib)
+{
+   auto pLib = AddrLib::GetAddrLib(hLib);
+
+   if (!pLib) {
+      return ADDR_ERROR;
+   }
+
+   return pLib->ResetStats();
+}
+
+
+/**
+***************************************************************************************************
+*   AddrStartTrace
+*
+*   @brief
+*       Start recording the calls of the library to a binary stream
+*
+*   @return
+*       ADDR_OK if successful, otherwise an error code of ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrStartTrace(ADDR_HANDLE hLib, const ADDR_START_TRACE_INPUT *pIn)
+{
+   auto pLib = AddrLib::GetAddrLib(hLib);
+
+   if (!pLib) {
+      return ADDR_ERROR;
+   }
+
+   return pLib->StartTrace(pIn);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrStopTrace
+*
+*   @brief
+*       Write out the recorded calls and stop recording
+*
+*   @return
+*       ADDR_OK if successful, otherwise an error code of ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrStopTrace(ADDR_HANDLE hLib)
+{
+   auto pLib = AddrLib::GetAddrLib(hLib);
+
+   if (!pLib) {
+      return ADDR_ERROR;
+   }
+
+   return pLib->StopTrace();
+}
+
+
+/**
+***************************************************************************************************
+*   AddrReadTrace
+*
+*   @brief
+*       Validate a call trace stream and decode its records
+*
+*   @return
+*       ADDR_OK if successful, otherwise an error code of ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrReadTrace(const ADDR_READ_TRACE_INPUT *pIn, ADDR_READ_TRACE_OUTPUT *pOut)
+{
+   return AddrTrace::Read(pIn, pOut);
+}
+
+
 /**
 ***************************************************************************************************
 *   AddrComputeSurfaceAddrFromCoord
@@ -128,16 +351,17 @@ AddrComputeSurfaceAddrFromCoord(ADDR_HANDLE hLib, ADDR_COMPUTE_SURFACE_ADDRFROMC
 
 /**
 ***************************************************************************************************
-*   AddrExtractBankPipeSwizzle
+*   AddrComputeSurfaceAddrFromCoordBatch
 *
 *   @brief
-*       Extract Bank and Pipe swizzle from base256b
+*       Compute surface addresses of many coordinates of one surface
+*
 *   @return
 *       ADDR_OK if successful, otherwise an error code of ADDR_E_RETURNCODE
 ***************************************************************************************************
 */
 ADDR_E_RETURNCODE
-AddrExtractBankPipeSwizzle(ADDR_HANDLE hLib, ADDR_EXTRACT_BANKPIPE_SWIZZLE_INPUT *pIn, ADDR_EXTRACT_BANKPIPE_SWIZZLE_OUTPUT *pOut)
+AddrComputeSurfaceAddrFromCoordBatch(ADDR_HANDLE hLib, const ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_INPUT *pIn, ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_OUTPUT *pOut)
 {
    auto pLib = AddrLib::GetAddrLib(hLib);
 
@@ -145,23 +369,23 @@ AddrExtractBankPipeSwizzle(ADDR_HANDLE hLib, ADDR_EXTRACT_BANKPIPE_SWIZZLE_INPUT
       return ADDR_ERROR;
    }
 
-   return pLib->ExtractBankPipeSwizzle(pIn, pOut);
+   return pLib->ComputeSurfaceAddrFromCoordBatch(pIn, pOut);
 }
 
 
 /**
 ***************************************************************************************************
-*   AddrComputeHtileInfo
+*   AddrCreateSurfacePlan
 *
 *   @brief
-*       Compute Htile pitch, height, base alignment and size in bytes
+*       Precompute everything about a surface which AddrPlanAddrFromCoord needs
 *
 *   @return
 *       ADDR_OK if successful, otherwise an error code of ADDR_E_RETURNCODE
 ***************************************************************************************************
 */
 ADDR_E_RETURNCODE
-AddrComputeHtileInfo(ADDR_HANDLE hLib, ADDR_COMPUTE_HTILE_INFO_INPUT *pIn, ADDR_COMPUTE_HTILE_INFO_OUTPUT *pOut)
+AddrCreateSurfacePlan(ADDR_HANDLE hLib, const ADDR_CREATE_SURFACE_PLAN_INPUT *pIn, ADDR_CREATE_SURFACE_PLAN_OUTPUT *pOut)
 {
    auto pLib = AddrLib::GetAddrLib(hLib);
 
@@ -169,22 +393,23 @@ AddrComputeHtileInfo(ADDR_HANDLE hLib, ADDR_COMPUTE_HTILE_INFO_INPUT *pIn, ADDR_
       return ADDR_ERROR;
    }
 
-   return pLib->ComputeHtileInfo(pIn, pOut);
+   return pLib->CreateSurfacePlan(pIn, pOut);
 }
 
 
 /**
 ***************************************************************************************************
-*   AddrComputeSliceSwizzle
+*   AddrDestroySurfacePlan
 *
 *   @brief
-*       Compute a swizzle for slice from a base swizzle
+*       Destroy a surface plan created by AddrCreateSurfacePlan
+*
 *   @return
-*       ADDR_OK if no error
+*       ADDR_OK if successful, otherwise an error code of ADDR_E_RETURNCODE
 ***************************************************************************************************
 */
 ADDR_E_RETURNCODE
-AddrComputeSliceSwizzle(ADDR_HANDLE hLib, ADDR_COMPUTE_SLICESWIZZLE_INPUT *pIn, ADDR_COMPUTE_SLICESWIZZLE_OUTPUT *pOut)
+AddrDestroySurfacePlan(ADDR_HANDLE hLib, ADDR_SURFACE_PLAN hPlan)
 {
    auto pLib = AddrLib::GetAddrLib(hLib);
 
@@ -192,5 +417,583 @@ AddrComputeSliceSwizzle(ADDR_HANDLE hLib, ADDR_COMPUTE_SLICESWIZZLE_INPUT *pIn,
       return ADDR_ERROR;
    }
 
-   return pLib->ComputeSliceTileSwizzle(pIn, pOut);
+   return pLib->DestroySurfacePlan(hPlan);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrPlanAddrFromCoord
+*
+*   @brief
+*       Compute the address of a coordinate of the surface of a plan
+*
+*   @return
+*       The byte address
+***************************************************************************************************
+*/
+uint64_t
+AddrPlanAddrFromCoord(ADDR_SURFACE_PLAN hPlan, uint32_t x, uint32_t y, uint32_t slice, uint32_t sample, uint32_t *pBitPosition)
+{
+   uint32_t bitPosition;
+   auto addr = AddrSurfacePlan::GetSurfacePlan(hPlan)->ComputeAddrFromCoord(x, y, slice, sample, &bitPosition);
+
+   if (pBitPosition) {
+      *pBitPosition = bitPosition;
+   }
+
+   return addr;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrComputeSurfaceCoordFromAddr
+*
+*   @brief
+*       Compute the coordinate of the element at a given surface address
+*
+*   @return
+*       ADDR_OK if successful, otherwise an error code of ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrComputeSurfaceCoordFromAddr(ADDR_HANDLE hLib, const ADDR_COMPUTE_SURFACE_COORDFROMADDR_INPUT *pIn, ADDR_COMPUTE_SURFACE_COORDFROMADDR_OUTPUT *pOut)
+{
+   auto pLib = AddrLib::GetAddrLib(hLib);
+
+   if (!pLib) {
+      return ADDR_ERROR;
+   }
+
+   return pLib->ComputeSurfaceCoordFromAddr(pIn, pOut);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrComputeSurfaceCoordFromAddrRange
+*
+*   @brief
+*       Compute the coordinates of every element touched by a byte range of a surface
+*
+*   @return
+*       ADDR_OK if successful, ADDR_OUTOFMEMORY if the range touches more than maxCoords
+*       elements, otherwise an error code of ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrComputeSurfaceCoordFromAddrRange(ADDR_HANDLE hLib, const ADDR_COMPUTE_SURFACE_COORDFROMADDR_RANGE_INPUT *pIn, ADDR_COMPUTE_SURFACE_COORDFROMADDR_RANGE_OUTPUT *pOut)
+{
+   auto pLib = AddrLib::GetAddrLib(hLib);
+
+   if (!pLib) {
+      return ADDR_ERROR;
+   }
+
+   return pLib->ComputeSurfaceCoordFromAddrRange(pIn, pOut);
 }
+
+
+/**
+***************************************************************************************************
+*   AddrComputeSurfaceDirtyRegions
+*
+*   @brief
+*       Compute the tile aligned regions of a surface whose bytes intersect a byte range
+*
+*   @return
+*       ADDR_OK if successful, ADDR_OUTOFMEMORY if there are more than maxRegions regions,
+*       otherwise an error code of ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrComputeSurfaceDirtyRegions(ADDR_HANDLE hLib, const ADDR_COMPUTE_SURFACE_DIRTY_REGIONS_INPUT *pIn, ADDR_COMPUTE_SURFACE_DIRTY_REGIONS_OUTPUT *pOut)
+{
+   auto pLib = AddrLib::GetAddrLib(hLib);
+
+   if (!pLib) {
+      return ADDR_ERROR;
+   }
+
+   return pLib->ComputeSurfaceDirtyRegions(pIn, pOut);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrExtractBankPipeSwizzle
+*
+*   @brief
+*       Extract Bank and Pipe swizzle from base256b
+*   @return
+*       ADDR_OK if successful, otherwise an error code of ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrExtractBankPipeSwizzle(ADDR_HANDLE hLib, ADDR_EXTRACT_BANKPIPE_SWIZZLE_INPUT *pIn, ADDR_EXTRACT_BANKPIPE_SWIZZLE_OUTPUT *pOut)
+{
+   auto pLib = AddrLib::GetAddrLib(hLib);
+
+   if (!pLib) {
+      return ADDR_ERROR;
+   }
+
+   return pLib->ExtractBankPipeSwizzle(pIn, pOut);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrComputeHtileInfo
+*
+*   @brief
+*       Compute Htile pitch, height, base alignment and size in bytes
+*
+*   @return
+*       ADDR_OK if successful, otherwise an error code of ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrComputeHtileInfo(ADDR_HANDLE hLib, ADDR_COMPUTE_HTILE_INFO_INPUT *pIn, ADDR_COMPUTE_HTILE_INFO_OUTPUT *pOut)
+{
+   auto pLib = AddrLib::GetAddrLib(hLib);
+
+   if (!pLib) {
+      return ADDR_ERROR;
+   }
+
+   return pLib->ComputeHtileInfo(pIn, pOut);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrComputeHtileAddrFromCoord
+*
+*   @brief
+*       Compute the address of the HTILE word of a depth surface pixel
+*
+*   @return
+*       ADDR_OK if successful, otherwise an error code of ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrComputeHtileAddrFromCoord(ADDR_HANDLE hLib, const ADDR_COMPUTE_HTILE_ADDRFROMCOORD_INPUT *pIn, ADDR_COMPUTE_HTILE_ADDRFROMCOORD_OUTPUT *pOut)
+{
+   auto pLib = AddrLib::GetAddrLib(hLib);
+
+   if (!pLib) {
+      return ADDR_ERROR;
+   }
+
+   return pLib->ComputeHtileAddrFromCoord(pIn, pOut);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrCopyHtileToLinear
+*
+*   @brief
+*       Read the HTILE of a surface or region into a linear array of tiles
+*
+*   @return
+*       ADDR_OK if successful, otherwise an error code of ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrCopyHtileToLinear(ADDR_HANDLE hLib, const ADDR_COPY_HTILE_INPUT *pIn)
+{
+   auto pLib = AddrLib::GetAddrLib(hLib);
+
+   if (!pLib) {
+      return ADDR_ERROR;
+   }
+
+   return pLib->CopyHtileToLinear(pIn);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrCopyLinearToHtile
+*
+*   @brief
+*       Write the HTILE of a surface or region from a linear array of tiles
+*
+*   @return
+*       ADDR_OK if successful, otherwise an error code of ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrCopyLinearToHtile(ADDR_HANDLE hLib, const ADDR_COPY_HTILE_INPUT *pIn)
+{
+   auto pLib = AddrLib::GetAddrLib(hLib);
+
+   if (!pLib) {
+      return ADDR_ERROR;
+   }
+
+   return pLib->CopyLinearToHtile(pIn);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrComputeFmaskInfo
+*
+*   @brief
+*       Compute the FMASK bits per sample, pitch, height, tile mode, alignment and size
+*
+*   @return
+*       ADDR_OK if successful, otherwise an error code of ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrComputeFmaskInfo(ADDR_HANDLE hLib, const ADDR_COMPUTE_FMASK_INFO_INPUT *pIn, ADDR_COMPUTE_FMASK_INFO_OUTPUT *pOut)
+{
+   auto pLib = AddrLib::GetAddrLib(hLib);
+
+   if (!pLib) {
+      return ADDR_ERROR;
+   }
+
+   return pLib->ComputeFmaskInfo(pIn, pOut);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrComputeFmaskAddrFromCoord
+*
+*   @brief
+*       Compute the address of the FMASK bits of a sample
+*
+*   @return
+*       ADDR_OK if successful, otherwise an error code of ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrComputeFmaskAddrFromCoord(ADDR_HANDLE hLib, const ADDR_COMPUTE_FMASK_ADDRFROMCOORD_INPUT *pIn, ADDR_COMPUTE_FMASK_ADDRFROMCOORD_OUTPUT *pOut)
+{
+   auto pLib = AddrLib::GetAddrLib(hLib);
+
+   if (!pLib) {
+      return ADDR_ERROR;
+   }
+
+   return pLib->ComputeFmaskAddrFromCoord(pIn, pOut);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrComputeFmaskAddrFromCoordBatch
+*
+*   @brief
+*       Compute the address of the FMASK bits of many samples of one surface
+*
+*   @return
+*       ADDR_OK if successful, otherwise an error code of ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrComputeFmaskAddrFromCoordBatch(ADDR_HANDLE hLib, const ADDR_COMPUTE_FMASK_ADDRFROMCOORD_BATCH_INPUT *pIn, ADDR_COMPUTE_FMASK_ADDRFROMCOORD_BATCH_OUTPUT *pOut)
+{
+   auto pLib = AddrLib::GetAddrLib(hLib);
+
+   if (!pLib) {
+      return ADDR_ERROR;
+   }
+
+   return pLib->ComputeFmaskAddrFromCoordBatch(pIn, pOut);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrCopyFmaskToLinear
+*
+*   @brief
+*       Read the FMASK of a surface or region into a linear array of pixels
+*
+*   @return
+*       ADDR_OK if successful, otherwise an error code of ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrCopyFmaskToLinear(ADDR_HANDLE hLib, const ADDR_COPY_FMASK_INPUT *pIn)
+{
+   auto pLib = AddrLib::GetAddrLib(hLib);
+
+   if (!pLib) {
+      return ADDR_ERROR;
+   }
+
+   return pLib->CopyFmaskToLinear(pIn);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrCopyLinearToFmask
+*
+*   @brief
+*       Write the FMASK of a surface or region from a linear array of pixels
+*
+*   @return
+*       ADDR_OK if successful, otherwise an error code of ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrCopyLinearToFmask(ADDR_HANDLE hLib, const ADDR_COPY_FMASK_INPUT *pIn)
+{
+   auto pLib = AddrLib::GetAddrLib(hLib);
+
+   if (!pLib) {
+      return ADDR_ERROR;
+   }
+
+   return pLib->CopyLinearToFmask(pIn);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrComputeCmaskInfo
+*
+*   @brief
+*       Compute the CMASK pitch, height, base alignment and size in bytes
+*
+*   @return
+*       ADDR_OK if successful, otherwise an error code of ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrComputeCmaskInfo(ADDR_HANDLE hLib, const ADDR_COMPUTE_CMASK_INFO_INPUT *pIn, ADDR_COMPUTE_CMASK_INFO_OUTPUT *pOut)
+{
+   auto pLib = AddrLib::GetAddrLib(hLib);
+
+   if (!pLib) {
+      return ADDR_ERROR;
+   }
+
+   return pLib->ComputeCmaskInfo(pIn, pOut);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrComputeCmaskAddrFromCoord
+*
+*   @brief
+*       Compute the address of the CMASK entry of a color surface pixel
+*
+*   @return
+*       ADDR_OK if successful, otherwise an error code of ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrComputeCmaskAddrFromCoord(ADDR_HANDLE hLib, const ADDR_COMPUTE_CMASK_ADDRFROMCOORD_INPUT *pIn, ADDR_COMPUTE_CMASK_ADDRFROMCOORD_OUTPUT *pOut)
+{
+   auto pLib = AddrLib::GetAddrLib(hLib);
+
+   if (!pLib) {
+      return ADDR_ERROR;
+   }
+
+   return pLib->ComputeCmaskAddrFromCoord(pIn, pOut);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrCopyCmaskToLinear
+*
+*   @brief
+*       Read the CMASK of a surface or region into a linear array of tiles
+*
+*   @return
+*       ADDR_OK if successful, otherwise an error code of ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrCopyCmaskToLinear(ADDR_HANDLE hLib, const ADDR_COPY_CMASK_INPUT *pIn)
+{
+   auto pLib = AddrLib::GetAddrLib(hLib);
+
+   if (!pLib) {
+      return ADDR_ERROR;
+   }
+
+   return pLib->CopyCmaskToLinear(pIn);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrCopyLinearToCmask
+*
+*   @brief
+*       Write the CMASK of a surface or region from a linear array of tiles
+*
+*   @return
+*       ADDR_OK if successful, otherwise an error code of ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrCopyLinearToCmask(ADDR_HANDLE hLib, const ADDR_COPY_CMASK_INPUT *pIn)
+{
+   auto pLib = AddrLib::GetAddrLib(hLib);
+
+   if (!pLib) {
+      return ADDR_ERROR;
+   }
+
+   return pLib->CopyLinearToCmask(pIn);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrCopyDepthPlanesToLinear
+*
+*   @brief
+*       Read the depth and stencil planes of a depth surface or region into separate linear
+*       buffers in one pass
+*
+*   @return
+*       ADDR_OK if successful, otherwise an error code of ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrCopyDepthPlanesToLinear(ADDR_HANDLE hLib, const ADDR_COPY_DEPTH_PLANES_INPUT *pIn)
+{
+   auto pLib = AddrLib::GetAddrLib(hLib);
+
+   if (!pLib) {
+      return ADDR_ERROR;
+   }
+
+   return pLib->CopyDepthPlanesToLinear(pIn);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrCopyLinearToDepthPlanes
+*
+*   @brief
+*       Write the depth and stencil planes of a depth surface or region from separate linear
+*       buffers in one pass
+*
+*   @return
+*       ADDR_OK if successful, otherwise an error code of ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrCopyLinearToDepthPlanes(ADDR_HANDLE hLib, const ADDR_COPY_DEPTH_PLANES_INPUT *pIn)
+{
+   auto pLib = AddrLib::GetAddrLib(hLib);
+
+   if (!pLib) {
+      return ADDR_ERROR;
+   }
+
+   return pLib->CopyLinearToDepthPlanes(pIn);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrComputeSliceSwizzle
+*
+*   @brief
+*       Compute a swizzle for slice from a base swizzle
+*   @return
+*       ADDR_OK if no error
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrComputeSliceSwizzle(ADDR_HANDLE hLib, ADDR_COMPUTE_SLICESWIZZLE_INPUT *pIn, ADDR_COMPUTE_SLICESWIZZLE_OUTPUT *pOut)
+{
+   auto pLib = AddrLib::GetAddrLib(hLib);
+
+   if (!pLib) {
+      return ADDR_ERROR;
+   }
+
+   return pLib->ComputeSliceTileSwizzle(pIn, pOut);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrComputePixelIndexTable
+*
+*   @brief
+*       Get the pixel index of every x, y position within one slice of a micro tile
+*   @return
+*       ADDR_OK if successful, otherwise an error code of ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrComputePixelIndexTable(ADDR_HANDLE hLib, ADDR_COMPUTE_PIXEL_INDEX_TABLE_INPUT *pIn, ADDR_COMPUTE_PIXEL_INDEX_TABLE_OUTPUT *pOut)
+{
+   auto pLib = AddrLib::GetAddrLib(hLib);
+
+   if (!pLib) {
+      return ADDR_ERROR;
+   }
+
+   return pLib->ComputePixelIndexTable(pIn, pOut);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrCopySurfaceTiledToLinear
+*
+*   @brief
+*       Copy every slice and sample of a tiled surface into a linear buffer
+*   @return
+*       ADDR_OK if successful, otherwise an error code of ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrCopySurfaceTiledToLinear(ADDR_HANDLE hLib, ADDR_COPY_SURFACE_INPUT *pIn)
+{
+   auto pLib = AddrLib::GetAddrLib(hLib);
+
+   if (!pLib) {
+      return ADDR_ERROR;
+   }
+
+   return pLib->CopySurfaceTiledToLinear(pIn);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrCopySurfaceLinearToTiled
+*
+*   @brief
+*       Copy every slice and sample of a linear buffer into a tiled surface
+*   @return
+*       ADDR_OK if successful, otherwise an error code of ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrCopySurfaceLinearToTiled(ADDR_HANDLE hLib, ADDR_COPY_SURFACE_INPUT *pIn)
+{
+   auto pLib = AddrLib::GetAddrLib(hLib);
+
+   if (!pLib) {
+      return ADDR_ERROR;
+   }
+
+   return pLib->CopySurfaceLinearToTiled(pIn);
+}
+
+
@@ -40,7 +40,14 @@ static const uint32_t MicroTileHeight = 8;
 static const uint32_t ThickTileThickness = 4;
 static const uint32_t XThickTileThickness = 8;
 static const uint32_t HtileCacheBits = 16384;
+static const uint32_t CmaskCacheBits = 1024;
+static const uint32_t CmaskElemBits = 4;
+static const uint32_t CmaskBlockPixels = 128 * 128;
 static const uint32_t MicroTilePixels = MicroTileWidth * MicroTileHeight;
+static const uint32_t MicroTileVolumePixels = MicroTilePixels * XThickTileThickness;
+static const uint32_t MicroTilePixelOrders = 7;
+static const uint32_t MicroTileThicknessModes = 3;
+static const uint16_t PixelCoordInvalid = 0xFFFF;
 
 static const int32_t TileIndexInvalid = TILEINDEX_INVALID;
 static const int32_t TileIndexLinearGeneral = TILEINDEX_LINEAR_GENERAL;
@@ -177,7 +184,7 @@ NextPow2(uint32_t dim)
 ***************************************************************************************************
 */
 template<typename Type>
-inline Type
+constexpr inline Type
 Log2(Type x)
 {
    Type y = 0;
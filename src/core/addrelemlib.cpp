@@ -49,6 +49,7 @@
 ***************************************************************************************************
 */
 AddrElemLib::AddrElemLib(AddrLib *pAddrLib) :
+   AddrObject(pAddrLib->GetClient()),
    mAddrLib(pAddrLib)
 {
    auto family = pAddrLib->GetAddrChipFamily();
@@ -86,17 +87,19 @@ AddrElemLib::AddrElemLib(AddrLib *pAddrLib) :
 ***************************************************************************************************
 */
 AddrElemLib *
-AddrElemLib::Create(AddrLib *pAddrLib, const ADDR_CREATE_INPUT *pInput)
+AddrElemLib::Create(AddrLib *pAddrLib, const ADDR_CREATE_INPUT *pInput, void *pMemory)
 {
    AddrElemLib *pElemLib = nullptr;
 
    if (pAddrLib) {
-      auto memory = AddrObject::ClientAlloc(sizeof(AddrElemLib), pInput->hClient);
-      pElemLib = new (memory) AddrElemLib(pAddrLib);
+      auto memory = pMemory ? pMemory : AddrObject::ClientAlloc(sizeof(AddrElemLib), pAddrLib->GetClient());
+
+      if (memory) {
+         pElemLib = new (memory) AddrElemLib(pAddrLib);
+      }
    }
 
    if (pElemLib) {
-      pElemLib->mClient = pInput->hClient;
       pElemLib->mDebugPrint = pInput->callbacks.debugPrint;
    }
 
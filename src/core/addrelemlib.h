@@ -78,7 +78,7 @@ public:
    AddrElemLib(AddrLib *pAddrLib);
 
    static AddrElemLib *
-   Create(AddrLib *pAddrLib, const ADDR_CREATE_INPUT *pInput);
+   Create(AddrLib *pAddrLib, const ADDR_CREATE_INPUT *pInput, void *pMemory);
 
    void
    SetConfigFlags(ADDR_CONFIG_FLAGS flags);
@@ -35,29 +35,40 @@
 #include <cstring>
 #include "addrlib.h"
 
+// Alignment of the storage and of every object of a library created in place
+static const uint32_t InstanceAlignment = 64;
+
 
 /**
 ***************************************************************************************************
 *   AddrLib::AddrLib
 *
 *   @brief
-*       Constructor for the AddrLib class with hClient as parameter
+*       Constructor for the AddrLib class with pClient as parameter
 *
 ***************************************************************************************************
 */
-AddrLib::AddrLib(ADDR_CLIENT_HANDLE hClient) :
-   AddrObject(hClient),
+AddrLib::AddrLib(const AddrClient *pClient) :
+   AddrObject(pClient),
    mClass(BASE_ADDRLIB),
    mChipFamily(ADDR_CHIP_FAMILY_IVLD),
    mChipRevision(0),
    mVersion(ADDRLIB_VERSION),
    mElemLib(nullptr),
+   mSurfaceInfoCache(nullptr),
+   mStats(nullptr),
+   mTrace(nullptr),
    mPipes(0),
    mBanks(0),
    mPipeInterleaveBytes(0),
-   mRowSize(0)
+   mRowSize(0),
+   mCpuFeatures(0)
 {
    mConfigFlags.value = 0;
+   mInPlace = false;
+   std::memset(&mCreateInput, 0, sizeof(mCreateInput));
+   InitPixelIndexTables();
+   AddrSetupMicroTileKernels(mCpuFeatures, &mMicroTileKernels);
 }
 
 
@@ -76,7 +87,6 @@ ADDR_E_RETURNCODE
 AddrLib::Create(const ADDR_CREATE_INPUT *pCreateIn, ADDR_CREATE_OUTPUT *pCreateOut)
 {
    ADDR_E_RETURNCODE returnCode = ADDR_OK;
-   AddrLib *pLib = nullptr;
 
    if (pCreateIn->createFlags.fillSizeFields) {
       if ((pCreateIn->size != sizeof(ADDR_CREATE_INPUT)) ||
@@ -87,19 +97,216 @@ AddrLib::Create(const ADDR_CREATE_INPUT *pCreateIn, ADDR_CREATE_OUTPUT *pCreateO
 
    if (returnCode == ADDR_OK) {
       if (pCreateIn->callbacks.allocSysMem && pCreateIn->callbacks.freeSysMem) {
-         AddrObject::SetupSysMemFuncs(pCreateIn->callbacks.allocSysMem, pCreateIn->callbacks.freeSysMem);
+         returnCode = CreateLib(pCreateIn, nullptr, pCreateOut);
+      } else {
+         pCreateOut->hLib = nullptr;
+         returnCode = ADDR_ERROR;
+      }
+   }
 
-         switch (pCreateIn->chipEngine) {
-         case CIASICIDGFXENGINE_R600:
-            pLib = AddrR600HwlInit(pCreateIn->hClient);
-            break;
-         default:
-            pLib = nullptr;
-         }
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::GetInstanceLayout
+*
+*   @brief
+*       Lays out the objects of a library created in place, each one starting on its own
+*       cache line.
+*
+*   @return
+*       Total bytes of storage, 0 if the chip engine is not supported
+***************************************************************************************************
+*/
+uint64_t
+AddrLib::GetInstanceLayout(const ADDR_CREATE_INPUT *pCreateIn,
+                           uint64_t *pElemLibOffset,
+                           uint64_t *pSurfaceInfoCacheOffset,
+                           uint64_t *pStatsOffset)
+{
+   uint64_t libSize = 0;
+   uint64_t size = 0;
+
+   switch (pCreateIn->chipEngine) {
+   case CIASICIDGFXENGINE_R600:
+      libSize = AddrR600GetInstanceSize();
+      break;
+   default:
+      libSize = 0;
+   }
+
+   if (libSize) {
+      *pElemLibOffset = PowTwoAlign<uint64_t>(libSize, InstanceAlignment);
+      size = *pElemLibOffset + sizeof(AddrElemLib);
+
+      if (pCreateIn->createFlags.surfaceInfoCache) {
+         *pSurfaceInfoCacheOffset = PowTwoAlign<uint64_t>(size, InstanceAlignment);
+         size = *pSurfaceInfoCacheOffset + sizeof(AddrSurfaceInfoCache);
+      } else {
+         *pSurfaceInfoCacheOffset = 0;
+      }
+
+#ifdef ADDR_STATS
+      if (pCreateIn->createFlags.collectStats) {
+         *pStatsOffset = PowTwoAlign<uint64_t>(size, InstanceAlignment);
+         size = *pStatsOffset + sizeof(AddrStats);
+      } else {
+         *pStatsOffset = 0;
+      }
+#else
+      *pStatsOffset = 0;
+#endif
+
+      size = PowTwoAlign<uint64_t>(size, InstanceAlignment);
+   }
+
+   return size;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::GetInstanceSize
+*
+*   @brief
+*       Interface function stub of AddrGetInstanceSize.
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrLib::GetInstanceSize(const ADDR_CREATE_INPUT *pCreateIn, ADDR_GET_INSTANCE_SIZE_OUTPUT *pOut)
+{
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+   uint64_t elemLibOffset;
+   uint64_t surfaceInfoCacheOffset;
+   uint64_t statsOffset;
+
+   if (pCreateIn->createFlags.fillSizeFields) {
+      if ((pCreateIn->size != sizeof(ADDR_CREATE_INPUT)) ||
+          (pOut->size != sizeof(ADDR_GET_INSTANCE_SIZE_OUTPUT))) {
+         returnCode = ADDR_PARAMSIZEMISMATCH;
+      }
+   }
+
+   if (returnCode == ADDR_OK) {
+      pOut->instanceSize = GetInstanceLayout(pCreateIn, &elemLibOffset, &surfaceInfoCacheOffset, &statsOffset);
+      pOut->instanceAlignment = InstanceAlignment;
+
+      if (!pOut->instanceSize) {
+         returnCode = ADDR_NOTSUPPORTED;
+      }
+   }
+
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::CreateInPlace
+*
+*   @brief
+*       Interface function stub of AddrCreateInPlace.
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrLib::CreateInPlace(const ADDR_CREATE_INPUT *pCreateIn,
+                       void *pStorage,
+                       uint64_t storageSize,
+                       ADDR_CREATE_OUTPUT *pCreateOut)
+{
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+   uint64_t elemLibOffset;
+   uint64_t surfaceInfoCacheOffset;
+   uint64_t statsOffset;
+
+   if (pCreateIn->createFlags.fillSizeFields) {
+      if ((pCreateIn->size != sizeof(ADDR_CREATE_INPUT)) ||
+          (pCreateOut->size != sizeof(ADDR_CREATE_OUTPUT))) {
+         returnCode = ADDR_PARAMSIZEMISMATCH;
+      }
+   }
+
+   if (returnCode == ADDR_OK) {
+      auto instanceSize = GetInstanceLayout(pCreateIn, &elemLibOffset, &surfaceInfoCacheOffset, &statsOffset);
+
+      if (!instanceSize) {
+         returnCode = ADDR_NOTSUPPORTED;
+      } else if (!pStorage || storageSize < instanceSize
+              || (reinterpret_cast<uintptr_t>(pStorage) & (InstanceAlignment - 1))) {
+         returnCode = ADDR_INVALIDPARAMS;
+      } else {
+         returnCode = CreateLib(pCreateIn, static_cast<uint8_t *>(pStorage), pCreateOut);
       }
    }
 
+   if (returnCode != ADDR_OK) {
+      pCreateOut->hLib = nullptr;
+   }
+
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::CreateLib
+*
+*   @brief
+*       Creates and initializes the objects of an AddrLib, in pStorage laid out by
+*       GetInstanceLayout or in client allocations when pStorage is nullptr.
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrLib::CreateLib(const ADDR_CREATE_INPUT *pCreateIn,
+                   uint8_t *pStorage,
+                   ADDR_CREATE_OUTPUT *pCreateOut)
+{
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+   AddrLib *pLib = nullptr;
+   AddrClient client;
+   uint64_t elemLibOffset = 0;
+   uint64_t surfaceInfoCacheOffset = 0;
+   uint64_t statsOffset = 0;
+   void *pElemLibMemory = nullptr;
+   void *pSurfaceInfoCacheMemory = nullptr;
+#ifdef ADDR_STATS
+   void *pStatsMemory = nullptr;
+#endif
+
+   client.handle = pCreateIn->hClient;
+   client.callbacks = pCreateIn->callbacks;
+
+   if (pStorage) {
+      GetInstanceLayout(pCreateIn, &elemLibOffset, &surfaceInfoCacheOffset, &statsOffset);
+      pElemLibMemory = pStorage + elemLibOffset;
+      pSurfaceInfoCacheMemory = pStorage + surfaceInfoCacheOffset;
+#ifdef ADDR_STATS
+      pStatsMemory = pStorage + statsOffset;
+#endif
+   }
+
+   switch (pCreateIn->chipEngine) {
+   case CIASICIDGFXENGINE_R600:
+      pLib = AddrR600HwlInit(&client, pStorage);
+      break;
+   default:
+      pLib = nullptr;
+   }
+
    if (pLib) {
+      pLib->mInPlace = pStorage != nullptr;
+      pLib->mCreateInput = *pCreateIn;
       pLib->mDebugPrint = pCreateIn->callbacks.debugPrint;
       pLib->mConfigFlags.forceLinearAligned = pCreateIn->createFlags.forceLinearAligned;
       pLib->mConfigFlags.noCubeMipSlicesPad = pCreateIn->createFlags.noCubeMipSlicesPad;
@@ -108,14 +315,43 @@ AddrLib::Create(const ADDR_CREATE_INPUT *pCreateIn, ADDR_CREATE_OUTPUT *pCreateO
       pLib->mConfigFlags.useTileIndex = pCreateIn->createFlags.useTileIndex;
       pLib->mConfigFlags.useTileCaps = pCreateIn->createFlags.useTileCaps;
       pLib->SetAddrChipFamily(pCreateIn->chipFamily, pCreateIn->chipRevision);
+      auto cpuFeatures = AddrDetectCpuFeatures();
+
+      if (pCreateIn->createFlags.noSse2) {
+         cpuFeatures &= ~ADDR_CPU_SSE2;
+      }
+
+      if (pCreateIn->createFlags.noAvx2) {
+         cpuFeatures &= ~ADDR_CPU_AVX2;
+      }
+
+      if (pCreateIn->createFlags.noAvx512) {
+         cpuFeatures &= ~ADDR_CPU_AVX512;
+      }
+
+      pLib->SetupMicroTileKernels(cpuFeatures);
 
       if (pLib->HwlInitGlobalParams(pCreateIn)) {
-         pLib->mElemLib = AddrElemLib::Create(pLib, pCreateIn);
+         pLib->mElemLib = AddrElemLib::Create(pLib, pCreateIn, pElemLibMemory);
       } else {
          pLib->mElemLib = nullptr;
       }
 
-      if (pLib->mElemLib) {
+      if (pLib->mElemLib && pCreateIn->createFlags.surfaceInfoCache) {
+         pLib->mSurfaceInfoCache = AddrSurfaceInfoCache::Create(&client, pSurfaceInfoCacheMemory);
+      }
+
+#ifdef ADDR_STATS
+      if (pLib->mElemLib && pCreateIn->createFlags.collectStats) {
+         pLib->mStats = AddrStats::Create(&client, pStatsMemory);
+      }
+
+      auto statsCreated = pLib->mStats || !pCreateIn->createFlags.collectStats;
+#else
+      auto statsCreated = true;
+#endif
+
+      if (pLib->mElemLib && (pLib->mSurfaceInfoCache || !pCreateIn->createFlags.surfaceInfoCache) && statsCreated) {
          pLib->mElemLib->SetConfigFlags(pLib->mConfigFlags);
       } else {
          pLib->Destroy();
@@ -132,12 +368,90 @@ AddrLib::Create(const ADDR_CREATE_INPUT *pCreateIn, ADDR_CREATE_OUTPUT *pCreateO
    return returnCode;
 }
 
+
+/**
+***************************************************************************************************
+*   AddrLib::Destroy
+*
+*   @brief
+*       Destroys the library and its objects, and frees their memory unless the library was
+*       created in place.
+*
+*   @return
+*       N/A
+***************************************************************************************************
+*/
 void
 AddrLib::Destroy()
 {
    auto client = mClient;
+   auto inPlace = mInPlace;
+
+   if (mTrace) {
+      StopTrace();
+   }
+
+   if (mSurfaceInfoCache) {
+      if (inPlace) {
+         mSurfaceInfoCache->~AddrSurfaceInfoCache();
+      } else {
+         mSurfaceInfoCache->Destroy();
+      }
+
+      mSurfaceInfoCache = nullptr;
+   }
+
+   if (mStats) {
+      if (inPlace) {
+         mStats->~AddrStats();
+      } else {
+         mStats->Destroy();
+      }
+
+      mStats = nullptr;
+   }
+
+   if (mElemLib) {
+      mElemLib->~AddrElemLib();
+
+      if (!inPlace) {
+         AddrObject::ClientFree(mElemLib, &client);
+      }
+
+      mElemLib = nullptr;
+   }
+
    this->~AddrLib();
-   AddrObject::ClientFree(this, client);
+
+   if (!inPlace) {
+      AddrObject::ClientFree(this, &client);
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::DestroyInPlace
+*
+*   @brief
+*       Interface function stub of AddrDestroyInPlace.
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrLib::DestroyInPlace()
+{
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+
+   if (mInPlace) {
+      Destroy();
+   } else {
+      returnCode = ADDR_INVALIDPARAMS;
+   }
+
+   return returnCode;
 }
 
 
@@ -488,7 +802,19 @@ AddrLib::ComputeSurfaceInfo(ADDR_COMPUTE_SURFACE_INFO_INPUT *pIn,
                             ADDR_COMPUTE_SURFACE_INFO_OUTPUT *pOut) const
 {
    ADDR_E_RETURNCODE returnCode = ADDR_OK;
-   AddrElemMode elemMode;
+   AddrStatsScope statsScope(GetStatsCounters(), ADDR_STATS_SURFACE_INFO);
+   auto traceStart = mTrace ? mTrace->Now() : 0;
+   AddrElemMode elemMode = ADDR_UNCOMPRESSED;
+   AddrSurfaceInfoCacheKey cacheKey;
+   auto useCache = false;
+   auto cacheHit = false;
+
+   // Recorded as passed, the stub fills in fields of pIn
+   ADDR_COMPUTE_SURFACE_INFO_INPUT traceIn;
+
+   if (mTrace) {
+      traceIn = *pIn;
+   }
 
    if (GetFillSizeFieldsFlags()) {
       if (pIn->size != sizeof(ADDR_COMPUTE_SURFACE_INFO_INPUT) || pOut->size != sizeof(ADDR_COMPUTE_SURFACE_INFO_OUTPUT)) {
@@ -500,17 +826,22 @@ AddrLib::ComputeSurfaceInfo(ADDR_COMPUTE_SURFACE_INFO_INPUT *pIn,
       returnCode = ADDR_INVALIDPARAMS;
    }
 
-   if (returnCode == ADDR_OK) {
+   if (returnCode == ADDR_OK && mSurfaceInfoCache && !UseTileIndex(pIn->tileIndex)) {
+      useCache = AddrSurfaceInfoCache::MakeKey(pIn, pOut, &cacheKey);
+
+      if (useCache) {
+         cacheHit = mSurfaceInfoCache->Lookup(&cacheKey, pIn, pOut, GetSliceComputingFlags() != 2);
+      }
+   }
+
+   if (returnCode == ADDR_OK && !cacheHit) {
       ADDR_TILEINFO tileInfoNull;
 
       ComputeMipLevel(pIn);
 
-      auto width = pIn->width;
-      auto height = pIn->height;
-      auto bpp = pIn->bpp;
+      auto elemBpp = uint32_t { 0 };
       auto expandX = uint32_t { 1 };
       auto expandY = uint32_t { 1 };
-      auto sliceFlags = GetSliceComputingFlags();
 
       if (UseTileIndex(pIn->tileIndex) && !pIn->pTileInfo) {
          std::memset(&tileInfoNull, 0, sizeof(ADDR_TILEINFO));
@@ -525,66 +856,34 @@ AddrLib::ComputeSurfaceInfo(ADDR_COMPUTE_SURFACE_INFO_INPUT *pIn,
 
       returnCode = HwlSetupTileCfg(pIn->tileIndex, pIn->pTileInfo, &pIn->tileMode, &pIn->tileType);
 
-      if (returnCode == ADDR_OK) {
-         pOut->pixelBits = pIn->bpp;
-
-         if (pIn->format != ADDR_FMT_INVALID) {
-            auto bpp = mElemLib->GetBitsPerPixel(pIn->format, &elemMode, &expandX, &expandY, nullptr);
-
-            if (elemMode == ADDR_EXPANDED && expandX == 3 && pIn->tileMode == ADDR_TM_LINEAR_ALIGNED) {
-               pIn->flags.linearWA = 1;
-            }
+      if (returnCode == ADDR_OK && pIn->format != ADDR_FMT_INVALID) {
+         elemBpp = mElemLib->GetBitsPerPixel(pIn->format, &elemMode, &expandX, &expandY, nullptr);
 
-            mElemLib->AdjustSurfaceInfo(elemMode, expandX, expandY, &bpp, &width, &height);
-
-            pIn->width = width;
-            pIn->height = height;
-            pIn->bpp = bpp;
-         } else if (pIn->bpp != 0) {
-            pIn->width = std::max<uint32_t>(1u, pIn->width);
-            pIn->height = std::max<uint32_t>(1u, pIn->height);
-         } else {
-            returnCode = ADDR_INVALIDPARAMS;
+         if (elemMode == ADDR_EXPANDED && expandX == 3 && pIn->tileMode == ADDR_TM_LINEAR_ALIGNED) {
+            pIn->flags.linearWA = 1;
          }
       }
 
       if (returnCode == ADDR_OK) {
-         returnCode = HwlComputeSurfaceInfo(pIn, pOut);
+         returnCode = ComputeSurfaceInfoLevel(pIn, pOut, elemMode, elemBpp, expandX, expandY);
       }
 
-      if (returnCode == ADDR_OK) {
-         pOut->bpp = pIn->bpp;
-         pOut->pixelPitch = pOut->pitch;
-         pOut->pixelHeight = pOut->height;
-
-         if (pIn->format != ADDR_FMT_INVALID && (!pIn->flags.linearWA || pIn->mipLevel == 0)) {
-            mElemLib->RestoreSurfaceInfo(elemMode, expandX, expandY, &bpp, &pOut->pixelPitch, &pOut->pixelHeight);
-         }
-
-         if (pIn->flags.qbStereo && pOut->pStereoInfo) {
-            ComputeQbStereoInfo(pOut);
-         }
+      if (returnCode == ADDR_OK && useCache) {
+         mSurfaceInfoCache->Insert(&cacheKey, pIn, pOut);
+      }
+   }
 
-         if (sliceFlags) {
-            if (sliceFlags == 1) {
-               pOut->sliceSize = BITS_TO_BYTES(static_cast<size_t>(pOut->height) * pOut->pitch * pOut->bpp * pIn->numSamples);
-            }
-         } else if (pIn->flags.volume) {
-            pOut->sliceSize = static_cast<uint32_t>(pOut->surfSize);
-         } else {
-            pOut->sliceSize = static_cast<uint32_t>(pOut->surfSize / pOut->depth);
+   if (returnCode == ADDR_OK && GetStatsCounters()) {
+      GetStatsCounters()->AddSurfaceTileMode(pOut->tileMode);
+   }
 
-            if (pIn->numSlices > 1) {
-               if (pIn->slice == (pIn->numSlices - 1)) {
-                  pOut->sliceSize += pOut->sliceSize * (pOut->depth - pIn->numSlices);
-               }
-            }
-         }
+   if (mTrace) {
+      AddrTraceSegment segments[] = {
+         { &traceIn, sizeof(traceIn) },
+         { pOut, sizeof(*pOut) },
+      };
 
-         pOut->pitchTileMax = (pOut->pitch / 8) - 1;
-         pOut->heightTileMax = (pOut->height / 8) - 1;
-         pOut->sliceTileMax = pOut->pitch * (pOut->height / 64) - 1;
-      }
+      mTrace->Record(ADDR_STATS_SURFACE_INFO, traceStart, returnCode, segments, sizeof(segments) / sizeof(segments[0]));
    }
 
    return returnCode;
@@ -593,59 +892,424 @@ AddrLib::ComputeSurfaceInfo(ADDR_COMPUTE_SURFACE_INFO_INPUT *pIn,
 
 /**
 ***************************************************************************************************
-*   AddrLib::ComputeSurfaceAddrFromCoordLinear
+*   AddrLib::ComputeSurfaceInfoLevel
 *
 *   @brief
-*       Compute address from coord for linear surface
+*       Computes the surface info of one mip level once the tile setting and the element
+*       mode of the format (elemMode, elemBpp, expandX, expandY) are known
 *
 *   @return
-*       Address in bytes
+*       ADDR_E_RETURNCODE
 ***************************************************************************************************
 */
-uint64_t
-AddrLib::ComputeSurfaceAddrFromCoordLinear(uint32_t x,
-                                           uint32_t y,
-                                           uint32_t slice,
-                                           uint32_t sample,
-                                           uint32_t bpp,
-                                           uint32_t pitch,
-                                           uint32_t height,
-                                           uint32_t numSlices,
-                                           uint32_t *pBitPosition) const
+ADDR_E_RETURNCODE
+AddrLib::ComputeSurfaceInfoLevel(ADDR_COMPUTE_SURFACE_INFO_INPUT *pIn,
+                                 ADDR_COMPUTE_SURFACE_INFO_OUTPUT *pOut,
+                                 AddrElemMode elemMode,
+                                 uint32_t elemBpp,
+                                 uint32_t expandX,
+                                 uint32_t expandY) const
 {
-   auto sliceSize = static_cast<uint64_t>(pitch) * height;
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+   auto width = pIn->width;
+   auto height = pIn->height;
+   auto bpp = pIn->bpp;
+   auto sliceFlags = GetSliceComputingFlags();
 
-   auto sliceOffset = sliceSize * (slice + sample * numSlices);
-   auto rowOffset = static_cast<uint64_t>(y) * pitch;
-   auto pixOffset = static_cast<uint64_t>(x);
+   pOut->pixelBits = pIn->bpp;
 
-   auto addr = (sliceOffset + rowOffset + pixOffset) * bpp;
+   if (pIn->format != ADDR_FMT_INVALID) {
+      mElemLib->AdjustSurfaceInfo(elemMode, expandX, expandY, &elemBpp, &width, &height);
 
-   *pBitPosition = static_cast<uint32_t>(addr % 8);
-   addr /= 8;
+      pIn->width = width;
+      pIn->height = height;
+      pIn->bpp = elemBpp;
+   } else if (pIn->bpp != 0) {
+      pIn->width = std::max<uint32_t>(1u, pIn->width);
+      pIn->height = std::max<uint32_t>(1u, pIn->height);
+   } else {
+      returnCode = ADDR_INVALIDPARAMS;
+   }
 
-   return addr;
+   if (returnCode == ADDR_OK) {
+      returnCode = HwlComputeSurfaceInfo(pIn, pOut);
+   }
+
+   if (returnCode == ADDR_OK) {
+      pOut->bpp = pIn->bpp;
+      pOut->pixelPitch = pOut->pitch;
+      pOut->pixelHeight = pOut->height;
+
+      if (pIn->format != ADDR_FMT_INVALID && (!pIn->flags.linearWA || pIn->mipLevel == 0)) {
+         mElemLib->RestoreSurfaceInfo(elemMode, expandX, expandY, &bpp, &pOut->pixelPitch, &pOut->pixelHeight);
+      }
+
+      if (pIn->flags.qbStereo && pOut->pStereoInfo) {
+         ComputeQbStereoInfo(pOut);
+      }
+
+      if (sliceFlags) {
+         if (sliceFlags == 1) {
+            pOut->sliceSize = BITS_TO_BYTES(static_cast<size_t>(pOut->height) * pOut->pitch * pOut->bpp * pIn->numSamples);
+         }
+      } else if (pIn->flags.volume) {
+         pOut->sliceSize = static_cast<uint32_t>(pOut->surfSize);
+      } else {
+         pOut->sliceSize = static_cast<uint32_t>(pOut->surfSize / pOut->depth);
+
+         if (pIn->numSlices > 1) {
+            if (pIn->slice == (pIn->numSlices - 1)) {
+               pOut->sliceSize += pOut->sliceSize * (pOut->depth - pIn->numSlices);
+            }
+         }
+      }
+
+      pOut->pitchTileMax = (pOut->pitch / 8) - 1;
+      pOut->heightTileMax = (pOut->height / 8) - 1;
+      pOut->sliceTileMax = pOut->pitch * (pOut->height / 64) - 1;
+   }
+
+   return returnCode;
 }
 
 
 /**
 ***************************************************************************************************
-*   AddrLib::ComputePixelIndexWithinMicroTile
+*   AddrLib::ComputeMipChainInfo
 *
 *   @brief
-*       Compute the pixel index inside a micro tile of surface
+*       Interface function stub of AddrComputeMipChainInfo. The tile setting and the element
+*       mode of the format are resolved once and shared by every level.
 *
 *   @return
-*       Pixel index
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrLib::ComputeMipChainInfo(const ADDR_COMPUTE_MIPCHAIN_INFO_INPUT *pIn,
+                             ADDR_COMPUTE_MIPCHAIN_INFO_OUTPUT *pOut) const
+{
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+   AddrStatsScope statsScope(GetStatsCounters(), ADDR_STATS_MIPCHAIN_INFO);
+   auto traceStart = mTrace ? mTrace->Now() : 0;
+   AddrElemMode elemMode = ADDR_UNCOMPRESSED;
+
+   if (GetFillSizeFieldsFlags()) {
+      if (pIn->size != sizeof(ADDR_COMPUTE_MIPCHAIN_INFO_INPUT) || pOut->size != sizeof(ADDR_COMPUTE_MIPCHAIN_INFO_OUTPUT)) {
+         returnCode = ADDR_PARAMSIZEMISMATCH;
+      }
+   }
+
+   if (pIn->bpp > 128 || pIn->numMipLevels == 0 || !pOut->pMipInfo) {
+      returnCode = ADDR_INVALIDPARAMS;
+   }
+
+   if (returnCode == ADDR_OK) {
+      ADDR_TILEINFO tileInfoNull;
+      ADDR_COMPUTE_SURFACE_INFO_INPUT baseIn;
+      auto elemBpp = uint32_t { 0 };
+      auto expandX = uint32_t { 1 };
+      auto expandY = uint32_t { 1 };
+
+      std::memset(&baseIn, 0, sizeof(ADDR_COMPUTE_SURFACE_INFO_INPUT));
+      baseIn.size = sizeof(ADDR_COMPUTE_SURFACE_INFO_INPUT);
+      baseIn.tileMode = pIn->tileMode;
+      baseIn.format = pIn->format;
+      baseIn.bpp = pIn->bpp;
+      baseIn.numSamples = pIn->numSamples;
+      baseIn.width = pIn->width;
+      baseIn.height = pIn->height;
+      baseIn.numSlices = pIn->numSlices;
+      baseIn.flags = pIn->flags;
+      baseIn.flags.inputBaseMap = 1;
+      baseIn.numFrags = pIn->numFrags;
+      baseIn.pTileInfo = pIn->pTileInfo;
+      baseIn.tileType = pIn->tileType;
+      baseIn.tileIndex = pIn->tileIndex;
+
+      if (UseTileIndex(baseIn.tileIndex) && !baseIn.pTileInfo) {
+         std::memset(&tileInfoNull, 0, sizeof(ADDR_TILEINFO));
+         baseIn.pTileInfo = &tileInfoNull;
+      }
+
+      returnCode = HwlSetupTileCfg(baseIn.tileIndex, baseIn.pTileInfo, &baseIn.tileMode, &baseIn.tileType);
+
+      if (returnCode == ADDR_OK && baseIn.format != ADDR_FMT_INVALID) {
+         elemBpp = mElemLib->GetBitsPerPixel(baseIn.format, &elemMode, &expandX, &expandY, nullptr);
+
+         if (elemMode == ADDR_EXPANDED && expandX == 3 && baseIn.tileMode == ADDR_TM_LINEAR_ALIGNED) {
+            baseIn.flags.linearWA = 1;
+         }
+      }
+
+      pOut->mipChainSize = 0;
+      pOut->baseAlign = 1;
+
+      for (auto level = 0u; returnCode == ADDR_OK && level < pIn->numMipLevels; ++level) {
+         ADDR_COMPUTE_SURFACE_INFO_INPUT levelIn = baseIn;
+         ADDR_COMPUTE_SURFACE_INFO_OUTPUT levelOut;
+         auto pInfo = &pOut->pMipInfo[level];
+
+         std::memset(&levelOut, 0, sizeof(ADDR_COMPUTE_SURFACE_INFO_OUTPUT));
+         levelOut.size = sizeof(ADDR_COMPUTE_SURFACE_INFO_OUTPUT);
+         levelOut.pTileInfo = baseIn.pTileInfo;
+         levelIn.mipLevel = level;
+
+         ComputeMipLevel(&levelIn);
+         returnCode = ComputeSurfaceInfoLevel(&levelIn, &levelOut, elemMode, elemBpp, expandX, expandY);
+
+         if (returnCode == ADDR_OK) {
+            pInfo->pitch = levelOut.pitch;
+            pInfo->height = levelOut.height;
+            pInfo->depth = levelOut.depth;
+            pInfo->tileMode = levelOut.tileMode;
+            pInfo->baseAlign = levelOut.baseAlign;
+            pInfo->pitchAlign = levelOut.pitchAlign;
+            pInfo->heightAlign = levelOut.heightAlign;
+            pInfo->depthAlign = levelOut.depthAlign;
+            pInfo->pixelPitch = levelOut.pixelPitch;
+            pInfo->pixelHeight = levelOut.pixelHeight;
+            pInfo->sliceSize = levelOut.sliceSize;
+            pInfo->surfSize = levelOut.surfSize;
+            pInfo->offset = PowTwoAlign<uint64_t>(pOut->mipChainSize, levelOut.baseAlign);
+
+            pOut->mipChainSize = pInfo->offset + pInfo->surfSize;
+            pOut->baseAlign = std::max(pOut->baseAlign, levelOut.baseAlign);
+         }
+      }
+   }
+
+   if (mTrace) {
+      AddrTraceSegment segments[] = {
+         { pIn, sizeof(*pIn) },
+         { pOut, sizeof(*pOut) },
+         AddrTraceArray(pOut->pMipInfo, returnCode == ADDR_OK ? pIn->numMipLevels : 0, sizeof(ADDR_MIP_LEVEL_INFO)),
+      };
+
+      mTrace->Record(ADDR_STATS_MIPCHAIN_INFO, traceStart, returnCode, segments, sizeof(segments) / sizeof(segments[0]));
+   }
+
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::GetSurfaceInfoCacheStats
+*
+*   @brief
+*       Interface function stub of AddrGetSurfaceInfoCacheStats.
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrLib::GetSurfaceInfoCacheStats(ADDR_GET_SURFACE_INFO_CACHE_STATS_OUTPUT *pOut) const
+{
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+
+   if (GetFillSizeFieldsFlags()) {
+      if (pOut->size != sizeof(ADDR_GET_SURFACE_INFO_CACHE_STATS_OUTPUT)) {
+         returnCode = ADDR_PARAMSIZEMISMATCH;
+      }
+   }
+
+   if (returnCode == ADDR_OK && !mSurfaceInfoCache) {
+      returnCode = ADDR_NOTSUPPORTED;
+   }
+
+   if (returnCode == ADDR_OK) {
+      mSurfaceInfoCache->GetStats(&pOut->hits, &pOut->misses);
+   }
+
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::GetStats
+*
+*   @brief
+*       Interface function stub of AddrGetStats.
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrLib::GetStats(ADDR_GET_STATS_OUTPUT *pOut) const
+{
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+   auto pStats = GetStatsCounters();
+
+   if (GetFillSizeFieldsFlags()) {
+      if (pOut->size != sizeof(ADDR_GET_STATS_OUTPUT)) {
+         returnCode = ADDR_PARAMSIZEMISMATCH;
+      }
+   }
+
+   if (returnCode == ADDR_OK && !pStats) {
+      returnCode = ADDR_NOTSUPPORTED;
+   }
+
+   if (returnCode == ADDR_OK) {
+      pStats->Read(pOut);
+   }
+
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::ResetStats
+*
+*   @brief
+*       Interface function stub of AddrResetStats.
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrLib::ResetStats()
+{
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+   auto pStats = GetStatsCounters();
+
+   if (pStats) {
+      pStats->Reset();
+   } else {
+      returnCode = ADDR_NOTSUPPORTED;
+   }
+
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::StartTrace
+*
+*   @brief
+*       Interface function stub of AddrStartTrace.
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrLib::StartTrace(const ADDR_START_TRACE_INPUT *pIn)
+{
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+
+   if (GetFillSizeFieldsFlags()) {
+      if (pIn->size != sizeof(ADDR_START_TRACE_INPUT)) {
+         returnCode = ADDR_PARAMSIZEMISMATCH;
+      }
+   }
+
+   if (returnCode == ADDR_OK && (!pIn->pfnWrite || mTrace)) {
+      returnCode = ADDR_INVALIDPARAMS;
+   }
+
+   if (returnCode == ADDR_OK) {
+      mTrace = AddrTrace::Create(&mClient, pIn, &mCreateInput);
+
+      if (!mTrace) {
+         returnCode = ADDR_ERROR;
+      }
+   }
+
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::StopTrace
+*
+*   @brief
+*       Interface function stub of AddrStopTrace.
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrLib::StopTrace()
+{
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+   auto pTrace = mTrace;
+
+   if (pTrace) {
+      mTrace = nullptr;
+      returnCode = pTrace->Stop();
+   } else {
+      returnCode = ADDR_INVALIDPARAMS;
+   }
+
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::ComputeSurfaceAddrFromCoordLinear
+*
+*   @brief
+*       Compute address from coord for linear surface
+*
+*   @return
+*       Address in bytes
+***************************************************************************************************
+*/
+uint64_t
+AddrLib::ComputeSurfaceAddrFromCoordLinear(uint32_t x,
+                                           uint32_t y,
+                                           uint32_t slice,
+                                           uint32_t sample,
+                                           uint32_t bpp,
+                                           uint32_t pitch,
+                                           uint32_t height,
+                                           uint32_t numSlices,
+                                           uint32_t *pBitPosition) const
+{
+   auto sliceSize = static_cast<uint64_t>(pitch) * height;
+
+   auto sliceOffset = sliceSize * (slice + sample * numSlices);
+   auto rowOffset = static_cast<uint64_t>(y) * pitch;
+   auto pixOffset = static_cast<uint64_t>(x);
+
+   auto addr = (sliceOffset + rowOffset + pixOffset) * bpp;
+
+   *pBitPosition = static_cast<uint32_t>(addr % 8);
+   addr /= 8;
+
+   return addr;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::ComputePixelIndexBits
+*
+*   @brief
+*       Compute the pixel index inside a micro tile of surface from the coordinate bits
+*
+*   @return
+*       Pixel index
 ***************************************************************************************************
 */
 uint32_t
-AddrLib::ComputePixelIndexWithinMicroTile(uint32_t x,
-                                          uint32_t y,
-                                          uint32_t z,
-                                          uint32_t bpp,
-                                          AddrTileMode tileMode,
-                                          AddrTileType tileType) const
+AddrLib::ComputePixelIndexBits(uint32_t x,
+                               uint32_t y,
+                               uint32_t z,
+                               uint32_t bpp,
+                               uint32_t thickness,
+                               AddrTileType tileType)
 {
    uint32_t pixelBit0 = 0;
    uint32_t pixelBit1 = 0;
@@ -668,8 +1332,6 @@ AddrLib::ComputePixelIndexWithinMicroTile(uint32_t x,
    uint32_t z1 = _BIT(z, 1);
    uint32_t z2 = _BIT(z, 2);
 
-   auto thickness = ComputeSurfaceThickness(tileMode);
-
    if (tileType == ADDR_THICK_TILING) {
       pixelBit0 = x0;
       pixelBit1 = y0;
@@ -744,45 +1406,2009 @@ AddrLib::ComputePixelIndexWithinMicroTile(uint32_t x,
       pixelBit8 = z2;
    }
 
-   pixelNumber = ((pixelBit0) |
-                  (pixelBit1 << 1) |
-                  (pixelBit2 << 2) |
-                  (pixelBit3 << 3) |
-                  (pixelBit4 << 4) |
-                  (pixelBit5 << 5) |
-                  (pixelBit6 << 6) |
-                  (pixelBit7 << 7) |
-                  (pixelBit8 << 8));
+   pixelNumber = ((pixelBit0) |
+                  (pixelBit1 << 1) |
+                  (pixelBit2 << 2) |
+                  (pixelBit3 << 3) |
+                  (pixelBit4 << 4) |
+                  (pixelBit5 << 5) |
+                  (pixelBit6 << 6) |
+                  (pixelBit7 << 7) |
+                  (pixelBit8 << 8));
+
+   return pixelNumber;
+}
+
+
+/**
+***************************************************************************************************
+*   GetPixelOrder
+*
+*   @brief
+*       Returns which micro tile pixel ordering a bpp and tile type combination uses
+*
+*   @return
+*       Index of the pixel order
+***************************************************************************************************
+*/
+static uint32_t
+GetPixelOrder(uint32_t bpp,
+              AddrTileType tileType)
+{
+   if (tileType == ADDR_THICK_TILING) {
+      return 6;
+   } else if (tileType == ADDR_NON_DISPLAYABLE) {
+      return 5;
+   }
+
+   switch (bpp) {
+   case 8:
+      return 0;
+   case 16:
+      return 1;
+   case 64:
+      return 3;
+   case 128:
+      return 4;
+   default:
+      return 2;
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   GetThicknessMode
+*
+*   @brief
+*       Returns the index of a micro tile thickness of 1, 4 or 8
+*
+*   @return
+*       Index of the thickness
+***************************************************************************************************
+*/
+static uint32_t
+GetThicknessMode(uint32_t thickness)
+{
+   switch (thickness) {
+   case ThickTileThickness:
+      return 1;
+   case XThickTileThickness:
+      return 2;
+   default:
+      return 0;
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::InitPixelIndexTables
+*
+*   @brief
+*       Builds the pixel index of every coordinate of a micro tile for each pixel order and
+*       thickness, so the per texel paths do not have to gather the coordinate bits again,
+*       and the coordinate of every pixel index for the address to coordinate paths.
+*
+*   @return
+*       N/A
+***************************************************************************************************
+*/
+void
+AddrLib::InitPixelIndexTables()
+{
+   static const uint32_t orderBpp[MicroTilePixelOrders] = { 8, 16, 32, 64, 128, 32, 32 };
+   static const AddrTileType orderTileType[MicroTilePixelOrders] = {
+      ADDR_DISPLAYABLE, ADDR_DISPLAYABLE, ADDR_DISPLAYABLE, ADDR_DISPLAYABLE, ADDR_DISPLAYABLE,
+      ADDR_NON_DISPLAYABLE, ADDR_THICK_TILING
+   };
+   static const uint32_t modeThickness[MicroTileThicknessModes] = { 1, ThickTileThickness, XThickTileThickness };
+
+   for (auto order = 0u; order < MicroTilePixelOrders; ++order) {
+      for (auto mode = 0u; mode < MicroTileThicknessModes; ++mode) {
+         auto pTable = mPixelIndexTable[order][mode];
+         auto pCoordTable = mPixelCoordTable[order][mode];
+
+         std::fill(pCoordTable, pCoordTable + MicroTileVolumePixels, PixelCoordInvalid);
+
+         for (auto z = 0u; z < XThickTileThickness; ++z) {
+            for (auto y = 0u; y < MicroTileHeight; ++y) {
+               for (auto x = 0u; x < MicroTileWidth; ++x) {
+                  auto pixelIndex = ComputePixelIndexBits(x, y, z,
+                                                          orderBpp[order],
+                                                          modeThickness[mode],
+                                                          orderTileType[order]);
+
+                  pTable[(z * MicroTileHeight + y) * MicroTileWidth + x] = static_cast<uint16_t>(pixelIndex);
+
+                  if (pCoordTable[pixelIndex] == PixelCoordInvalid) {
+                     pCoordTable[pixelIndex] = static_cast<uint16_t>(x | (y << 3) | (z << 6));
+                  }
+               }
+            }
+         }
+      }
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::GetPixelIndexTable
+*
+*   @brief
+*       Get the pixel indices of one slice of a micro tile, indexed by y * MicroTileWidth + x
+*
+*   @return
+*       Pointer to MicroTilePixels pixel indices
+***************************************************************************************************
+*/
+const uint16_t *
+AddrLib::GetPixelIndexTable(uint32_t z,
+                            uint32_t bpp,
+                            AddrTileMode tileMode,
+                            AddrTileType tileType) const
+{
+   auto order = GetPixelOrder(bpp, tileType);
+   auto mode = GetThicknessMode(ComputeSurfaceThickness(tileMode));
+   return mPixelIndexTable[order][mode] + (z % XThickTileThickness) * MicroTilePixels;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::GetPixelCoordTable
+*
+*   @brief
+*       Returns the table mapping a pixel index back to the micro tile coordinate packed as
+*       x | (y << 3) | (z << 6), PixelCoordInvalid for unused pixel indices
+*
+*   @return
+*       Pointer to MicroTileVolumePixels coordinates
+***************************************************************************************************
+*/
+const uint16_t *
+AddrLib::GetPixelCoordTable(uint32_t bpp,
+                            AddrTileMode tileMode,
+                            AddrTileType tileType) const
+{
+   auto order = GetPixelOrder(bpp, tileType);
+   auto mode = GetThicknessMode(ComputeSurfaceThickness(tileMode));
+   return mPixelCoordTable[order][mode];
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::ComputePixelIndexWithinMicroTile
+*
+*   @brief
+*       Compute the pixel index inside a micro tile of surface
+*
+*   @return
+*       Pixel index
+***************************************************************************************************
+*/
+uint32_t
+AddrLib::ComputePixelIndexWithinMicroTile(uint32_t x,
+                                          uint32_t y,
+                                          uint32_t z,
+                                          uint32_t bpp,
+                                          AddrTileMode tileMode,
+                                          AddrTileType tileType) const
+{
+   auto pTable = GetPixelIndexTable(z, bpp, tileMode, tileType);
+   return pTable[(y % MicroTileHeight) * MicroTileWidth + (x % MicroTileWidth)];
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::GetMicroTileKernel
+*
+*   @brief
+*       Get the kernel which copies a whole micro tile of the given bpp and tile type
+*
+*   @return
+*       The kernel, or nullptr when the micro tile has to be copied an element at a time
+***************************************************************************************************
+*/
+AddrMicroTileKernel
+AddrLib::GetMicroTileKernel(uint32_t bpp,
+                            AddrTileType tileType,
+                            bool tiledToLinear) const
+{
+   if (bpp < 8 || bpp > 128 || !IsPow2(bpp)) {
+      return nullptr;
+   }
+
+   auto order = GetPixelOrder(bpp, tileType);
+   auto size = Log2(bpp / 8);
+
+   if (tiledToLinear) {
+      return mMicroTileKernels.untile[order][size];
+   } else {
+      return mMicroTileKernels.tile[order][size];
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::SetupMicroTileKernels
+*
+*   @brief
+*       Selects the micro tile kernels for the given AddrCpuFeature mask
+*
+*   @return
+*       N/A
+***************************************************************************************************
+*/
+void
+AddrLib::SetupMicroTileKernels(uint32_t cpuFeatures)
+{
+   mCpuFeatures = cpuFeatures;
+   AddrSetupMicroTileKernels(mCpuFeatures, &mMicroTileKernels);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::ComputePixelIndexTable
+*
+*   @brief
+*       Interface function stub of AddrComputePixelIndexTable.
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrLib::ComputePixelIndexTable(const ADDR_COMPUTE_PIXEL_INDEX_TABLE_INPUT *pIn,
+                                ADDR_COMPUTE_PIXEL_INDEX_TABLE_OUTPUT *pOut) const
+{
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+   AddrStatsScope statsScope(GetStatsCounters(), ADDR_STATS_PIXEL_INDEX_TABLE);
+   auto traceStart = mTrace ? mTrace->Now() : 0;
+
+   if (GetFillSizeFieldsFlags()) {
+      if (pIn->size != sizeof(ADDR_COMPUTE_PIXEL_INDEX_TABLE_INPUT) || pOut->size != sizeof(ADDR_COMPUTE_PIXEL_INDEX_TABLE_OUTPUT)) {
+         returnCode = ADDR_PARAMSIZEMISMATCH;
+      }
+   }
+
+   if (returnCode == ADDR_OK) {
+      if (pIn->tileMode >= ADDR_TM_COUNT || pIn->tileType > ADDR_THICK_TILING) {
+         returnCode = ADDR_INVALIDPARAMS;
+      }
+   }
+
+   if (returnCode == ADDR_OK) {
+      pOut->pPixelIndex = GetPixelIndexTable(pIn->slice, pIn->bpp, pIn->tileMode, pIn->tileType);
+   }
+
+   if (mTrace) {
+      AddrTraceSegment segments[] = {
+         { pIn, sizeof(*pIn) },
+         { pOut, sizeof(*pOut) },
+      };
+
+      mTrace->Record(ADDR_STATS_PIXEL_INDEX_TABLE, traceStart, returnCode, segments, sizeof(segments) / sizeof(segments[0]));
+   }
+
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::ComputeSurfaceInfo
+*
+*   @brief
+*       Interface function stub of AddrComputeSurfaceInfo.
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrLib::ComputeSurfaceAddrFromCoord(const ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_INPUT *pIn,
+                                     ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_OUTPUT *pOut) const
+{
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+   AddrStatsScope statsScope(GetStatsCounters(), ADDR_STATS_SURFACE_ADDRFROMCOORD);
+   auto traceStart = mTrace ? mTrace->Now() : 0;
+   auto pTraceIn = pIn;
+
+   if (GetFillSizeFieldsFlags()) {
+      if (pIn->size != sizeof(ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_INPUT) || pOut->size != sizeof(ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_OUTPUT)) {
+         returnCode = ADDR_PARAMSIZEMISMATCH;
+      }
+   }
+
+   if (returnCode == ADDR_OK) {
+      ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_INPUT input;
+      ADDR_TILEINFO tileInfoNull;
+
+      if (UseTileIndex(pIn->tileIndex)) {
+         std::memset(&tileInfoNull, 0, sizeof(ADDR_TILEINFO));
+         input = *pIn;
+
+         if (!pIn->pTileInfo) {
+            input.pTileInfo = &tileInfoNull;
+         }
+
+         returnCode = HwlSetupTileCfg(input.tileIndex, input.pTileInfo, &input.tileMode, &input.tileType);
+         pIn = &input;
+      }
+
+      if (returnCode == ADDR_OK) {
+         returnCode = HwlComputeSurfaceAddrFromCoord(pIn, pOut);
+      }
+
+      if (returnCode == ADDR_OK && GetStatsCounters()) {
+         GetStatsCounters()->AddAddrTileMode(pIn->tileMode, 1);
+      }
+   }
+
+   if (mTrace) {
+      AddrTraceSegment segments[] = {
+         { pTraceIn, sizeof(*pTraceIn) },
+         { pOut, sizeof(*pOut) },
+      };
+
+      mTrace->Record(ADDR_STATS_SURFACE_ADDRFROMCOORD, traceStart, returnCode, segments, sizeof(segments) / sizeof(segments[0]));
+   }
+
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::ComputeSurfaceAddrFromCoordBatch
+*
+*   @brief
+*       Interface function stub of AddrComputeSurfaceAddrFromCoordBatch.
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrLib::ComputeSurfaceAddrFromCoordBatch(const ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_INPUT *pIn,
+                                          ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_OUTPUT *pOut) const
+{
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+   AddrStatsScope statsScope(GetStatsCounters(), ADDR_STATS_SURFACE_ADDRFROMCOORD_BATCH);
+   auto traceStart = mTrace ? mTrace->Now() : 0;
+   auto pTraceIn = pIn;
+
+   if (GetFillSizeFieldsFlags()) {
+      if (pIn->size != sizeof(ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_INPUT) || pOut->size != sizeof(ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_OUTPUT)) {
+         returnCode = ADDR_PARAMSIZEMISMATCH;
+      }
+   }
+
+   if (returnCode == ADDR_OK && pIn->numCoords && (!pIn->pX || !pIn->pY || !pOut->pAddr)) {
+      returnCode = ADDR_INVALIDPARAMS;
+   }
+
+   if (returnCode == ADDR_OK) {
+      ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_INPUT input;
+      ADDR_TILEINFO tileInfoNull;
+
+      if (UseTileIndex(pIn->tileIndex)) {
+         std::memset(&tileInfoNull, 0, sizeof(ADDR_TILEINFO));
+         input = *pIn;
+
+         if (!pIn->pTileInfo) {
+            input.pTileInfo = &tileInfoNull;
+         }
+
+         returnCode = HwlSetupTileCfg(input.tileIndex, input.pTileInfo, &input.tileMode, &input.tileType);
+         pIn = &input;
+      }
+
+      if (returnCode == ADDR_OK) {
+         returnCode = HwlComputeSurfaceAddrFromCoordBatch(pIn, pOut);
+      }
+
+      if (returnCode == ADDR_OK && GetStatsCounters()) {
+         GetStatsCounters()->AddAddrTileMode(pIn->tileMode, pIn->numCoords);
+      }
+   }
+
+   if (mTrace) {
+      auto numOutCoords = returnCode == ADDR_OK ? pTraceIn->numCoords : 0;
+      AddrTraceSegment segments[] = {
+         { pTraceIn, sizeof(*pTraceIn) },
+         { pOut, sizeof(*pOut) },
+         AddrTraceArray(pTraceIn->pX, pTraceIn->numCoords, sizeof(uint32_t)),
+         AddrTraceArray(pTraceIn->pY, pTraceIn->numCoords, sizeof(uint32_t)),
+         AddrTraceArray(pTraceIn->pSlice, pTraceIn->numCoords, sizeof(uint32_t)),
+         AddrTraceArray(pTraceIn->pSample, pTraceIn->numCoords, sizeof(uint32_t)),
+         AddrTraceArray(pOut->pAddr, numOutCoords, sizeof(uint64_t)),
+         AddrTraceArray(pOut->pBitPosition, numOutCoords, sizeof(uint32_t)),
+      };
+
+      mTrace->Record(ADDR_STATS_SURFACE_ADDRFROMCOORD_BATCH, traceStart, returnCode, segments, sizeof(segments) / sizeof(segments[0]));
+   }
+
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::CreateSurfacePlan
+*
+*   @brief
+*       Interface function stub of AddrCreateSurfacePlan.
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrLib::CreateSurfacePlan(const ADDR_CREATE_SURFACE_PLAN_INPUT *pIn,
+                           ADDR_CREATE_SURFACE_PLAN_OUTPUT *pOut) const
+{
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+   AddrStatsScope statsScope(GetStatsCounters(), ADDR_STATS_CREATE_SURFACE_PLAN);
+   auto traceStart = mTrace ? mTrace->Now() : 0;
+   auto pTraceIn = pIn;
+
+   if (GetFillSizeFieldsFlags()) {
+      if (pIn->size != sizeof(ADDR_CREATE_SURFACE_PLAN_INPUT) || pOut->size != sizeof(ADDR_CREATE_SURFACE_PLAN_OUTPUT)) {
+         returnCode = ADDR_PARAMSIZEMISMATCH;
+      }
+   }
+
+   if (returnCode == ADDR_OK) {
+      ADDR_CREATE_SURFACE_PLAN_INPUT input;
+      ADDR_TILEINFO tileInfoNull;
+      AddrSurfacePlan *pPlan = nullptr;
+
+      if (UseTileIndex(pIn->tileIndex)) {
+         std::memset(&tileInfoNull, 0, sizeof(ADDR_TILEINFO));
+         input = *pIn;
+
+         if (!pIn->pTileInfo) {
+            input.pTileInfo = &tileInfoNull;
+         }
+
+         returnCode = HwlSetupTileCfg(input.tileIndex, input.pTileInfo, &input.tileMode, &input.tileType);
+         pIn = &input;
+      }
+
+      if (returnCode == ADDR_OK) {
+         returnCode = HwlCreateSurfacePlan(pIn, &pPlan);
+      }
+
+      pOut->hPlan = pPlan;
+   }
+
+   if (mTrace) {
+      AddrTraceSegment segments[] = {
+         { pTraceIn, sizeof(*pTraceIn) },
+         { pOut, sizeof(*pOut) },
+      };
+
+      mTrace->Record(ADDR_STATS_CREATE_SURFACE_PLAN, traceStart, returnCode, segments, sizeof(segments) / sizeof(segments[0]));
+   }
+
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::DestroySurfacePlan
+*
+*   @brief
+*       Interface function stub of AddrDestroySurfacePlan.
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrLib::DestroySurfacePlan(ADDR_SURFACE_PLAN hPlan) const
+{
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+
+   if (hPlan) {
+      AddrSurfacePlan::GetSurfacePlan(hPlan)->Destroy();
+   } else {
+      returnCode = ADDR_INVALIDPARAMS;
+   }
+
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::ComputeSurfaceCoordFromAddr
+*
+*   @brief
+*       Interface function stub of AddrComputeSurfaceCoordFromAddr.
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrLib::ComputeSurfaceCoordFromAddr(const ADDR_COMPUTE_SURFACE_COORDFROMADDR_INPUT *pIn,
+                                     ADDR_COMPUTE_SURFACE_COORDFROMADDR_OUTPUT *pOut) const
+{
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+   AddrStatsScope statsScope(GetStatsCounters(), ADDR_STATS_SURFACE_COORDFROMADDR);
+   auto traceStart = mTrace ? mTrace->Now() : 0;
+   auto pTraceIn = pIn;
+
+   if (GetFillSizeFieldsFlags()) {
+      if (pIn->size != sizeof(ADDR_COMPUTE_SURFACE_COORDFROMADDR_INPUT) || pOut->size != sizeof(ADDR_COMPUTE_SURFACE_COORDFROMADDR_OUTPUT)) {
+         returnCode = ADDR_PARAMSIZEMISMATCH;
+      }
+   }
+
+   if (returnCode == ADDR_OK) {
+      ADDR_COMPUTE_SURFACE_COORDFROMADDR_INPUT input;
+      ADDR_TILEINFO tileInfoNull;
+
+      if (UseTileIndex(pIn->tileIndex)) {
+         std::memset(&tileInfoNull, 0, sizeof(ADDR_TILEINFO));
+         input = *pIn;
+
+         if (!pIn->pTileInfo) {
+            input.pTileInfo = &tileInfoNull;
+         }
+
+         returnCode = HwlSetupTileCfg(input.tileIndex, input.pTileInfo, &input.tileMode, &input.tileType);
+         pIn = &input;
+      }
+
+      if (returnCode == ADDR_OK) {
+         returnCode = HwlComputeSurfaceCoordFromAddr(pIn, pOut);
+      }
+   }
+
+   if (mTrace) {
+      AddrTraceSegment segments[] = {
+         { pTraceIn, sizeof(*pTraceIn) },
+         { pOut, sizeof(*pOut) },
+      };
+
+      mTrace->Record(ADDR_STATS_SURFACE_COORDFROMADDR, traceStart, returnCode, segments, sizeof(segments) / sizeof(segments[0]));
+   }
+
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::ComputeSurfaceCoordFromAddrRange
+*
+*   @brief
+*       Interface function stub of AddrComputeSurfaceCoordFromAddrRange.
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrLib::ComputeSurfaceCoordFromAddrRange(const ADDR_COMPUTE_SURFACE_COORDFROMADDR_RANGE_INPUT *pIn,
+                                          ADDR_COMPUTE_SURFACE_COORDFROMADDR_RANGE_OUTPUT *pOut) const
+{
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+   AddrStatsScope statsScope(GetStatsCounters(), ADDR_STATS_SURFACE_COORDFROMADDR_RANGE);
+   auto traceStart = mTrace ? mTrace->Now() : 0;
+   auto pTraceIn = pIn;
+
+   if (GetFillSizeFieldsFlags()) {
+      if (pIn->size != sizeof(ADDR_COMPUTE_SURFACE_COORDFROMADDR_RANGE_INPUT) || pOut->size != sizeof(ADDR_COMPUTE_SURFACE_COORDFROMADDR_RANGE_OUTPUT)) {
+         returnCode = ADDR_PARAMSIZEMISMATCH;
+      }
+   }
+
+   if (returnCode == ADDR_OK && pOut->maxCoords && (!pOut->pX || !pOut->pY || !pOut->pSlice || !pOut->pSample)) {
+      returnCode = ADDR_INVALIDPARAMS;
+   }
+
+   if (returnCode == ADDR_OK) {
+      ADDR_COMPUTE_SURFACE_COORDFROMADDR_RANGE_INPUT input;
+      ADDR_TILEINFO tileInfoNull;
+
+      if (UseTileIndex(pIn->tileIndex)) {
+         std::memset(&tileInfoNull, 0, sizeof(ADDR_TILEINFO));
+         input = *pIn;
+
+         if (!pIn->pTileInfo) {
+            input.pTileInfo = &tileInfoNull;
+         }
+
+         returnCode = HwlSetupTileCfg(input.tileIndex, input.pTileInfo, &input.tileMode, &input.tileType);
+         pIn = &input;
+      }
+
+      if (returnCode == ADDR_OK) {
+         returnCode = HwlComputeSurfaceCoordFromAddrRange(pIn, pOut);
+      }
+   }
+
+   if (mTrace) {
+      auto numOutCoords = returnCode == ADDR_OK ? pOut->numCoords : 0;
+      AddrTraceSegment segments[] = {
+         { pTraceIn, sizeof(*pTraceIn) },
+         { pOut, sizeof(*pOut) },
+         AddrTraceArray(pOut->pX, numOutCoords, sizeof(uint32_t)),
+         AddrTraceArray(pOut->pY, numOutCoords, sizeof(uint32_t)),
+         AddrTraceArray(pOut->pSlice, numOutCoords, sizeof(uint32_t)),
+         AddrTraceArray(pOut->pSample, numOutCoords, sizeof(uint32_t)),
+      };
+
+      mTrace->Record(ADDR_STATS_SURFACE_COORDFROMADDR_RANGE, traceStart, returnCode, segments, sizeof(segments) / sizeof(segments[0]));
+   }
+
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::ComputeSurfaceDirtyRegions
+*
+*   @brief
+*       Interface function stub of AddrComputeSurfaceDirtyRegions.
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrLib::ComputeSurfaceDirtyRegions(const ADDR_COMPUTE_SURFACE_DIRTY_REGIONS_INPUT *pIn,
+                                    ADDR_COMPUTE_SURFACE_DIRTY_REGIONS_OUTPUT *pOut) const
+{
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+   AddrStatsScope statsScope(GetStatsCounters(), ADDR_STATS_SURFACE_DIRTY_REGIONS);
+   auto traceStart = mTrace ? mTrace->Now() : 0;
+   auto pTraceIn = pIn;
+
+   if (GetFillSizeFieldsFlags()) {
+      if (pIn->size != sizeof(ADDR_COMPUTE_SURFACE_DIRTY_REGIONS_INPUT) || pOut->size != sizeof(ADDR_COMPUTE_SURFACE_DIRTY_REGIONS_OUTPUT)) {
+         returnCode = ADDR_PARAMSIZEMISMATCH;
+      }
+   }
+
+   if (returnCode == ADDR_OK && ((pOut->maxRegions && !pOut->pRegions) || (pIn->numMipLevels && !pIn->pMipInfo))) {
+      returnCode = ADDR_INVALIDPARAMS;
+   }
+
+   if (returnCode == ADDR_OK) {
+      ADDR_COMPUTE_SURFACE_DIRTY_REGIONS_INPUT input;
+      ADDR_TILEINFO tileInfoNull;
+
+      if (UseTileIndex(pIn->tileIndex)) {
+         std::memset(&tileInfoNull, 0, sizeof(ADDR_TILEINFO));
+         input = *pIn;
+
+         if (!pIn->pTileInfo) {
+            input.pTileInfo = &tileInfoNull;
+         }
+
+         returnCode = HwlSetupTileCfg(input.tileIndex, input.pTileInfo, &input.tileMode, &input.tileType);
+         pIn = &input;
+      }
+
+      if (returnCode == ADDR_OK) {
+         returnCode = HwlComputeSurfaceDirtyRegions(pIn, pOut);
+      }
+   }
+
+   if (mTrace) {
+      auto numOutRegions = returnCode == ADDR_OK ? pOut->numRegions : 0;
+      AddrTraceSegment segments[] = {
+         { pTraceIn, sizeof(*pTraceIn) },
+         { pOut, sizeof(*pOut) },
+         AddrTraceArray(pTraceIn->pMipInfo, pTraceIn->numMipLevels, sizeof(ADDR_MIP_LEVEL_INFO)),
+         AddrTraceArray(pOut->pRegions, numOutRegions, sizeof(ADDR_COPY_REGION)),
+         AddrTraceArray(pOut->pMipLevels, numOutRegions, sizeof(uint32_t)),
+      };
+
+      mTrace->Record(ADDR_STATS_SURFACE_DIRTY_REGIONS, traceStart, returnCode, segments, sizeof(segments) / sizeof(segments[0]));
+   }
+
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::ExtractBankPipeSwizzle
+*
+*   @brief
+*       Interface function stub of AddrExtractBankPipeSwizzle.
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrLib::ExtractBankPipeSwizzle(const ADDR_EXTRACT_BANKPIPE_SWIZZLE_INPUT *pIn,
+                                ADDR_EXTRACT_BANKPIPE_SWIZZLE_OUTPUT *pOut) const
+{
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+   AddrStatsScope statsScope(GetStatsCounters(), ADDR_STATS_EXTRACT_BANKPIPE_SWIZZLE);
+   auto traceStart = mTrace ? mTrace->Now() : 0;
+   auto pTraceIn = pIn;
+
+   if (GetFillSizeFieldsFlags()) {
+      if (pIn->size != sizeof(ADDR_EXTRACT_BANKPIPE_SWIZZLE_INPUT) || pOut->size != sizeof(ADDR_EXTRACT_BANKPIPE_SWIZZLE_OUTPUT)) {
+         returnCode = ADDR_PARAMSIZEMISMATCH;
+      }
+   }
+
+   if (returnCode == ADDR_OK) {
+      ADDR_EXTRACT_BANKPIPE_SWIZZLE_INPUT input;
+      ADDR_TILEINFO tileInfoNull;
+
+      if (UseTileIndex(pIn->tileIndex)) {
+         std::memset(&tileInfoNull, 0, sizeof(ADDR_TILEINFO));
+         input = *pIn;
+
+         if (!pIn->pTileInfo) {
+            input.pTileInfo = &tileInfoNull;
+         }
+
+         returnCode = HwlSetupTileCfg(input.tileIndex, input.pTileInfo, nullptr, nullptr);
+         pIn = &input;
+      }
+
+      if (returnCode == ADDR_OK) {
+         returnCode = HwlExtractBankPipeSwizzle(pIn, pOut);
+      }
+   }
+
+   if (mTrace) {
+      AddrTraceSegment segments[] = {
+         { pTraceIn, sizeof(*pTraceIn) },
+         { pOut, sizeof(*pOut) },
+      };
+
+      mTrace->Record(ADDR_STATS_EXTRACT_BANKPIPE_SWIZZLE, traceStart, returnCode, segments, sizeof(segments) / sizeof(segments[0]));
+   }
+
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::HwlComputeTileDataWidthAndHeightLinear
+*
+*   @brief
+*       Compute the squared cache shape for per-tile data (CMASK and HTILE) for linear layout
+*
+*   @return
+*       N/A
+*
+*   @note
+*       MacroWidth and macroHeight are measured in pixels
+***************************************************************************************************
+*/
+void
+AddrLib::HwlComputeTileDataWidthAndHeightLinear(uint32_t *pMacroWidth,
+                                                uint32_t *pMacroHeight,
+                                                uint32_t bpp,
+                                                ADDR_TILEINFO *pTileInfo) const
+{
+   *pMacroWidth = (8 * 512) / bpp;
+   *pMacroHeight = 8 * mPipes;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::ComputeTileDataWidthAndHeight
+*
+*   @brief
+*       Compute the squared cache shape for per-tile data (CMASK and HTILE)
+*
+*   @return
+*       N/A
+*
+*   @note
+*       MacroWidth and macroHeight are measured in pixels
+***************************************************************************************************
+*/
+void
+AddrLib::ComputeTileDataWidthAndHeight(uint32_t bpp,
+                                       uint32_t cacheBits,
+                                       ADDR_TILEINFO *pTileInfo,
+                                       uint32_t *pMacroWidth,
+                                       uint32_t *pMacroHeight) const
+{
+   auto height = 1;
+   auto width = cacheBits / bpp;
+   auto pipes = GetNumPipes(pTileInfo);
+
+   while ((width > height * 2 * pipes) && !(width & 1)) {
+      width /= 2;
+      height *= 2;
+   }
+
+   *pMacroWidth = 8 * width;
+   *pMacroHeight = 8 * height * pipes;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::ComputeHtileInfo
+*
+*   @brief
+*       Compute htile pitch,width, bytes per 2D slice
+*
+*   @return
+*       Htile bpp i.e. How many bits for an 8x8 tile
+*       Also returns by output parameters:
+*       *Htile pitch, height, total size in bytes, macro-tile dimensions and slice size*
+***************************************************************************************************
+*/
+uint32_t
+AddrLib::ComputeHtileInfo(uint32_t pitchIn,
+                          uint32_t heightIn,
+                          uint32_t numSlices,
+                          bool isLinear,
+                          bool isWidth8,
+                          bool isHeight8,
+                          ADDR_TILEINFO *pTileInfo,
+                          uint32_t *pPitchOut,
+                          uint32_t *pHeightOut,
+                          uint64_t *pHtileBytes,
+                          uint32_t *pMacroWidth,
+                          uint32_t *pMacroHeight,
+                          uint64_t *pSliceBytes,
+                          uint32_t *pBaseAlign) const
+{
+   auto pipes = GetNumPipes(pTileInfo);
+   auto bpp = HwlComputeHtileBpp(isWidth8, isHeight8);
+   auto macroWidth = uint32_t { 0 };
+   auto macroHeight = uint32_t { 0 };
+
+   if (isLinear) {
+      HwlComputeTileDataWidthAndHeightLinear(&macroWidth, &macroHeight, bpp, pTileInfo);
+   } else {
+      ComputeTileDataWidthAndHeight(bpp, HtileCacheBits, pTileInfo, &macroWidth, &macroHeight);
+   }
+
+   *pPitchOut = PowTwoAlign(pitchIn, macroWidth);
+   *pHeightOut = PowTwoAlign(heightIn, macroHeight);
+
+   auto baseAlign = HwlComputeHtileBaseAlign(isLinear, pipes);
+   auto surfBytes = HwlComputeHtileBytes(*pPitchOut,
+                                         *pHeightOut,
+                                         bpp,
+                                         isLinear,
+                                         numSlices,
+                                         baseAlign);
+
+
+   auto sliceBytes = BITS_TO_BYTES(static_cast<uint64_t>(*pHeightOut) * (*pPitchOut) * bpp / 64);
+
+   if (pHtileBytes) {
+      *pHtileBytes = surfBytes;
+   }
+
+   if (pMacroWidth) {
+      *pMacroWidth = macroWidth;
+   }
+
+   if (pMacroHeight) {
+      *pMacroHeight = macroHeight;
+   }
+
+   if (pSliceBytes) {
+      *pSliceBytes = sliceBytes;
+   }
+
+   if (pBaseAlign) {
+      *pBaseAlign = baseAlign;
+   }
+
+   return bpp;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::ComputeHtileInfo
+*
+*   @brief
+*       Interface function stub of AddrComputeHtilenfo
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrLib::ComputeHtileInfo(const ADDR_COMPUTE_HTILE_INFO_INPUT *pIn,
+                          ADDR_COMPUTE_HTILE_INFO_OUTPUT *pOut) const
+{
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+   AddrStatsScope statsScope(GetStatsCounters(), ADDR_STATS_HTILE_INFO);
+   auto traceStart = mTrace ? mTrace->Now() : 0;
+   auto pTraceIn = pIn;
+   auto isWidth8 = (pIn->blockWidth == 8);
+   auto isHeight8 = (pIn->blockHeight == 8);
+
+   if (GetFillSizeFieldsFlags()) {
+      if (pIn->size != sizeof(ADDR_COMPUTE_HTILE_INFO_INPUT) || pOut->size != sizeof(ADDR_COMPUTE_HTILE_INFO_OUTPUT)) {
+         returnCode = ADDR_PARAMSIZEMISMATCH;
+      }
+   }
+
+   if (returnCode == ADDR_OK) {
+      ADDR_COMPUTE_HTILE_INFO_INPUT input;
+      ADDR_TILEINFO tileInfoNull;
+
+      if (UseTileIndex(pIn->tileIndex)) {
+         std::memset(&tileInfoNull, 0, sizeof(ADDR_TILEINFO));
+         input = *pIn;
+
+         if (!pIn->pTileInfo) {
+            input.pTileInfo = &tileInfoNull;
+         }
+
+         returnCode = HwlSetupTileCfg(input.tileIndex, input.pTileInfo, nullptr, nullptr);
+         pIn = &input;
+      }
+
+      if (returnCode == ADDR_OK) {
+         pOut->bpp = ComputeHtileInfo(pIn->pitch,
+                                      pIn->height,
+                                      pIn->numSlices,
+                                      pIn->isLinear,
+                                      isWidth8,
+                                      isHeight8,
+                                      pIn->pTileInfo,
+                                      &pOut->pitch,
+                                      &pOut->height,
+                                      &pOut->htileBytes,
+                                      &pOut->macroWidth,
+                                      &pOut->macroHeight,
+                                      nullptr,
+                                      &pOut->baseAlign);
+      }
+   }
+
+   if (mTrace) {
+      AddrTraceSegment segments[] = {
+         { pTraceIn, sizeof(*pTraceIn) },
+         { pOut, sizeof(*pOut) },
+      };
+
+      mTrace->Record(ADDR_STATS_HTILE_INFO, traceStart, returnCode, segments, sizeof(segments) / sizeof(segments[0]));
+   }
+
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::ComputeHtileAddrFromCoord
+*
+*   @brief
+*       Interface function stub of AddrComputeHtileAddrFromCoord
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrLib::ComputeHtileAddrFromCoord(const ADDR_COMPUTE_HTILE_ADDRFROMCOORD_INPUT *pIn,
+                                   ADDR_COMPUTE_HTILE_ADDRFROMCOORD_OUTPUT *pOut) const
+{
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+   AddrStatsScope statsScope(GetStatsCounters(), ADDR_STATS_HTILE_ADDRFROMCOORD);
+   auto traceStart = mTrace ? mTrace->Now() : 0;
+   auto pTraceIn = pIn;
+
+   if (GetFillSizeFieldsFlags()) {
+      if (pIn->size != sizeof(ADDR_COMPUTE_HTILE_ADDRFROMCOORD_INPUT) || pOut->size != sizeof(ADDR_COMPUTE_HTILE_ADDRFROMCOORD_OUTPUT)) {
+         returnCode = ADDR_PARAMSIZEMISMATCH;
+      }
+   }
+
+   if (returnCode == ADDR_OK) {
+      ADDR_COMPUTE_HTILE_ADDRFROMCOORD_INPUT input;
+      ADDR_TILEINFO tileInfoNull;
+      AddrTileDataLayout layout;
+
+      if (UseTileIndex(pIn->tileIndex)) {
+         std::memset(&tileInfoNull, 0, sizeof(ADDR_TILEINFO));
+         input = *pIn;
+
+         if (!pIn->pTileInfo) {
+            input.pTileInfo = &tileInfoNull;
+         }
+
+         returnCode = HwlSetupTileCfg(input.tileIndex, input.pTileInfo, nullptr, nullptr);
+         pIn = &input;
+      }
+
+      if (returnCode == ADDR_OK) {
+         returnCode = ComputeHtileLayout(pIn->pitch,
+                                         pIn->height,
+                                         pIn->numSlices,
+                                         pIn->isLinear,
+                                         pIn->blockWidth,
+                                         pIn->blockHeight,
+                                         pIn->pTileInfo,
+                                         &layout);
+      }
+
+      if (returnCode == ADDR_OK) {
+         if (pIn->x >= layout.pitch || pIn->y >= layout.height || pIn->slice >= layout.numSlices) {
+            returnCode = ADDR_INVALIDPARAMS;
+         }
+      }
+
+      if (returnCode == ADDR_OK) {
+         auto isWidth8 = (pIn->blockWidth == ADDR_HTILE_BLOCKSIZE_8);
+         auto isHeight8 = (pIn->blockHeight == ADDR_HTILE_BLOCKSIZE_8);
+
+         // Tiles of 4x4 blocks have a word per block, in row-major order
+         auto blockX = isWidth8 ? 0 : (pIn->x % MicroTileWidth) / 4;
+         auto blockY = isHeight8 ? 0 : (pIn->y % MicroTileHeight) / 4;
+         auto blocksPerRow = isWidth8 ? 1 : 2;
+
+         pOut->addr = ComputeTileDataAddrFromCoord(&layout, pIn->x, pIn->y, pIn->slice, &pOut->bitPosition)
+            + (blockY * blocksPerRow + blockX) * sizeof(uint32_t);
+      }
+   }
+
+   if (mTrace) {
+      AddrTraceSegment segments[] = {
+         { pTraceIn, sizeof(*pTraceIn) },
+         { pOut, sizeof(*pOut) },
+      };
+
+      mTrace->Record(ADDR_STATS_HTILE_ADDRFROMCOORD, traceStart, returnCode, segments, sizeof(segments) / sizeof(segments[0]));
+   }
+
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::CopyHtileToLinear
+*
+*   @brief
+*       Interface function stub of AddrCopyHtileToLinear.
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrLib::CopyHtileToLinear(const ADDR_COPY_HTILE_INPUT *pIn) const
+{
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+   AddrStatsScope statsScope(GetStatsCounters(), ADDR_STATS_COPY_HTILE_TO_LINEAR);
+   auto traceStart = mTrace ? mTrace->Now() : 0;
+   auto pTraceIn = pIn;
+
+   if (GetFillSizeFieldsFlags()) {
+      if (pIn->size != sizeof(ADDR_COPY_HTILE_INPUT)) {
+         returnCode = ADDR_PARAMSIZEMISMATCH;
+      }
+   }
+
+   if (returnCode == ADDR_OK) {
+      ADDR_COPY_HTILE_INPUT input;
+      ADDR_TILEINFO tileInfoNull;
+
+      if (UseTileIndex(pIn->tileIndex)) {
+         std::memset(&tileInfoNull, 0, sizeof(ADDR_TILEINFO));
+         input = *pIn;
+
+         if (!pIn->pTileInfo) {
+            input.pTileInfo = &tileInfoNull;
+         }
+
+         returnCode = HwlSetupTileCfg(input.tileIndex, input.pTileInfo, nullptr, nullptr);
+         pIn = &input;
+      }
+
+      if (returnCode == ADDR_OK) {
+         returnCode = CopyHtile(pIn, true);
+      }
+   }
+
+   if (mTrace) {
+      AddrTraceSegment segments[] = {
+         { pTraceIn, sizeof(*pTraceIn) },
+         AddrTraceArray(pTraceIn->pRegion, 1, sizeof(ADDR_COPY_REGION)),
+      };
+
+      mTrace->Record(ADDR_STATS_COPY_HTILE_TO_LINEAR, traceStart, returnCode, segments, sizeof(segments) / sizeof(segments[0]));
+   }
+
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::CopyLinearToHtile
+*
+*   @brief
+*       Interface function stub of AddrCopyLinearToHtile.
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrLib::CopyLinearToHtile(const ADDR_COPY_HTILE_INPUT *pIn) const
+{
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+   AddrStatsScope statsScope(GetStatsCounters(), ADDR_STATS_COPY_LINEAR_TO_HTILE);
+   auto traceStart = mTrace ? mTrace->Now() : 0;
+   auto pTraceIn = pIn;
+
+   if (GetFillSizeFieldsFlags()) {
+      if (pIn->size != sizeof(ADDR_COPY_HTILE_INPUT)) {
+         returnCode = ADDR_PARAMSIZEMISMATCH;
+      }
+   }
+
+   if (returnCode == ADDR_OK) {
+      ADDR_COPY_HTILE_INPUT input;
+      ADDR_TILEINFO tileInfoNull;
+
+      if (UseTileIndex(pIn->tileIndex)) {
+         std::memset(&tileInfoNull, 0, sizeof(ADDR_TILEINFO));
+         input = *pIn;
+
+         if (!pIn->pTileInfo) {
+            input.pTileInfo = &tileInfoNull;
+         }
+
+         returnCode = HwlSetupTileCfg(input.tileIndex, input.pTileInfo, nullptr, nullptr);
+         pIn = &input;
+      }
+
+      if (returnCode == ADDR_OK) {
+         returnCode = CopyHtile(pIn, false);
+      }
+   }
+
+   if (mTrace) {
+      AddrTraceSegment segments[] = {
+         { pTraceIn, sizeof(*pTraceIn) },
+         AddrTraceArray(pTraceIn->pRegion, 1, sizeof(ADDR_COPY_REGION)),
+      };
+
+      mTrace->Record(ADDR_STATS_COPY_LINEAR_TO_HTILE, traceStart, returnCode, segments, sizeof(segments) / sizeof(segments[0]));
+   }
+
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::ComputeFmaskSurfaceInfo
+*
+*   @brief
+*       Compute the FMASK of an MSAA color surface as a single sample surface
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrLib::ComputeFmaskSurfaceInfo(AddrTileMode tileMode,
+                                 uint32_t pitch,
+                                 uint32_t height,
+                                 uint32_t numSlices,
+                                 uint32_t numSamples,
+                                 uint32_t numFrags,
+                                 ADDR_TILEINFO *pTileInfo,
+                                 ADDR_COMPUTE_SURFACE_INFO_OUTPUT *pSurfOut,
+                                 uint32_t *pBitsPerSample) const
+{
+   ADDR_COMPUTE_SURFACE_INFO_INPUT surfIn;
+   auto bpp = HwlComputeFmaskBits(numSamples, numFrags ? numFrags : numSamples, pBitsPerSample);
+
+   if (bpp == 0 || pitch == 0 || height == 0) {
+      return ADDR_INVALIDPARAMS;
+   }
+
+   std::memset(&surfIn, 0, sizeof(surfIn));
+   std::memset(pSurfOut, 0, sizeof(*pSurfOut));
+
+   surfIn.size = sizeof(ADDR_COMPUTE_SURFACE_INFO_INPUT);
+   surfIn.tileMode = tileMode;
+   surfIn.bpp = bpp;
+   surfIn.numSamples = 1;
+   surfIn.width = pitch;
+   surfIn.height = height;
+   surfIn.numSlices = std::max(numSlices, 1u);
+   surfIn.flags.fmask = 1;
+   surfIn.pTileInfo = pTileInfo;
+   surfIn.tileIndex = -1;
+   pSurfOut->size = sizeof(ADDR_COMPUTE_SURFACE_INFO_OUTPUT);
+
+   return ComputeSurfaceInfoLevel(&surfIn, pSurfOut, ADDR_UNCOMPRESSED, 0, 1, 1);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::ComputeFmaskInfo
+*
+*   @brief
+*       Interface function stub of AddrComputeFmaskInfo
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrLib::ComputeFmaskInfo(const ADDR_COMPUTE_FMASK_INFO_INPUT *pIn,
+                          ADDR_COMPUTE_FMASK_INFO_OUTPUT *pOut) const
+{
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+   AddrStatsScope statsScope(GetStatsCounters(), ADDR_STATS_FMASK_INFO);
+   auto traceStart = mTrace ? mTrace->Now() : 0;
+   auto pTraceIn = pIn;
+
+   if (GetFillSizeFieldsFlags()) {
+      if (pIn->size != sizeof(ADDR_COMPUTE_FMASK_INFO_INPUT) || pOut->size != sizeof(ADDR_COMPUTE_FMASK_INFO_OUTPUT)) {
+         returnCode = ADDR_PARAMSIZEMISMATCH;
+      }
+   }
+
+   if (returnCode == ADDR_OK) {
+      ADDR_COMPUTE_FMASK_INFO_INPUT input;
+      ADDR_TILEINFO tileInfoNull;
+
+      if (UseTileIndex(pIn->tileIndex)) {
+         std::memset(&tileInfoNull, 0, sizeof(ADDR_TILEINFO));
+         input = *pIn;
+
+         if (!pIn->pTileInfo) {
+            input.pTileInfo = &tileInfoNull;
+         }
+
+         returnCode = HwlSetupTileCfg(input.tileIndex, input.pTileInfo, &input.tileMode, nullptr);
+         pIn = &input;
+      }
+
+      if (returnCode == ADDR_OK) {
+         ADDR_COMPUTE_SURFACE_INFO_OUTPUT surfOut;
+
+         returnCode = ComputeFmaskSurfaceInfo(pIn->tileMode,
+                                              pIn->pitch,
+                                              pIn->height,
+                                              pIn->numSlices,
+                                              pIn->numSamples,
+                                              pIn->numFrags,
+                                              pIn->pTileInfo,
+                                              &surfOut,
+                                              &pOut->bitsPerSample);
+
+         if (returnCode == ADDR_OK) {
+            pOut->pitch = surfOut.pitch;
+            pOut->height = surfOut.height;
+            pOut->numSlices = surfOut.depth;
+            pOut->fmaskBytes = surfOut.surfSize;
+            pOut->baseAlign = surfOut.baseAlign;
+            pOut->pitchAlign = surfOut.pitchAlign;
+            pOut->heightAlign = surfOut.heightAlign;
+            pOut->bpp = surfOut.bpp;
+            pOut->tileMode = surfOut.tileMode;
+         }
+      }
+   }
+
+   if (mTrace) {
+      AddrTraceSegment segments[] = {
+         { pTraceIn, sizeof(*pTraceIn) },
+         { pOut, sizeof(*pOut) },
+      };
+
+      mTrace->Record(ADDR_STATS_FMASK_INFO, traceStart, returnCode, segments, sizeof(segments) / sizeof(segments[0]));
+   }
+
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::ComputeFmaskAddrFromCoord
+*
+*   @brief
+*       Interface function stub of AddrComputeFmaskAddrFromCoord
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrLib::ComputeFmaskAddrFromCoord(const ADDR_COMPUTE_FMASK_ADDRFROMCOORD_INPUT *pIn,
+                                   ADDR_COMPUTE_FMASK_ADDRFROMCOORD_OUTPUT *pOut) const
+{
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+   AddrStatsScope statsScope(GetStatsCounters(), ADDR_STATS_FMASK_ADDRFROMCOORD);
+   auto traceStart = mTrace ? mTrace->Now() : 0;
+   auto pTraceIn = pIn;
+
+   if (GetFillSizeFieldsFlags()) {
+      if (pIn->size != sizeof(ADDR_COMPUTE_FMASK_ADDRFROMCOORD_INPUT) || pOut->size != sizeof(ADDR_COMPUTE_FMASK_ADDRFROMCOORD_OUTPUT)) {
+         returnCode = ADDR_PARAMSIZEMISMATCH;
+      }
+   }
+
+   if (returnCode == ADDR_OK) {
+      ADDR_COMPUTE_FMASK_ADDRFROMCOORD_INPUT input;
+      ADDR_TILEINFO tileInfoNull;
+
+      if (UseTileIndex(pIn->tileIndex)) {
+         std::memset(&tileInfoNull, 0, sizeof(ADDR_TILEINFO));
+         input = *pIn;
+
+         if (!pIn->pTileInfo) {
+            input.pTileInfo = &tileInfoNull;
+         }
+
+         returnCode = HwlSetupTileCfg(input.tileIndex, input.pTileInfo, &input.tileMode, nullptr);
+         pIn = &input;
+      }
+
+      ADDR_COMPUTE_SURFACE_INFO_OUTPUT surfOut;
+      auto bitsPerSample = 0u;
+
+      if (returnCode == ADDR_OK) {
+         returnCode = ComputeFmaskSurfaceInfo(pIn->tileMode,
+                                              pIn->pitch,
+                                              pIn->height,
+                                              pIn->numSlices,
+                                              pIn->numSamples,
+                                              pIn->numFrags,
+                                              pIn->pTileInfo,
+                                              &surfOut,
+                                              &bitsPerSample);
+      }
+
+      if (returnCode == ADDR_OK) {
+         if (pIn->x >= surfOut.pitch || pIn->y >= surfOut.height || pIn->slice >= surfOut.depth || pIn->sample >= pIn->numSamples) {
+            returnCode = ADDR_INVALIDPARAMS;
+         }
+      }
+
+      if (returnCode == ADDR_OK) {
+         ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_INPUT addrIn;
+         ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_OUTPUT addrOut;
+
+         std::memset(&addrIn, 0, sizeof(addrIn));
+         addrIn.size = sizeof(ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_INPUT);
+         addrIn.x = pIn->x;
+         addrIn.y = pIn->y;
+         addrIn.slice = pIn->slice;
+         addrIn.bpp = surfOut.bpp;
+         addrIn.pitch = surfOut.pitch;
+         addrIn.height = surfOut.height;
+         addrIn.numSlices = surfOut.depth;
+         addrIn.numSamples = 1;
+         addrIn.tileMode = surfOut.tileMode;
+         addrIn.pipeSwizzle = pIn->pipeSwizzle;
+         addrIn.bankSwizzle = pIn->bankSwizzle;
+         addrIn.pTileInfo = pIn->pTileInfo;
+         addrIn.tileIndex = -1;
+         addrOut.size = sizeof(ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_OUTPUT);
+
+         returnCode = HwlComputeSurfaceAddrFromCoord(&addrIn, &addrOut);
+
+         if (returnCode == ADDR_OK) {
+            auto bitOffset = addrOut.bitPosition + pIn->sample * bitsPerSample;
+
+            pOut->addr = addrOut.addr + bitOffset / BITS_PER_BYTE;
+            pOut->bitPosition = bitOffset % BITS_PER_BYTE;
+         }
+      }
+   }
+
+   if (mTrace) {
+      AddrTraceSegment segments[] = {
+         { pTraceIn, sizeof(*pTraceIn) },
+         { pOut, sizeof(*pOut) },
+      };
+
+      mTrace->Record(ADDR_STATS_FMASK_ADDRFROMCOORD, traceStart, returnCode, segments, sizeof(segments) / sizeof(segments[0]));
+   }
+
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::ComputeFmaskAddrFromCoordBatch
+*
+*   @brief
+*       Interface function stub of AddrComputeFmaskAddrFromCoordBatch, the FMASK layout is
+*       computed once for all of the coordinates
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrLib::ComputeFmaskAddrFromCoordBatch(const ADDR_COMPUTE_FMASK_ADDRFROMCOORD_BATCH_INPUT *pIn,
+                                        ADDR_COMPUTE_FMASK_ADDRFROMCOORD_BATCH_OUTPUT *pOut) const
+{
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+   AddrStatsScope statsScope(GetStatsCounters(), ADDR_STATS_FMASK_ADDRFROMCOORD_BATCH);
+   auto traceStart = mTrace ? mTrace->Now() : 0;
+   auto pTraceIn = pIn;
+
+   if (GetFillSizeFieldsFlags()) {
+      if (pIn->size != sizeof(ADDR_COMPUTE_FMASK_ADDRFROMCOORD_BATCH_INPUT) || pOut->size != sizeof(ADDR_COMPUTE_FMASK_ADDRFROMCOORD_BATCH_OUTPUT)) {
+         returnCode = ADDR_PARAMSIZEMISMATCH;
+      }
+   }
+
+   if (returnCode == ADDR_OK && pIn->numCoords && (!pIn->pX || !pIn->pY || !pOut->pAddr)) {
+      returnCode = ADDR_INVALIDPARAMS;
+   }
+
+   if (returnCode == ADDR_OK) {
+      ADDR_COMPUTE_FMASK_ADDRFROMCOORD_BATCH_INPUT input;
+      ADDR_TILEINFO tileInfoNull;
+
+      if (UseTileIndex(pIn->tileIndex)) {
+         std::memset(&tileInfoNull, 0, sizeof(ADDR_TILEINFO));
+         input = *pIn;
+
+         if (!pIn->pTileInfo) {
+            input.pTileInfo = &tileInfoNull;
+         }
+
+         returnCode = HwlSetupTileCfg(input.tileIndex, input.pTileInfo, &input.tileMode, nullptr);
+         pIn = &input;
+      }
+
+      ADDR_COMPUTE_SURFACE_INFO_OUTPUT surfOut;
+      auto bitsPerSample = 0u;
+
+      if (returnCode == ADDR_OK) {
+         returnCode = ComputeFmaskSurfaceInfo(pIn->tileMode,
+                                              pIn->pitch,
+                                              pIn->height,
+                                              pIn->numSlices,
+                                              pIn->numSamples,
+                                              pIn->numFrags,
+                                              pIn->pTileInfo,
+                                              &surfOut,
+                                              &bitsPerSample);
+      }
+
+      if (returnCode == ADDR_OK) {
+         auto outOfRange = false;
+
+         for (auto i = 0u; i < pIn->numCoords; ++i) {
+            outOfRange |= (pIn->pX[i] >= surfOut.pitch) | (pIn->pY[i] >= surfOut.height);
+            outOfRange |= pIn->pSlice && pIn->pSlice[i] >= surfOut.depth;
+            outOfRange |= pIn->pSample && pIn->pSample[i] >= pIn->numSamples;
+         }
+
+         if (outOfRange) {
+            returnCode = ADDR_INVALIDPARAMS;
+         }
+      }
+
+      if (returnCode == ADDR_OK) {
+         ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_INPUT batchIn;
+         ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_OUTPUT batchOut;
+
+         std::memset(&batchIn, 0, sizeof(batchIn));
+         batchIn.size = sizeof(ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_INPUT);
+         batchIn.bpp = surfOut.bpp;
+         batchIn.pitch = surfOut.pitch;
+         batchIn.height = surfOut.height;
+         batchIn.numSlices = surfOut.depth;
+         batchIn.numSamples = 1;
+         batchIn.tileMode = surfOut.tileMode;
+         batchIn.pipeSwizzle = pIn->pipeSwizzle;
+         batchIn.bankSwizzle = pIn->bankSwizzle;
+         batchIn.pTileInfo = pIn->pTileInfo;
+         batchIn.tileIndex = -1;
+         batchIn.numCoords = pIn->numCoords;
+         batchIn.pX = pIn->pX;
+         batchIn.pY = pIn->pY;
+         batchIn.pSlice = pIn->pSlice;
+         batchOut.size = sizeof(ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_OUTPUT);
+         batchOut.pAddr = pOut->pAddr;
+         batchOut.pBitPosition = nullptr;
+
+         returnCode = HwlComputeSurfaceAddrFromCoordBatch(&batchIn, &batchOut);
+
+         // FMASK pixels are at least a byte, only the sample moves the bit position
+         if (returnCode == ADDR_OK) {
+            for (auto i = 0u; i < pIn->numCoords; ++i) {
+               auto bitOffset = pIn->pSample ? pIn->pSample[i] * bitsPerSample : 0;
+
+               pOut->pAddr[i] += bitOffset / BITS_PER_BYTE;
+
+               if (pOut->pBitPosition) {
+                  pOut->pBitPosition[i] = bitOffset % BITS_PER_BYTE;
+               }
+            }
+         }
+      }
+   }
+
+   if (mTrace) {
+      auto numOutCoords = returnCode == ADDR_OK ? pTraceIn->numCoords : 0;
+      AddrTraceSegment segments[] = {
+         { pTraceIn, sizeof(*pTraceIn) },
+         { pOut, sizeof(*pOut) },
+         AddrTraceArray(pTraceIn->pX, pTraceIn->numCoords, sizeof(uint32_t)),
+         AddrTraceArray(pTraceIn->pY, pTraceIn->numCoords, sizeof(uint32_t)),
+         AddrTraceArray(pTraceIn->pSlice, pTraceIn->numCoords, sizeof(uint32_t)),
+         AddrTraceArray(pTraceIn->pSample, pTraceIn->numCoords, sizeof(uint32_t)),
+         AddrTraceArray(pOut->pAddr, numOutCoords, sizeof(uint64_t)),
+         AddrTraceArray(pOut->pBitPosition, numOutCoords, sizeof(uint32_t)),
+      };
+
+      mTrace->Record(ADDR_STATS_FMASK_ADDRFROMCOORD_BATCH, traceStart, returnCode, segments, sizeof(segments) / sizeof(segments[0]));
+   }
+
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::CopyFmask
+*
+*   @brief
+*       Copy the FMASK of a surface or region to or from a linear array of pixels with the
+*       surface copy of the FMASK as a single sample surface
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrLib::CopyFmask(const ADDR_COPY_FMASK_INPUT *pIn,
+                   bool toLinear) const
+{
+   ADDR_COMPUTE_SURFACE_INFO_OUTPUT surfOut;
+   ADDR_COPY_SURFACE_INPUT copyIn;
+   auto bitsPerSample = 0u;
+
+   if (!pIn->pFmask || !pIn->pLinear) {
+      return ADDR_INVALIDPARAMS;
+   }
+
+   auto returnCode = ComputeFmaskSurfaceInfo(pIn->tileMode,
+                                             pIn->pitch,
+                                             pIn->height,
+                                             pIn->numSlices,
+                                             pIn->numSamples,
+                                             pIn->numFrags,
+                                             pIn->pTileInfo,
+                                             &surfOut,
+                                             &bitsPerSample);
+
+   if (returnCode != ADDR_OK) {
+      return returnCode;
+   }
+
+   std::memset(&copyIn, 0, sizeof(copyIn));
+   copyIn.size = sizeof(ADDR_COPY_SURFACE_INPUT);
+   copyIn.bpp = surfOut.bpp;
+   copyIn.pitch = surfOut.pitch;
+   copyIn.height = surfOut.height;
+   copyIn.numSlices = surfOut.depth;
+   copyIn.numSamples = 1;
+   copyIn.tileMode = surfOut.tileMode;
+   copyIn.pipeSwizzle = pIn->pipeSwizzle;
+   copyIn.bankSwizzle = pIn->bankSwizzle;
+   copyIn.pTileInfo = pIn->pTileInfo;
+   copyIn.tileIndex = -1;
+   copyIn.pTiled = pIn->pFmask;
+   copyIn.pLinear = pIn->pLinear;
+   copyIn.linearPitch = pIn->linearPitch;
+   copyIn.linearSliceSize = pIn->linearSliceSize;
+   copyIn.pRegion = pIn->pRegion;
+   copyIn.numThreads = pIn->numThreads;
+   copyIn.pExecutor = pIn->pExecutor;
+   copyIn.pExecutorData = pIn->pExecutorData;
+
+   if (toLinear) {
+      returnCode = HwlCopySurfaceTiledToLinear(&copyIn);
+   } else {
+      returnCode = HwlCopySurfaceLinearToTiled(&copyIn);
+   }
+
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::CopyFmaskToLinear
+*
+*   @brief
+*       Interface function stub of AddrCopyFmaskToLinear.
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrLib::CopyFmaskToLinear(const ADDR_COPY_FMASK_INPUT *pIn) const
+{
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+   AddrStatsScope statsScope(GetStatsCounters(), ADDR_STATS_COPY_FMASK_TO_LINEAR);
+   auto traceStart = mTrace ? mTrace->Now() : 0;
+   auto pTraceIn = pIn;
+
+   if (GetFillSizeFieldsFlags()) {
+      if (pIn->size != sizeof(ADDR_COPY_FMASK_INPUT)) {
+         returnCode = ADDR_PARAMSIZEMISMATCH;
+      }
+   }
+
+   if (returnCode == ADDR_OK) {
+      ADDR_COPY_FMASK_INPUT input;
+      ADDR_TILEINFO tileInfoNull;
+
+      if (UseTileIndex(pIn->tileIndex)) {
+         std::memset(&tileInfoNull, 0, sizeof(ADDR_TILEINFO));
+         input = *pIn;
+
+         if (!pIn->pTileInfo) {
+            input.pTileInfo = &tileInfoNull;
+         }
+
+         returnCode = HwlSetupTileCfg(input.tileIndex, input.pTileInfo, &input.tileMode, nullptr);
+         pIn = &input;
+      }
+
+      if (returnCode == ADDR_OK) {
+         returnCode = CopyFmask(pIn, true);
+      }
+   }
+
+   if (mTrace) {
+      AddrTraceSegment segments[] = {
+         { pTraceIn, sizeof(*pTraceIn) },
+         AddrTraceArray(pTraceIn->pRegion, 1, sizeof(ADDR_COPY_REGION)),
+      };
+
+      mTrace->Record(ADDR_STATS_COPY_FMASK_TO_LINEAR, traceStart, returnCode, segments, sizeof(segments) / sizeof(segments[0]));
+   }
+
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::CopyLinearToFmask
+*
+*   @brief
+*       Interface function stub of AddrCopyLinearToFmask.
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrLib::CopyLinearToFmask(const ADDR_COPY_FMASK_INPUT *pIn) const
+{
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+   AddrStatsScope statsScope(GetStatsCounters(), ADDR_STATS_COPY_LINEAR_TO_FMASK);
+   auto traceStart = mTrace ? mTrace->Now() : 0;
+   auto pTraceIn = pIn;
+
+   if (GetFillSizeFieldsFlags()) {
+      if (pIn->size != sizeof(ADDR_COPY_FMASK_INPUT)) {
+         returnCode = ADDR_PARAMSIZEMISMATCH;
+      }
+   }
+
+   if (returnCode == ADDR_OK) {
+      ADDR_COPY_FMASK_INPUT input;
+      ADDR_TILEINFO tileInfoNull;
+
+      if (UseTileIndex(pIn->tileIndex)) {
+         std::memset(&tileInfoNull, 0, sizeof(ADDR_TILEINFO));
+         input = *pIn;
+
+         if (!pIn->pTileInfo) {
+            input.pTileInfo = &tileInfoNull;
+         }
+
+         returnCode = HwlSetupTileCfg(input.tileIndex, input.pTileInfo, &input.tileMode, nullptr);
+         pIn = &input;
+      }
+
+      if (returnCode == ADDR_OK) {
+         returnCode = CopyFmask(pIn, false);
+      }
+   }
+
+   if (mTrace) {
+      AddrTraceSegment segments[] = {
+         { pTraceIn, sizeof(*pTraceIn) },
+         AddrTraceArray(pTraceIn->pRegion, 1, sizeof(ADDR_COPY_REGION)),
+      };
+
+      mTrace->Record(ADDR_STATS_COPY_LINEAR_TO_FMASK, traceStart, returnCode, segments, sizeof(segments) / sizeof(segments[0]));
+   }
+
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::ComputeCmaskInfo
+*
+*   @brief
+*       Compute cmask pitch, height and bytes of a color surface, the padding works as for
+*       htile with 4 bits per 8x8 tile and a 1024 bit cache line
+*
+*   @return
+*       N/A, returns by output parameters:
+*       *Cmask pitch, height, total size in bytes, macro-tile dimensions, base alignment and
+*       the index of the last 128x128 block of a slice*
+***************************************************************************************************
+*/
+void
+AddrLib::ComputeCmaskInfo(uint32_t pitchIn,
+                          uint32_t heightIn,
+                          uint32_t numSlices,
+                          bool isLinear,
+                          ADDR_TILEINFO *pTileInfo,
+                          uint32_t *pPitchOut,
+                          uint32_t *pHeightOut,
+                          uint64_t *pCmaskBytes,
+                          uint32_t *pMacroWidth,
+                          uint32_t *pMacroHeight,
+                          uint32_t *pBaseAlign,
+                          uint32_t *pBlockMax) const
+{
+   auto pipes = GetNumPipes(pTileInfo);
+   auto macroWidth = uint32_t { 0 };
+   auto macroHeight = uint32_t { 0 };
+
+   if (isLinear) {
+      HwlComputeTileDataWidthAndHeightLinear(&macroWidth, &macroHeight, CmaskElemBits, pTileInfo);
+   } else {
+      ComputeTileDataWidthAndHeight(CmaskElemBits, CmaskCacheBits, pTileInfo, &macroWidth, &macroHeight);
+   }
+
+   *pPitchOut = PowTwoAlign(pitchIn, macroWidth);
+   *pHeightOut = PowTwoAlign(heightIn, macroHeight);
+
+   // Every pipe stores whole interleave groups, so the size is a multiple of a group per pipe
+   auto baseAlign = pipes * mPipeInterleaveBytes;
+   auto slicePixels = static_cast<uint64_t>(*pPitchOut) * (*pHeightOut);
+   auto sliceBytes = BITS_TO_BYTES(slicePixels * CmaskElemBits / MicroTilePixels);
+
+   if (pCmaskBytes) {
+      *pCmaskBytes = PowTwoAlign<uint64_t>(sliceBytes * std::max(numSlices, 1u), baseAlign);
+   }
+
+   if (pMacroWidth) {
+      *pMacroWidth = macroWidth;
+   }
+
+   if (pMacroHeight) {
+      *pMacroHeight = macroHeight;
+   }
+
+   if (pBaseAlign) {
+      *pBaseAlign = baseAlign;
+   }
+
+   if (pBlockMax) {
+      *pBlockMax = static_cast<uint32_t>(std::max<uint64_t>(slicePixels / CmaskBlockPixels, 1) - 1);
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::ComputeCmaskInfo
+*
+*   @brief
+*       Interface function stub of AddrComputeCmaskInfo
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrLib::ComputeCmaskInfo(const ADDR_COMPUTE_CMASK_INFO_INPUT *pIn,
+                          ADDR_COMPUTE_CMASK_INFO_OUTPUT *pOut) const
+{
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+   AddrStatsScope statsScope(GetStatsCounters(), ADDR_STATS_CMASK_INFO);
+   auto traceStart = mTrace ? mTrace->Now() : 0;
+   auto pTraceIn = pIn;
+
+   if (GetFillSizeFieldsFlags()) {
+      if (pIn->size != sizeof(ADDR_COMPUTE_CMASK_INFO_INPUT) || pOut->size != sizeof(ADDR_COMPUTE_CMASK_INFO_OUTPUT)) {
+         returnCode = ADDR_PARAMSIZEMISMATCH;
+      }
+   }
+
+   if (returnCode == ADDR_OK) {
+      ADDR_COMPUTE_CMASK_INFO_INPUT input;
+      ADDR_TILEINFO tileInfoNull;
+
+      if (UseTileIndex(pIn->tileIndex)) {
+         std::memset(&tileInfoNull, 0, sizeof(ADDR_TILEINFO));
+         input = *pIn;
+
+         if (!pIn->pTileInfo) {
+            input.pTileInfo = &tileInfoNull;
+         }
+
+         returnCode = HwlSetupTileCfg(input.tileIndex, input.pTileInfo, nullptr, nullptr);
+         pIn = &input;
+      }
+
+      if (returnCode == ADDR_OK) {
+         pOut->bpp = CmaskElemBits;
+
+         ComputeCmaskInfo(pIn->pitch,
+                          pIn->height,
+                          pIn->numSlices,
+                          pIn->isLinear,
+                          pIn->pTileInfo,
+                          &pOut->pitch,
+                          &pOut->height,
+                          &pOut->cmaskBytes,
+                          &pOut->macroWidth,
+                          &pOut->macroHeight,
+                          &pOut->baseAlign,
+                          &pOut->blockMax);
+      }
+   }
+
+   if (mTrace) {
+      AddrTraceSegment segments[] = {
+         { pTraceIn, sizeof(*pTraceIn) },
+         { pOut, sizeof(*pOut) },
+      };
+
+      mTrace->Record(ADDR_STATS_CMASK_INFO, traceStart, returnCode, segments, sizeof(segments) / sizeof(segments[0]));
+   }
+
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::ComputeCmaskAddrFromCoord
+*
+*   @brief
+*       Interface function stub of AddrComputeCmaskAddrFromCoord
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrLib::ComputeCmaskAddrFromCoord(const ADDR_COMPUTE_CMASK_ADDRFROMCOORD_INPUT *pIn,
+                                   ADDR_COMPUTE_CMASK_ADDRFROMCOORD_OUTPUT *pOut) const
+{
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+   AddrStatsScope statsScope(GetStatsCounters(), ADDR_STATS_CMASK_ADDRFROMCOORD);
+   auto traceStart = mTrace ? mTrace->Now() : 0;
+   auto pTraceIn = pIn;
+
+   if (GetFillSizeFieldsFlags()) {
+      if (pIn->size != sizeof(ADDR_COMPUTE_CMASK_ADDRFROMCOORD_INPUT) || pOut->size != sizeof(ADDR_COMPUTE_CMASK_ADDRFROMCOORD_OUTPUT)) {
+         returnCode = ADDR_PARAMSIZEMISMATCH;
+      }
+   }
+
+   if (returnCode == ADDR_OK) {
+      ADDR_COMPUTE_CMASK_ADDRFROMCOORD_INPUT input;
+      ADDR_TILEINFO tileInfoNull;
+      AddrTileDataLayout layout;
+
+      if (UseTileIndex(pIn->tileIndex)) {
+         std::memset(&tileInfoNull, 0, sizeof(ADDR_TILEINFO));
+         input = *pIn;
+
+         if (!pIn->pTileInfo) {
+            input.pTileInfo = &tileInfoNull;
+         }
+
+         returnCode = HwlSetupTileCfg(input.tileIndex, input.pTileInfo, nullptr, nullptr);
+         pIn = &input;
+      }
+
+      if (returnCode == ADDR_OK) {
+         returnCode = ComputeCmaskLayout(pIn->pitch,
+                                         pIn->height,
+                                         pIn->numSlices,
+                                         pIn->isLinear,
+                                         pIn->pTileInfo,
+                                         &layout);
+      }
+
+      if (returnCode == ADDR_OK) {
+         if (pIn->x >= layout.pitch || pIn->y >= layout.height || pIn->slice >= layout.numSlices) {
+            returnCode = ADDR_INVALIDPARAMS;
+         }
+      }
+
+      if (returnCode == ADDR_OK) {
+         pOut->addr = ComputeTileDataAddrFromCoord(&layout, pIn->x, pIn->y, pIn->slice, &pOut->bitPosition);
+      }
+   }
+
+   if (mTrace) {
+      AddrTraceSegment segments[] = {
+         { pTraceIn, sizeof(*pTraceIn) },
+         { pOut, sizeof(*pOut) },
+      };
 
-   return pixelNumber;
+      mTrace->Record(ADDR_STATS_CMASK_ADDRFROMCOORD, traceStart, returnCode, segments, sizeof(segments) / sizeof(segments[0]));
+   }
+
+   return returnCode;
 }
 
 
 /**
 ***************************************************************************************************
-*   AddrLib::ComputeSurfaceInfo
+*   AddrLib::CopyCmaskToLinear
 *
 *   @brief
-*       Interface function stub of AddrComputeSurfaceInfo.
+*       Interface function stub of AddrCopyCmaskToLinear.
 *
 *   @return
 *       ADDR_E_RETURNCODE
 ***************************************************************************************************
 */
 ADDR_E_RETURNCODE
-AddrLib::ComputeSurfaceAddrFromCoord(const ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_INPUT *pIn,
-                                     ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_OUTPUT *pOut) const
+AddrLib::CopyCmaskToLinear(const ADDR_COPY_CMASK_INPUT *pIn) const
 {
    ADDR_E_RETURNCODE returnCode = ADDR_OK;
+   AddrStatsScope statsScope(GetStatsCounters(), ADDR_STATS_COPY_CMASK_TO_LINEAR);
+   auto traceStart = mTrace ? mTrace->Now() : 0;
+   auto pTraceIn = pIn;
 
    if (GetFillSizeFieldsFlags()) {
-      if (pIn->size != sizeof(ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_INPUT) || pOut->size != sizeof(ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_OUTPUT)) {
+      if (pIn->size != sizeof(ADDR_COPY_CMASK_INPUT)) {
          returnCode = ADDR_PARAMSIZEMISMATCH;
       }
    }
 
    if (returnCode == ADDR_OK) {
-      ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_INPUT input;
+      ADDR_COPY_CMASK_INPUT input;
       ADDR_TILEINFO tileInfoNull;
 
       if (UseTileIndex(pIn->tileIndex)) {
@@ -793,44 +3419,55 @@ AddrLib::ComputeSurfaceAddrFromCoord(const ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_IN
             input.pTileInfo = &tileInfoNull;
          }
 
-         returnCode = HwlSetupTileCfg(input.tileIndex, input.pTileInfo, &input.tileMode, &input.tileType);
+         returnCode = HwlSetupTileCfg(input.tileIndex, input.pTileInfo, nullptr, nullptr);
          pIn = &input;
       }
 
       if (returnCode == ADDR_OK) {
-         returnCode = HwlComputeSurfaceAddrFromCoord(pIn, pOut);
+         returnCode = CopyCmask(pIn, true);
       }
    }
 
+   if (mTrace) {
+      AddrTraceSegment segments[] = {
+         { pTraceIn, sizeof(*pTraceIn) },
+         AddrTraceArray(pTraceIn->pRegion, 1, sizeof(ADDR_COPY_REGION)),
+      };
+
+      mTrace->Record(ADDR_STATS_COPY_CMASK_TO_LINEAR, traceStart, returnCode, segments, sizeof(segments) / sizeof(segments[0]));
+   }
+
    return returnCode;
 }
 
 
 /**
 ***************************************************************************************************
-*   AddrLib::ExtractBankPipeSwizzle
+*   AddrLib::CopyLinearToCmask
 *
 *   @brief
-*       Interface function stub of AddrExtractBankPipeSwizzle.
+*       Interface function stub of AddrCopyLinearToCmask.
 *
 *   @return
 *       ADDR_E_RETURNCODE
 ***************************************************************************************************
 */
 ADDR_E_RETURNCODE
-AddrLib::ExtractBankPipeSwizzle(const ADDR_EXTRACT_BANKPIPE_SWIZZLE_INPUT *pIn,
-                                ADDR_EXTRACT_BANKPIPE_SWIZZLE_OUTPUT *pOut) const
+AddrLib::CopyLinearToCmask(const ADDR_COPY_CMASK_INPUT *pIn) const
 {
    ADDR_E_RETURNCODE returnCode = ADDR_OK;
+   AddrStatsScope statsScope(GetStatsCounters(), ADDR_STATS_COPY_LINEAR_TO_CMASK);
+   auto traceStart = mTrace ? mTrace->Now() : 0;
+   auto pTraceIn = pIn;
 
    if (GetFillSizeFieldsFlags()) {
-      if (pIn->size != sizeof(ADDR_EXTRACT_BANKPIPE_SWIZZLE_INPUT) || pOut->size != sizeof(ADDR_EXTRACT_BANKPIPE_SWIZZLE_OUTPUT)) {
+      if (pIn->size != sizeof(ADDR_COPY_CMASK_INPUT)) {
          returnCode = ADDR_PARAMSIZEMISMATCH;
       }
    }
 
    if (returnCode == ADDR_OK) {
-      ADDR_EXTRACT_BANKPIPE_SWIZZLE_INPUT input;
+      ADDR_COPY_CMASK_INPUT input;
       ADDR_TILEINFO tileInfoNull;
 
       if (UseTileIndex(pIn->tileIndex)) {
@@ -846,179 +3483,240 @@ AddrLib::ExtractBankPipeSwizzle(const ADDR_EXTRACT_BANKPIPE_SWIZZLE_INPUT *pIn,
       }
 
       if (returnCode == ADDR_OK) {
-         returnCode = HwlExtractBankPipeSwizzle(pIn, pOut);
+         returnCode = CopyCmask(pIn, false);
       }
    }
 
+   if (mTrace) {
+      AddrTraceSegment segments[] = {
+         { pTraceIn, sizeof(*pTraceIn) },
+         AddrTraceArray(pTraceIn->pRegion, 1, sizeof(ADDR_COPY_REGION)),
+      };
+
+      mTrace->Record(ADDR_STATS_COPY_LINEAR_TO_CMASK, traceStart, returnCode, segments, sizeof(segments) / sizeof(segments[0]));
+   }
+
    return returnCode;
 }
 
 
 /**
 ***************************************************************************************************
-*   AddrLib::HwlComputeTileDataWidthAndHeightLinear
+*   AddrLib::ComputeSliceTileSwizzle
 *
 *   @brief
-*       Compute the squared cache shape for per-tile data (CMASK and HTILE) for linear layout
+*       Interface function stub of ComputeSliceTileSwizzle.
 *
 *   @return
-*       N/A
-*
-*   @note
-*       MacroWidth and macroHeight are measured in pixels
+*       ADDR_E_RETURNCODE
 ***************************************************************************************************
 */
-void
-AddrLib::HwlComputeTileDataWidthAndHeightLinear(uint32_t *pMacroWidth,
-                                                uint32_t *pMacroHeight,
-                                                uint32_t bpp,
-                                                ADDR_TILEINFO *pTileInfo) const
+ADDR_E_RETURNCODE
+AddrLib::ComputeSliceTileSwizzle(const ADDR_COMPUTE_SLICESWIZZLE_INPUT *pIn,
+                                 ADDR_COMPUTE_SLICESWIZZLE_OUTPUT *pOut) const
 {
-   *pMacroWidth = (8 * 512) / bpp;
-   *pMacroHeight = 8 * mPipes;
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+   AddrStatsScope statsScope(GetStatsCounters(), ADDR_STATS_SLICE_SWIZZLE);
+   auto traceStart = mTrace ? mTrace->Now() : 0;
+   auto pTraceIn = pIn;
+
+   if (GetFillSizeFieldsFlags()) {
+      if (pIn->size != sizeof(ADDR_COMPUTE_SLICESWIZZLE_INPUT) || pOut->size != sizeof(ADDR_COMPUTE_SLICESWIZZLE_OUTPUT)) {
+         returnCode = ADDR_PARAMSIZEMISMATCH;
+      }
+   }
+
+   if (returnCode == ADDR_OK) {
+      ADDR_COMPUTE_SLICESWIZZLE_INPUT input;
+      ADDR_TILEINFO tileInfoNull;
+
+      if (UseTileIndex(pIn->tileIndex)) {
+         std::memset(&tileInfoNull, 0, sizeof(ADDR_TILEINFO));
+         input = *pIn;
+
+         if (!pIn->pTileInfo) {
+            input.pTileInfo = &tileInfoNull;
+         }
+
+         returnCode = HwlSetupTileCfg(input.tileIndex, input.pTileInfo, nullptr, nullptr);
+         pIn = &input;
+      }
+
+      if (returnCode == ADDR_OK) {
+         returnCode = HwlComputeSliceTileSwizzle(pIn, pOut);
+      }
+   }
+
+   if (mTrace) {
+      AddrTraceSegment segments[] = {
+         { pTraceIn, sizeof(*pTraceIn) },
+         { pOut, sizeof(*pOut) },
+      };
+
+      mTrace->Record(ADDR_STATS_SLICE_SWIZZLE, traceStart, returnCode, segments, sizeof(segments) / sizeof(segments[0]));
+   }
+
+   return returnCode;
 }
 
 
 /**
 ***************************************************************************************************
-*   AddrLib::ComputeTileDataWidthAndHeight
+*   AddrLib::CopySurfaceTiledToLinear
 *
 *   @brief
-*       Compute the squared cache shape for per-tile data (CMASK and HTILE)
+*       Interface function stub of AddrCopySurfaceTiledToLinear.
 *
 *   @return
-*       N/A
-*
-*   @note
-*       MacroWidth and macroHeight are measured in pixels
+*       ADDR_E_RETURNCODE
 ***************************************************************************************************
 */
-void
-AddrLib::ComputeTileDataWidthAndHeight(uint32_t bpp,
-                                       uint32_t cacheBits,
-                                       ADDR_TILEINFO *pTileInfo,
-                                       uint32_t *pMacroWidth,
-                                       uint32_t *pMacroHeight) const
+ADDR_E_RETURNCODE
+AddrLib::CopySurfaceTiledToLinear(const ADDR_COPY_SURFACE_INPUT *pIn) const
 {
-   auto height = 1;
-   auto width = cacheBits / bpp;
-   auto pipes = GetNumPipes(pTileInfo);
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+   AddrStatsScope statsScope(GetStatsCounters(), ADDR_STATS_COPY_TILED_TO_LINEAR);
+   auto traceStart = mTrace ? mTrace->Now() : 0;
+   auto pTraceIn = pIn;
 
-   while ((width > height * 2 * pipes) && !(width & 1)) {
-      width /= 2;
-      height *= 2;
+   if (GetFillSizeFieldsFlags()) {
+      if (pIn->size != sizeof(ADDR_COPY_SURFACE_INPUT)) {
+         returnCode = ADDR_PARAMSIZEMISMATCH;
+      }
    }
 
-   *pMacroWidth = 8 * width;
-   *pMacroHeight = 8 * height * pipes;
+   if (!pIn->pTiled || !pIn->pLinear) {
+      returnCode = ADDR_INVALIDPARAMS;
+   }
+
+   if (returnCode == ADDR_OK) {
+      ADDR_COPY_SURFACE_INPUT input;
+      ADDR_TILEINFO tileInfoNull;
+
+      if (UseTileIndex(pIn->tileIndex)) {
+         std::memset(&tileInfoNull, 0, sizeof(ADDR_TILEINFO));
+         input = *pIn;
+
+         if (!pIn->pTileInfo) {
+            input.pTileInfo = &tileInfoNull;
+         }
+
+         returnCode = HwlSetupTileCfg(input.tileIndex, input.pTileInfo, &input.tileMode, nullptr);
+         pIn = &input;
+      }
+
+      if (returnCode == ADDR_OK) {
+         returnCode = HwlCopySurfaceTiledToLinear(pIn);
+      }
+   }
+
+   if (mTrace) {
+      AddrTraceSegment segments[] = {
+         { pTraceIn, sizeof(*pTraceIn) },
+         AddrTraceArray(pTraceIn->pRegion, 1, sizeof(ADDR_COPY_REGION)),
+      };
+
+      mTrace->Record(ADDR_STATS_COPY_TILED_TO_LINEAR, traceStart, returnCode, segments, sizeof(segments) / sizeof(segments[0]));
+   }
+
+   return returnCode;
 }
 
 
 /**
 ***************************************************************************************************
-*   AddrLib::ComputeHtileInfo
+*   AddrLib::CopySurfaceLinearToTiled
 *
 *   @brief
-*       Compute htile pitch,width, bytes per 2D slice
+*       Interface function stub of AddrCopySurfaceLinearToTiled.
 *
 *   @return
-*       Htile bpp i.e. How many bits for an 8x8 tile
-*       Also returns by output parameters:
-*       *Htile pitch, height, total size in bytes, macro-tile dimensions and slice size*
+*       ADDR_E_RETURNCODE
 ***************************************************************************************************
 */
-uint32_t
-AddrLib::ComputeHtileInfo(uint32_t pitchIn,
-                          uint32_t heightIn,
-                          uint32_t numSlices,
-                          bool isLinear,
-                          bool isWidth8,
-                          bool isHeight8,
-                          ADDR_TILEINFO *pTileInfo,
-                          uint32_t *pPitchOut,
-                          uint32_t *pHeightOut,
-                          uint64_t *pHtileBytes,
-                          uint32_t *pMacroWidth,
-                          uint32_t *pMacroHeight,
-                          uint64_t *pSliceBytes,
-                          uint32_t *pBaseAlign) const
+ADDR_E_RETURNCODE
+AddrLib::CopySurfaceLinearToTiled(const ADDR_COPY_SURFACE_INPUT *pIn) const
 {
-   auto pipes = GetNumPipes(pTileInfo);
-   auto bpp = HwlComputeHtileBpp(isWidth8, isHeight8);
-   auto macroWidth = uint32_t { 0 };
-   auto macroHeight = uint32_t { 0 };
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+   AddrStatsScope statsScope(GetStatsCounters(), ADDR_STATS_COPY_LINEAR_TO_TILED);
+   auto traceStart = mTrace ? mTrace->Now() : 0;
+   auto pTraceIn = pIn;
 
-   if (isLinear) {
-      HwlComputeTileDataWidthAndHeightLinear(&macroWidth, &macroHeight, bpp, pTileInfo);
-   } else {
-      ComputeTileDataWidthAndHeight(bpp, HtileCacheBits, pTileInfo, &macroWidth, &macroHeight);
+   if (GetFillSizeFieldsFlags()) {
+      if (pIn->size != sizeof(ADDR_COPY_SURFACE_INPUT)) {
+         returnCode = ADDR_PARAMSIZEMISMATCH;
+      }
    }
 
-   *pPitchOut = PowTwoAlign(pitchIn, macroWidth);
-   *pHeightOut = PowTwoAlign(heightIn, macroHeight);
-
-   auto baseAlign = HwlComputeHtileBaseAlign(isLinear, pipes);
-   auto surfBytes = HwlComputeHtileBytes(*pPitchOut,
-                                         *pHeightOut,
-                                         bpp,
-                                         isLinear,
-                                         numSlices,
-                                         baseAlign);
+   if (!pIn->pTiled || !pIn->pLinear) {
+      returnCode = ADDR_INVALIDPARAMS;
+   }
 
+   if (returnCode == ADDR_OK) {
+      ADDR_COPY_SURFACE_INPUT input;
+      ADDR_TILEINFO tileInfoNull;
 
-   auto sliceBytes = BITS_TO_BYTES(static_cast<uint64_t>(*pHeightOut) * (*pPitchOut) * bpp / 64);
+      if (UseTileIndex(pIn->tileIndex)) {
+         std::memset(&tileInfoNull, 0, sizeof(ADDR_TILEINFO));
+         input = *pIn;
 
-   if (pHtileBytes) {
-      *pHtileBytes = surfBytes;
-   }
+         if (!pIn->pTileInfo) {
+            input.pTileInfo = &tileInfoNull;
+         }
 
-   if (pMacroWidth) {
-      *pMacroWidth = macroWidth;
-   }
+         returnCode = HwlSetupTileCfg(input.tileIndex, input.pTileInfo, &input.tileMode, nullptr);
+         pIn = &input;
+      }
 
-   if (pMacroHeight) {
-      *pMacroHeight = macroHeight;
+      if (returnCode == ADDR_OK) {
+         returnCode = HwlCopySurfaceLinearToTiled(pIn);
+      }
    }
 
-   if (pSliceBytes) {
-      *pSliceBytes = sliceBytes;
-   }
+   if (mTrace) {
+      AddrTraceSegment segments[] = {
+         { pTraceIn, sizeof(*pTraceIn) },
+         AddrTraceArray(pTraceIn->pRegion, 1, sizeof(ADDR_COPY_REGION)),
+      };
 
-   if (pBaseAlign) {
-      *pBaseAlign = baseAlign;
+      mTrace->Record(ADDR_STATS_COPY_LINEAR_TO_TILED, traceStart, returnCode, segments, sizeof(segments) / sizeof(segments[0]));
    }
 
-   return bpp;
+   return returnCode;
 }
 
 
 /**
 ***************************************************************************************************
-*   AddrLib::ComputeHtileInfo
+*   AddrLib::CopyDepthPlanesToLinear
 *
 *   @brief
-*       Interface function stub of AddrComputeHtilenfo
+*       Interface function stub of AddrCopyDepthPlanesToLinear.
 *
 *   @return
 *       ADDR_E_RETURNCODE
 ***************************************************************************************************
 */
 ADDR_E_RETURNCODE
-AddrLib::ComputeHtileInfo(const ADDR_COMPUTE_HTILE_INFO_INPUT *pIn,
-                          ADDR_COMPUTE_HTILE_INFO_OUTPUT *pOut) const
+AddrLib::CopyDepthPlanesToLinear(const ADDR_COPY_DEPTH_PLANES_INPUT *pIn) const
 {
    ADDR_E_RETURNCODE returnCode = ADDR_OK;
-   auto isWidth8 = (pIn->blockWidth == 8);
-   auto isHeight8 = (pIn->blockHeight == 8);
+   AddrStatsScope statsScope(GetStatsCounters(), ADDR_STATS_COPY_DEPTH_PLANES_TO_LINEAR);
+   auto traceStart = mTrace ? mTrace->Now() : 0;
+   auto pTraceIn = pIn;
 
    if (GetFillSizeFieldsFlags()) {
-      if (pIn->size != sizeof(ADDR_COMPUTE_HTILE_INFO_INPUT) || pOut->size != sizeof(ADDR_COMPUTE_HTILE_INFO_OUTPUT)) {
+      if (pIn->size != sizeof(ADDR_COPY_DEPTH_PLANES_INPUT)) {
          returnCode = ADDR_PARAMSIZEMISMATCH;
       }
    }
 
+   if (returnCode == ADDR_OK && (!pIn->pTiled || !pIn->pPlanes || pIn->numPlanes == 0 || pIn->numPlanes > ADDR_MAX_DEPTH_PLANES)) {
+      returnCode = ADDR_INVALIDPARAMS;
+   }
+
    if (returnCode == ADDR_OK) {
-      ADDR_COMPUTE_HTILE_INFO_INPUT input;
+      ADDR_COPY_DEPTH_PLANES_INPUT input;
       ADDR_TILEINFO tileInfoNull;
 
       if (UseTileIndex(pIn->tileIndex)) {
@@ -1029,57 +3727,60 @@ AddrLib::ComputeHtileInfo(const ADDR_COMPUTE_HTILE_INFO_INPUT *pIn,
             input.pTileInfo = &tileInfoNull;
          }
 
-         returnCode = HwlSetupTileCfg(input.tileIndex, input.pTileInfo, nullptr, nullptr);
+         returnCode = HwlSetupTileCfg(input.tileIndex, input.pTileInfo, &input.tileMode, nullptr);
          pIn = &input;
       }
 
       if (returnCode == ADDR_OK) {
-         pOut->bpp = ComputeHtileInfo(pIn->pitch,
-                                      pIn->height,
-                                      pIn->numSlices,
-                                      pIn->isLinear,
-                                      isWidth8,
-                                      isHeight8,
-                                      pIn->pTileInfo,
-                                      &pOut->pitch,
-                                      &pOut->height,
-                                      &pOut->htileBytes,
-                                      &pOut->macroWidth,
-                                      &pOut->macroHeight,
-                                      nullptr,
-                                      &pOut->baseAlign);
+         returnCode = HwlCopyDepthPlanesToLinear(pIn);
       }
    }
 
+   if (mTrace) {
+      AddrTraceSegment segments[] = {
+         { pTraceIn, sizeof(*pTraceIn) },
+         AddrTraceArray(pTraceIn->pRegion, 1, sizeof(ADDR_COPY_REGION)),
+         AddrTraceArray(pTraceIn->pPlanes, std::min(pTraceIn->numPlanes, ADDR_MAX_DEPTH_PLANES), sizeof(ADDR_COPY_DEPTH_PLANE)),
+      };
+
+      mTrace->Record(ADDR_STATS_COPY_DEPTH_PLANES_TO_LINEAR, traceStart, returnCode, segments, sizeof(segments) / sizeof(segments[0]));
+   }
+
    return returnCode;
 }
 
 
 /**
 ***************************************************************************************************
-*   AddrLib::ComputeSliceTileSwizzle
+*   AddrLib::CopyLinearToDepthPlanes
 *
 *   @brief
-*       Interface function stub of ComputeSliceTileSwizzle.
+*       Interface function stub of AddrCopyLinearToDepthPlanes.
 *
 *   @return
 *       ADDR_E_RETURNCODE
 ***************************************************************************************************
 */
 ADDR_E_RETURNCODE
-AddrLib::ComputeSliceTileSwizzle(const ADDR_COMPUTE_SLICESWIZZLE_INPUT *pIn,
-                                 ADDR_COMPUTE_SLICESWIZZLE_OUTPUT *pOut) const
+AddrLib::CopyLinearToDepthPlanes(const ADDR_COPY_DEPTH_PLANES_INPUT *pIn) const
 {
    ADDR_E_RETURNCODE returnCode = ADDR_OK;
+   AddrStatsScope statsScope(GetStatsCounters(), ADDR_STATS_COPY_LINEAR_TO_DEPTH_PLANES);
+   auto traceStart = mTrace ? mTrace->Now() : 0;
+   auto pTraceIn = pIn;
 
    if (GetFillSizeFieldsFlags()) {
-      if (pIn->size != sizeof(ADDR_COMPUTE_SLICESWIZZLE_INPUT) || pOut->size != sizeof(ADDR_COMPUTE_SLICESWIZZLE_OUTPUT)) {
+      if (pIn->size != sizeof(ADDR_COPY_DEPTH_PLANES_INPUT)) {
          returnCode = ADDR_PARAMSIZEMISMATCH;
       }
    }
 
+   if (returnCode == ADDR_OK && (!pIn->pTiled || !pIn->pPlanes || pIn->numPlanes == 0 || pIn->numPlanes > ADDR_MAX_DEPTH_PLANES)) {
+      returnCode = ADDR_INVALIDPARAMS;
+   }
+
    if (returnCode == ADDR_OK) {
-      ADDR_COMPUTE_SLICESWIZZLE_INPUT input;
+      ADDR_COPY_DEPTH_PLANES_INPUT input;
       ADDR_TILEINFO tileInfoNull;
 
       if (UseTileIndex(pIn->tileIndex)) {
@@ -1090,14 +3791,24 @@ AddrLib::ComputeSliceTileSwizzle(const ADDR_COMPUTE_SLICESWIZZLE_INPUT *pIn,
             input.pTileInfo = &tileInfoNull;
          }
 
-         returnCode = HwlSetupTileCfg(input.tileIndex, input.pTileInfo, nullptr, nullptr);
+         returnCode = HwlSetupTileCfg(input.tileIndex, input.pTileInfo, &input.tileMode, nullptr);
          pIn = &input;
       }
 
       if (returnCode == ADDR_OK) {
-         returnCode = HwlComputeSliceTileSwizzle(pIn, pOut);
+         returnCode = HwlCopyLinearToDepthPlanes(pIn);
       }
    }
 
+   if (mTrace) {
+      AddrTraceSegment segments[] = {
+         { pTraceIn, sizeof(*pTraceIn) },
+         AddrTraceArray(pTraceIn->pRegion, 1, sizeof(ADDR_COPY_REGION)),
+         AddrTraceArray(pTraceIn->pPlanes, std::min(pTraceIn->numPlanes, ADDR_MAX_DEPTH_PLANES), sizeof(ADDR_COPY_DEPTH_PLANE)),
+      };
+
+      mTrace->Record(ADDR_STATS_COPY_LINEAR_TO_DEPTH_PLANES, traceStart, returnCode, segments, sizeof(segments) / sizeof(segments[0]));
+   }
+
    return returnCode;
 }
@@ -35,6 +35,45 @@
 #include "addrlib/addrinterface.h"
 #include "addrobject.h"
 #include "addrelemlib.h"
+#include "addrmicrotile.h"
+#include "addrsurfacecache.h"
+#include "addrsurfaceplan.h"
+#include "addrstats.h"
+#include "addrtrace.h"
+
+
+/**
+***************************************************************************************************
+* @brief Layout of per tile data (HTILE and CMASK) of a surface. Every 8x8 tile has an entry,
+*        macro tiles of entries are stored in row-major order and within a macro tile each pipe
+*        stores every pipes-th row of tiles, the rows of a pipe packed together. The data of the
+*        pipes is then interleaved every pipeInterleaveBytes.
+***************************************************************************************************
+*/
+struct AddrTileDataLayout
+{
+   // Padded surface dimensions, in pixels
+   uint32_t pitch;
+   uint32_t height;
+   uint32_t numSlices;
+
+   uint32_t entryBits;
+   uint32_t pipes;
+   uint32_t pipeInterleaveBytes;
+
+   // Macro tile dimensions, in tiles
+   uint32_t macroTileColumns;
+   uint32_t macroTileRows;
+   uint32_t macroTilesPerRow;
+   uint32_t macroTilesPerColumn;
+
+   // Entries each pipe stores per macro tile and per slice
+   uint64_t macroTileEntries;
+   uint64_t sliceEntries;
+
+   // Row within a group of pipes rows of tiles stored by each pipe, [tile x % 8][pipe]
+   uint8_t pipeRow[8][8];
+};
 
 
 /**
@@ -45,18 +84,30 @@
 class AddrLib : public AddrObject
 {
 public:
-   AddrLib(ADDR_CLIENT_HANDLE hClient);
+   AddrLib(const AddrClient *pClient);
    virtual ~AddrLib() = default;
 
    static ADDR_E_RETURNCODE
    Create(const ADDR_CREATE_INPUT *pCreateIn, ADDR_CREATE_OUTPUT *pCreateOut);
 
+   static ADDR_E_RETURNCODE
+   GetInstanceSize(const ADDR_CREATE_INPUT *pCreateIn, ADDR_GET_INSTANCE_SIZE_OUTPUT *pOut);
+
+   static ADDR_E_RETURNCODE
+   CreateInPlace(const ADDR_CREATE_INPUT *pCreateIn,
+                 void *pStorage,
+                 uint64_t storageSize,
+                 ADDR_CREATE_OUTPUT *pCreateOut);
+
    static AddrLib *
    GetAddrLib(ADDR_HANDLE hLib);
 
    void
    Destroy();
 
+   ADDR_E_RETURNCODE
+   DestroyInPlace();
+
    AddrChipFamily
    GetAddrChipFamily();
 
@@ -99,6 +150,33 @@ public:
    ComputeSurfaceInfo(ADDR_COMPUTE_SURFACE_INFO_INPUT *pIn,
                       ADDR_COMPUTE_SURFACE_INFO_OUTPUT *pOut) const;
 
+   ADDR_E_RETURNCODE
+   ComputeSurfaceInfoLevel(ADDR_COMPUTE_SURFACE_INFO_INPUT *pIn,
+                           ADDR_COMPUTE_SURFACE_INFO_OUTPUT *pOut,
+                           AddrElemMode elemMode,
+                           uint32_t elemBpp,
+                           uint32_t expandX,
+                           uint32_t expandY) const;
+
+   ADDR_E_RETURNCODE
+   ComputeMipChainInfo(const ADDR_COMPUTE_MIPCHAIN_INFO_INPUT *pIn,
+                       ADDR_COMPUTE_MIPCHAIN_INFO_OUTPUT *pOut) const;
+
+   ADDR_E_RETURNCODE
+   GetSurfaceInfoCacheStats(ADDR_GET_SURFACE_INFO_CACHE_STATS_OUTPUT *pOut) const;
+
+   ADDR_E_RETURNCODE
+   GetStats(ADDR_GET_STATS_OUTPUT *pOut) const;
+
+   ADDR_E_RETURNCODE
+   ResetStats();
+
+   ADDR_E_RETURNCODE
+   StartTrace(const ADDR_START_TRACE_INPUT *pIn);
+
+   ADDR_E_RETURNCODE
+   StopTrace();
+
    uint64_t
    ComputeSurfaceAddrFromCoordLinear(uint32_t x,
                                      uint32_t y,
@@ -110,6 +188,28 @@ public:
                                      uint32_t numSlices,
                                      uint32_t *pBitPosition) const;
 
+   static uint32_t
+   ComputePixelIndexBits(uint32_t x,
+                         uint32_t y,
+                         uint32_t z,
+                         uint32_t bpp,
+                         uint32_t thickness,
+                         AddrTileType tileType);
+
+   void
+   InitPixelIndexTables();
+
+   const uint16_t *
+   GetPixelIndexTable(uint32_t z,
+                      uint32_t bpp,
+                      AddrTileMode tileMode,
+                      AddrTileType tileType) const;
+
+   const uint16_t *
+   GetPixelCoordTable(uint32_t bpp,
+                      AddrTileMode tileMode,
+                      AddrTileType tileType) const;
+
    uint32_t
    ComputePixelIndexWithinMicroTile(uint32_t x,
                                     uint32_t y,
@@ -118,10 +218,45 @@ public:
                                     AddrTileMode tileMode,
                                     AddrTileType tileType) const;
 
+   AddrMicroTileKernel
+   GetMicroTileKernel(uint32_t bpp,
+                      AddrTileType tileType,
+                      bool tiledToLinear) const;
+
+   void
+   SetupMicroTileKernels(uint32_t cpuFeatures);
+
+   ADDR_E_RETURNCODE
+   ComputePixelIndexTable(const ADDR_COMPUTE_PIXEL_INDEX_TABLE_INPUT *pIn,
+                          ADDR_COMPUTE_PIXEL_INDEX_TABLE_OUTPUT *pOut) const;
+
    ADDR_E_RETURNCODE
    ComputeSurfaceAddrFromCoord(const ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_INPUT *pIn,
                                ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_OUTPUT *pOut) const;
 
+   ADDR_E_RETURNCODE
+   ComputeSurfaceAddrFromCoordBatch(const ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_INPUT *pIn,
+                                    ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_OUTPUT *pOut) const;
+
+   ADDR_E_RETURNCODE
+   CreateSurfacePlan(const ADDR_CREATE_SURFACE_PLAN_INPUT *pIn,
+                     ADDR_CREATE_SURFACE_PLAN_OUTPUT *pOut) const;
+
+   ADDR_E_RETURNCODE
+   DestroySurfacePlan(ADDR_SURFACE_PLAN hPlan) const;
+
+   ADDR_E_RETURNCODE
+   ComputeSurfaceCoordFromAddr(const ADDR_COMPUTE_SURFACE_COORDFROMADDR_INPUT *pIn,
+                               ADDR_COMPUTE_SURFACE_COORDFROMADDR_OUTPUT *pOut) const;
+
+   ADDR_E_RETURNCODE
+   ComputeSurfaceCoordFromAddrRange(const ADDR_COMPUTE_SURFACE_COORDFROMADDR_RANGE_INPUT *pIn,
+                                    ADDR_COMPUTE_SURFACE_COORDFROMADDR_RANGE_OUTPUT *pOut) const;
+
+   ADDR_E_RETURNCODE
+   ComputeSurfaceDirtyRegions(const ADDR_COMPUTE_SURFACE_DIRTY_REGIONS_INPUT *pIn,
+                              ADDR_COMPUTE_SURFACE_DIRTY_REGIONS_OUTPUT *pOut) const;
+
    ADDR_E_RETURNCODE
    ExtractBankPipeSwizzle(const ADDR_EXTRACT_BANKPIPE_SWIZZLE_INPUT *pIn,
                           ADDR_EXTRACT_BANKPIPE_SWIZZLE_OUTPUT *pOut) const;
@@ -153,10 +288,145 @@ public:
    ComputeHtileInfo(const ADDR_COMPUTE_HTILE_INFO_INPUT *pIn,
                      ADDR_COMPUTE_HTILE_INFO_OUTPUT *pOut) const;
 
+   void
+   ComputeTileDataLayout(uint32_t pitch,
+                         uint32_t height,
+                         uint32_t numSlices,
+                         uint32_t entryBits,
+                         uint32_t macroWidth,
+                         uint32_t macroHeight,
+                         ADDR_TILEINFO *pTileInfo,
+                         AddrTileDataLayout *pLayout) const;
+
+   uint64_t
+   ComputeTileDataAddrFromCoord(const AddrTileDataLayout *pLayout,
+                                uint32_t x,
+                                uint32_t y,
+                                uint32_t slice,
+                                uint32_t *pBitPosition) const;
+
+   void
+   CopyTileData(const AddrTileDataLayout *pLayout,
+                uint8_t *pTileData,
+                uint8_t *pLinear,
+                uint32_t linearPitch,
+                uint64_t linearSliceSize,
+                const ADDR_COPY_REGION *pTileRegion,
+                bool toLinear) const;
+
+   ADDR_E_RETURNCODE
+   ComputeHtileLayout(uint32_t pitch,
+                      uint32_t height,
+                      uint32_t numSlices,
+                      bool isLinear,
+                      AddrHtileBlockSize blockWidth,
+                      AddrHtileBlockSize blockHeight,
+                      ADDR_TILEINFO *pTileInfo,
+                      AddrTileDataLayout *pLayout) const;
+
+   ADDR_E_RETURNCODE
+   ComputeHtileAddrFromCoord(const ADDR_COMPUTE_HTILE_ADDRFROMCOORD_INPUT *pIn,
+                             ADDR_COMPUTE_HTILE_ADDRFROMCOORD_OUTPUT *pOut) const;
+
+   ADDR_E_RETURNCODE
+   CopyHtile(const ADDR_COPY_HTILE_INPUT *pIn,
+             bool toLinear) const;
+
+   ADDR_E_RETURNCODE
+   CopyHtileToLinear(const ADDR_COPY_HTILE_INPUT *pIn) const;
+
+   ADDR_E_RETURNCODE
+   CopyLinearToHtile(const ADDR_COPY_HTILE_INPUT *pIn) const;
+
+   ADDR_E_RETURNCODE
+   ComputeFmaskSurfaceInfo(AddrTileMode tileMode,
+                           uint32_t pitch,
+                           uint32_t height,
+                           uint32_t numSlices,
+                           uint32_t numSamples,
+                           uint32_t numFrags,
+                           ADDR_TILEINFO *pTileInfo,
+                           ADDR_COMPUTE_SURFACE_INFO_OUTPUT *pSurfOut,
+                           uint32_t *pBitsPerSample) const;
+
+   ADDR_E_RETURNCODE
+   ComputeFmaskInfo(const ADDR_COMPUTE_FMASK_INFO_INPUT *pIn,
+                    ADDR_COMPUTE_FMASK_INFO_OUTPUT *pOut) const;
+
+   ADDR_E_RETURNCODE
+   ComputeFmaskAddrFromCoord(const ADDR_COMPUTE_FMASK_ADDRFROMCOORD_INPUT *pIn,
+                             ADDR_COMPUTE_FMASK_ADDRFROMCOORD_OUTPUT *pOut) const;
+
+   ADDR_E_RETURNCODE
+   ComputeFmaskAddrFromCoordBatch(const ADDR_COMPUTE_FMASK_ADDRFROMCOORD_BATCH_INPUT *pIn,
+                                  ADDR_COMPUTE_FMASK_ADDRFROMCOORD_BATCH_OUTPUT *pOut) const;
+
+   ADDR_E_RETURNCODE
+   CopyFmask(const ADDR_COPY_FMASK_INPUT *pIn,
+             bool toLinear) const;
+
+   ADDR_E_RETURNCODE
+   CopyFmaskToLinear(const ADDR_COPY_FMASK_INPUT *pIn) const;
+
+   ADDR_E_RETURNCODE
+   CopyLinearToFmask(const ADDR_COPY_FMASK_INPUT *pIn) const;
+
+   void
+   ComputeCmaskInfo(uint32_t pitchIn,
+                    uint32_t heightIn,
+                    uint32_t numSlices,
+                    bool isLinear,
+                    ADDR_TILEINFO *pTileInfo,
+                    uint32_t *pPitchOut,
+                    uint32_t *pHeightOut,
+                    uint64_t *pCmaskBytes,
+                    uint32_t *pMacroWidth,
+                    uint32_t *pMacroHeight,
+                    uint32_t *pBaseAlign,
+                    uint32_t *pBlockMax) const;
+
+   ADDR_E_RETURNCODE
+   ComputeCmaskInfo(const ADDR_COMPUTE_CMASK_INFO_INPUT *pIn,
+                    ADDR_COMPUTE_CMASK_INFO_OUTPUT *pOut) const;
+
+   ADDR_E_RETURNCODE
+   ComputeCmaskLayout(uint32_t pitch,
+                      uint32_t height,
+                      uint32_t numSlices,
+                      bool isLinear,
+                      ADDR_TILEINFO *pTileInfo,
+                      AddrTileDataLayout *pLayout) const;
+
+   ADDR_E_RETURNCODE
+   ComputeCmaskAddrFromCoord(const ADDR_COMPUTE_CMASK_ADDRFROMCOORD_INPUT *pIn,
+                             ADDR_COMPUTE_CMASK_ADDRFROMCOORD_OUTPUT *pOut) const;
+
+   ADDR_E_RETURNCODE
+   CopyCmask(const ADDR_COPY_CMASK_INPUT *pIn,
+             bool toLinear) const;
+
+   ADDR_E_RETURNCODE
+   CopyCmaskToLinear(const ADDR_COPY_CMASK_INPUT *pIn) const;
+
+   ADDR_E_RETURNCODE
+   CopyLinearToCmask(const ADDR_COPY_CMASK_INPUT *pIn) const;
+
    ADDR_E_RETURNCODE
    ComputeSliceTileSwizzle(const ADDR_COMPUTE_SLICESWIZZLE_INPUT *pIn,
                            ADDR_COMPUTE_SLICESWIZZLE_OUTPUT *pOut) const;
 
+   ADDR_E_RETURNCODE
+   CopySurfaceTiledToLinear(const ADDR_COPY_SURFACE_INPUT *pIn) const;
+
+   ADDR_E_RETURNCODE
+   CopySurfaceLinearToTiled(const ADDR_COPY_SURFACE_INPUT *pIn) const;
+
+   ADDR_E_RETURNCODE
+   CopyDepthPlanesToLinear(const ADDR_COPY_DEPTH_PLANES_INPUT *pIn) const;
+
+   ADDR_E_RETURNCODE
+   CopyLinearToDepthPlanes(const ADDR_COPY_DEPTH_PLANES_INPUT *pIn) const;
+
    virtual bool
    ComputeQbStereoInfo(ADDR_COMPUTE_SURFACE_INFO_OUTPUT *pOut) const;
 
@@ -183,6 +453,26 @@ public:
    HwlComputeSurfaceAddrFromCoord(const ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_INPUT *pIn,
                                   ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_OUTPUT *pOut) const = 0;
 
+   virtual ADDR_E_RETURNCODE
+   HwlComputeSurfaceAddrFromCoordBatch(const ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_INPUT *pIn,
+                                       ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_OUTPUT *pOut) const = 0;
+
+   virtual ADDR_E_RETURNCODE
+   HwlCreateSurfacePlan(const ADDR_CREATE_SURFACE_PLAN_INPUT *pIn,
+                        AddrSurfacePlan **ppPlan) const = 0;
+
+   virtual ADDR_E_RETURNCODE
+   HwlComputeSurfaceCoordFromAddr(const ADDR_COMPUTE_SURFACE_COORDFROMADDR_INPUT *pIn,
+                                  ADDR_COMPUTE_SURFACE_COORDFROMADDR_OUTPUT *pOut) const = 0;
+
+   virtual ADDR_E_RETURNCODE
+   HwlComputeSurfaceCoordFromAddrRange(const ADDR_COMPUTE_SURFACE_COORDFROMADDR_RANGE_INPUT *pIn,
+                                       ADDR_COMPUTE_SURFACE_COORDFROMADDR_RANGE_OUTPUT *pOut) const = 0;
+
+   virtual ADDR_E_RETURNCODE
+   HwlComputeSurfaceDirtyRegions(const ADDR_COMPUTE_SURFACE_DIRTY_REGIONS_INPUT *pIn,
+                                 ADDR_COMPUTE_SURFACE_DIRTY_REGIONS_OUTPUT *pOut) const = 0;
+
    virtual ADDR_E_RETURNCODE
    HwlSetupTileCfg(int32_t index,
                    ADDR_TILEINFO *pInfo,
@@ -213,10 +503,60 @@ public:
                         uint32_t numSlices,
                         uint32_t baseAlign) const = 0;
 
+   virtual uint32_t
+   HwlComputePipeFromCoord(uint32_t x,
+                           uint32_t y) const = 0;
+
+   virtual uint32_t
+   HwlComputeFmaskBits(uint32_t numSamples,
+                       uint32_t numFrags,
+                       uint32_t *pBitsPerSample) const = 0;
+
    virtual ADDR_E_RETURNCODE
    HwlComputeSliceTileSwizzle(const ADDR_COMPUTE_SLICESWIZZLE_INPUT *pIn,
                               ADDR_COMPUTE_SLICESWIZZLE_OUTPUT *pOut) const = 0;
 
+   virtual ADDR_E_RETURNCODE
+   HwlCopySurfaceTiledToLinear(const ADDR_COPY_SURFACE_INPUT *pIn) const = 0;
+
+   virtual ADDR_E_RETURNCODE
+   HwlCopySurfaceLinearToTiled(const ADDR_COPY_SURFACE_INPUT *pIn) const = 0;
+
+   virtual ADDR_E_RETURNCODE
+   HwlCopyDepthPlanesToLinear(const ADDR_COPY_DEPTH_PLANES_INPUT *pIn) const = 0;
+
+   virtual ADDR_E_RETURNCODE
+   HwlCopyLinearToDepthPlanes(const ADDR_COPY_DEPTH_PLANES_INPUT *pIn) const = 0;
+
+   virtual uint64_t
+   HwlVerifyLookupTables(uint64_t *pNumChecks,
+                         uint32_t *pFirstX,
+                         uint32_t *pFirstY) const = 0;
+
+private:
+   static uint64_t
+   GetInstanceLayout(const ADDR_CREATE_INPUT *pCreateIn,
+                     uint64_t *pElemLibOffset,
+                     uint64_t *pSurfaceInfoCacheOffset,
+                     uint64_t *pStatsOffset);
+
+   static ADDR_E_RETURNCODE
+   CreateLib(const ADDR_CREATE_INPUT *pCreateIn,
+             uint8_t *pStorage,
+             ADDR_CREATE_OUTPUT *pCreateOut);
+
+protected:
+   // Counters of the calling thread, nullptr unless created with createFlags.collectStats
+   AddrStats *
+   GetStatsCounters() const
+   {
+#ifdef ADDR_STATS
+      return mStats;
+#else
+      return nullptr;
+#endif
+   }
+
 protected:
    AddrLibClass mClass;
    AddrChipFamily mChipFamily;
@@ -224,13 +564,37 @@ protected:
    uint32_t mVersion;
    ADDR_CONFIG_FLAGS mConfigFlags;
 
+   // Created by AddrCreateInPlace, the objects live in client storage and are never freed
+   bool mInPlace;
+
    AddrElemLib *mElemLib;
+   AddrSurfaceInfoCache *mSurfaceInfoCache;
+   AddrStats *mStats;
+
+   // Recorder of AddrStartTrace, and the creation input its streams start with
+   AddrTrace *mTrace;
+   ADDR_CREATE_INPUT mCreateInput;
 
    uint32_t mPipes;
    uint32_t mBanks;
    uint32_t mPipeInterleaveBytes;
    uint32_t mRowSize;
+
+   uint32_t mCpuFeatures;
+   AddrMicroTileKernels mMicroTileKernels;
+
+   // Pixel index of every (x, y, z) of a micro tile, [order][thickness][z * 64 + y * 8 + x]
+   uint16_t mPixelIndexTable[MicroTilePixelOrders][MicroTileThicknessModes][MicroTileVolumePixels];
+
+   // Inverse of mPixelIndexTable, x | (y << 3) | (z << 6) of every pixel index, lowest z first
+   uint16_t mPixelCoordTable[MicroTilePixelOrders][MicroTileThicknessModes][MicroTileVolumePixels];
 };
 
 AddrLib *
-AddrR600HwlInit(ADDR_CLIENT_HANDLE hClient);
+AddrR600HwlInit(const AddrClient *pClient, void *pMemory);
+
+uint64_t
+AddrR600GetInstanceSize();
+
+uint32_t
+AddrR600GetTilingConfigs(uint32_t *pConfigs);
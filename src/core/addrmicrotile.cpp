@@ -0,0 +1,718 @@
+/*
+ * Copyright  2014 Advanced Micro Devices, Inc.
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sub license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON-INFRINGEMENT. IN NO EVENT SHALL THE COPYRIGHT HOLDERS, AUTHORS
+ * AND/OR ITS SUPPLIERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ */
+
+/**
+***************************************************************************************************
+* @file  addrmicrotile.cpp
+* @brief Contains the SSE2 / AVX2 / AVX-512 micro tile copy kernels.
+*
+*        The kernels move a whole micro tile of one pixel order, the orders being the displayable
+*        8, 16, 32, 64 and 128 bpp orders (0 - 4) and the non displayable order (5) of
+*        AddrLib::ComputePixelIndexBits. The thick order and partial micro tiles are left to the
+*        generic per element copy.
+***************************************************************************************************
+*/
+
+#include <cstring>
+#include "addrmicrotile.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define ADDR_X86_KERNELS 1
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define ADDR_TARGET(features)
+#else
+#include <cpuid.h>
+#define ADDR_TARGET(features) __attribute__((target(features)))
+#endif
+#endif
+
+
+/**
+***************************************************************************************************
+*   AddrDetectCpuFeatures
+*
+*   @brief
+*       Detects which of the vector instruction sets used by the micro tile kernels the CPU and
+*       the OS support
+*
+*   @return
+*       Mask of AddrCpuFeature
+***************************************************************************************************
+*/
+uint32_t
+AddrDetectCpuFeatures()
+{
+   uint32_t features = 0;
+
+#ifdef ADDR_X86_KERNELS
+   uint32_t regs[4] = { 0, 0, 0, 0 };
+   uint32_t maxLeaf = 0;
+   uint64_t xcr0 = 0;
+
+#ifdef _MSC_VER
+   int info[4];
+   __cpuid(info, 0);
+   maxLeaf = static_cast<uint32_t>(info[0]);
+   __cpuid(info, 1);
+   std::memcpy(regs, info, sizeof(regs));
+#else
+   maxLeaf = __get_cpuid_max(0, nullptr);
+   __cpuid(1, regs[0], regs[1], regs[2], regs[3]);
+#endif
+
+   if (regs[3] & (1u << 26)) {
+      features |= ADDR_CPU_SSE2;
+   }
+
+   // The OS has to save the ymm / zmm state before AVX2 or AVX-512 can be used
+   if ((regs[2] & (1u << 27)) && (regs[2] & (1u << 28))) {
+#ifdef _MSC_VER
+      xcr0 = _xgetbv(0);
+#else
+      uint32_t xcr0Lo, xcr0Hi;
+      __asm__ ("xgetbv" : "=a"(xcr0Lo), "=d"(xcr0Hi) : "c"(0));
+      xcr0 = (static_cast<uint64_t>(xcr0Hi) << 32) | xcr0Lo;
+#endif
+   }
+
+   if (maxLeaf >= 7) {
+#ifdef _MSC_VER
+      __cpuidex(info, 7, 0);
+      std::memcpy(regs, info, sizeof(regs));
+#else
+      __cpuid_count(7, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+
+      if ((regs[1] & (1u << 5)) && (xcr0 & 0x6) == 0x6) {
+         features |= ADDR_CPU_AVX2;
+      }
+
+      if ((regs[1] & (1u << 16)) && (xcr0 & 0xE6) == 0xE6) {
+         features |= ADDR_CPU_AVX512;
+      }
+   }
+#endif
+
+   return features;
+}
+
+#ifdef ADDR_X86_KERNELS
+
+ADDR_TARGET("sse2") static inline __m128i
+Load128(const uint8_t *p)
+{
+   return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+}
+
+ADDR_TARGET("sse2") static inline void
+Store128(uint8_t *p, __m128i v)
+{
+   _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v);
+}
+
+ADDR_TARGET("sse2") static inline __m128i
+Load64(const uint8_t *p)
+{
+   return _mm_loadl_epi64(reinterpret_cast<const __m128i *>(p));
+}
+
+ADDR_TARGET("sse2") static inline void
+Store64(uint8_t *p, __m128i v)
+{
+   _mm_storel_epi64(reinterpret_cast<__m128i *>(p), v);
+}
+
+template<bool Untile>
+ADDR_TARGET("sse2") static inline void
+Move128(uint8_t *pTile, uint8_t *pLinear)
+{
+   if (Untile) {
+      Store128(pLinear, Load128(pTile));
+   } else {
+      Store128(pTile, Load128(pLinear));
+   }
+}
+
+ADDR_TARGET("avx2") static inline __m256i
+Load256(const uint8_t *p)
+{
+   return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+}
+
+ADDR_TARGET("avx2") static inline void
+Store256(uint8_t *p, __m256i v)
+{
+   _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v);
+}
+
+ADDR_TARGET("avx512f") static inline __m512i
+Load512(const void *p)
+{
+   return _mm512_loadu_si512(p);
+}
+
+ADDR_TARGET("avx512f") static inline void
+Store512(uint8_t *p, __m512i v)
+{
+   _mm512_storeu_si512(p, v);
+}
+
+// The zero masked forms are used as the unmasked ones start from an undefined register,
+// which GCC 12 reports as an uninitialized use
+ADDR_TARGET("avx512f") static inline __m512i
+Load256Pair(const uint8_t *pLow, const uint8_t *pHigh)
+{
+   auto low = _mm512_maskz_inserti64x4(0xFF, _mm512_setzero_si512(), Load256(pLow), 0);
+   return _mm512_maskz_inserti64x4(0xFF, low, Load256(pHigh), 1);
+}
+
+ADDR_TARGET("avx512f") static inline void
+Store256Pair(uint8_t *pLow, uint8_t *pHigh, __m512i v)
+{
+   Store256(pLow, _mm512_maskz_extracti64x4_epi64(0xF, v, 0));
+   Store256(pHigh, _mm512_maskz_extracti64x4_epi64(0xF, v, 1));
+}
+
+
+/**
+***************************************************************************************************
+*   MicroTileD8Sse2
+*
+*   @brief
+*       Displayable 8 bpp: each row is 8 contiguous bytes, rows y and y + 2 share 16 bytes
+***************************************************************************************************
+*/
+template<bool Untile>
+ADDR_TARGET("sse2") static void
+MicroTileD8Sse2(uint8_t *pTile, uint8_t *pLinear, uint32_t linearPitch)
+{
+   for (auto i = 0u; i < 4; ++i) {
+      auto y = (i & 1) + (i >> 1) * 4;
+      auto pRow0 = pLinear + y * linearPitch;
+      auto pRow2 = pRow0 + 2 * linearPitch;
+
+      if (Untile) {
+         auto v = Load128(pTile + i * 16);
+         Store64(pRow0, v);
+         Store64(pRow2, _mm_unpackhi_epi64(v, v));
+      } else {
+         Store128(pTile + i * 16, _mm_unpacklo_epi64(Load64(pRow0), Load64(pRow2)));
+      }
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   MicroTileD16Sse2
+*
+*   @brief
+*       Displayable 16 bpp: the micro tile is stored in row order
+***************************************************************************************************
+*/
+template<bool Untile>
+ADDR_TARGET("sse2") static void
+MicroTileD16Sse2(uint8_t *pTile, uint8_t *pLinear, uint32_t linearPitch)
+{
+   for (auto y = 0u; y < MicroTileHeight; ++y) {
+      Move128<Untile>(pTile + y * 16, pLinear + y * linearPitch);
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   MicroTileDRowPairSse2
+*
+*   @brief
+*       Displayable 32, 64 and 128 bpp: rows y and y + 1 are stored as a PairBytes block which
+*       alternates 16 bytes of the even row and 16 bytes of the odd row
+***************************************************************************************************
+*/
+template<uint32_t PairBytes, bool Untile>
+ADDR_TARGET("sse2") static void
+MicroTileDRowPairSse2(uint8_t *pTile, uint8_t *pLinear, uint32_t linearPitch)
+{
+   for (auto y = 0u; y < MicroTileHeight; ++y) {
+      auto pPair = pTile + (y >> 1) * PairBytes + (y & 1) * 16;
+      auto pRow = pLinear + y * linearPitch;
+
+      for (auto j = 0u; j < PairBytes / 32; ++j) {
+         Move128<Untile>(pPair + j * 32, pRow + j * 16);
+      }
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   MicroTileND8Sse2
+*
+*   @brief
+*       Non displayable 8 bpp: each 16 bytes hold a 4x4 block in (x0, y0, x1, y1) order
+***************************************************************************************************
+*/
+template<bool Untile>
+ADDR_TARGET("sse2") static void
+MicroTileND8Sse2(uint8_t *pTile, uint8_t *pLinear, uint32_t linearPitch)
+{
+   for (auto y2 = 0u; y2 < 2; ++y2) {
+      auto pBlock = pTile + y2 * 32;
+      auto pRow0 = pLinear + y2 * 4 * linearPitch;
+      auto pRow1 = pRow0 + linearPitch;
+      auto pRow2 = pRow1 + linearPitch;
+      auto pRow3 = pRow2 + linearPitch;
+
+      if (Untile) {
+         // Gather each block into 4 rows of 4 bytes, then join the x2 = 0 and x2 = 1 halves
+         auto a = Load128(pBlock);
+         auto b = Load128(pBlock + 16);
+         a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(a, 0xD8), 0xD8);
+         b = _mm_shufflehi_epi16(_mm_shufflelo_epi16(b, 0xD8), 0xD8);
+
+         auto rows01 = _mm_unpacklo_epi32(a, b);
+         auto rows23 = _mm_unpackhi_epi32(a, b);
+         Store64(pRow0, rows01);
+         Store64(pRow1, _mm_unpackhi_epi64(rows01, rows01));
+         Store64(pRow2, rows23);
+         Store64(pRow3, _mm_unpackhi_epi64(rows23, rows23));
+      } else {
+         auto rows01 = _mm_shuffle_epi32(_mm_unpacklo_epi64(Load64(pRow0), Load64(pRow1)), 0xD8);
+         auto rows23 = _mm_shuffle_epi32(_mm_unpacklo_epi64(Load64(pRow2), Load64(pRow3)), 0xD8);
+         auto a = _mm_unpacklo_epi64(rows01, rows23);
+         auto b = _mm_unpackhi_epi64(rows01, rows23);
+         Store128(pBlock, _mm_shufflehi_epi16(_mm_shufflelo_epi16(a, 0xD8), 0xD8));
+         Store128(pBlock + 16, _mm_shufflehi_epi16(_mm_shufflelo_epi16(b, 0xD8), 0xD8));
+      }
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   MicroTileND16Sse2
+*
+*   @brief
+*       Non displayable 16 bpp: each 16 bytes hold a 4x2 block in (x0, y0, x1) order
+***************************************************************************************************
+*/
+template<bool Untile>
+ADDR_TARGET("sse2") static void
+MicroTileND16Sse2(uint8_t *pTile, uint8_t *pLinear, uint32_t linearPitch)
+{
+   for (auto i = 0u; i < 4; ++i) {
+      // i is (y1, y2), the x2 = 1 block follows 32 bytes after the x2 = 0 block
+      auto pBlock = pTile + ((i & 1) + (i >> 1) * 4) * 16;
+      auto pRow0 = pLinear + i * 2 * linearPitch;
+      auto pRow1 = pRow0 + linearPitch;
+
+      if (Untile) {
+         auto a = _mm_shuffle_epi32(Load128(pBlock), 0xD8);
+         auto b = _mm_shuffle_epi32(Load128(pBlock + 32), 0xD8);
+         Store128(pRow0, _mm_unpacklo_epi64(a, b));
+         Store128(pRow1, _mm_unpackhi_epi64(a, b));
+      } else {
+         auto row0 = Load128(pRow0);
+         auto row1 = Load128(pRow1);
+         Store128(pBlock, _mm_shuffle_epi32(_mm_unpacklo_epi64(row0, row1), 0xD8));
+         Store128(pBlock + 32, _mm_shuffle_epi32(_mm_unpackhi_epi64(row0, row1), 0xD8));
+      }
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   MicroTileND32Sse2
+*
+*   @brief
+*       Non displayable 32 bpp: each 16 bytes hold a 2x2 block
+***************************************************************************************************
+*/
+template<bool Untile>
+ADDR_TARGET("sse2") static void
+MicroTileND32Sse2(uint8_t *pTile, uint8_t *pLinear, uint32_t linearPitch)
+{
+   for (auto i = 0u; i < 4; ++i) {
+      // i is (y1, y2), blocks are ordered (x1, y1, x2, y2)
+      auto pBlock = pTile + ((i & 1) * 2 + (i >> 1) * 8) * 16;
+      auto pRow0 = pLinear + i * 2 * linearPitch;
+      auto pRow1 = pRow0 + linearPitch;
+
+      for (auto x2 = 0u; x2 < 2; ++x2) {
+         auto pBlocks = pBlock + x2 * 64;
+
+         if (Untile) {
+            auto a = Load128(pBlocks);
+            auto b = Load128(pBlocks + 16);
+            Store128(pRow0 + x2 * 16, _mm_unpacklo_epi64(a, b));
+            Store128(pRow1 + x2 * 16, _mm_unpackhi_epi64(a, b));
+         } else {
+            auto row0 = Load128(pRow0 + x2 * 16);
+            auto row1 = Load128(pRow1 + x2 * 16);
+            Store128(pBlocks, _mm_unpacklo_epi64(row0, row1));
+            Store128(pBlocks + 16, _mm_unpackhi_epi64(row0, row1));
+         }
+      }
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   MicroTileND64Sse2
+*
+*   @brief
+*       Non displayable 64 bpp: each 16 bytes hold an x0 pair of one row
+***************************************************************************************************
+*/
+template<bool Untile>
+ADDR_TARGET("sse2") static void
+MicroTileND64Sse2(uint8_t *pTile, uint8_t *pLinear, uint32_t linearPitch)
+{
+   for (auto y = 0u; y < MicroTileHeight; ++y) {
+      auto pRow = pLinear + y * linearPitch;
+
+      for (auto k = 0u; k < 4; ++k) {
+         auto elem = (_BIT(y, 0) << 1) | (_BIT(k, 0) << 2) | (_BIT(y, 1) << 3) | (_BIT(k, 1) << 4) | (_BIT(y, 2) << 5);
+         Move128<Untile>(pTile + elem * 8, pRow + k * 16);
+      }
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   MicroTileND128Sse2
+*
+*   @brief
+*       Non displayable 128 bpp: each 16 bytes hold one element
+***************************************************************************************************
+*/
+template<bool Untile>
+ADDR_TARGET("sse2") static void
+MicroTileND128Sse2(uint8_t *pTile, uint8_t *pLinear, uint32_t linearPitch)
+{
+   for (auto y = 0u; y < MicroTileHeight; ++y) {
+      auto pRow = pLinear + y * linearPitch;
+
+      for (auto x = 0u; x < MicroTileWidth; ++x) {
+         auto elem = _BIT(x, 0) | (_BIT(y, 0) << 1) | (_BIT(x, 1) << 2) | (_BIT(y, 1) << 3) | (_BIT(x, 2) << 4) | (_BIT(y, 2) << 5);
+         Move128<Untile>(pTile + elem * 16, pRow + x * 16);
+      }
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   MicroTileDRowPairAvx2
+*
+*   @brief
+*       AVX2 version of MicroTileDRowPairSse2, 32 bytes of the even and odd rows are split out
+*       of each 64 bytes of the row pair block
+***************************************************************************************************
+*/
+template<uint32_t PairBytes, bool Untile>
+ADDR_TARGET("avx2") static void
+MicroTileDRowPairAvx2(uint8_t *pTile, uint8_t *pLinear, uint32_t linearPitch)
+{
+   for (auto p = 0u; p < MicroTileHeight / 2; ++p) {
+      auto pPair = pTile + p * PairBytes;
+      auto pEven = pLinear + p * 2 * linearPitch;
+      auto pOdd = pEven + linearPitch;
+
+      for (auto j = 0u; j < PairBytes / 64; ++j) {
+         if (Untile) {
+            auto a = Load256(pPair + j * 64);
+            auto b = Load256(pPair + j * 64 + 32);
+            Store256(pEven + j * 32, _mm256_permute2x128_si256(a, b, 0x20));
+            Store256(pOdd + j * 32, _mm256_permute2x128_si256(a, b, 0x31));
+         } else {
+            auto even = Load256(pEven + j * 32);
+            auto odd = Load256(pOdd + j * 32);
+            Store256(pPair + j * 64, _mm256_permute2x128_si256(even, odd, 0x20));
+            Store256(pPair + j * 64 + 32, _mm256_permute2x128_si256(even, odd, 0x31));
+         }
+      }
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   MicroTileND16Avx2
+*
+*   @brief
+*       AVX2 version of MicroTileND16Sse2, handles the y1 = 0 and y1 = 1 blocks together
+***************************************************************************************************
+*/
+template<bool Untile>
+ADDR_TARGET("avx2") static void
+MicroTileND16Avx2(uint8_t *pTile, uint8_t *pLinear, uint32_t linearPitch)
+{
+   for (auto y2 = 0u; y2 < 2; ++y2) {
+      auto pBlock = pTile + y2 * 64;
+      auto pRow0 = pLinear + y2 * 4 * linearPitch;
+      auto pRow1 = pRow0 + linearPitch;
+      auto pRow2 = pRow1 + linearPitch;
+      auto pRow3 = pRow2 + linearPitch;
+
+      if (Untile) {
+         auto a = _mm256_shuffle_epi32(Load256(pBlock), 0xD8);
+         auto b = _mm256_shuffle_epi32(Load256(pBlock + 32), 0xD8);
+         auto rows02 = _mm256_unpacklo_epi64(a, b);
+         auto rows13 = _mm256_unpackhi_epi64(a, b);
+         Store128(pRow0, _mm256_castsi256_si128(rows02));
+         Store128(pRow1, _mm256_castsi256_si128(rows13));
+         Store128(pRow2, _mm256_extracti128_si256(rows02, 1));
+         Store128(pRow3, _mm256_extracti128_si256(rows13, 1));
+      } else {
+         auto rows02 = _mm256_inserti128_si256(_mm256_castsi128_si256(Load128(pRow0)), Load128(pRow2), 1);
+         auto rows13 = _mm256_inserti128_si256(_mm256_castsi128_si256(Load128(pRow1)), Load128(pRow3), 1);
+         Store256(pBlock, _mm256_shuffle_epi32(_mm256_unpacklo_epi64(rows02, rows13), 0xD8));
+         Store256(pBlock + 32, _mm256_shuffle_epi32(_mm256_unpackhi_epi64(rows02, rows13), 0xD8));
+      }
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   MicroTileND32Avx2
+*
+*   @brief
+*       AVX2 version of MicroTileND32Sse2, handles a full 8 element row pair at once
+***************************************************************************************************
+*/
+template<bool Untile>
+ADDR_TARGET("avx2") static void
+MicroTileND32Avx2(uint8_t *pTile, uint8_t *pLinear, uint32_t linearPitch)
+{
+   for (auto i = 0u; i < 4; ++i) {
+      auto pBlock = pTile + ((i & 1) * 2 + (i >> 1) * 8) * 16;
+      auto pRow0 = pLinear + i * 2 * linearPitch;
+      auto pRow1 = pRow0 + linearPitch;
+
+      if (Untile) {
+         auto a = _mm256_permute4x64_epi64(Load256(pBlock), 0xD8);
+         auto b = _mm256_permute4x64_epi64(Load256(pBlock + 64), 0xD8);
+         Store256(pRow0, _mm256_permute2x128_si256(a, b, 0x20));
+         Store256(pRow1, _mm256_permute2x128_si256(a, b, 0x31));
+      } else {
+         auto row0 = Load256(pRow0);
+         auto row1 = Load256(pRow1);
+         Store256(pBlock, _mm256_permute4x64_epi64(_mm256_permute2x128_si256(row0, row1, 0x20), 0xD8));
+         Store256(pBlock + 64, _mm256_permute4x64_epi64(_mm256_permute2x128_si256(row0, row1, 0x31), 0xD8));
+      }
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   MicroTileD32Avx512
+*
+*   @brief
+*       AVX-512 version of MicroTileDRowPairSse2 for 32 bpp, one register holds a row pair
+***************************************************************************************************
+*/
+template<bool Untile>
+ADDR_TARGET("avx512f") static void
+MicroTileD32Avx512(uint8_t *pTile, uint8_t *pLinear, uint32_t linearPitch)
+{
+   static const int64_t swapMiddle[8] = { 0, 1, 4, 5, 2, 3, 6, 7 };
+   auto index = Load512(swapMiddle);
+
+   for (auto p = 0u; p < MicroTileHeight / 2; ++p) {
+      auto pEven = pLinear + p * 2 * linearPitch;
+      auto pOdd = pEven + linearPitch;
+
+      if (Untile) {
+         Store256Pair(pEven, pOdd, _mm512_maskz_permutexvar_epi64(0xFF, index, Load512(pTile + p * 64)));
+      } else {
+         Store512(pTile + p * 64, _mm512_maskz_permutexvar_epi64(0xFF, index, Load256Pair(pEven, pOdd)));
+      }
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   MicroTileDRowPairAvx512
+*
+*   @brief
+*       AVX-512 version of MicroTileDRowPairSse2 for 64 and 128 bpp, 64 bytes of the even and
+*       odd rows are split out of each 128 bytes of the row pair block
+***************************************************************************************************
+*/
+template<uint32_t PairBytes, bool Untile>
+ADDR_TARGET("avx512f") static void
+MicroTileDRowPairAvx512(uint8_t *pTile, uint8_t *pLinear, uint32_t linearPitch)
+{
+   static const int64_t evenLanes[8] = { 0, 1, 4, 5, 8, 9, 12, 13 };
+   static const int64_t oddLanes[8] = { 2, 3, 6, 7, 10, 11, 14, 15 };
+   static const int64_t lowLanes[8] = { 0, 1, 8, 9, 2, 3, 10, 11 };
+   static const int64_t highLanes[8] = { 4, 5, 12, 13, 6, 7, 14, 15 };
+
+   for (auto p = 0u; p < MicroTileHeight / 2; ++p) {
+      auto pPair = pTile + p * PairBytes;
+      auto pEven = pLinear + p * 2 * linearPitch;
+      auto pOdd = pEven + linearPitch;
+
+      for (auto j = 0u; j < PairBytes / 128; ++j) {
+         if (Untile) {
+            auto a = Load512(pPair + j * 128);
+            auto b = Load512(pPair + j * 128 + 64);
+            Store512(pEven + j * 64, _mm512_permutex2var_epi64(a, Load512(evenLanes), b));
+            Store512(pOdd + j * 64, _mm512_permutex2var_epi64(a, Load512(oddLanes), b));
+         } else {
+            auto even = Load512(pEven + j * 64);
+            auto odd = Load512(pOdd + j * 64);
+            Store512(pPair + j * 128, _mm512_permutex2var_epi64(even, Load512(lowLanes), odd));
+            Store512(pPair + j * 128 + 64, _mm512_permutex2var_epi64(even, Load512(highLanes), odd));
+         }
+      }
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   MicroTileND32Avx512
+*
+*   @brief
+*       AVX-512 version of MicroTileND32Sse2, handles four full rows at once
+***************************************************************************************************
+*/
+template<bool Untile>
+ADDR_TARGET("avx512f") static void
+MicroTileND32Avx512(uint8_t *pTile, uint8_t *pLinear, uint32_t linearPitch)
+{
+   static const int64_t rows01Lanes[8] = { 0, 2, 8, 10, 1, 3, 9, 11 };
+   static const int64_t rows23Lanes[8] = { 4, 6, 12, 14, 5, 7, 13, 15 };
+   static const int64_t lowLanes[8] = { 0, 4, 1, 5, 8, 12, 9, 13 };
+   static const int64_t highLanes[8] = { 2, 6, 3, 7, 10, 14, 11, 15 };
+
+   for (auto y2 = 0u; y2 < 2; ++y2) {
+      auto pBlock = pTile + y2 * 128;
+      auto pRow0 = pLinear + y2 * 4 * linearPitch;
+      auto pRow1 = pRow0 + linearPitch;
+      auto pRow2 = pRow1 + linearPitch;
+      auto pRow3 = pRow2 + linearPitch;
+
+      if (Untile) {
+         auto a = Load512(pBlock);
+         auto b = Load512(pBlock + 64);
+         auto rows01 = _mm512_permutex2var_epi64(a, Load512(rows01Lanes), b);
+         auto rows23 = _mm512_permutex2var_epi64(a, Load512(rows23Lanes), b);
+         Store256Pair(pRow0, pRow1, rows01);
+         Store256Pair(pRow2, pRow3, rows23);
+      } else {
+         auto rows01 = Load256Pair(pRow0, pRow1);
+         auto rows23 = Load256Pair(pRow2, pRow3);
+         Store512(pBlock, _mm512_permutex2var_epi64(rows01, Load512(lowLanes), rows23));
+         Store512(pBlock + 64, _mm512_permutex2var_epi64(rows01, Load512(highLanes), rows23));
+      }
+   }
+}
+
+#endif
+
+
+/**
+***************************************************************************************************
+*   AddrSetupMicroTileKernels
+*
+*   @brief
+*       Selects the fastest micro tile kernel the CPU supports for every pixel order and
+*       element size
+*
+*   @return
+*       N/A
+***************************************************************************************************
+*/
+void
+AddrSetupMicroTileKernels(uint32_t cpuFeatures,
+                          AddrMicroTileKernels *pKernels)
+{
+   std::memset(pKernels, 0, sizeof(AddrMicroTileKernels));
+
+#ifdef ADDR_X86_KERNELS
+   if (cpuFeatures & ADDR_CPU_SSE2) {
+      pKernels->untile[0][0] = MicroTileD8Sse2<true>;
+      pKernels->untile[1][1] = MicroTileD16Sse2<true>;
+      pKernels->untile[2][2] = MicroTileDRowPairSse2<64, true>;
+      pKernels->untile[3][3] = MicroTileDRowPairSse2<128, true>;
+      pKernels->untile[4][4] = MicroTileDRowPairSse2<256, true>;
+      pKernels->untile[5][0] = MicroTileND8Sse2<true>;
+      pKernels->untile[5][1] = MicroTileND16Sse2<true>;
+      pKernels->untile[5][2] = MicroTileND32Sse2<true>;
+      pKernels->untile[5][3] = MicroTileND64Sse2<true>;
+      pKernels->untile[5][4] = MicroTileND128Sse2<true>;
+
+      pKernels->tile[0][0] = MicroTileD8Sse2<false>;
+      pKernels->tile[1][1] = MicroTileD16Sse2<false>;
+      pKernels->tile[2][2] = MicroTileDRowPairSse2<64, false>;
+      pKernels->tile[3][3] = MicroTileDRowPairSse2<128, false>;
+      pKernels->tile[4][4] = MicroTileDRowPairSse2<256, false>;
+      pKernels->tile[5][0] = MicroTileND8Sse2<false>;
+      pKernels->tile[5][1] = MicroTileND16Sse2<false>;
+      pKernels->tile[5][2] = MicroTileND32Sse2<false>;
+      pKernels->tile[5][3] = MicroTileND64Sse2<false>;
+      pKernels->tile[5][4] = MicroTileND128Sse2<false>;
+   }
+
+   if (cpuFeatures & ADDR_CPU_AVX2) {
+      pKernels->untile[2][2] = MicroTileDRowPairAvx2<64, true>;
+      pKernels->untile[3][3] = MicroTileDRowPairAvx2<128, true>;
+      pKernels->untile[4][4] = MicroTileDRowPairAvx2<256, true>;
+      pKernels->untile[5][1] = MicroTileND16Avx2<true>;
+      pKernels->untile[5][2] = MicroTileND32Avx2<true>;
+
+      pKernels->tile[2][2] = MicroTileDRowPairAvx2<64, false>;
+      pKernels->tile[3][3] = MicroTileDRowPairAvx2<128, false>;
+      pKernels->tile[4][4] = MicroTileDRowPairAvx2<256, false>;
+      pKernels->tile[5][1] = MicroTileND16Avx2<false>;
+      pKernels->tile[5][2] = MicroTileND32Avx2<false>;
+   }
+
+   if (cpuFeatures & ADDR_CPU_AVX512) {
+      pKernels->untile[2][2] = MicroTileD32Avx512<true>;
+      pKernels->untile[3][3] = MicroTileDRowPairAvx512<128, true>;
+      pKernels->untile[4][4] = MicroTileDRowPairAvx512<256, true>;
+      pKernels->untile[5][2] = MicroTileND32Avx512<true>;
+
+      pKernels->tile[2][2] = MicroTileD32Avx512<false>;
+      pKernels->tile[3][3] = MicroTileDRowPairAvx512<128, false>;
+      pKernels->tile[4][4] = MicroTileDRowPairAvx512<256, false>;
+      pKernels->tile[5][2] = MicroTileND32Avx512<false>;
+   }
+#endif
+}
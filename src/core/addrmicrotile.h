@@ -0,0 +1,84 @@
+/*
+ * Copyright  2014 Advanced Micro Devices, Inc.
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sub license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON-INFRINGEMENT. IN NO EVENT SHALL THE COPYRIGHT HOLDERS, AUTHORS
+ * AND/OR ITS SUPPLIERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ */
+
+/**
+***************************************************************************************************
+* @file  addrmicrotile.h
+* @brief Contains the micro tile copy kernels and their CPU feature dispatch.
+***************************************************************************************************
+*/
+
+#pragma once
+#include "addrcommon.h"
+
+static const uint32_t MicroTileElemSizes = 5;
+
+/**
+***************************************************************************************************
+* @brief Copies a whole 8x8 micro tile between its contiguous tiled form and a linear buffer
+***************************************************************************************************
+*/
+typedef void (*AddrMicroTileKernel)(uint8_t *pTile, uint8_t *pLinear, uint32_t linearPitch);
+
+
+/**
+***************************************************************************************************
+* AddrCpuFeature
+*
+*   @brief
+*       CPU features which select the micro tile kernels
+***************************************************************************************************
+*/
+enum AddrCpuFeature : uint32_t
+{
+   ADDR_CPU_SSE2 = 0x1,
+   ADDR_CPU_AVX2 = 0x2,
+   ADDR_CPU_AVX512 = 0x4,
+};
+
+
+/**
+***************************************************************************************************
+* AddrMicroTileKernels
+*
+*   @brief
+*       Micro tile kernels indexed by [pixel order][log2(element bytes)], a null kernel means
+*       the generic per element copy has to be used
+***************************************************************************************************
+*/
+struct AddrMicroTileKernels
+{
+   AddrMicroTileKernel untile[MicroTilePixelOrders][MicroTileElemSizes];
+   AddrMicroTileKernel tile[MicroTilePixelOrders][MicroTileElemSizes];
+};
+
+
+uint32_t
+AddrDetectCpuFeatures();
+
+void
+AddrSetupMicroTileKernels(uint32_t cpuFeatures,
+                          AddrMicroTileKernels *pKernels);
@@ -34,12 +34,6 @@
 #include <cstring>
 #include "addrobject.h"
 
-ADDR_ALLOCSYSMEM
-AddrObject::mAllocSysMem = nullptr;
-
-ADDR_FREESYSMEM
-AddrObject::mFreeSysMem = nullptr;
-
 
 /**
 ***************************************************************************************************
@@ -50,9 +44,9 @@ AddrObject::mFreeSysMem = nullptr;
 ***************************************************************************************************
 */
 AddrObject::AddrObject() :
-   mClient(nullptr),
    mDebugPrint(nullptr)
 {
+   memset(&mClient, 0, sizeof(AddrClient));
 }
 
 
@@ -64,19 +58,12 @@ AddrObject::AddrObject() :
 *       Constructor for the AddrObject class.
 ***************************************************************************************************
 */
-AddrObject::AddrObject(ADDR_CLIENT_HANDLE hClient) :
-   mClient(hClient),
+AddrObject::AddrObject(const AddrClient *pClient) :
+   mClient(*pClient),
    mDebugPrint(nullptr)
 {
 }
 
-void
-AddrObject::SetupSysMemFuncs(ADDR_ALLOCSYSMEM allocSysMem, ADDR_FREESYSMEM freeSysMem)
-{
-   mAllocSysMem = allocSysMem;
-   mFreeSysMem = freeSysMem;
-}
-
 
 /**
 ***************************************************************************************************
@@ -89,7 +76,7 @@ AddrObject::SetupSysMemFuncs(ADDR_ALLOCSYSMEM allocSysMem, ADDR_FREESYSMEM freeS
 void *
 AddrObject::AddrMalloc(uint32_t size)
 {
-   return ClientAlloc(size, mClient);
+   return ClientAlloc(size, &mClient);
 }
 
 
@@ -104,7 +91,7 @@ AddrObject::AddrMalloc(uint32_t size)
 ADDR_E_RETURNCODE
 AddrObject::AddrFree(void *pVirtAddr)
 {
-   return ClientFree(pVirtAddr, mClient);
+   return ClientFree(pVirtAddr, &mClient);
 }
 
 
@@ -117,19 +104,19 @@ AddrObject::AddrFree(void *pVirtAddr)
 ***************************************************************************************************
 */
 void *
-AddrObject::ClientAlloc(uint32_t size, ADDR_CLIENT_HANDLE hClient)
+AddrObject::ClientAlloc(uint32_t size, const AddrClient *pClient)
 {
    ADDR_ALLOCSYSMEM_INPUT input;
    memset(&input, 0, sizeof(input));
 
-   if (!mAllocSysMem) {
+   if (!pClient->callbacks.allocSysMem) {
       return nullptr;
    }
 
    input.size = sizeof(ADDR_ALLOCSYSMEM_INPUT);
-   input.hClient = hClient;
+   input.hClient = pClient->handle;
    input.sizeInBytes = size;
-   return mAllocSysMem(&input);
+   return pClient->callbacks.allocSysMem(&input);
 }
 
 
@@ -142,17 +129,17 @@ AddrObject::ClientAlloc(uint32_t size, ADDR_CLIENT_HANDLE hClient)
 ***************************************************************************************************
 */
 ADDR_E_RETURNCODE
-AddrObject::ClientFree(void *pVirtAddr, ADDR_CLIENT_HANDLE hClient)
+AddrObject::ClientFree(void *pVirtAddr, const AddrClient *pClient)
 {
    ADDR_FREESYSMEM_INPUT input;
    memset(&input, 0, sizeof(input));
 
-   if (!mAllocSysMem) {
+   if (!pClient->callbacks.freeSysMem) {
       return ADDR_ERROR;
    }
 
    input.size = sizeof(ADDR_FREESYSMEM_INPUT);
-   input.hClient = hClient;
+   input.hClient = pClient->handle;
    input.pVirtAddr = pVirtAddr;
-   return mFreeSysMem(&input);
+   return pClient->callbacks.freeSysMem(&input);
 }
@@ -32,10 +32,23 @@
 */
 
 #pragma once
-#include "addrlib/addrtypes.h"
+#include "addrlib/addrinterface.h"
 #include "addrcommon.h"
 
 
+/**
+***************************************************************************************************
+* @brief Client handle and the callbacks it passed to AddrCreate, every object keeps its own copy
+*        so instances created with different allocators never share state.
+***************************************************************************************************
+*/
+struct AddrClient
+{
+   ADDR_CLIENT_HANDLE handle;
+   ADDR_CALLBACKS callbacks;
+};
+
+
 /**
 ***************************************************************************************************
 * @brief This class is the base class for all ADDR class objects.
@@ -45,11 +58,14 @@ class AddrObject
 {
 public:
    AddrObject();
-   AddrObject(ADDR_CLIENT_HANDLE hClient);
+   AddrObject(const AddrClient *pClient);
    virtual ~AddrObject() = default;
 
-   static void
-   SetupSysMemFuncs(ADDR_ALLOCSYSMEM allocSysMem, ADDR_FREESYSMEM freeSysMem);
+   const AddrClient *
+   GetClient() const
+   {
+      return &mClient;
+   }
 
    void *
    AddrMalloc(uint32_t size);
@@ -58,15 +74,12 @@ public:
    AddrFree(void *pVirtAddr);
 
    static void *
-   ClientAlloc(uint32_t size, ADDR_CLIENT_HANDLE hClient);
+   ClientAlloc(uint32_t size, const AddrClient *pClient);
 
    static ADDR_E_RETURNCODE
-   ClientFree(void *pVirtAddr, ADDR_CLIENT_HANDLE hClient);
+   ClientFree(void *pVirtAddr, const AddrClient *pClient);
 
 protected:
-   ADDR_CLIENT_HANDLE mClient;
+   AddrClient mClient;
    ADDR_DEBUGPRINT mDebugPrint;
-
-   static ADDR_ALLOCSYSMEM mAllocSysMem;
-   static ADDR_FREESYSMEM mFreeSysMem;
 };
@@ -0,0 +1,239 @@
+/*
+ * Copyright  2014 Advanced Micro Devices, Inc.
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sub license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON-INFRINGEMENT. IN NO EVENT SHALL THE COPYRIGHT HOLDERS, AUTHORS
+ * AND/OR ITS SUPPLIERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ */
+
+/**
+***************************************************************************************************
+* @file  addrstats.cpp
+* @brief Contains the AddrStats class implementation.
+***************************************************************************************************
+*/
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include "addrstats.h"
+
+// Ids are never reused, so a thread never mistakes a new AddrStats at a freed address for the
+// one it cached its block for
+static std::atomic<uint64_t> sNextStatsId { 1 };
+
+
+/**
+***************************************************************************************************
+*   AddrStats::AddrStats
+*
+*   @brief
+*       Constructor for the AddrStats class.
+***************************************************************************************************
+*/
+AddrStats::AddrStats(const AddrClient *pClient) :
+   AddrObject(pClient),
+   mId(sNextStatsId.fetch_add(1, std::memory_order_relaxed)),
+   mNumThreads(0)
+{
+   for (auto i = 0u; i < StatsMaxThreads; ++i) {
+      mThreads[i].store(std::thread::id(), std::memory_order_relaxed);
+   }
+
+   Reset();
+}
+
+
+/**
+***************************************************************************************************
+*   AddrStats::Create
+*
+*   @brief
+*       Creates an AddrStats object in pMemory, or in a client allocation when pMemory is
+*       nullptr.
+*
+*   @return
+*       Returns an AddrStats object pointer, nullptr if the allocation failed.
+***************************************************************************************************
+*/
+AddrStats *
+AddrStats::Create(const AddrClient *pClient, void *pMemory)
+{
+   auto memory = pMemory ? pMemory : AddrObject::ClientAlloc(sizeof(AddrStats), pClient);
+
+   if (!memory) {
+      return nullptr;
+   }
+
+   return new (memory) AddrStats(pClient);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrStats::Destroy
+*
+*   @brief
+*       Destroys the object and frees its memory.
+***************************************************************************************************
+*/
+void
+AddrStats::Destroy()
+{
+   auto client = mClient;
+   this->~AddrStats();
+   AddrObject::ClientFree(this, &client);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrStats::GetThreadBlock
+*
+*   @brief
+*       Returns the counters of the calling thread, cached for the last AddrStats it used
+*
+*   @return
+*       AddrStatsBlock pointer
+***************************************************************************************************
+*/
+AddrStatsBlock *
+AddrStats::GetThreadBlock()
+{
+   static thread_local uint64_t sCachedId = 0;
+   static thread_local AddrStatsBlock *sCachedBlock = nullptr;
+
+   if (sCachedId != mId) {
+      sCachedBlock = FindThreadBlock();
+      sCachedId = mId;
+   }
+
+   return sCachedBlock;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrStats::FindThreadBlock
+*
+*   @brief
+*       Looks up the block the calling thread claimed, claiming a new one on its first call
+*
+*   @return
+*       AddrStatsBlock pointer
+***************************************************************************************************
+*/
+AddrStatsBlock *
+AddrStats::FindThreadBlock()
+{
+   auto self = std::this_thread::get_id();
+   auto numThreads = std::min(mNumThreads.load(std::memory_order_acquire), StatsMaxThreads);
+
+   for (auto i = 0u; i < numThreads; ++i) {
+      if (mThreads[i].load(std::memory_order_relaxed) == self) {
+         return &mBlocks[i];
+      }
+   }
+
+   auto index = mNumThreads.fetch_add(1, std::memory_order_acq_rel);
+
+   if (index >= StatsMaxThreads) {
+      return &mBlocks[StatsMaxThreads - 1];
+   }
+
+   mThreads[index].store(self, std::memory_order_relaxed);
+   return &mBlocks[index];
+}
+
+
+/**
+***************************************************************************************************
+*   AddrStats::Read
+*
+*   @brief
+*       Sums the counters of every thread into pOut
+***************************************************************************************************
+*/
+void
+AddrStats::Read(ADDR_GET_STATS_OUTPUT *pOut) const
+{
+   auto numThreads = mNumThreads.load(std::memory_order_acquire);
+
+   std::memset(pOut->entryCalls, 0, sizeof(pOut->entryCalls));
+   std::memset(pOut->entryNs, 0, sizeof(pOut->entryNs));
+   std::memset(pOut->surfaceTileModes, 0, sizeof(pOut->surfaceTileModes));
+   std::memset(pOut->addrTileModes, 0, sizeof(pOut->addrTileModes));
+   pOut->numThreads = numThreads;
+   pOut->mipTileModeDegrades = 0;
+   pOut->bankSwappedLookups = 0;
+
+   for (auto i = 0u; i < std::min(numThreads, StatsMaxThreads); ++i) {
+      auto pBlock = &mBlocks[i];
+
+      for (auto entry = 0u; entry < ADDR_STATS_ENTRY_COUNT; ++entry) {
+         pOut->entryCalls[entry] += pBlock->entryCalls[entry].load(std::memory_order_relaxed);
+         pOut->entryNs[entry] += pBlock->entryNs[entry].load(std::memory_order_relaxed);
+      }
+
+      for (auto tileMode = 0u; tileMode < ADDR_TM_COUNT; ++tileMode) {
+         pOut->surfaceTileModes[tileMode] += pBlock->surfaceTileModes[tileMode].load(std::memory_order_relaxed);
+         pOut->addrTileModes[tileMode] += pBlock->addrTileModes[tileMode].load(std::memory_order_relaxed);
+      }
+
+      pOut->mipTileModeDegrades += pBlock->counters[ADDR_STATS_MIP_TILE_MODE_DEGRADES].load(std::memory_order_relaxed);
+      pOut->bankSwappedLookups += pBlock->counters[ADDR_STATS_BANK_SWAPPED_LOOKUPS].load(std::memory_order_relaxed);
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   AddrStats::Reset
+*
+*   @brief
+*       Clears the counters of every thread, increments racing with it may survive
+***************************************************************************************************
+*/
+void
+AddrStats::Reset()
+{
+   for (auto &block : mBlocks) {
+      for (auto &counter : block.entryCalls) {
+         counter.store(0, std::memory_order_relaxed);
+      }
+
+      for (auto &counter : block.entryNs) {
+         counter.store(0, std::memory_order_relaxed);
+      }
+
+      for (auto &counter : block.surfaceTileModes) {
+         counter.store(0, std::memory_order_relaxed);
+      }
+
+      for (auto &counter : block.addrTileModes) {
+         counter.store(0, std::memory_order_relaxed);
+      }
+
+      for (auto &counter : block.counters) {
+         counter.store(0, std::memory_order_relaxed);
+      }
+   }
+}
@@ -0,0 +1,185 @@
+/*
+ * Copyright  2014 Advanced Micro Devices, Inc.
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sub license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON-INFRINGEMENT. IN NO EVENT SHALL THE COPYRIGHT HOLDERS, AUTHORS
+ * AND/OR ITS SUPPLIERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ */
+
+/**
+***************************************************************************************************
+* @file  addrstats.h
+* @brief Contains the AddrStats class definition.
+***************************************************************************************************
+*/
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "addrobject.h"
+
+// Define ADDR_DISABLE_STATS to compile the counters out, createFlags.collectStats is then ignored
+#ifndef ADDR_DISABLE_STATS
+#define ADDR_STATS
+#endif
+
+static const uint32_t StatsMaxThreads = 64;
+
+
+/**
+***************************************************************************************************
+* AddrStatsCounter
+*
+*   @brief
+*       Counters of ADDR_GET_STATS_OUTPUT which are not indexed by entry point or tile mode
+***************************************************************************************************
+*/
+enum AddrStatsCounter : uint32_t
+{
+   ADDR_STATS_MIP_TILE_MODE_DEGRADES,
+   ADDR_STATS_BANK_SWAPPED_LOOKUPS,
+   ADDR_STATS_COUNTER_COUNT,
+};
+
+
+/**
+***************************************************************************************************
+* AddrStatsBlock
+*
+*   @brief
+*       Counters of one thread, on their own cache lines so threads never share them. Threads
+*       past StatsMaxThreads share the last block, hence the atomic increments.
+***************************************************************************************************
+*/
+struct alignas(64) AddrStatsBlock
+{
+   std::atomic<uint64_t> entryCalls[ADDR_STATS_ENTRY_COUNT];
+   std::atomic<uint64_t> entryNs[ADDR_STATS_ENTRY_COUNT];
+   std::atomic<uint64_t> surfaceTileModes[ADDR_TM_COUNT];
+   std::atomic<uint64_t> addrTileModes[ADDR_TM_COUNT];
+   std::atomic<uint64_t> counters[ADDR_STATS_COUNTER_COUNT];
+};
+
+
+/**
+***************************************************************************************************
+* @brief Per thread performance counters of one AddrLib, merged when they are read
+***************************************************************************************************
+*/
+class AddrStats : public AddrObject
+{
+public:
+   AddrStats(const AddrClient *pClient);
+
+   static AddrStats *
+   Create(const AddrClient *pClient, void *pMemory);
+
+   void
+   Destroy();
+
+   void
+   Read(ADDR_GET_STATS_OUTPUT *pOut) const;
+
+   void
+   Reset();
+
+   void
+   AddEntry(AddrStatsEntry entry, uint64_t ns)
+   {
+      auto pBlock = GetThreadBlock();
+      pBlock->entryCalls[entry].fetch_add(1, std::memory_order_relaxed);
+      pBlock->entryNs[entry].fetch_add(ns, std::memory_order_relaxed);
+   }
+
+   void
+   AddSurfaceTileMode(AddrTileMode tileMode)
+   {
+      if (tileMode < ADDR_TM_COUNT) {
+         GetThreadBlock()->surfaceTileModes[tileMode].fetch_add(1, std::memory_order_relaxed);
+      }
+   }
+
+   void
+   AddAddrTileMode(AddrTileMode tileMode, uint64_t numElements)
+   {
+      if (tileMode < ADDR_TM_COUNT) {
+         GetThreadBlock()->addrTileModes[tileMode].fetch_add(numElements, std::memory_order_relaxed);
+      }
+   }
+
+   void
+   AddCounter(AddrStatsCounter counter, uint64_t value)
+   {
+      GetThreadBlock()->counters[counter].fetch_add(value, std::memory_order_relaxed);
+   }
+
+protected:
+   AddrStatsBlock *
+   GetThreadBlock();
+
+   AddrStatsBlock *
+   FindThreadBlock();
+
+protected:
+   uint64_t mId;
+   std::atomic<uint32_t> mNumThreads;
+   std::atomic<std::thread::id> mThreads[StatsMaxThreads];
+   AddrStatsBlock mBlocks[StatsMaxThreads];
+};
+
+
+/**
+***************************************************************************************************
+* @brief Counts and times one call of an entry point, does nothing when pStats is nullptr
+***************************************************************************************************
+*/
+class AddrStatsScope
+{
+public:
+#ifdef ADDR_STATS
+   AddrStatsScope(AddrStats *pStats, AddrStatsEntry entry) :
+      mStats(pStats),
+      mEntry(entry)
+   {
+      if (mStats) {
+         mStart = std::chrono::steady_clock::now();
+      }
+   }
+
+   ~AddrStatsScope()
+   {
+      if (mStats) {
+         auto elapsed = std::chrono::steady_clock::now() - mStart;
+         mStats->AddEntry(mEntry, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+      }
+   }
+
+private:
+   AddrStats *mStats;
+   AddrStatsEntry mEntry;
+   std::chrono::steady_clock::time_point mStart;
+#else
+   AddrStatsScope(AddrStats *, AddrStatsEntry)
+   {
+   }
+#endif
+};
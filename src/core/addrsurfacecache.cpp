@@ -0,0 +1,285 @@
+/*
+ * Copyright  2014 Advanced Micro Devices, Inc.
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sub license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON-INFRINGEMENT. IN NO EVENT SHALL THE COPYRIGHT HOLDERS, AUTHORS
+ * AND/OR ITS SUPPLIERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ */
+
+/**
+***************************************************************************************************
+* @file  addrsurfacecache.cpp
+* @brief Contains the AddrSurfaceInfoCache class implementation.
+***************************************************************************************************
+*/
+
+#include <cstring>
+#include <mutex>
+#include <new>
+#include "addrsurfacecache.h"
+
+
+/**
+***************************************************************************************************
+*   AddrSurfaceInfoCache::AddrSurfaceInfoCache
+*
+*   @brief
+*       Constructor for the AddrSurfaceInfoCache class.
+***************************************************************************************************
+*/
+AddrSurfaceInfoCache::AddrSurfaceInfoCache(const AddrClient *pClient) :
+   AddrObject(pClient),
+   mHits(0),
+   mMisses(0)
+{
+   std::memset(mNextWay, 0, sizeof(mNextWay));
+   std::memset(mEntries, 0, sizeof(mEntries));
+}
+
+
+/**
+***************************************************************************************************
+*   AddrSurfaceInfoCache::Create
+*
+*   @brief
+*       Creates an AddrSurfaceInfoCache object in pMemory, or in a client allocation when
+*       pMemory is nullptr.
+*
+*   @return
+*       Returns an AddrSurfaceInfoCache object pointer, nullptr if the allocation failed.
+***************************************************************************************************
+*/
+AddrSurfaceInfoCache *
+AddrSurfaceInfoCache::Create(const AddrClient *pClient, void *pMemory)
+{
+   auto memory = pMemory ? pMemory : AddrObject::ClientAlloc(sizeof(AddrSurfaceInfoCache), pClient);
+
+   if (!memory) {
+      return nullptr;
+   }
+
+   return new (memory) AddrSurfaceInfoCache(pClient);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrSurfaceInfoCache::Destroy
+*
+*   @brief
+*       Destroys the object and frees its memory.
+***************************************************************************************************
+*/
+void
+AddrSurfaceInfoCache::Destroy()
+{
+   auto client = mClient;
+   this->~AddrSurfaceInfoCache();
+   AddrObject::ClientFree(this, &client);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrSurfaceInfoCache::MakeKey
+*
+*   @brief
+*       Builds the cache key of an AddrComputeSurfaceInfo call
+*
+*   @return
+*       False if the call can not be cached, which is when the caller passes tile info for
+*       AddrLib to read or fill
+***************************************************************************************************
+*/
+bool
+AddrSurfaceInfoCache::MakeKey(const ADDR_COMPUTE_SURFACE_INFO_INPUT *pIn,
+                              const ADDR_COMPUTE_SURFACE_INFO_OUTPUT *pOut,
+                              AddrSurfaceInfoCacheKey *pKey)
+{
+   if (pIn->pTileInfo || pOut->pTileInfo) {
+      return false;
+   }
+
+   pKey->tileMode = pIn->tileMode;
+   pKey->format = pIn->format;
+   pKey->bpp = pIn->bpp;
+   pKey->numSamples = pIn->numSamples;
+   pKey->width = pIn->width;
+   pKey->height = pIn->height;
+   pKey->numSlices = pIn->numSlices;
+   pKey->slice = pIn->slice;
+   pKey->mipLevel = pIn->mipLevel;
+   pKey->flags = pIn->flags.value;
+   pKey->numFrags = pIn->numFrags;
+   pKey->tileType = pIn->tileType;
+   pKey->stereoInfo = (pOut->pStereoInfo != nullptr) ? 1 : 0;
+   return true;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrSurfaceInfoCache::HashKey
+*
+*   @brief
+*       FNV-1a hash of a cache key
+*
+*   @return
+*       Hash value
+***************************************************************************************************
+*/
+uint32_t
+AddrSurfaceInfoCache::HashKey(const AddrSurfaceInfoCacheKey *pKey)
+{
+   auto words = reinterpret_cast<const uint32_t *>(pKey);
+   auto hash = uint32_t { 2166136261u };
+
+   for (auto i = 0u; i < sizeof(AddrSurfaceInfoCacheKey) / sizeof(uint32_t); ++i) {
+      hash = (hash ^ words[i]) * 16777619u;
+   }
+
+   return hash ^ (hash >> 16);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrSurfaceInfoCache::Lookup
+*
+*   @brief
+*       Replays a cached call onto pIn and pOut, writing the same fields the uncached
+*       AddrComputeSurfaceInfo would
+*
+*   @return
+*       True on a cache hit
+***************************************************************************************************
+*/
+bool
+AddrSurfaceInfoCache::Lookup(const AddrSurfaceInfoCacheKey *pKey,
+                             ADDR_COMPUTE_SURFACE_INFO_INPUT *pIn,
+                             ADDR_COMPUTE_SURFACE_INFO_OUTPUT *pOut,
+                             bool writeSliceSize)
+{
+   auto set = mEntries[HashKey(pKey) % SurfaceInfoCacheSets];
+   std::shared_lock<std::shared_mutex> lock(mMutex);
+
+   for (auto way = 0u; way < SurfaceInfoCacheWays; ++way) {
+      auto &entry = set[way];
+
+      if (!entry.valid || std::memcmp(&entry.key, pKey, sizeof(AddrSurfaceInfoCacheKey)) != 0) {
+         continue;
+      }
+
+      pIn->tileMode = entry.in.tileMode;
+      pIn->bpp = entry.in.bpp;
+      pIn->width = entry.in.width;
+      pIn->height = entry.in.height;
+      pIn->numSlices = entry.in.numSlices;
+      pIn->flags = entry.in.flags;
+      pIn->tileType = entry.in.tileType;
+
+      pOut->pitch = entry.out.pitch;
+      pOut->height = entry.out.height;
+      pOut->depth = entry.out.depth;
+      pOut->surfSize = entry.out.surfSize;
+      pOut->tileMode = entry.out.tileMode;
+      pOut->baseAlign = entry.out.baseAlign;
+      pOut->pitchAlign = entry.out.pitchAlign;
+      pOut->heightAlign = entry.out.heightAlign;
+      pOut->depthAlign = entry.out.depthAlign;
+      pOut->bpp = entry.out.bpp;
+      pOut->pixelPitch = entry.out.pixelPitch;
+      pOut->pixelHeight = entry.out.pixelHeight;
+      pOut->pixelBits = entry.out.pixelBits;
+      pOut->pitchTileMax = entry.out.pitchTileMax;
+      pOut->heightTileMax = entry.out.heightTileMax;
+      pOut->sliceTileMax = entry.out.sliceTileMax;
+
+      if (writeSliceSize) {
+         pOut->sliceSize = entry.out.sliceSize;
+      }
+
+      if (pIn->flags.qbStereo && pOut->pStereoInfo) {
+         *pOut->pStereoInfo = entry.stereoInfo;
+      }
+
+      mHits.fetch_add(1, std::memory_order_relaxed);
+      return true;
+   }
+
+   mMisses.fetch_add(1, std::memory_order_relaxed);
+   return false;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrSurfaceInfoCache::Insert
+*
+*   @brief
+*       Records a successful AddrComputeSurfaceInfo call, evicting the ways of a set in
+*       round robin order
+***************************************************************************************************
+*/
+void
+AddrSurfaceInfoCache::Insert(const AddrSurfaceInfoCacheKey *pKey,
+                             const ADDR_COMPUTE_SURFACE_INFO_INPUT *pIn,
+                             const ADDR_COMPUTE_SURFACE_INFO_OUTPUT *pOut)
+{
+   auto setIndex = HashKey(pKey) % SurfaceInfoCacheSets;
+   auto set = mEntries[setIndex];
+   std::unique_lock<std::shared_mutex> lock(mMutex);
+   auto victim = &set[mNextWay[setIndex]];
+
+   for (auto way = 0u; way < SurfaceInfoCacheWays; ++way) {
+      if (set[way].valid && std::memcmp(&set[way].key, pKey, sizeof(AddrSurfaceInfoCacheKey)) == 0) {
+         // Another thread inserted the same call first
+         return;
+      }
+   }
+
+   mNextWay[setIndex] = static_cast<uint8_t>((mNextWay[setIndex] + 1) % SurfaceInfoCacheWays);
+
+   victim->valid = true;
+   victim->key = *pKey;
+   victim->in = *pIn;
+   victim->out = *pOut;
+
+   if (pIn->flags.qbStereo && pOut->pStereoInfo) {
+      victim->stereoInfo = *pOut->pStereoInfo;
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   AddrSurfaceInfoCache::GetStats
+*
+*   @brief
+*       Returns the number of lookups which hit and missed the cache
+***************************************************************************************************
+*/
+void
+AddrSurfaceInfoCache::GetStats(uint64_t *pHits, uint64_t *pMisses) const
+{
+   *pHits = mHits.load(std::memory_order_relaxed);
+   *pMisses = mMisses.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright  2014 Advanced Micro Devices, Inc.
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sub license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON-INFRINGEMENT. IN NO EVENT SHALL THE COPYRIGHT HOLDERS, AUTHORS
+ * AND/OR ITS SUPPLIERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ */
+
+/**
+***************************************************************************************************
+* @file  addrsurfacecache.h
+* @brief Contains the AddrSurfaceInfoCache class definition.
+***************************************************************************************************
+*/
+
+#pragma once
+#include <atomic>
+#include <shared_mutex>
+#include "addrobject.h"
+
+static const uint32_t SurfaceInfoCacheWays = 4;
+static const uint32_t SurfaceInfoCacheSets = 256;
+
+
+/**
+***************************************************************************************************
+* AddrSurfaceInfoCacheKey
+*
+*   @brief
+*       Normalized ADDR_COMPUTE_SURFACE_INFO_INPUT, the pointers are replaced by whether the
+*       output they select is written
+***************************************************************************************************
+*/
+struct AddrSurfaceInfoCacheKey
+{
+   uint32_t tileMode;
+   uint32_t format;
+   uint32_t bpp;
+   uint32_t numSamples;
+   uint32_t width;
+   uint32_t height;
+   uint32_t numSlices;
+   uint32_t slice;
+   uint32_t mipLevel;
+   uint32_t flags;
+   uint32_t numFrags;
+   uint32_t tileType;
+   uint32_t stereoInfo;
+};
+
+
+/**
+***************************************************************************************************
+* AddrSurfaceInfoCacheEntry
+*
+*   @brief
+*       One cached AddrComputeSurfaceInfo call, holding pIn as the call left it and pOut
+***************************************************************************************************
+*/
+struct AddrSurfaceInfoCacheEntry
+{
+   bool valid;
+   AddrSurfaceInfoCacheKey key;
+   ADDR_COMPUTE_SURFACE_INFO_INPUT in;
+   ADDR_COMPUTE_SURFACE_INFO_OUTPUT out;
+   ADDR_QBSTEREOINFO stereoInfo;
+};
+
+
+/**
+***************************************************************************************************
+* @brief Bounded set associative cache of AddrComputeSurfaceInfo results, lookups may run
+*        concurrently with each other and with inserts
+***************************************************************************************************
+*/
+class AddrSurfaceInfoCache : public AddrObject
+{
+public:
+   AddrSurfaceInfoCache(const AddrClient *pClient);
+
+   static AddrSurfaceInfoCache *
+   Create(const AddrClient *pClient, void *pMemory);
+
+   void
+   Destroy();
+
+   static bool
+   MakeKey(const ADDR_COMPUTE_SURFACE_INFO_INPUT *pIn,
+           const ADDR_COMPUTE_SURFACE_INFO_OUTPUT *pOut,
+           AddrSurfaceInfoCacheKey *pKey);
+
+   bool
+   Lookup(const AddrSurfaceInfoCacheKey *pKey,
+          ADDR_COMPUTE_SURFACE_INFO_INPUT *pIn,
+          ADDR_COMPUTE_SURFACE_INFO_OUTPUT *pOut,
+          bool writeSliceSize);
+
+   void
+   Insert(const AddrSurfaceInfoCacheKey *pKey,
+          const ADDR_COMPUTE_SURFACE_INFO_INPUT *pIn,
+          const ADDR_COMPUTE_SURFACE_INFO_OUTPUT *pOut);
+
+   void
+   GetStats(uint64_t *pHits, uint64_t *pMisses) const;
+
+protected:
+   static uint32_t
+   HashKey(const AddrSurfaceInfoCacheKey *pKey);
+
+protected:
+   std::shared_mutex mMutex;
+   std::atomic<uint64_t> mHits;
+   std::atomic<uint64_t> mMisses;
+
+   uint8_t mNextWay[SurfaceInfoCacheSets];
+   AddrSurfaceInfoCacheEntry mEntries[SurfaceInfoCacheSets][SurfaceInfoCacheWays];
+};
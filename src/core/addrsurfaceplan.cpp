@@ -0,0 +1,83 @@
+/*
+ * Copyright  2014 Advanced Micro Devices, Inc.
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sub license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON-INFRINGEMENT. IN NO EVENT SHALL THE COPYRIGHT HOLDERS, AUTHORS
+ * AND/OR ITS SUPPLIERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ */
+
+/**
+***************************************************************************************************
+* @file  addrsurfaceplan.cpp
+* @brief Contains the AddrSurfacePlan class implementation.
+***************************************************************************************************
+*/
+
+#include "addrsurfaceplan.h"
+
+
+/**
+***************************************************************************************************
+*   AddrSurfacePlan::AddrSurfacePlan
+*
+*   @brief
+*       Constructor for the AddrSurfacePlan class.
+***************************************************************************************************
+*/
+AddrSurfacePlan::AddrSurfacePlan(const AddrClient *pClient) :
+   AddrObject(pClient)
+{
+}
+
+
+/**
+***************************************************************************************************
+*   AddrSurfacePlan::GetSurfacePlan
+*
+*   @brief
+*      Get AddrSurfacePlan pointer
+*
+*   @return
+*      An AddrSurfacePlan class pointer
+***************************************************************************************************
+*/
+AddrSurfacePlan *
+AddrSurfacePlan::GetSurfacePlan(ADDR_SURFACE_PLAN hPlan)
+{
+   return reinterpret_cast<AddrSurfacePlan *>(hPlan);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrSurfacePlan::Destroy
+*
+*   @brief
+*       Destroys the object and frees its memory.
+***************************************************************************************************
+*/
+void
+AddrSurfacePlan::Destroy()
+{
+   auto client = mClient;
+   this->~AddrSurfacePlan();
+   AddrObject::ClientFree(this, &client);
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright  2014 Advanced Micro Devices, Inc.
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sub license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON-INFRINGEMENT. IN NO EVENT SHALL THE COPYRIGHT HOLDERS, AUTHORS
+ * AND/OR ITS SUPPLIERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ */
+
+/**
+***************************************************************************************************
+* @file  addrsurfaceplan.h
+* @brief Contains the AddrSurfacePlan class definition.
+***************************************************************************************************
+*/
+
+#pragma once
+#include "addrlib/addrinterface.h"
+#include "addrobject.h"
+
+
+/**
+***************************************************************************************************
+* @brief Base class of the surface plans returned by AddrCreateSurfacePlan, which hold every
+*        per surface term of the address computation so only the per element work is left
+***************************************************************************************************
+*/
+class AddrSurfacePlan : public AddrObject
+{
+public:
+   AddrSurfacePlan(const AddrClient *pClient);
+   virtual ~AddrSurfacePlan() = default;
+
+   static AddrSurfacePlan *
+   GetSurfacePlan(ADDR_SURFACE_PLAN hPlan);
+
+   void
+   Destroy();
+
+   virtual uint64_t
+   ComputeAddrFromCoord(uint32_t x,
+                        uint32_t y,
+                        uint32_t slice,
+                        uint32_t sample,
+                        uint32_t *pBitPosition) const = 0;
+};
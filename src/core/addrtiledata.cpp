@@ -0,0 +1,595 @@
+/*
+ * Copyright  2014 Advanced Micro Devices, Inc.
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sub license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON-INFRINGEMENT. IN NO EVENT SHALL THE COPYRIGHT HOLDERS, AUTHORS
+ * AND/OR ITS SUPPLIERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ */
+
+/**
+***************************************************************************************************
+* @file  addrtiledata.cpp
+* @brief Contains the addressing and bulk copies of per tile data (HTILE and CMASK).
+***************************************************************************************************
+*/
+
+#include <algorithm>
+#include <cstring>
+#include "addrlib.h"
+
+
+/**
+***************************************************************************************************
+* @brief Position of a pipe's entry within the per tile data, advanced in address order
+***************************************************************************************************
+*/
+struct AddrTileDataCursor
+{
+   uint32_t slice;
+   uint32_t macroX;
+   uint32_t macroY;
+   uint32_t row;
+   uint32_t column;
+};
+
+
+/**
+***************************************************************************************************
+*   SetTileDataCursor
+*
+*   @brief
+*       Points the cursor at the entry-th entry a pipe stores
+***************************************************************************************************
+*/
+static void
+SetTileDataCursor(const AddrTileDataLayout *pLayout,
+                  uint64_t entry,
+                  AddrTileDataCursor *pCursor)
+{
+   auto macroIndex = (entry % pLayout->sliceEntries) / pLayout->macroTileEntries;
+   auto macroEntry = static_cast<uint32_t>(entry % pLayout->macroTileEntries);
+
+   pCursor->slice = static_cast<uint32_t>(entry / pLayout->sliceEntries);
+   pCursor->macroX = static_cast<uint32_t>(macroIndex % pLayout->macroTilesPerRow);
+   pCursor->macroY = static_cast<uint32_t>(macroIndex / pLayout->macroTilesPerRow);
+   pCursor->row = macroEntry / pLayout->macroTileColumns;
+   pCursor->column = macroEntry % pLayout->macroTileColumns;
+}
+
+
+/**
+***************************************************************************************************
+*   AdvanceTileDataCursor
+*
+*   @brief
+*       Moves the cursor to the next entry of the pipe
+***************************************************************************************************
+*/
+static void
+AdvanceTileDataCursor(const AddrTileDataLayout *pLayout,
+                      AddrTileDataCursor *pCursor)
+{
+   if (++pCursor->column < pLayout->macroTileColumns) {
+      return;
+   }
+
+   pCursor->column = 0;
+
+   if (++pCursor->row < pLayout->macroTileRows / pLayout->pipes) {
+      return;
+   }
+
+   pCursor->row = 0;
+
+   if (++pCursor->macroX < pLayout->macroTilesPerRow) {
+      return;
+   }
+
+   pCursor->macroX = 0;
+
+   if (++pCursor->macroY < pLayout->macroTilesPerColumn) {
+      return;
+   }
+
+   pCursor->macroY = 0;
+   ++pCursor->slice;
+}
+
+
+/**
+***************************************************************************************************
+*   GetTileDataAddr
+*
+*   @brief
+*       Interleaves the bit offset of an entry within its pipe's data with the other pipes
+*
+*   @return
+*       Byte address of the entry
+***************************************************************************************************
+*/
+static inline uint64_t
+GetTileDataAddr(const AddrTileDataLayout *pLayout,
+                uint64_t pipeBitOffset,
+                uint32_t pipe,
+                uint32_t *pBitPosition)
+{
+   auto pipeOffset = pipeBitOffset / BITS_PER_BYTE;
+   auto groupMask = static_cast<uint64_t>(pLayout->pipeInterleaveBytes) - 1;
+
+   if (pBitPosition) {
+      *pBitPosition = static_cast<uint32_t>(pipeBitOffset % BITS_PER_BYTE);
+   }
+
+   return (pipeOffset & ~groupMask) * pLayout->pipes
+      + static_cast<uint64_t>(pipe) * pLayout->pipeInterleaveBytes
+      + (pipeOffset & groupMask);
+}
+
+
+/**
+***************************************************************************************************
+*   ComputeTileDataRegion
+*
+*   @brief
+*       Round a pixel region of a surface out to the tiles of its per tile data, the whole
+*       padded surface when pRegion is nullptr. An empty region gives a depth of 0.
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+static ADDR_E_RETURNCODE
+ComputeTileDataRegion(const AddrTileDataLayout *pLayout,
+                      const ADDR_COPY_REGION *pRegion,
+                      ADDR_COPY_REGION *pTileRegion)
+{
+   if (!pRegion) {
+      pTileRegion->x = 0;
+      pTileRegion->y = 0;
+      pTileRegion->slice = 0;
+      pTileRegion->width = pLayout->pitch / MicroTileWidth;
+      pTileRegion->height = pLayout->height / MicroTileHeight;
+      pTileRegion->depth = pLayout->numSlices;
+      return ADDR_OK;
+   }
+
+   if (static_cast<uint64_t>(pRegion->x) + pRegion->width > pLayout->pitch
+    || static_cast<uint64_t>(pRegion->y) + pRegion->height > pLayout->height
+    || static_cast<uint64_t>(pRegion->slice) + pRegion->depth > pLayout->numSlices) {
+      return ADDR_INVALIDPARAMS;
+   }
+
+   std::memset(pTileRegion, 0, sizeof(ADDR_COPY_REGION));
+
+   if (pRegion->width && pRegion->height && pRegion->depth) {
+      pTileRegion->x = pRegion->x / MicroTileWidth;
+      pTileRegion->y = pRegion->y / MicroTileHeight;
+      pTileRegion->slice = pRegion->slice;
+      pTileRegion->width = (pRegion->x + pRegion->width + MicroTileWidth - 1) / MicroTileWidth - pTileRegion->x;
+      pTileRegion->height = (pRegion->y + pRegion->height + MicroTileHeight - 1) / MicroTileHeight - pTileRegion->y;
+      pTileRegion->depth = pRegion->depth;
+   }
+
+   return ADDR_OK;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::ComputeTileDataLayout
+*
+*   @brief
+*       Compute the layout of per tile data from the padded dimensions and macro tile size
+*       ComputeHtileInfo or ComputeCmaskInfo return
+*
+*   @return
+*       N/A
+***************************************************************************************************
+*/
+void
+AddrLib::ComputeTileDataLayout(uint32_t pitch,
+                               uint32_t height,
+                               uint32_t numSlices,
+                               uint32_t entryBits,
+                               uint32_t macroWidth,
+                               uint32_t macroHeight,
+                               ADDR_TILEINFO *pTileInfo,
+                               AddrTileDataLayout *pLayout) const
+{
+   pLayout->pitch = pitch;
+   pLayout->height = height;
+   pLayout->numSlices = numSlices;
+   pLayout->entryBits = entryBits;
+   pLayout->pipes = GetNumPipes(pTileInfo);
+   pLayout->pipeInterleaveBytes = mPipeInterleaveBytes;
+
+   pLayout->macroTileColumns = macroWidth / MicroTileWidth;
+   pLayout->macroTileRows = macroHeight / MicroTileHeight;
+   pLayout->macroTilesPerRow = pitch / macroWidth;
+   pLayout->macroTilesPerColumn = height / macroHeight;
+
+   pLayout->macroTileEntries = pLayout->macroTileColumns * pLayout->macroTileRows / pLayout->pipes;
+   pLayout->sliceEntries = pLayout->macroTileEntries * pLayout->macroTilesPerRow * pLayout->macroTilesPerColumn;
+
+   // The pipe of a tile only depends on the low 3 bits of its x and y, and the y bits always
+   // give every pipe one row of a group of pipes rows
+   std::memset(pLayout->pipeRow, 0, sizeof(pLayout->pipeRow));
+
+   for (auto tileX = 0u; tileX < 8; ++tileX) {
+      for (auto row = 0u; row < pLayout->pipes; ++row) {
+         auto pipe = HwlComputePipeFromCoord(tileX * MicroTileWidth, row * MicroTileHeight);
+         pLayout->pipeRow[tileX][pipe] = static_cast<uint8_t>(row);
+      }
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::ComputeTileDataAddrFromCoord
+*
+*   @brief
+*       Compute the address of the per tile data entry of pixel (x, y) of a slice
+*
+*   @return
+*       Byte address of the entry, and its bit position in *pBitPosition
+***************************************************************************************************
+*/
+uint64_t
+AddrLib::ComputeTileDataAddrFromCoord(const AddrTileDataLayout *pLayout,
+                                      uint32_t x,
+                                      uint32_t y,
+                                      uint32_t slice,
+                                      uint32_t *pBitPosition) const
+{
+   auto tileX = x / MicroTileWidth;
+   auto tileY = y / MicroTileHeight;
+   auto macroIndex = static_cast<uint64_t>(tileY / pLayout->macroTileRows) * pLayout->macroTilesPerRow
+      + tileX / pLayout->macroTileColumns;
+   auto row = (tileY % pLayout->macroTileRows) / pLayout->pipes;
+   auto column = tileX % pLayout->macroTileColumns;
+
+   auto entry = slice * pLayout->sliceEntries
+      + macroIndex * pLayout->macroTileEntries
+      + row * pLayout->macroTileColumns
+      + column;
+
+   return GetTileDataAddr(pLayout,
+                          entry * pLayout->entryBits,
+                          HwlComputePipeFromCoord(x, y),
+                          pBitPosition);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::CopyTileData
+*
+*   @brief
+*       Copy the per tile data entries of a region between the tile data and a linear array of
+*       entries, the region is in tiles and the linear array starts at its first tile. Entries
+*       smaller than a byte take a byte each in the linear array, in its low bits.
+*
+*       The entries are visited in address order, one pipe interleave group at a time, so
+*       every cache line of the tile data is touched once. Macro tiles outside the region are
+*       skipped.
+*
+*   @return
+*       N/A
+***************************************************************************************************
+*/
+void
+AddrLib::CopyTileData(const AddrTileDataLayout *pLayout,
+                      uint8_t *pTileData,
+                      uint8_t *pLinear,
+                      uint32_t linearPitch,
+                      uint64_t linearSliceSize,
+                      const ADDR_COPY_REGION *pTileRegion,
+                      bool toLinear) const
+{
+   auto entryBytes = std::max(pLayout->entryBits / BITS_PER_BYTE, 1u);
+   auto entryMask = static_cast<uint8_t>((1u << (pLayout->entryBits % BITS_PER_BYTE)) - 1);
+   auto groupEntries = static_cast<uint64_t>(pLayout->pipeInterleaveBytes) * BITS_PER_BYTE / pLayout->entryBits;
+   auto endX = pTileRegion->x + pTileRegion->width;
+   auto endY = pTileRegion->y + pTileRegion->height;
+   auto entry = pTileRegion->slice * pLayout->sliceEntries;
+   auto endEntry = (pTileRegion->slice + pTileRegion->depth) * pLayout->sliceEntries;
+
+   while (entry < endEntry) {
+      AddrTileDataCursor start;
+      SetTileDataCursor(pLayout, entry, &start);
+
+      auto macroX = start.macroX * pLayout->macroTileColumns;
+      auto macroY = start.macroY * pLayout->macroTileRows;
+
+      if (macroX >= endX || macroX + pLayout->macroTileColumns <= pTileRegion->x ||
+          macroY >= endY || macroY + pLayout->macroTileRows <= pTileRegion->y) {
+         entry = (entry / pLayout->macroTileEntries + 1) * pLayout->macroTileEntries;
+         continue;
+      }
+
+      auto groupEnd = std::min((entry / groupEntries + 1) * groupEntries, endEntry);
+
+      for (auto pipe = 0u; pipe < pLayout->pipes; ++pipe) {
+         auto cursor = start;
+
+         for (auto pipeEntry = entry; pipeEntry < groupEnd; ++pipeEntry) {
+            auto tileX = cursor.macroX * pLayout->macroTileColumns + cursor.column;
+            auto tileY = cursor.macroY * pLayout->macroTileRows
+               + cursor.row * pLayout->pipes
+               + pLayout->pipeRow[tileX % 8][pipe];
+
+            if (tileX >= pTileRegion->x && tileX < endX && tileY >= pTileRegion->y && tileY < endY) {
+               auto bitPosition = uint32_t { 0 };
+               auto pEntry = pTileData + GetTileDataAddr(pLayout, pipeEntry * pLayout->entryBits, pipe, &bitPosition);
+               auto pLinearEntry = pLinear
+                  + (cursor.slice - pTileRegion->slice) * linearSliceSize
+                  + static_cast<uint64_t>(tileY - pTileRegion->y) * linearPitch
+                  + (tileX - pTileRegion->x) * entryBytes;
+
+               if (entryMask) {
+                  auto mask = static_cast<uint8_t>(entryMask << bitPosition);
+
+                  if (toLinear) {
+                     *pLinearEntry = static_cast<uint8_t>((*pEntry & mask) >> bitPosition);
+                  } else {
+                     *pEntry = static_cast<uint8_t>((*pEntry & ~mask) | ((*pLinearEntry << bitPosition) & mask));
+                  }
+               } else if (toLinear) {
+                  std::memcpy(pLinearEntry, pEntry, entryBytes);
+               } else {
+                  std::memcpy(pEntry, pLinearEntry, entryBytes);
+               }
+            }
+
+            AdvanceTileDataCursor(pLayout, &cursor);
+         }
+      }
+
+      entry = groupEnd;
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::ComputeHtileLayout
+*
+*   @brief
+*       Compute the HTILE layout of a depth surface
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrLib::ComputeHtileLayout(uint32_t pitch,
+                            uint32_t height,
+                            uint32_t numSlices,
+                            bool isLinear,
+                            AddrHtileBlockSize blockWidth,
+                            AddrHtileBlockSize blockHeight,
+                            ADDR_TILEINFO *pTileInfo,
+                            AddrTileDataLayout *pLayout) const
+{
+   if (pitch == 0 || height == 0) {
+      return ADDR_INVALIDPARAMS;
+   }
+
+   auto paddedPitch = uint32_t { 0 };
+   auto paddedHeight = uint32_t { 0 };
+   auto macroWidth = uint32_t { 0 };
+   auto macroHeight = uint32_t { 0 };
+
+   numSlices = std::max(numSlices, 1u);
+
+   auto bpp = ComputeHtileInfo(pitch,
+                               height,
+                               numSlices,
+                               isLinear,
+                               blockWidth == ADDR_HTILE_BLOCKSIZE_8,
+                               blockHeight == ADDR_HTILE_BLOCKSIZE_8,
+                               pTileInfo,
+                               &paddedPitch,
+                               &paddedHeight,
+                               nullptr,
+                               &macroWidth,
+                               &macroHeight,
+                               nullptr,
+                               nullptr);
+
+   ComputeTileDataLayout(paddedPitch,
+                         paddedHeight,
+                         numSlices,
+                         bpp,
+                         macroWidth,
+                         macroHeight,
+                         pTileInfo,
+                         pLayout);
+
+   return ADDR_OK;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::CopyHtile
+*
+*   @brief
+*       Copy the HTILE of a depth surface or region to or from a linear array of tiles
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrLib::CopyHtile(const ADDR_COPY_HTILE_INPUT *pIn,
+                   bool toLinear) const
+{
+   AddrTileDataLayout layout;
+   ADDR_COPY_REGION tileRegion;
+
+   if (!pIn->pHtile || !pIn->pLinear) {
+      return ADDR_INVALIDPARAMS;
+   }
+
+   auto returnCode = ComputeHtileLayout(pIn->pitch,
+                                        pIn->height,
+                                        pIn->numSlices,
+                                        pIn->isLinear,
+                                        pIn->blockWidth,
+                                        pIn->blockHeight,
+                                        pIn->pTileInfo,
+                                        &layout);
+
+   if (returnCode != ADDR_OK) {
+      return returnCode;
+   }
+
+   returnCode = ComputeTileDataRegion(&layout, pIn->pRegion, &tileRegion);
+
+   if (returnCode != ADDR_OK || tileRegion.depth == 0) {
+      return returnCode;
+   }
+
+   auto entryBytes = layout.entryBits / BITS_PER_BYTE;
+   auto linearPitch = pIn->linearPitch ? pIn->linearPitch : tileRegion.width * entryBytes;
+   auto linearSliceSize = pIn->linearSliceSize ? pIn->linearSliceSize : static_cast<uint64_t>(linearPitch) * tileRegion.height;
+
+   CopyTileData(&layout,
+                static_cast<uint8_t *>(pIn->pHtile),
+                static_cast<uint8_t *>(pIn->pLinear),
+                linearPitch,
+                linearSliceSize,
+                &tileRegion,
+                toLinear);
+
+   return ADDR_OK;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::ComputeCmaskLayout
+*
+*   @brief
+*       Compute the CMASK layout of a color surface
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrLib::ComputeCmaskLayout(uint32_t pitch,
+                            uint32_t height,
+                            uint32_t numSlices,
+                            bool isLinear,
+                            ADDR_TILEINFO *pTileInfo,
+                            AddrTileDataLayout *pLayout) const
+{
+   if (pitch == 0 || height == 0) {
+      return ADDR_INVALIDPARAMS;
+   }
+
+   auto paddedPitch = uint32_t { 0 };
+   auto paddedHeight = uint32_t { 0 };
+   auto macroWidth = uint32_t { 0 };
+   auto macroHeight = uint32_t { 0 };
+
+   numSlices = std::max(numSlices, 1u);
+
+   ComputeCmaskInfo(pitch,
+                    height,
+                    numSlices,
+                    isLinear,
+                    pTileInfo,
+                    &paddedPitch,
+                    &paddedHeight,
+                    nullptr,
+                    &macroWidth,
+                    &macroHeight,
+                    nullptr,
+                    nullptr);
+
+   ComputeTileDataLayout(paddedPitch,
+                         paddedHeight,
+                         numSlices,
+                         CmaskElemBits,
+                         macroWidth,
+                         macroHeight,
+                         pTileInfo,
+                         pLayout);
+
+   return ADDR_OK;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrLib::CopyCmask
+*
+*   @brief
+*       Copy the CMASK of a color surface or region to or from a linear array of tiles
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrLib::CopyCmask(const ADDR_COPY_CMASK_INPUT *pIn,
+                   bool toLinear) const
+{
+   AddrTileDataLayout layout;
+   ADDR_COPY_REGION tileRegion;
+
+   if (!pIn->pCmask || !pIn->pLinear) {
+      return ADDR_INVALIDPARAMS;
+   }
+
+   auto returnCode = ComputeCmaskLayout(pIn->pitch,
+                                        pIn->height,
+                                        pIn->numSlices,
+                                        pIn->isLinear,
+                                        pIn->pTileInfo,
+                                        &layout);
+
+   if (returnCode == ADDR_OK) {
+      returnCode = ComputeTileDataRegion(&layout, pIn->pRegion, &tileRegion);
+   }
+
+   if (returnCode != ADDR_OK || tileRegion.depth == 0) {
+      return returnCode;
+   }
+
+   // A byte per entry in the linear array
+   auto linearPitch = pIn->linearPitch ? pIn->linearPitch : tileRegion.width;
+   auto linearSliceSize = pIn->linearSliceSize ? pIn->linearSliceSize : static_cast<uint64_t>(linearPitch) * tileRegion.height;
+
+   CopyTileData(&layout,
+                static_cast<uint8_t *>(pIn->pCmask),
+                static_cast<uint8_t *>(pIn->pLinear),
+                linearPitch,
+                linearSliceSize,
+                &tileRegion,
+                toLinear);
+
+   return ADDR_OK;
+}
@@ -0,0 +1,577 @@
+/*
+ * Copyright  2014 Advanced Micro Devices, Inc.
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sub license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON-INFRINGEMENT. IN NO EVENT SHALL THE COPYRIGHT HOLDERS, AUTHORS
+ * AND/OR ITS SUPPLIERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ */
+
+/**
+***************************************************************************************************
+* @file  addrtrace.cpp
+* @brief Contains the AddrTrace class implementation.
+***************************************************************************************************
+*/
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <new>
+#include "addrtrace.h"
+
+// Ids are never reused, so a thread never mistakes a new AddrTrace at a freed address for the
+// one it cached its buffer for
+static std::atomic<uint64_t> sNextTraceId { 1 };
+
+static const uint8_t TracePadding[8] = { };
+
+
+/**
+***************************************************************************************************
+*   TraceAlign
+*
+*   @brief
+*       Rounds a byte count up to the 8 byte alignment of the stream blocks
+***************************************************************************************************
+*/
+static uint64_t
+TraceAlign(uint64_t bytes)
+{
+   return (bytes + 7) & ~uint64_t { 7 };
+}
+
+
+/**
+***************************************************************************************************
+*   GetTraceThreadId
+*
+*   @brief
+*       Returns the hash of the calling thread id which the chunk headers carry
+***************************************************************************************************
+*/
+static uint64_t
+GetTraceThreadId()
+{
+   return std::hash<std::thread::id>()(std::this_thread::get_id());
+}
+
+
+/**
+***************************************************************************************************
+*   AddrTrace::AddrTrace
+*
+*   @brief
+*       Constructor for the AddrTrace class.
+***************************************************************************************************
+*/
+AddrTrace::AddrTrace(const AddrClient *pClient, const ADDR_START_TRACE_INPUT *pIn) :
+   AddrObject(pClient),
+   mId(sNextTraceId.fetch_add(1, std::memory_order_relaxed)),
+   mWrite(pIn->pfnWrite),
+   mWriteData(pIn->pWriteData),
+   mBufferSize(pIn->threadBufferSize ? pIn->threadBufferSize : TraceDefaultBufferSize),
+   mStart(std::chrono::steady_clock::now()),
+   mFailed(false),
+   mNumThreads(0)
+{
+   for (auto i = 0u; i < TraceMaxThreads; ++i) {
+      mThreads[i].store(std::thread::id(), std::memory_order_relaxed);
+      mBuffers[i].pData = nullptr;
+      mBuffers[i].used = 0;
+      mBuffers[i].threadId = 0;
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   AddrTrace::Create
+*
+*   @brief
+*       Creates an AddrTrace object and writes the stream header.
+*
+*   @return
+*       Returns an AddrTrace object pointer, nullptr if the allocation or the write failed.
+***************************************************************************************************
+*/
+AddrTrace *
+AddrTrace::Create(const AddrClient *pClient,
+                  const ADDR_START_TRACE_INPUT *pIn,
+                  const ADDR_CREATE_INPUT *pCreateIn)
+{
+   auto memory = AddrObject::ClientAlloc(sizeof(AddrTrace), pClient);
+
+   if (!memory) {
+      return nullptr;
+   }
+
+   auto pTrace = new (memory) AddrTrace(pClient, pIn);
+   auto startTime = std::chrono::system_clock::now().time_since_epoch();
+   ADDR_TRACE_HEADER header;
+
+   header.magic = ADDR_TRACE_MAGIC;
+   header.version = ADDR_TRACE_VERSION;
+   header.pointerBytes = sizeof(void *);
+   header.createInputBytes = sizeof(ADDR_CREATE_INPUT);
+   header.startTime = std::chrono::duration_cast<std::chrono::nanoseconds>(startTime).count();
+
+   pTrace->Write(&header, sizeof(header));
+   pTrace->Write(pCreateIn, sizeof(ADDR_CREATE_INPUT));
+   pTrace->Write(TracePadding, TraceAlign(sizeof(ADDR_CREATE_INPUT)) - sizeof(ADDR_CREATE_INPUT));
+
+   if (pTrace->mFailed.load(std::memory_order_relaxed)) {
+      pTrace->Stop();
+      pTrace = nullptr;
+   }
+
+   return pTrace;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrTrace::Stop
+*
+*   @brief
+*       Writes out the buffered records of every thread, then destroys the object and frees
+*       its memory.
+*
+*   @return
+*       ADDR_OK if every write succeeded, ADDR_ERROR otherwise
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrTrace::Stop()
+{
+   auto numThreads = std::min(mNumThreads.load(std::memory_order_acquire), TraceMaxThreads);
+
+   for (auto i = 0u; i < numThreads; ++i) {
+      FlushBuffer(i);
+
+      if (mBuffers[i].pData) {
+         AddrObject::ClientFree(mBuffers[i].pData, &mClient);
+      }
+   }
+
+   auto returnCode = mFailed.load(std::memory_order_relaxed) ? ADDR_ERROR : ADDR_OK;
+   auto client = mClient;
+   this->~AddrTrace();
+   AddrObject::ClientFree(this, &client);
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrTrace::GetThreadIndex
+*
+*   @brief
+*       Returns the buffer index of the calling thread, cached for the last AddrTrace it used
+*
+*   @return
+*       Buffer index, ADDR_TRACE_SHARED_THREAD when every buffer is taken
+***************************************************************************************************
+*/
+uint32_t
+AddrTrace::GetThreadIndex()
+{
+   static thread_local uint64_t sCachedId = 0;
+   static thread_local uint32_t sCachedIndex = 0;
+
+   if (sCachedId != mId) {
+      sCachedIndex = FindThreadIndex();
+      sCachedId = mId;
+   }
+
+   return sCachedIndex;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrTrace::FindThreadIndex
+*
+*   @brief
+*       Looks up the buffer the calling thread claimed, claiming and allocating a new one on
+*       its first call. A thread whose allocation failed writes its records directly.
+*
+*   @return
+*       Buffer index, ADDR_TRACE_SHARED_THREAD when every buffer is taken
+***************************************************************************************************
+*/
+uint32_t
+AddrTrace::FindThreadIndex()
+{
+   auto self = std::this_thread::get_id();
+   auto numThreads = std::min(mNumThreads.load(std::memory_order_acquire), TraceMaxThreads);
+
+   for (auto i = 0u; i < numThreads; ++i) {
+      if (mThreads[i].load(std::memory_order_relaxed) == self) {
+         return i;
+      }
+   }
+
+   auto index = mNumThreads.fetch_add(1, std::memory_order_acq_rel);
+
+   if (index >= TraceMaxThreads) {
+      return ADDR_TRACE_SHARED_THREAD;
+   }
+
+   mBuffers[index].pData = static_cast<uint8_t *>(AddrObject::ClientAlloc(mBufferSize, &mClient));
+   mBuffers[index].threadId = GetTraceThreadId();
+   mThreads[index].store(self, std::memory_order_relaxed);
+   return index;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrTrace::Write
+*
+*   @brief
+*       Passes bytes to the client sink, the caller serializes the calls. Nothing is written
+*       after the first failure.
+***************************************************************************************************
+*/
+void
+AddrTrace::Write(const void *pData, uint64_t numBytes)
+{
+   if (numBytes && !mFailed.load(std::memory_order_relaxed)) {
+      if (mWrite(mWriteData, pData, numBytes) != ADDR_OK) {
+         mFailed.store(true, std::memory_order_relaxed);
+      }
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   AddrTrace::FlushBuffer
+*
+*   @brief
+*       Writes the buffered records of a thread as one chunk
+***************************************************************************************************
+*/
+void
+AddrTrace::FlushBuffer(uint32_t threadIndex)
+{
+   auto pBuffer = &mBuffers[threadIndex];
+
+   if (pBuffer->used) {
+      ADDR_TRACE_CHUNK_HEADER chunk;
+      chunk.magic = ADDR_TRACE_CHUNK_MAGIC;
+      chunk.threadIndex = threadIndex;
+      chunk.threadId = pBuffer->threadId;
+      chunk.bytes = pBuffer->used;
+      std::memcpy(pBuffer->pData, &chunk, sizeof(chunk));
+
+      std::lock_guard<std::mutex> lock(mWriteMutex);
+      Write(pBuffer->pData, sizeof(chunk) + pBuffer->used);
+      pBuffer->used = 0;
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   AddrTrace::WriteChunk
+*
+*   @brief
+*       Writes one record as a chunk of its own, the caller holds mWriteMutex
+***************************************************************************************************
+*/
+void
+AddrTrace::WriteChunk(uint32_t threadIndex,
+                      uint64_t threadId,
+                      const ADDR_TRACE_RECORD_HEADER *pHeader,
+                      const AddrTraceSegment *pSegments)
+{
+   ADDR_TRACE_CHUNK_HEADER chunk;
+   chunk.magic = ADDR_TRACE_CHUNK_MAGIC;
+   chunk.threadIndex = threadIndex;
+   chunk.threadId = threadId;
+   chunk.bytes = pHeader->bytes;
+
+   Write(&chunk, sizeof(chunk));
+   Write(pHeader, sizeof(ADDR_TRACE_RECORD_HEADER));
+
+   for (auto i = 0u; i < pHeader->numSegments; ++i) {
+      Write(&pSegments[i].bytes, sizeof(uint64_t));
+      Write(pSegments[i].pData, pSegments[i].bytes);
+      Write(TracePadding, TraceAlign(pSegments[i].bytes) - pSegments[i].bytes);
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   AddrTrace::Record
+*
+*   @brief
+*       Appends a call which started at startNs to the buffer of the calling thread. Records
+*       which do not fit an empty buffer, and those of threads without one, are written
+*       directly after the buffered ones.
+***************************************************************************************************
+*/
+void
+AddrTrace::Record(AddrStatsEntry entry,
+                  uint64_t startNs,
+                  ADDR_E_RETURNCODE returnCode,
+                  const AddrTraceSegment *pSegments,
+                  uint32_t numSegments)
+{
+   if (mFailed.load(std::memory_order_relaxed)) {
+      return;
+   }
+
+   ADDR_TRACE_RECORD_HEADER header;
+   header.entry = entry;
+   header.returnCode = returnCode;
+   header.startNs = startNs;
+   header.durationNs = Now() - startNs;
+   header.numSegments = numSegments;
+   header.reserved = 0;
+   header.bytes = sizeof(header);
+
+   for (auto i = 0u; i < numSegments; ++i) {
+      header.bytes += sizeof(uint64_t) + TraceAlign(pSegments[i].bytes);
+   }
+
+   auto threadIndex = GetThreadIndex();
+   auto capacity = uint64_t { mBufferSize } - std::min<uint64_t>(mBufferSize, sizeof(ADDR_TRACE_CHUNK_HEADER));
+
+   if (threadIndex != ADDR_TRACE_SHARED_THREAD && mBuffers[threadIndex].pData && header.bytes <= capacity) {
+      auto pBuffer = &mBuffers[threadIndex];
+
+      if (pBuffer->used + header.bytes > capacity) {
+         FlushBuffer(threadIndex);
+      }
+
+      auto pDst = pBuffer->pData + sizeof(ADDR_TRACE_CHUNK_HEADER) + pBuffer->used;
+      std::memcpy(pDst, &header, sizeof(header));
+      pDst += sizeof(header);
+
+      for (auto i = 0u; i < numSegments; ++i) {
+         auto bytes = pSegments[i].bytes;
+         std::memcpy(pDst, &bytes, sizeof(uint64_t));
+         pDst += sizeof(uint64_t);
+
+         if (bytes) {
+            std::memcpy(pDst, pSegments[i].pData, bytes);
+         }
+
+         std::memset(pDst + bytes, 0, TraceAlign(bytes) - bytes);
+         pDst += TraceAlign(bytes);
+      }
+
+      pBuffer->used += header.bytes;
+   } else {
+      auto threadId = uint64_t { 0 };
+
+      if (threadIndex != ADDR_TRACE_SHARED_THREAD) {
+         FlushBuffer(threadIndex);
+         threadId = mBuffers[threadIndex].threadId;
+      } else {
+         threadId = GetTraceThreadId();
+      }
+
+      std::lock_guard<std::mutex> lock(mWriteMutex);
+      WriteChunk(threadIndex, threadId, &header, pSegments);
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   ReadTraceChunk
+*
+*   @brief
+*       Decodes the records of one chunk and passes them to pIn->pfnRecord, clearing
+*       *pKeepReading when the callback asks to stop
+*
+*   @return
+*       ADDR_OK if the records are valid, ADDR_INVALIDPARAMS otherwise
+***************************************************************************************************
+*/
+static ADDR_E_RETURNCODE
+ReadTraceChunk(const ADDR_READ_TRACE_INPUT *pIn,
+               const ADDR_TRACE_CHUNK_HEADER *pChunk,
+               const uint8_t *pRecords,
+               bool *pKeepReading,
+               ADDR_READ_TRACE_OUTPUT *pOut)
+{
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+   auto offset = uint64_t { 0 };
+
+   while (returnCode == ADDR_OK && *pKeepReading && offset < pChunk->bytes) {
+      auto remaining = pChunk->bytes - offset;
+      ADDR_TRACE_RECORD_HEADER header;
+      ADDR_TRACE_RECORD record;
+
+      if (remaining < sizeof(header)) {
+         returnCode = ADDR_INVALIDPARAMS;
+         break;
+      }
+
+      std::memcpy(&header, pRecords + offset, sizeof(header));
+
+      if (header.entry >= ADDR_STATS_ENTRY_COUNT ||
+          header.numSegments > ADDR_TRACE_MAX_SEGMENTS ||
+          header.bytes < sizeof(header) ||
+          header.bytes > remaining ||
+          header.bytes != TraceAlign(header.bytes)) {
+         returnCode = ADDR_INVALIDPARAMS;
+         break;
+      }
+
+      record.entry = static_cast<AddrStatsEntry>(header.entry);
+      record.returnCode = static_cast<ADDR_E_RETURNCODE>(header.returnCode);
+      record.threadIndex = pChunk->threadIndex;
+      record.threadId = pChunk->threadId;
+      record.startNs = header.startNs;
+      record.durationNs = header.durationNs;
+      record.numSegments = header.numSegments;
+
+      auto segmentOffset = uint64_t { sizeof(header) };
+
+      for (auto i = 0u; i < ADDR_TRACE_MAX_SEGMENTS; ++i) {
+         record.pSegments[i] = nullptr;
+         record.segmentBytes[i] = 0;
+
+         if (i < header.numSegments && returnCode == ADDR_OK) {
+            auto bytes = uint64_t { 0 };
+
+            if (header.bytes - segmentOffset < sizeof(uint64_t)) {
+               returnCode = ADDR_INVALIDPARAMS;
+               break;
+            }
+
+            std::memcpy(&bytes, pRecords + offset + segmentOffset, sizeof(uint64_t));
+            segmentOffset += sizeof(uint64_t);
+
+            if (bytes > header.bytes - segmentOffset || TraceAlign(bytes) > header.bytes - segmentOffset) {
+               returnCode = ADDR_INVALIDPARAMS;
+               break;
+            }
+
+            record.pSegments[i] = pRecords + offset + segmentOffset;
+            record.segmentBytes[i] = bytes;
+            segmentOffset += TraceAlign(bytes);
+         }
+      }
+
+      if (returnCode == ADDR_OK && segmentOffset != header.bytes) {
+         returnCode = ADDR_INVALIDPARAMS;
+      }
+
+      if (returnCode == ADDR_OK) {
+         pOut->numRecords++;
+
+         if (pIn->pfnRecord) {
+            *pKeepReading = pIn->pfnRecord(pIn->pRecordData, &record);
+         }
+      }
+
+      offset += header.bytes;
+   }
+
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   AddrTrace::Read
+*
+*   @brief
+*       Interface function stub of AddrReadTrace.
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrTrace::Read(const ADDR_READ_TRACE_INPUT *pIn, ADDR_READ_TRACE_OUTPUT *pOut)
+{
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+   auto pData = static_cast<const uint8_t *>(pIn->pData);
+   auto offset = uint64_t { 0 };
+   auto keepReading = true;
+   ADDR_TRACE_HEADER header;
+
+   pOut->startTime = 0;
+   pOut->pCreateIn = nullptr;
+   pOut->numThreads = 0;
+   pOut->numChunks = 0;
+   pOut->numRecords = 0;
+
+   if (!pData || (reinterpret_cast<uintptr_t>(pData) & 7) || pIn->dataSize < sizeof(header)) {
+      returnCode = ADDR_INVALIDPARAMS;
+   }
+
+   if (returnCode == ADDR_OK) {
+      std::memcpy(&header, pData, sizeof(header));
+      offset = TraceAlign(sizeof(header) + header.createInputBytes);
+
+      if (header.magic != ADDR_TRACE_MAGIC ||
+          header.version != ADDR_TRACE_VERSION ||
+          header.pointerBytes != sizeof(void *) ||
+          header.createInputBytes != sizeof(ADDR_CREATE_INPUT) ||
+          offset > pIn->dataSize) {
+         returnCode = ADDR_INVALIDPARAMS;
+      }
+   }
+
+   if (returnCode == ADDR_OK) {
+      pOut->startTime = header.startTime;
+      pOut->pCreateIn = reinterpret_cast<const ADDR_CREATE_INPUT *>(pData + sizeof(header));
+   }
+
+   while (returnCode == ADDR_OK && keepReading && offset < pIn->dataSize) {
+      ADDR_TRACE_CHUNK_HEADER chunk;
+
+      if (pIn->dataSize - offset < sizeof(chunk)) {
+         returnCode = ADDR_INVALIDPARAMS;
+         break;
+      }
+
+      std::memcpy(&chunk, pData + offset, sizeof(chunk));
+      offset += sizeof(chunk);
+
+      if (chunk.magic != ADDR_TRACE_CHUNK_MAGIC ||
+          chunk.bytes > pIn->dataSize - offset ||
+          chunk.bytes != TraceAlign(chunk.bytes)) {
+         returnCode = ADDR_INVALIDPARAMS;
+         break;
+      }
+
+      pOut->numChunks++;
+
+      if (chunk.threadIndex != ADDR_TRACE_SHARED_THREAD) {
+         pOut->numThreads = std::max(pOut->numThreads, chunk.threadIndex + 1);
+      }
+
+      returnCode = ReadTraceChunk(pIn, &chunk, pData + offset, &keepReading, pOut);
+      offset += chunk.bytes;
+   }
+
+   return returnCode;
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright  2014 Advanced Micro Devices, Inc.
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sub license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON-INFRINGEMENT. IN NO EVENT SHALL THE COPYRIGHT HOLDERS, AUTHORS
+ * AND/OR ITS SUPPLIERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ */
+
+/**
+***************************************************************************************************
+* @file  addrtrace.h
+* @brief Contains the AddrTrace class definition.
+***************************************************************************************************
+*/
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include "addrobject.h"
+
+static const uint32_t TraceMaxThreads = 64;
+static const uint32_t TraceDefaultBufferSize = 64 * 1024;
+
+
+/**
+***************************************************************************************************
+* AddrTraceSegment
+*
+*   @brief
+*       One structure or array of a recorded call
+***************************************************************************************************
+*/
+struct AddrTraceSegment
+{
+   const void *pData;
+   uint64_t bytes;
+};
+
+
+/**
+***************************************************************************************************
+* @brief Returns the segment of an array of count elements, empty when pData is nullptr
+***************************************************************************************************
+*/
+inline AddrTraceSegment
+AddrTraceArray(const void *pData, uint64_t count, uint64_t elemBytes)
+{
+   AddrTraceSegment segment;
+   segment.pData = pData;
+   segment.bytes = pData ? count * elemBytes : 0;
+   return segment;
+}
+
+
+/**
+***************************************************************************************************
+* AddrTraceBuffer
+*
+*   @brief
+*       Records of one thread not written yet, on their own cache line so threads never share
+*       it. pData starts with room for the chunk header.
+***************************************************************************************************
+*/
+struct alignas(64) AddrTraceBuffer
+{
+   uint8_t *pData;
+   uint64_t used;
+   uint64_t threadId;
+};
+
+
+/**
+***************************************************************************************************
+* @brief Records the calls of one AddrLib to a client sink in the stream format of
+*        ADDR_TRACE_HEADER
+***************************************************************************************************
+*/
+class AddrTrace : public AddrObject
+{
+public:
+   AddrTrace(const AddrClient *pClient, const ADDR_START_TRACE_INPUT *pIn);
+
+   static AddrTrace *
+   Create(const AddrClient *pClient,
+          const ADDR_START_TRACE_INPUT *pIn,
+          const ADDR_CREATE_INPUT *pCreateIn);
+
+   ADDR_E_RETURNCODE
+   Stop();
+
+   static ADDR_E_RETURNCODE
+   Read(const ADDR_READ_TRACE_INPUT *pIn, ADDR_READ_TRACE_OUTPUT *pOut);
+
+   // Nanoseconds since recording started
+   uint64_t
+   Now() const
+   {
+      auto elapsed = std::chrono::steady_clock::now() - mStart;
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+   }
+
+   void
+   Record(AddrStatsEntry entry,
+          uint64_t startNs,
+          ADDR_E_RETURNCODE returnCode,
+          const AddrTraceSegment *pSegments,
+          uint32_t numSegments);
+
+protected:
+   uint32_t
+   GetThreadIndex();
+
+   uint32_t
+   FindThreadIndex();
+
+   void
+   FlushBuffer(uint32_t threadIndex);
+
+   void
+   Write(const void *pData, uint64_t numBytes);
+
+   void
+   WriteChunk(uint32_t threadIndex,
+              uint64_t threadId,
+              const ADDR_TRACE_RECORD_HEADER *pHeader,
+              const AddrTraceSegment *pSegments);
+
+protected:
+   uint64_t mId;
+   ADDR_TRACE_WRITE mWrite;
+   void *mWriteData;
+   uint32_t mBufferSize;
+   std::chrono::steady_clock::time_point mStart;
+
+   // Serializes the sink, held while a chunk is written
+   std::mutex mWriteMutex;
+   std::atomic<bool> mFailed;
+
+   std::atomic<uint32_t> mNumThreads;
+   std::atomic<std::thread::id> mThreads[TraceMaxThreads];
+   AddrTraceBuffer mBuffers[TraceMaxThreads];
+};
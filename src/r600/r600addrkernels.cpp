@@ -0,0 +1,506 @@
+/*
+ * Copyright  2014 Advanced Micro Devices, Inc.
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sub license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON-INFRINGEMENT. IN NO EVENT SHALL THE COPYRIGHT HOLDERS, AUTHORS
+ * AND/OR ITS SUPPLIERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ */
+
+/**
+***************************************************************************************************
+* @file  r600addrkernels.cpp
+* @brief Contains the surface plan address kernels, with compile time specialised macro tiled
+*        kernels for the common R600 pipe, bank and interleave configurations, and the bank
+*        pipe table gathers.
+***************************************************************************************************
+*/
+
+#include "r600addrlib.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define ADDR_X86_KERNELS 1
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#define ADDR_TARGET(features)
+#else
+#define ADDR_TARGET(features) __attribute__((target(features)))
+#endif
+#endif
+
+
+/**
+***************************************************************************************************
+*   PlanAddrFromCoordLinear
+*
+*   @brief
+*       Plan version of ComputeSurfaceAddrFromCoordLinear
+*
+*   @return
+*       The byte address
+***************************************************************************************************
+*/
+static uint64_t
+PlanAddrFromCoordLinear(const R600SurfacePlanTerms *pTerms,
+                        uint32_t x,
+                        uint32_t y,
+                        uint32_t slice,
+                        uint32_t sample,
+                        uint32_t *pBitPosition)
+{
+   const auto &layout = pTerms->layout;
+   uint64_t image = slice + static_cast<uint64_t>(sample) * layout.numSlices;
+   uint64_t bits = (image * pTerms->imageElems + static_cast<uint64_t>(y) * layout.pitch + x) * layout.bpp;
+
+   *pBitPosition = static_cast<uint32_t>(bits % 8);
+   return bits / 8;
+}
+
+
+/**
+***************************************************************************************************
+*   PlanAddrFromCoordMicroTiled
+*
+*   @brief
+*       Plan version of ComputeSurfaceAddrFromCoordMicroTiled, the samples of a 1D tiled
+*       surface share the same memory so the sample is not used
+*
+*   @return
+*       The byte address
+***************************************************************************************************
+*/
+static uint64_t
+PlanAddrFromCoordMicroTiled(const R600SurfacePlanTerms *pTerms,
+                            uint32_t x,
+                            uint32_t y,
+                            uint32_t slice,
+                            uint32_t /*sample*/,
+                            uint32_t *pBitPosition)
+{
+   const auto &layout = pTerms->layout;
+   uint64_t pixelIndex = pTerms->pPixelIndex[(slice % XThickTileThickness) * MicroTilePixels
+                                             + (y % MicroTileHeight) * MicroTileWidth
+                                             + (x % MicroTileWidth)];
+   uint64_t bits = pTerms->baseBits + pTerms->pixelBits * pixelIndex;
+   uint64_t microTileOffset = layout.microTileBytes * (x / MicroTileWidth + (y / MicroTileHeight) * layout.microTilesPerRow);
+
+   *pBitPosition = static_cast<uint32_t>(bits % 8);
+   return bits / 8 + microTileOffset + (slice >> pTerms->thicknessShift) * layout.sliceBytes;
+}
+
+
+/**
+***************************************************************************************************
+*   PlanAddrFromCoordMacroTiled
+*
+*   @brief
+*       Plan version of ComputeSurfaceAddrFromCoordMacroTiled for any GPU configuration
+*
+*   @return
+*       The byte address
+***************************************************************************************************
+*/
+static uint64_t
+PlanAddrFromCoordMacroTiled(const R600SurfacePlanTerms *pTerms,
+                            uint32_t x,
+                            uint32_t y,
+                            uint32_t slice,
+                            uint32_t sample,
+                            uint32_t *pBitPosition)
+{
+   const auto &layout = pTerms->layout;
+   uint64_t pixelIndex = pTerms->pPixelIndex[(slice % XThickTileThickness) * MicroTilePixels
+                                             + (y % MicroTileHeight) * MicroTileWidth
+                                             + (x % MicroTileWidth)];
+   uint64_t elemOffset = pTerms->baseBits + pTerms->sampleBits * sample + pTerms->pixelBits * pixelIndex;
+   uint64_t sampleSlice = 0;
+
+   *pBitPosition = static_cast<uint32_t>(elemOffset % 8);
+
+   if (layout.numSampleSplits > 1) {
+      sampleSlice = elemOffset / layout.tileSliceBits;
+      elemOffset %= layout.tileSliceBits;
+   }
+
+   uint64_t bankPipe = pTerms->pLib->ComputeBankPipeFromCoordWoRotation(x, y);
+   uint64_t sliceIn = slice >> pTerms->rotationSliceShift;
+
+   bankPipe ^= pTerms->sampleSliceSwizzle * sampleSlice ^ (pTerms->swizzle + sliceIn * layout.rotation);
+   bankPipe &= pTerms->bankPipeMask;
+   uint64_t pipe = bankPipe & (pTerms->numPipes - 1);
+   uint64_t bank = bankPipe >> pTerms->pipeBits;
+
+   uint64_t macroTileIndexX = x >> pTerms->macroTilePitchShift;
+   uint64_t macroTileIndexY = y >> pTerms->macroTileHeightShift;
+   uint64_t macroTileOffset = layout.macroTileBytes * (macroTileIndexX + layout.macroTilesPerRow * macroTileIndexY);
+   uint64_t sliceOffset = layout.sliceBytes * ((sampleSlice + layout.numSampleSplits * slice) >> pTerms->thicknessShift);
+
+   if (layout.bankSwapWidth) {
+      uint64_t swapIndex = layout.macroTilePitch * macroTileIndexX / layout.bankSwapWidth;
+      bank ^= BankSwapOrder[swapIndex & (pTerms->numBanks - 1)];
+   }
+
+   uint64_t offset = ((macroTileOffset + sliceOffset) >> pTerms->bankPipeShift) + elemOffset / 8;
+
+   return ((offset & ~pTerms->groupMask) << pTerms->bankPipeShift)
+      | (bank << (pTerms->pipeBits + pTerms->groupBits))
+      | (pipe << pTerms->groupBits)
+      | (offset & pTerms->groupMask);
+}
+
+
+static constexpr bool
+IsFixedThickTileMode(AddrTileMode tileMode)
+{
+   return tileMode == ADDR_TM_2D_TILED_THICK || tileMode == ADDR_TM_2B_TILED_THICK
+      || tileMode == ADDR_TM_3D_TILED_THICK || tileMode == ADDR_TM_3B_TILED_THICK;
+}
+
+
+static constexpr bool
+IsFixedBankSwappedTileMode(AddrTileMode tileMode)
+{
+   return (tileMode >= ADDR_TM_2B_TILED_THIN1 && tileMode <= ADDR_TM_2B_TILED_THICK)
+      || tileMode == ADDR_TM_3B_TILED_THIN1 || tileMode == ADDR_TM_3B_TILED_THICK;
+}
+
+
+// Macro tiles of the THIN2 and THIN4 modes are narrower and taller by this factor
+static constexpr uint32_t
+FixedMacroTileAspect(AddrTileMode tileMode)
+{
+   return (tileMode == ADDR_TM_2D_TILED_THIN2 || tileMode == ADDR_TM_2B_TILED_THIN2) ? 2
+      : (tileMode == ADDR_TM_2D_TILED_THIN4 || tileMode == ADDR_TM_2B_TILED_THIN4) ? 4 : 1;
+}
+
+
+// Same as ComputeSurfaceRotationFromTileMode for the macro tiled modes
+static constexpr uint32_t
+FixedMacroTileRotation(uint32_t numPipes, uint32_t numBanks, AddrTileMode tileMode)
+{
+   return tileMode < ADDR_TM_3D_TILED_THIN1 ? numPipes * ((numBanks >> 1) - 1)
+      : numPipes >= 4 ? (numPipes >> 1) - 1 : 1;
+}
+
+
+/**
+***************************************************************************************************
+*   ComputeFixedPipeFromCoord
+*
+*   @brief
+*       ComputePipeFromCoordWoRotation for a compile time number of pipes
+*
+*   @return
+*       Pipe number
+***************************************************************************************************
+*/
+template<uint32_t NumPipes>
+static inline uint32_t
+ComputeFixedPipeFromCoord(uint32_t x, uint32_t y)
+{
+   static_assert(NumPipes == 1 || NumPipes == 2 || NumPipes == 4, "unsupported number of pipes");
+
+   if (NumPipes == 2) {
+      return _BIT(y, 3) ^ _BIT(x, 3);
+   } else if (NumPipes == 4) {
+      return (_BIT(y, 3) ^ _BIT(x, 4))
+         | ((_BIT(y, 4) ^ _BIT(x, 3)) << 1);
+   }
+
+   return 0;
+}
+
+
+/**
+***************************************************************************************************
+*   ComputeFixedBankFromCoord
+*
+*   @brief
+*       ComputeBankFromCoordWoRotation for a compile time number of pipes and banks
+*
+*   @note
+*       Only 8 pipe configurations use the optimal bank swap, so these are left to the
+*       generic kernel
+*
+*   @return
+*       Bank number
+***************************************************************************************************
+*/
+template<uint32_t NumPipes, uint32_t NumBanks>
+static inline uint32_t
+ComputeFixedBankFromCoord(uint32_t x, uint32_t y)
+{
+   static_assert(NumPipes != 8, "8 pipe configurations depend on optimalBankSwap");
+   static_assert(NumBanks == 4 || NumBanks == 8, "unsupported number of banks");
+
+   uint32_t ty = y / NumPipes;
+
+   if (NumBanks == 4) {
+      return (_BIT(ty, 4) ^ _BIT(x, 3))
+         | ((_BIT(ty, 3) ^ _BIT(x, 4)) << 1);
+   }
+
+   return (_BIT(ty, 5) ^ _BIT(x, 3))
+      | ((_BIT(ty, 5) ^ _BIT(ty, 4) ^ _BIT(x, 4)) << 1)
+      | ((_BIT(ty, 3) ^ _BIT(x, 5)) << 2);
+}
+
+
+/**
+***************************************************************************************************
+*   PlanAddrFromCoordFixedMacroTiled
+*
+*   @brief
+*       PlanAddrFromCoordMacroTiled with the pipes, banks, pipe interleave and tile mode known
+*       at compile time, which turns the pipe, bank, rotation and macro tile terms into
+*       constant shifts and masks
+*
+*   @return
+*       The byte address
+***************************************************************************************************
+*/
+template<uint32_t NumPipes, uint32_t NumBanks, uint32_t GroupBytes, AddrTileMode TileMode>
+static uint64_t
+PlanAddrFromCoordFixedMacroTiled(const R600SurfacePlanTerms *pTerms,
+                                 uint32_t x,
+                                 uint32_t y,
+                                 uint32_t slice,
+                                 uint32_t sample,
+                                 uint32_t *pBitPosition)
+{
+   static constexpr uint32_t PipeBits = Log2(NumPipes);
+   static constexpr uint32_t GroupBits = Log2(GroupBytes);
+   static constexpr uint32_t BankPipeShift = Log2(NumPipes) + Log2(NumBanks);
+   static constexpr uint64_t GroupMask = GroupBytes - 1;
+   static constexpr uint32_t Thickness = IsFixedThickTileMode(TileMode) ? ThickTileThickness : 1;
+   static constexpr uint32_t Aspect = FixedMacroTileAspect(TileMode);
+   static constexpr uint32_t MacroTilePitch = MicroTileWidth * NumBanks / Aspect;
+   static constexpr uint32_t MacroTileHeight = MicroTileHeight * NumPipes * Aspect;
+   static constexpr uint32_t Rotation = FixedMacroTileRotation(NumPipes, NumBanks, TileMode);
+   static constexpr uint32_t SampleSliceSwizzle = NumPipes * ((NumBanks >> 1) + 1);
+
+   const auto &layout = pTerms->layout;
+   uint64_t pixelIndex = pTerms->pPixelIndex[(slice % XThickTileThickness) * MicroTilePixels
+                                             + (y % MicroTileHeight) * MicroTileWidth
+                                             + (x % MicroTileWidth)];
+   uint64_t elemOffset = pTerms->baseBits + pTerms->sampleBits * sample + pTerms->pixelBits * pixelIndex;
+   uint64_t sampleSlice = 0;
+
+   *pBitPosition = static_cast<uint32_t>(elemOffset % 8);
+
+   if (layout.numSampleSplits > 1) {
+      sampleSlice = elemOffset / layout.tileSliceBits;
+      elemOffset %= layout.tileSliceBits;
+   }
+
+   uint64_t pipe = ComputeFixedPipeFromCoord<NumPipes>(x, y);
+   uint64_t bank = ComputeFixedBankFromCoord<NumPipes, NumBanks>(x, y);
+   uint64_t bankPipe = pipe + NumPipes * bank;
+   uint64_t sliceIn = slice / Thickness;
+
+   bankPipe ^= SampleSliceSwizzle * sampleSlice ^ (pTerms->swizzle + sliceIn * Rotation);
+   bankPipe &= NumPipes * NumBanks - 1;
+   pipe = bankPipe & (NumPipes - 1);
+   bank = bankPipe >> PipeBits;
+
+   uint64_t macroTileIndexX = x / MacroTilePitch;
+   uint64_t macroTileIndexY = y / MacroTileHeight;
+   uint64_t macroTileOffset = layout.macroTileBytes * (macroTileIndexX + layout.macroTilesPerRow * macroTileIndexY);
+   uint64_t sliceOffset = layout.sliceBytes * ((sampleSlice + layout.numSampleSplits * slice) / Thickness);
+
+   if (IsFixedBankSwappedTileMode(TileMode) && layout.bankSwapWidth) {
+      uint64_t swapIndex = MacroTilePitch * macroTileIndexX / layout.bankSwapWidth;
+      bank ^= BankSwapOrder[swapIndex & (NumBanks - 1)];
+   }
+
+   uint64_t offset = ((macroTileOffset + sliceOffset) >> BankPipeShift) + elemOffset / 8;
+
+   return ((offset & ~GroupMask) << BankPipeShift)
+      | (bank << (PipeBits + GroupBits))
+      | (pipe << GroupBits)
+      | (offset & GroupMask);
+}
+
+
+/**
+***************************************************************************************************
+* @brief Plan kernels of every tile mode for a compile time GPU configuration
+***************************************************************************************************
+*/
+template<uint32_t NumPipes, uint32_t NumBanks, uint32_t GroupBytes>
+struct R600FixedPlanAddrKernels
+{
+   static const R600PlanAddrKernel Kernels[ADDR_TM_3B_TILED_THICK + 1];
+};
+
+template<uint32_t NumPipes, uint32_t NumBanks, uint32_t GroupBytes>
+const R600PlanAddrKernel
+R600FixedPlanAddrKernels<NumPipes, NumBanks, GroupBytes>::Kernels[ADDR_TM_3B_TILED_THICK + 1] = {
+   PlanAddrFromCoordLinear,
+   PlanAddrFromCoordLinear,
+   PlanAddrFromCoordMicroTiled,
+   PlanAddrFromCoordMicroTiled,
+   PlanAddrFromCoordFixedMacroTiled<NumPipes, NumBanks, GroupBytes, ADDR_TM_2D_TILED_THIN1>,
+   PlanAddrFromCoordFixedMacroTiled<NumPipes, NumBanks, GroupBytes, ADDR_TM_2D_TILED_THIN2>,
+   PlanAddrFromCoordFixedMacroTiled<NumPipes, NumBanks, GroupBytes, ADDR_TM_2D_TILED_THIN4>,
+   PlanAddrFromCoordFixedMacroTiled<NumPipes, NumBanks, GroupBytes, ADDR_TM_2D_TILED_THICK>,
+   PlanAddrFromCoordFixedMacroTiled<NumPipes, NumBanks, GroupBytes, ADDR_TM_2B_TILED_THIN1>,
+   PlanAddrFromCoordFixedMacroTiled<NumPipes, NumBanks, GroupBytes, ADDR_TM_2B_TILED_THIN2>,
+   PlanAddrFromCoordFixedMacroTiled<NumPipes, NumBanks, GroupBytes, ADDR_TM_2B_TILED_THIN4>,
+   PlanAddrFromCoordFixedMacroTiled<NumPipes, NumBanks, GroupBytes, ADDR_TM_2B_TILED_THICK>,
+   PlanAddrFromCoordFixedMacroTiled<NumPipes, NumBanks, GroupBytes, ADDR_TM_3D_TILED_THIN1>,
+   PlanAddrFromCoordFixedMacroTiled<NumPipes, NumBanks, GroupBytes, ADDR_TM_3D_TILED_THICK>,
+   PlanAddrFromCoordFixedMacroTiled<NumPipes, NumBanks, GroupBytes, ADDR_TM_3B_TILED_THIN1>,
+   PlanAddrFromCoordFixedMacroTiled<NumPipes, NumBanks, GroupBytes, ADDR_TM_3B_TILED_THICK>,
+};
+
+
+static const R600PlanAddrKernel
+GenericPlanAddrKernels[ADDR_TM_3B_TILED_THICK + 1] = {
+   PlanAddrFromCoordLinear,
+   PlanAddrFromCoordLinear,
+   PlanAddrFromCoordMicroTiled,
+   PlanAddrFromCoordMicroTiled,
+   PlanAddrFromCoordMacroTiled,
+   PlanAddrFromCoordMacroTiled,
+   PlanAddrFromCoordMacroTiled,
+   PlanAddrFromCoordMacroTiled,
+   PlanAddrFromCoordMacroTiled,
+   PlanAddrFromCoordMacroTiled,
+   PlanAddrFromCoordMacroTiled,
+   PlanAddrFromCoordMacroTiled,
+   PlanAddrFromCoordMacroTiled,
+   PlanAddrFromCoordMacroTiled,
+   PlanAddrFromCoordMacroTiled,
+   PlanAddrFromCoordMacroTiled,
+};
+
+
+/**
+***************************************************************************************************
+*   R600SelectPlanAddrKernels
+*
+*   @brief
+*       Selects the plan kernels of a GPU configuration, configurations without specialised
+*       kernels use the generic ones
+*
+*   @return
+*       Plan kernels indexed by tile mode
+***************************************************************************************************
+*/
+const R600PlanAddrKernel *
+R600SelectPlanAddrKernels(uint32_t numPipes,
+                          uint32_t numBanks,
+                          uint32_t groupBytes)
+{
+   if (groupBytes == 256) {
+      if (numBanks == 4) {
+         if (numPipes == 1) {
+            return R600FixedPlanAddrKernels<1, 4, 256>::Kernels;
+         } else if (numPipes == 2) {
+            return R600FixedPlanAddrKernels<2, 4, 256>::Kernels;
+         } else if (numPipes == 4) {
+            return R600FixedPlanAddrKernels<4, 4, 256>::Kernels;
+         }
+      } else if (numBanks == 8) {
+         if (numPipes == 2) {
+            return R600FixedPlanAddrKernels<2, 8, 256>::Kernels;
+         } else if (numPipes == 4) {
+            return R600FixedPlanAddrKernels<4, 8, 256>::Kernels;
+         }
+      }
+   }
+
+   return GenericPlanAddrKernels;
+}
+
+
+#ifdef ADDR_X86_KERNELS
+/**
+***************************************************************************************************
+*   GatherBankPipeAvx2
+*
+*   @brief
+*       Looks up the bank pipe of eight coordinates at a time with AVX2 gathers, returns how
+*       many coordinates it handled
+*
+*   @return
+*       Number of coordinates looked up
+***************************************************************************************************
+*/
+ADDR_TARGET("avx2") static uint32_t
+GatherBankPipeAvx2(const uint8_t *pTable,
+                   const uint32_t *pX,
+                   const uint32_t *pY,
+                   uint32_t count,
+                   uint32_t *pBankPipe)
+{
+   const __m256i xMask = _mm256_set1_epi32(BankPipeTableWidth - 1);
+   const __m256i yMask = _mm256_set1_epi32(BankPipeTableHeight - 1);
+   const __m256i byteMask = _mm256_set1_epi32(0xFF);
+   auto i = 0u;
+
+   for (; i + 8 <= count; i += 8) {
+      __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pX + i));
+      __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pY + i));
+      __m256i tileX = _mm256_and_si256(_mm256_srli_epi32(x, 3), xMask);
+      __m256i tileY = _mm256_and_si256(_mm256_srli_epi32(y, 3), yMask);
+      __m256i index = _mm256_or_si256(_mm256_slli_epi32(tileY, Log2(BankPipeTableWidth)), tileX);
+
+      // Gathers 32 bits from every byte index, the table padding keeps the last one in bounds
+      __m256i bankPipe = _mm256_i32gather_epi32(reinterpret_cast<const int *>(pTable), index, 1);
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(pBankPipe + i), _mm256_and_si256(bankPipe, byteMask));
+   }
+
+   return i;
+}
+#endif
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::ComputeBankPipeFromCoordWoRotationBatch
+*
+*   @brief
+*       Gather version of ComputeBankPipeFromCoordWoRotation for arrays of coordinates
+*
+*   @return
+*       N/A
+***************************************************************************************************
+*/
+void
+R600AddrLib::ComputeBankPipeFromCoordWoRotationBatch(const uint32_t *pX,
+                                                     const uint32_t *pY,
+                                                     uint32_t count,
+                                                     uint32_t *pBankPipe) const
+{
+   auto i = 0u;
+
+#ifdef ADDR_X86_KERNELS
+   if (mCpuFeatures & ADDR_CPU_AVX2) {
+      i = GatherBankPipeAvx2(mBankPipeTable, pX, pY, count, pBankPipe);
+   }
+#endif
+
+   for (; i < count; ++i) {
+      pBankPipe[i] = mBankPipeTable[GetBankPipeTableIndex(pX[i], pY[i])];
+   }
+}
@@ -32,7 +32,10 @@
 */
 
 #include <algorithm>
+#include <cstring>
 #include <new>
+#include <thread>
+#include <vector>
 #include "r600addrlib.h"
 
 
@@ -48,9 +51,75 @@
 ***************************************************************************************************
 */
 AddrLib *
-AddrR600HwlInit(ADDR_CLIENT_HANDLE hClient)
+AddrR600HwlInit(const AddrClient *pClient, void *pMemory)
 {
-   return R600AddrLib::CreateObj(hClient);
+   return R600AddrLib::CreateObj(pClient, pMemory);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrR600GetInstanceSize
+*
+*   @brief
+*       Returns the size of an R600AddrLib object.
+*
+*   @return
+*       sizeof(R600AddrLib)
+***************************************************************************************************
+*/
+uint64_t
+AddrR600GetInstanceSize()
+{
+   return sizeof(R600AddrLib);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrR600GetTilingConfigs
+*
+*   @brief
+*       Enumerates every GB_TILING_CONFIG value DecodeGbRegs accepts, pConfigs may be nullptr
+*       to only count them
+*
+*   @return
+*       Number of tiling configurations
+***************************************************************************************************
+*/
+uint32_t
+AddrR600GetTilingConfigs(uint32_t *pConfigs)
+{
+   auto numConfigs = 0u;
+
+   for (auto pipes = 0u; pipes < 4; ++pipes) {
+      for (auto banks = 0u; banks < 2; ++banks) {
+         for (auto group = 0u; group <= ADDR_CONFIG_PIPE_INTERLEAVE_512B; ++group) {
+            for (auto row = 0u; row <= ADDR_CONFIG_8KB_ROW_OPT_BANK_SWAP; ++row) {
+               for (auto swap = 0u; swap <= ADDR_CONFIG_BANK_SWAP_1024B; ++swap) {
+                  for (auto split = 0u; split <= ADDR_CONFIG_SAMPLE_SPLIT_8KB; ++split) {
+                     if (pConfigs) {
+                        GB_TILING_CONFIG reg;
+
+                        reg.value = 0;
+                        reg.pipe_tiling = pipes;
+                        reg.bank_tiling = banks;
+                        reg.group_size = group;
+                        reg.row_tiling = row;
+                        reg.bank_swaps = swap;
+                        reg.sample_split = split;
+                        pConfigs[numConfigs] = reg.value;
+                     }
+
+                     numConfigs++;
+                  }
+               }
+            }
+         }
+      }
+   }
+
+   return numConfigs;
 }
 
 
@@ -63,10 +132,12 @@ AddrR600HwlInit(ADDR_CLIENT_HANDLE hClient)
 *
 ***************************************************************************************************
 */
-R600AddrLib::R600AddrLib(ADDR_CLIENT_HANDLE hClient) :
-   AddrLib(hClient),
+R600AddrLib::R600AddrLib(const AddrClient *pClient) :
+   AddrLib(pClient),
    mSwapSize(0),
-   mSplitSize(0)
+   mSplitSize(0),
+   mPlanAddrKernels(nullptr),
+   mPipeBits(0)
 {
    mClass = R600_ADDRLIB;
 }
@@ -84,10 +155,15 @@ R600AddrLib::R600AddrLib(ADDR_CLIENT_HANDLE hClient) :
 ***************************************************************************************************
 */
 R600AddrLib *
-R600AddrLib::CreateObj(ADDR_CLIENT_HANDLE hClient)
+R600AddrLib::CreateObj(const AddrClient *pClient, void *pMemory)
 {
-   auto memory = AddrObject::ClientAlloc(sizeof(R600AddrLib), hClient);
-   return new (memory) R600AddrLib(hClient);
+   auto memory = pMemory ? pMemory : AddrObject::ClientAlloc(sizeof(R600AddrLib), pClient);
+
+   if (!memory) {
+      return nullptr;
+   }
+
+   return new (memory) R600AddrLib(pClient);
 }
 
 
@@ -238,6 +314,12 @@ R600AddrLib::HwlInitGlobalParams(const ADDR_CREATE_INPUT *pCreateIn)
 {
    auto valid = DecodeGbRegs(&pCreateIn->regValue);
    mConfigFlags.no1DTiledMSAA = 1;
+   mPlanAddrKernels = R600SelectPlanAddrKernels(mPipes, mBanks, mPipeInterleaveBytes);
+
+   if (valid) {
+      BuildBankPipeTable();
+   }
+
    return valid;
 }
 
@@ -586,6 +668,7 @@ R600AddrLib::ComputeSurfaceMipLevelTileMode(AddrTileMode baseTileMode,
 
    tileMode = ConvertToNonBankSwappedMode(tileMode);
 
+   auto macroTiled = IsMacroTiled(tileMode);
    auto thickness = ComputeSurfaceThickness(tileMode);
    auto microTileBytes = BITS_TO_BYTES(numSamples * bpp * thickness * 64);
    auto widthAlignFactor = 1u;
@@ -629,6 +712,10 @@ R600AddrLib::ComputeSurfaceMipLevelTileMode(AddrTileMode baseTileMode,
       break;
    }
 
+   if (macroTiled && !IsMacroTiled(tileMode) && GetStatsCounters()) {
+      GetStatsCounters()->AddCounter(ADDR_STATS_MIP_TILE_MODE_DEGRADES, 1);
+   }
+
    if (tileMode == ADDR_TM_1D_TILED_THICK) {
       if (numSlices < 4) {
          tileMode = ADDR_TM_1D_TILED_THIN1;
@@ -1055,6 +1142,29 @@ R600AddrLib::IsThickMacroTiled(AddrTileMode tileMode) const
 }
 
 
+/**
+***************************************************************************************************
+*   R600AddrLib::IsSampleLargerThanSplit
+*
+*   @brief
+*       Check if one sample of a macro tiled multisampled micro tile is larger than the split
+*       size, no sample then fits in a sample slice and the layout cannot be computed
+*
+*   @return
+*       TRUE if no sample fits in the split size
+***************************************************************************************************
+*/
+bool
+R600AddrLib::IsSampleLargerThanSplit(AddrTileMode tileMode,
+                                     uint32_t bpp,
+                                     uint32_t numSamples) const
+{
+   uint64_t bytesPerSample = BITS_TO_BYTES(static_cast<uint64_t>(MicroTilePixels) * ComputeSurfaceThickness(tileMode) * bpp);
+
+   return numSamples > 1 && IsMacroTiled(tileMode) && bytesPerSample > mSplitSize;
+}
+
+
 /**
 ***************************************************************************************************
 *   R600AddrLib::IsBankSwappedTileMode
@@ -1451,17 +1561,18 @@ R600AddrLib::ComputeSurfaceAddrFromCoordMicroTiled(uint32_t x,
 
 /**
 ***************************************************************************************************
-*   R600AddrLib::ComputePipeFromCoordWoRotation
+*   R600AddrLib::ComputePipeEquation
 *
 *   @brief
-*       Computes the pipe index from coord
+*       Computes the pipe index from coord with the pipe equation, only used to build the
+*       bank pipe table
 *
 *   @return
 *       The pipe index
 ***************************************************************************************************
 */
 uint32_t
-R600AddrLib::ComputePipeFromCoordWoRotation(uint32_t x, uint32_t y) const
+R600AddrLib::ComputePipeEquation(uint32_t x, uint32_t y) const
 {
    uint32_t pipe;
    uint32_t pipeBit0 = 0;
@@ -1504,17 +1615,18 @@ R600AddrLib::ComputePipeFromCoordWoRotation(uint32_t x, uint32_t y) const
 
 /**
 ***************************************************************************************************
-*   R600AddrLib::ComputePipeFromCoordWoRotation
+*   R600AddrLib::ComputeBankEquation
 *
 *   @brief
-*       Computes the bank index from coord
+*       Computes the bank index from coord with the bank equation, only used to build the
+*       bank pipe table
 *
 *   @return
 *       The bank index
 ***************************************************************************************************
 */
 uint32_t
-R600AddrLib::ComputeBankFromCoordWoRotation(uint32_t x, uint32_t y) const
+R600AddrLib::ComputeBankEquation(uint32_t x, uint32_t y) const
 {
    uint32_t numPipes = mPipes;
    uint32_t numBanks = mBanks;
@@ -1566,6 +1678,141 @@ R600AddrLib::ComputeBankFromCoordWoRotation(uint32_t x, uint32_t y) const
 }
 
 
+/**
+***************************************************************************************************
+*   R600AddrLib::BuildBankPipeTable
+*
+*   @brief
+*       Evaluates the pipe and bank equations for one period of micro tiles
+*
+*   @return
+*       N/A
+***************************************************************************************************
+*/
+void
+R600AddrLib::BuildBankPipeTable()
+{
+   mPipeBits = Log2(mPipes);
+
+   for (auto tileY = 0u; tileY < BankPipeTableHeight; ++tileY) {
+      for (auto tileX = 0u; tileX < BankPipeTableWidth; ++tileX) {
+         auto x = tileX * MicroTileWidth;
+         auto y = tileY * MicroTileHeight;
+         auto bankPipe = ComputePipeEquation(x, y) + mPipes * ComputeBankEquation(x, y);
+
+         mBankPipeTable[GetBankPipeTableIndex(x, y)] = static_cast<uint8_t>(bankPipe);
+      }
+   }
+
+   std::fill(mBankPipeTable + BankPipeTableWidth * BankPipeTableHeight, std::end(mBankPipeTable), uint8_t { 0 });
+}
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::HwlVerifyLookupTables
+*
+*   @brief
+*       Compares the bank pipe table and its gather against the pipe and bank equations over
+*       two periods of x and y
+*
+*   @return
+*       Number of mismatching coordinates
+***************************************************************************************************
+*/
+uint64_t
+R600AddrLib::HwlVerifyLookupTables(uint64_t *pNumChecks,
+                                   uint32_t *pFirstX,
+                                   uint32_t *pFirstY) const
+{
+   static const uint32_t Width = 2 * BankPipeTableWidth * MicroTileWidth;
+   static const uint32_t Height = 2 * BankPipeTableHeight * MicroTileHeight;
+   uint32_t rowX[Width];
+   uint32_t rowY[Width];
+   uint32_t gathered[Width];
+   auto numMismatches = uint64_t { 0 };
+
+   for (auto x = 0u; x < Width; ++x) {
+      rowX[x] = x;
+   }
+
+   for (auto y = 0u; y < Height; ++y) {
+      std::fill(rowY, rowY + Width, y);
+      ComputeBankPipeFromCoordWoRotationBatch(rowX, rowY, Width, gathered);
+
+      for (auto x = 0u; x < Width; ++x) {
+         auto bankPipe = ComputePipeEquation(x, y) + mPipes * ComputeBankEquation(x, y);
+
+         if (ComputeBankPipeFromCoordWoRotation(x, y) != bankPipe || gathered[x] != bankPipe) {
+            if (numMismatches == 0) {
+               *pFirstX = x;
+               *pFirstY = y;
+            }
+
+            numMismatches++;
+         }
+      }
+   }
+
+   *pNumChecks = static_cast<uint64_t>(Width) * Height;
+   return numMismatches;
+}
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::ComputePipeFromCoordWoRotation
+*
+*   @brief
+*       Computes the pipe index from coord
+*
+*   @return
+*       The pipe index
+***************************************************************************************************
+*/
+uint32_t
+R600AddrLib::ComputePipeFromCoordWoRotation(uint32_t x, uint32_t y) const
+{
+   return mBankPipeTable[GetBankPipeTableIndex(x, y)] & (mPipes - 1);
+}
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::ComputeBankFromCoordWoRotation
+*
+*   @brief
+*       Computes the bank index from coord
+*
+*   @return
+*       The bank index
+***************************************************************************************************
+*/
+uint32_t
+R600AddrLib::ComputeBankFromCoordWoRotation(uint32_t x, uint32_t y) const
+{
+   return mBankPipeTable[GetBankPipeTableIndex(x, y)] >> mPipeBits;
+}
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::ComputeBankPipeFromCoordWoRotation
+*
+*   @brief
+*       Computes pipe + numPipes * bank from coord
+*
+*   @return
+*       The combined bank and pipe index
+***************************************************************************************************
+*/
+uint32_t
+R600AddrLib::ComputeBankPipeFromCoordWoRotation(uint32_t x, uint32_t y) const
+{
+   return mBankPipeTable[GetBankPipeTableIndex(x, y)];
+}
+
+
 /**
 ***************************************************************************************************
 *   R600AddrLib::ComputeSurfaceAddrFromCoordMicroTiled
@@ -1648,10 +1895,7 @@ R600AddrLib::ComputeSurfaceAddrFromCoordMacroTiled(uint32_t x,
 
    elemOffset /= 8;
 
-   uint64_t pipe = ComputePipeFromCoordWoRotation(x, y);
-   uint64_t bank = ComputeBankFromCoordWoRotation(x, y);
-
-   uint64_t bankPipe = pipe + numPipes * bank;
+   uint64_t bankPipe = ComputeBankPipeFromCoordWoRotation(x, y);
    uint64_t rotation = ComputeSurfaceRotationFromTileMode(tileMode);
    uint64_t swizzle = pipeSwizzle + numPipes * bankSwizzle;
    uint64_t sliceIn = slice;
@@ -1662,8 +1906,8 @@ R600AddrLib::ComputeSurfaceAddrFromCoordMacroTiled(uint32_t x,
 
    bankPipe ^= numPipes * sampleSlice * ((numBanks >> 1) + 1) ^ (swizzle + sliceIn * rotation);
    bankPipe %= numPipes * numBanks;
-   pipe = bankPipe % numPipes;
-   bank = bankPipe / numPipes;
+   uint64_t pipe = bankPipe % numPipes;
+   uint64_t bank = bankPipe / numPipes;
 
    uint64_t sliceBytes = BITS_TO_BYTES(pitch * height * microTileThickness * bpp * numSamples);
    uint64_t sliceOffset = sliceBytes * ((sampleSlice + numSampleSplits * slice) / microTileThickness);
@@ -1823,8 +2067,14 @@ R600AddrLib::HwlComputeSurfaceAddrFromCoord(const ADDR_COMPUTE_SURFACE_ADDRFROMC
     || pIn->y > pIn->height
     || pIn->numSamples > 8) {
       returnCode = ADDR_INVALIDPARAMS;
+   } else if (IsSampleLargerThanSplit(pIn->tileMode, pIn->bpp, pIn->numSamples)) {
+      returnCode = ADDR_NOTSUPPORTED;
    } else {
       pOut->addr = DispatchComputeSurfaceAddrFromCoord(pIn, pOut);
+
+      if (IsBankSwappedTileMode(pIn->tileMode) && GetStatsCounters()) {
+         GetStatsCounters()->AddCounter(ADDR_STATS_BANK_SWAPPED_LOOKUPS, 1);
+      }
    }
 
    return returnCode;
@@ -1957,6 +2207,60 @@ R600AddrLib::HwlComputeHtileBytes(uint32_t pitch,
 }
 
 
+/**
+***************************************************************************************************
+*   R600AddrLib::HwlComputePipeFromCoord
+*
+*   @brief
+*       Compute the pipe of the per tile data (HTILE and CMASK) of pixel (x, y)
+*
+*   @return
+*       The pipe index
+***************************************************************************************************
+*/
+uint32_t
+R600AddrLib::HwlComputePipeFromCoord(uint32_t x,
+                                     uint32_t y) const
+{
+   return ComputePipeFromCoordWoRotation(x, y);
+}
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::HwlComputeFmaskBits
+*
+*   @brief
+*       Compute the FMASK bits per sample and per pixel. A sample needs an index code per
+*       fragment, plus one for no fragment when there are fewer fragments than samples, the
+*       bits per sample are rounded to a power of 2 so no sample straddles a byte.
+*
+*   @return
+*       FMASK bpp, 0 if the sample and fragment counts are not supported
+***************************************************************************************************
+*/
+uint32_t
+R600AddrLib::HwlComputeFmaskBits(uint32_t numSamples,
+                                 uint32_t numFrags,
+                                 uint32_t *pBitsPerSample) const
+{
+   auto bpp = 0u;
+
+   if ((numSamples == 2 || numSamples == 4 || numSamples == 8)
+    && numFrags > 0
+    && numFrags <= numSamples
+    && IsPow2(numFrags)) {
+      auto numCodes = (numFrags < numSamples) ? numFrags + 1 : numFrags;
+      auto bitsPerSample = NextPow2(Log2(NextPow2(numCodes)));
+
+      *pBitsPerSample = bitsPerSample;
+      bpp = std::max(8u, bitsPerSample * numSamples);
+   }
+
+   return bpp;
+}
+
+
 /**
 ***************************************************************************************************
 *   R600AddrLib::ComputeSliceTileSwizzle
@@ -2014,3 +2318,2550 @@ R600AddrLib::HwlComputeSliceTileSwizzle(const ADDR_COMPUTE_SLICESWIZZLE_INPUT *p
 
    return ADDR_OK;
 }
+
+/**
+***************************************************************************************************
+*   R600AddrLib::ComputeSurfaceLayout
+*
+*   @brief
+*       Compute the coordinate independent terms of the surface address calculation
+*
+*   @return
+*       ADDR_NOTSUPPORTED if one sample of a micro tile is larger than the split size
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+R600AddrLib::ComputeSurfaceLayout(AddrTileMode tileMode,
+                                  uint32_t bpp,
+                                  uint32_t pitch,
+                                  uint32_t height,
+                                  uint32_t numSlices,
+                                  uint32_t numSamples,
+                                  bool isDepth,
+                                  uint32_t tileBase,
+                                  uint32_t compBits,
+                                  uint32_t pipeSwizzle,
+                                  uint32_t bankSwizzle,
+                                  R600SurfaceLayout *pLayout) const
+{
+   numSamples = std::max<uint32_t>(1u, numSamples);
+
+   if (IsSampleLargerThanSplit(tileMode, bpp, numSamples)) {
+      return ADDR_NOTSUPPORTED;
+   }
+
+   pLayout->tileMode = tileMode;
+   pLayout->tileType = GetTileType(isDepth);
+   pLayout->bpp = bpp;
+   pLayout->pitch = pitch;
+   pLayout->height = height;
+   pLayout->numSlices = std::max<uint32_t>(1u, numSlices);
+   pLayout->numSamples = numSamples;
+   pLayout->isDepth = isDepth;
+   pLayout->tileBase = tileBase;
+   pLayout->compBits = compBits;
+   pLayout->pipeSwizzle = pipeSwizzle;
+   pLayout->bankSwizzle = bankSwizzle;
+   pLayout->thickness = ComputeSurfaceThickness(tileMode);
+   pLayout->microTileBits = 0;
+   pLayout->microTileBytes = 0;
+   pLayout->microTilesPerRow = 0;
+   pLayout->sliceBytes = 0;
+   pLayout->numSampleSplits = 1;
+   pLayout->tileSliceBits = 0;
+   pLayout->macroTilePitch = 0;
+   pLayout->macroTileHeight = 0;
+   pLayout->macroTilesPerRow = 0;
+   pLayout->macroTileBytes = 0;
+   pLayout->bankSwapWidth = 0;
+   pLayout->rotation = 0;
+
+   uint64_t thickness = pLayout->thickness;
+
+   if (tileMode == ADDR_TM_LINEAR_GENERAL || tileMode == ADDR_TM_LINEAR_ALIGNED) {
+      pLayout->sliceBytes = BITS_TO_BYTES(static_cast<uint64_t>(pitch) * height * bpp);
+   } else if (tileMode == ADDR_TM_1D_TILED_THIN1 || tileMode == ADDR_TM_1D_TILED_THICK) {
+      pLayout->microTileBits = MicroTilePixels * thickness * bpp;
+      pLayout->microTileBytes = pLayout->microTileBits / 8;
+      pLayout->microTilesPerRow = pitch / MicroTileWidth;
+      pLayout->sliceBytes = BITS_TO_BYTES(static_cast<uint64_t>(pitch) * height * thickness * bpp);
+   } else if (IsMacroTiled(tileMode)) {
+      uint64_t microTileBits = MicroTilePixels * thickness * bpp * numSamples;
+      uint64_t microTileBytes = microTileBits / 8;
+      uint64_t bytesPerSample = microTileBytes / numSamples;
+      uint64_t samplesPerSlice = numSamples;
+
+      pLayout->microTileBits = microTileBits;
+      pLayout->microTileBytes = microTileBytes;
+      pLayout->tileSliceBits = microTileBits;
+
+      if (numSamples > 1 && microTileBytes > static_cast<uint64_t>(mSplitSize)) {
+         samplesPerSlice = mSplitSize / bytesPerSample;
+         pLayout->numSampleSplits = numSamples / samplesPerSlice;
+         pLayout->tileSliceBits = microTileBits / pLayout->numSampleSplits;
+      }
+
+      pLayout->sliceBytes = BITS_TO_BYTES(static_cast<uint64_t>(pitch) * height * thickness * bpp * samplesPerSlice);
+      pLayout->macroTilePitch = 8 * mBanks;
+      pLayout->macroTileHeight = 8 * mPipes;
+
+      switch (tileMode) {
+      case ADDR_TM_2D_TILED_THIN2:
+      case ADDR_TM_2B_TILED_THIN2:
+         pLayout->macroTilePitch /= 2;
+         pLayout->macroTileHeight *= 2;
+         break;
+      case ADDR_TM_2D_TILED_THIN4:
+      case ADDR_TM_2B_TILED_THIN4:
+         pLayout->macroTilePitch /= 4;
+         pLayout->macroTileHeight *= 4;
+         break;
+      }
+
+      pLayout->macroTilesPerRow = pitch / pLayout->macroTilePitch;
+      pLayout->macroTileBytes = BITS_TO_BYTES(samplesPerSlice * thickness * bpp * pLayout->macroTileHeight * pLayout->macroTilePitch);
+      pLayout->rotation = ComputeSurfaceRotationFromTileMode(tileMode);
+
+      if (IsBankSwappedTileMode(tileMode)) {
+         pLayout->bankSwapWidth = ComputeSurfaceBankSwappedWidth(tileMode, bpp, static_cast<uint32_t>(samplesPerSlice), pitch, nullptr);
+      }
+   }
+
+   return ADDR_OK;
+}
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::ComputeMacroTileBase
+*
+*   @brief
+*       Computes the pipe and bank bits and the pre-interleave byte offset shared by every
+*       element of the micro tile at (x, y, slice) within the given sample slice.
+*
+*   @return
+*       Byte offset to add the element offset to before interleaving pipe and bank bits
+***************************************************************************************************
+*/
+uint64_t
+R600AddrLib::ComputeMacroTileBase(const R600SurfaceLayout *pLayout,
+                                  uint32_t x,
+                                  uint32_t y,
+                                  uint32_t slice,
+                                  uint32_t sampleSlice,
+                                  uint64_t *pBankPipeBits) const
+{
+   return ComputeMacroTileBase(pLayout, ComputeBankPipeFromCoordWoRotation(x, y), x, y, slice, sampleSlice, pBankPipeBits);
+}
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::ComputeMacroTileBase
+*
+*   @brief
+*       ComputeMacroTileBase with the unrotated bank pipe of (x, y) already looked up
+*
+*   @return
+*       Byte offset to add the element offset to before interleaving pipe and bank bits
+***************************************************************************************************
+*/
+uint64_t
+R600AddrLib::ComputeMacroTileBase(const R600SurfaceLayout *pLayout,
+                                  uint32_t bankPipeIn,
+                                  uint32_t x,
+                                  uint32_t y,
+                                  uint32_t slice,
+                                  uint32_t sampleSlice,
+                                  uint64_t *pBankPipeBits) const
+{
+   uint64_t numPipes = mPipes;
+   uint64_t numBanks = mBanks;
+   uint64_t numGroupBits = Log2(mPipeInterleaveBytes);
+   uint64_t numPipeBits = Log2(mPipes);
+   uint64_t numBankBits = Log2(mBanks);
+
+   uint64_t bankPipe = bankPipeIn;
+   uint64_t swizzle = pLayout->pipeSwizzle + numPipes * pLayout->bankSwizzle;
+   uint64_t sliceIn = slice;
+
+   if (IsThickMacroTiled(pLayout->tileMode)) {
+      sliceIn /= ThickTileThickness;
+   }
+
+   bankPipe ^= numPipes * sampleSlice * ((numBanks >> 1) + 1) ^ (swizzle + sliceIn * pLayout->rotation);
+   bankPipe %= numPipes * numBanks;
+   uint64_t pipe = bankPipe % numPipes;
+   uint64_t bank = bankPipe / numPipes;
+
+   uint64_t sliceOffset = pLayout->sliceBytes * ((sampleSlice + pLayout->numSampleSplits * slice) / pLayout->thickness);
+   uint64_t macroTileIndexX = x / pLayout->macroTilePitch;
+   uint64_t macroTileIndexY = y / pLayout->macroTileHeight;
+   uint64_t macroTileOffset = pLayout->macroTileBytes * (macroTileIndexX + pLayout->macroTilesPerRow * macroTileIndexY);
+
+   if (pLayout->bankSwapWidth) {
+      uint64_t swapIndex = pLayout->macroTilePitch * macroTileIndexX / pLayout->bankSwapWidth;
+      bank ^= BankSwapOrder[swapIndex & (mBanks - 1)];
+   }
+
+   *pBankPipeBits = (bank << (numPipeBits + numGroupBits)) | (pipe << numGroupBits);
+   return (macroTileOffset + sliceOffset) >> (numBankBits + numPipeBits);
+}
+
+
+/**
+***************************************************************************************************
+*   InterleaveMacroTileOffset
+*
+*   @brief
+*       Inserts the pipe and bank bits above the pipe interleave bits of a macro tile offset
+*
+*   @return
+*       The byte address
+***************************************************************************************************
+*/
+static inline uint64_t
+InterleaveMacroTileOffset(uint64_t offset,
+                          uint64_t bankPipeBits,
+                          uint64_t groupMask,
+                          uint32_t bankPipeShift)
+{
+   return ((offset & ~groupMask) << bankPipeShift) | bankPipeBits | (offset & groupMask);
+}
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::ComputeLayoutAddrFromCoordMacroTiled
+*
+*   @brief
+*       Computes the same address as ComputeSurfaceAddrFromCoordMacroTiled from a precomputed
+*       surface layout, its micro tile pixel index table (the table of slice 0) and the
+*       unrotated bank pipe of (x, y)
+*
+*   @return
+*       The byte address
+***************************************************************************************************
+*/
+uint64_t
+R600AddrLib::ComputeLayoutAddrFromCoordMacroTiled(const R600SurfaceLayout *pLayout,
+                                                  const uint16_t *pPixelIndex,
+                                                  uint32_t bankPipe,
+                                                  uint32_t x,
+                                                  uint32_t y,
+                                                  uint32_t slice,
+                                                  uint32_t sample,
+                                                  uint32_t *pBitPosition) const
+{
+   uint64_t numSamples = pLayout->numSamples;
+   uint64_t bpp = pLayout->bpp;
+   uint64_t pixelIndex = pPixelIndex[(slice % XThickTileThickness) * MicroTilePixels
+                                     + (y % MicroTileHeight) * MicroTileWidth
+                                     + (x % MicroTileWidth)];
+   uint64_t elemOffset;
+
+   if (pLayout->isDepth) {
+      if (pLayout->compBits && pLayout->compBits != bpp) {
+         elemOffset = pLayout->tileBase + pLayout->compBits * sample + numSamples * pLayout->compBits * pixelIndex;
+      } else {
+         elemOffset = bpp * sample + numSamples * bpp * pixelIndex;
+      }
+   } else {
+      elemOffset = sample * (pLayout->microTileBits / numSamples) + bpp * pixelIndex;
+   }
+
+   *pBitPosition = static_cast<uint32_t>(elemOffset % 8);
+
+   uint32_t sampleSlice = 0;
+
+   if (pLayout->numSampleSplits > 1) {
+      sampleSlice = static_cast<uint32_t>(elemOffset / pLayout->tileSliceBits);
+      elemOffset %= pLayout->tileSliceBits;
+   }
+
+   uint64_t bankPipeBits;
+   uint64_t base = ComputeMacroTileBase(pLayout, bankPipe, x, y, slice, sampleSlice, &bankPipeBits);
+
+   return InterleaveMacroTileOffset(base + elemOffset / 8, bankPipeBits, mPipeInterleaveBytes - 1, Log2(mBanks) + Log2(mPipes));
+}
+
+
+/**
+***************************************************************************************************
+*   GetLinearElement
+*
+*   @brief
+*       Returns the address of an element of a surface copy in the linear buffer
+*
+*   @return
+*       Pointer into the linear buffer
+***************************************************************************************************
+*/
+static inline uint8_t *
+GetLinearElement(const R600SurfaceCopy *pCopy,
+                 uint32_t x,
+                 uint32_t y,
+                 uint32_t slice,
+                 uint32_t sample)
+{
+   auto &region = pCopy->region;
+   auto image = static_cast<uint64_t>(slice - region.slice) + static_cast<uint64_t>(sample) * region.depth;
+
+   return pCopy->pLinear
+      + image * pCopy->linearSliceSize
+      + static_cast<uint64_t>(y - region.y) * pCopy->linearPitch
+      + static_cast<uint64_t>(x - region.x) * pCopy->elemBytes;
+}
+
+
+/**
+***************************************************************************************************
+*   CopyMicroTileElements
+*
+*   @brief
+*       Copies the elements of a width x height rectangle of a micro tile between a contiguous
+*       micro tile and a linear buffer using the micro tile pixel order in pPixelIndex
+*
+*   @return
+*       N/A
+***************************************************************************************************
+*/
+template<uint32_t ElemBytes>
+static void
+CopyMicroTileElements(uint8_t *pTile,
+                      uint8_t *pLinear,
+                      uint32_t linearPitch,
+                      const uint16_t *pPixelIndex,
+                      uint32_t elemBytes,
+                      uint32_t x,
+                      uint32_t y,
+                      uint32_t width,
+                      uint32_t height,
+                      bool tiledToLinear)
+{
+   if (ElemBytes) {
+      elemBytes = ElemBytes;
+   }
+
+   for (auto j = 0u; j < height; ++j) {
+      auto pRow = pLinear + j * linearPitch;
+      auto pIndex = pPixelIndex + (y + j) * MicroTileWidth + x;
+
+      if (tiledToLinear) {
+         for (auto i = 0u; i < width; ++i) {
+            std::memcpy(pRow + i * elemBytes, pTile + pIndex[i] * elemBytes, elemBytes);
+         }
+      } else {
+         for (auto i = 0u; i < width; ++i) {
+            std::memcpy(pTile + pIndex[i] * elemBytes, pRow + i * elemBytes, elemBytes);
+         }
+      }
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   CopyMicroTile
+*
+*   @brief
+*       Copies a rectangle of a contiguous micro tile to or from a linear buffer, whole micro
+*       tiles go through the micro tile kernel when there is one
+*
+*   @return
+*       N/A
+***************************************************************************************************
+*/
+static void
+CopyMicroTile(uint8_t *pTile,
+              uint8_t *pLinear,
+              uint32_t linearPitch,
+              const uint16_t *pPixelIndex,
+              AddrMicroTileKernel kernel,
+              uint32_t elemBytes,
+              uint32_t x,
+              uint32_t y,
+              uint32_t width,
+              uint32_t height,
+              bool tiledToLinear)
+{
+   if (kernel && width == MicroTileWidth && height == MicroTileHeight) {
+      kernel(pTile, pLinear, linearPitch);
+      return;
+   }
+
+   switch (elemBytes) {
+   case 1:
+      CopyMicroTileElements<1>(pTile, pLinear, linearPitch, pPixelIndex, elemBytes, x, y, width, height, tiledToLinear);
+      break;
+   case 2:
+      CopyMicroTileElements<2>(pTile, pLinear, linearPitch, pPixelIndex, elemBytes, x, y, width, height, tiledToLinear);
+      break;
+   case 4:
+      CopyMicroTileElements<4>(pTile, pLinear, linearPitch, pPixelIndex, elemBytes, x, y, width, height, tiledToLinear);
+      break;
+   case 8:
+      CopyMicroTileElements<8>(pTile, pLinear, linearPitch, pPixelIndex, elemBytes, x, y, width, height, tiledToLinear);
+      break;
+   case 16:
+      CopyMicroTileElements<16>(pTile, pLinear, linearPitch, pPixelIndex, elemBytes, x, y, width, height, tiledToLinear);
+      break;
+   default:
+      CopyMicroTileElements<0>(pTile, pLinear, linearPitch, pPixelIndex, elemBytes, x, y, width, height, tiledToLinear);
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::CopySurfaceRectLinear
+*
+*   @brief
+*       Copies a rectangle of one slice and sample of a linear general / aligned surface
+*
+*   @return
+*       N/A
+***************************************************************************************************
+*/
+void
+R600AddrLib::CopySurfaceRectLinear(const R600SurfaceCopy *pCopy,
+                                   uint32_t slice,
+                                   uint32_t sample,
+                                   uint32_t x,
+                                   uint32_t y,
+                                   uint32_t width,
+                                   uint32_t height) const
+{
+   auto &layout = pCopy->layout;
+   auto elemBytes = pCopy->elemBytes;
+   auto image = static_cast<uint64_t>(slice) + static_cast<uint64_t>(sample) * layout.numSlices;
+   auto pTiled = pCopy->pTiled + image * layout.sliceBytes;
+   auto rowBytes = static_cast<size_t>(width) * elemBytes;
+
+   for (auto j = y; j < y + height; ++j) {
+      auto pTiledRow = pTiled + (static_cast<uint64_t>(j) * layout.pitch + x) * elemBytes;
+      auto pLinearRow = GetLinearElement(pCopy, x, j, slice, sample);
+
+      if (pCopy->tiledToLinear) {
+         std::memcpy(pLinearRow, pTiledRow, rowBytes);
+      } else {
+         std::memcpy(pTiledRow, pLinearRow, rowBytes);
+      }
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::CopySurfaceRectMicroTiled
+*
+*   @brief
+*       Copies a rectangle of one slice and sample of a 1D tiled (micro tiled) surface
+*
+*   @return
+*       N/A
+***************************************************************************************************
+*/
+void
+R600AddrLib::CopySurfaceRectMicroTiled(const R600SurfaceCopy *pCopy,
+                                       uint32_t slice,
+                                       uint32_t sample,
+                                       uint32_t x,
+                                       uint32_t y,
+                                       uint32_t width,
+                                       uint32_t height) const
+{
+   auto &layout = pCopy->layout;
+   auto elemBytes = pCopy->elemBytes;
+   uint64_t sliceOffset = (slice / layout.thickness) * layout.sliceBytes;
+   uint64_t zOffset = ComputePixelIndexWithinMicroTile(0, 0, slice, layout.bpp, layout.tileMode, layout.tileType) * elemBytes;
+
+   for (auto tileY = y & ~(MicroTileHeight - 1); tileY < y + height; tileY += MicroTileHeight) {
+      auto y0 = std::max(y, tileY);
+      auto y1 = std::min(y + height, tileY + MicroTileHeight);
+
+      for (auto tileX = x & ~(MicroTileWidth - 1); tileX < x + width; tileX += MicroTileWidth) {
+         auto x0 = std::max(x, tileX);
+         auto x1 = std::min(x + width, tileX + MicroTileWidth);
+         uint64_t microTileIndex = (tileX / MicroTileWidth) + (tileY / MicroTileHeight) * layout.microTilesPerRow;
+         auto pTile = pCopy->pTiled + sliceOffset + microTileIndex * layout.microTileBytes + zOffset;
+         auto pLinearTile = GetLinearElement(pCopy, x0, y0, slice, sample);
+
+         CopyMicroTile(pTile, pLinearTile, pCopy->linearPitch, pCopy->pPixelIndex, pCopy->pKernel, elemBytes,
+                       x0 - tileX, y0 - tileY, x1 - x0, y1 - y0, pCopy->tiledToLinear);
+      }
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::CopySurfaceRectMacroTiled
+*
+*   @brief
+*       Copies a rectangle of one slice and sample of a 2D/3D tiled (macro tiled) surface
+*
+*   @note
+*       When the elements of a sample are contiguous within the micro tile, the micro tile is
+*       copied in pipe interleave sized pieces, otherwise it is copied an element at a time.
+*
+*   @return
+*       N/A
+***************************************************************************************************
+*/
+void
+R600AddrLib::CopySurfaceRectMacroTiled(const R600SurfaceCopy *pCopy,
+                                       uint32_t slice,
+                                       uint32_t sample,
+                                       uint32_t x,
+                                       uint32_t y,
+                                       uint32_t width,
+                                       uint32_t height) const
+{
+   auto &layout = pCopy->layout;
+   auto elemBytes = pCopy->elemBytes;
+   auto bankPipeShift = Log2(mBanks) + Log2(mPipes);
+   uint64_t groupBytes = mPipeInterleaveBytes;
+   uint64_t groupMask = groupBytes - 1;
+   uint64_t zIndex = ComputePixelIndexWithinMicroTile(0, 0, slice, layout.bpp, layout.tileMode, layout.tileType);
+   uint64_t tileBytes = MicroTilePixels * elemBytes;
+   auto interleaved = layout.isDepth && layout.numSamples > 1;
+   auto contiguous = !interleaved && IsPow2(elemBytes);
+
+   // Bit offset of this slice and sample within the micro tile
+   uint64_t startBits = zIndex * layout.bpp;
+   uint32_t startSampleSlice = 0;
+
+   if (!interleaved) {
+      startBits += sample * (layout.microTileBits / layout.numSamples);
+   }
+
+   if (!interleaved && layout.numSampleSplits > 1) {
+      startSampleSlice = static_cast<uint32_t>(startBits / layout.tileSliceBits);
+      startBits %= layout.tileSliceBits;
+   }
+
+   for (auto tileY = y & ~(MicroTileHeight - 1); tileY < y + height; tileY += MicroTileHeight) {
+      auto y0 = std::max(y, tileY);
+      auto y1 = std::min(y + height, tileY + MicroTileHeight);
+
+      for (auto tileX = x & ~(MicroTileWidth - 1); tileX < x + width; tileX += MicroTileWidth) {
+         auto x0 = std::max(x, tileX);
+         auto x1 = std::min(x + width, tileX + MicroTileWidth);
+         auto pLinearTile = GetLinearElement(pCopy, x0, y0, slice, sample);
+         uint64_t bankPipeBits[8];
+         uint64_t base[8];
+
+         if (!interleaved) {
+            base[0] = ComputeMacroTileBase(&layout, tileX, tileY, slice, startSampleSlice, &bankPipeBits[0]);
+            auto offset = base[0] + startBits / 8;
+
+            if (contiguous && !(offset & (elemBytes - 1)) && (offset & groupMask) + tileBytes <= groupBytes) {
+               auto pTile = pCopy->pTiled + InterleaveMacroTileOffset(offset, bankPipeBits[0], groupMask, bankPipeShift);
+
+               CopyMicroTile(pTile, pLinearTile, pCopy->linearPitch, pCopy->pPixelIndex, pCopy->pKernel, elemBytes,
+                             x0 - tileX, y0 - tileY, x1 - x0, y1 - y0, pCopy->tiledToLinear);
+               continue;
+            }
+
+            if (contiguous && !(offset & (elemBytes - 1))) {
+               // The micro tile crosses pipe interleave groups, stage it through a contiguous buffer
+               alignas(16) uint8_t staging[MicroTilePixels * 16];
+
+               for (auto pos = uint64_t { 0 }; pos < tileBytes; ) {
+                  auto pieceBytes = std::min(tileBytes - pos, groupBytes - ((offset + pos) & groupMask));
+                  auto pTiled = pCopy->pTiled + InterleaveMacroTileOffset(offset + pos, bankPipeBits[0], groupMask, bankPipeShift);
+                  std::memcpy(staging + pos, pTiled, static_cast<size_t>(pieceBytes));
+                  pos += pieceBytes;
+               }
+
+               CopyMicroTile(staging, pLinearTile, pCopy->linearPitch, pCopy->pPixelIndex, pCopy->pKernel, elemBytes,
+                             x0 - tileX, y0 - tileY, x1 - x0, y1 - y0, pCopy->tiledToLinear);
+
+               if (!pCopy->tiledToLinear) {
+                  for (auto pos = uint64_t { 0 }; pos < tileBytes; ) {
+                     auto pieceBytes = std::min(tileBytes - pos, groupBytes - ((offset + pos) & groupMask));
+                     auto pTiled = pCopy->pTiled + InterleaveMacroTileOffset(offset + pos, bankPipeBits[0], groupMask, bankPipeShift);
+                     std::memcpy(pTiled, staging + pos, static_cast<size_t>(pieceBytes));
+                     pos += pieceBytes;
+                  }
+               }
+
+               continue;
+            }
+         } else {
+            for (auto i = 0u; i < layout.numSampleSplits; ++i) {
+               base[i] = ComputeMacroTileBase(&layout, tileX, tileY, slice, i, &bankPipeBits[i]);
+            }
+         }
+
+         // Element at a time, matches ComputeSurfaceAddrFromCoordMacroTiled for every layout
+         for (auto j = y0; j < y1; ++j) {
+            auto pRow = GetLinearElement(pCopy, x0, j, slice, sample);
+
+            for (auto i = x0; i < x1; ++i) {
+               uint64_t pixelIndex = pCopy->pPixelIndex[(j - tileY) * MicroTileWidth + (i - tileX)];
+               uint64_t elemBits;
+               uint32_t sampleSlice = 0;
+
+               if (interleaved) {
+                  elemBits = layout.numSamples * layout.bpp * (pixelIndex + zIndex) + layout.bpp * sample;
+
+                  if (layout.numSampleSplits > 1) {
+                     sampleSlice = static_cast<uint32_t>(elemBits / layout.tileSliceBits);
+                     elemBits %= layout.tileSliceBits;
+                  }
+               } else {
+                  elemBits = startBits + layout.bpp * pixelIndex;
+               }
+
+               auto offset = base[sampleSlice] + elemBits / 8;
+               auto pTiled = pCopy->pTiled + InterleaveMacroTileOffset(offset, bankPipeBits[sampleSlice], groupMask, bankPipeShift);
+
+               if (pCopy->tiledToLinear) {
+                  std::memcpy(pRow + static_cast<uint64_t>(i - x0) * elemBytes, pTiled, elemBytes);
+               } else {
+                  std::memcpy(pTiled, pRow + static_cast<uint64_t>(i - x0) * elemBytes, elemBytes);
+               }
+            }
+         }
+      }
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::CopySurfaceRect
+*
+*   @brief
+*       Copies a rectangle of one slice and sample of a surface
+*
+*   @return
+*       N/A
+***************************************************************************************************
+*/
+void
+R600AddrLib::CopySurfaceRect(const R600SurfaceCopy *pCopy,
+                             uint32_t slice,
+                             uint32_t sample,
+                             uint32_t x,
+                             uint32_t y,
+                             uint32_t width,
+                             uint32_t height) const
+{
+   switch (pCopy->layout.tileMode) {
+   case ADDR_TM_LINEAR_GENERAL:
+   case ADDR_TM_LINEAR_ALIGNED:
+      CopySurfaceRectLinear(pCopy, slice, sample, x, y, width, height);
+      break;
+   case ADDR_TM_1D_TILED_THIN1:
+   case ADDR_TM_1D_TILED_THICK:
+      CopySurfaceRectMicroTiled(pCopy, slice, sample, x, y, width, height);
+      break;
+   default:
+      CopySurfaceRectMacroTiled(pCopy, slice, sample, x, y, width, height);
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::SetupSurfaceCopy
+*
+*   @brief
+*       Validates a bulk copy request and computes the state shared by all of its micro tiles
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+R600AddrLib::SetupSurfaceCopy(const ADDR_COPY_SURFACE_INPUT *pIn,
+                              bool tiledToLinear,
+                              R600SurfaceCopy *pCopy) const
+{
+   if (pIn->pipeSwizzle >= mPipes
+    || pIn->bankSwizzle >= mBanks
+    || pIn->numSamples > 8
+    || pIn->bpp == 0
+    || pIn->bpp > 128) {
+      return ADDR_INVALIDPARAMS;
+   }
+
+   switch (pIn->tileMode) {
+   case ADDR_TM_LINEAR_GENERAL:
+   case ADDR_TM_LINEAR_ALIGNED:
+   case ADDR_TM_1D_TILED_THIN1:
+   case ADDR_TM_1D_TILED_THICK:
+   case ADDR_TM_2D_TILED_THIN1:
+   case ADDR_TM_2D_TILED_THIN2:
+   case ADDR_TM_2D_TILED_THIN4:
+   case ADDR_TM_2D_TILED_THICK:
+   case ADDR_TM_2B_TILED_THIN1:
+   case ADDR_TM_2B_TILED_THIN2:
+   case ADDR_TM_2B_TILED_THIN4:
+   case ADDR_TM_2B_TILED_THICK:
+   case ADDR_TM_3D_TILED_THIN1:
+   case ADDR_TM_3D_TILED_THICK:
+   case ADDR_TM_3B_TILED_THIN1:
+   case ADDR_TM_3B_TILED_THICK:
+      break;
+   default:
+      return ADDR_INVALIDPARAMS;
+   }
+
+   if (pIn->pRegion) {
+      pCopy->region = *pIn->pRegion;
+
+      if (static_cast<uint64_t>(pCopy->region.x) + pCopy->region.width > pIn->pitch
+       || static_cast<uint64_t>(pCopy->region.y) + pCopy->region.height > pIn->height
+       || static_cast<uint64_t>(pCopy->region.slice) + pCopy->region.depth > pIn->numSlices) {
+         return ADDR_INVALIDPARAMS;
+      }
+   } else {
+      pCopy->region.x = 0;
+      pCopy->region.y = 0;
+      pCopy->region.slice = 0;
+      pCopy->region.width = pIn->pitch;
+      pCopy->region.height = pIn->height;
+      pCopy->region.depth = pIn->numSlices;
+   }
+
+   // Sub-byte elements and split depth planes do not map to whole bytes
+   if ((pIn->bpp % 8) || (pIn->isDepth && pIn->compBits && pIn->compBits != pIn->bpp)) {
+      return ADDR_NOTSUPPORTED;
+   }
+
+   auto returnCode = ComputeSurfaceLayout(pIn->tileMode,
+                                          pIn->bpp,
+                                          pIn->pitch,
+                                          pIn->height,
+                                          pIn->numSlices,
+                                          pIn->numSamples,
+                                          pIn->isDepth,
+                                          pIn->tileBase,
+                                          pIn->compBits,
+                                          pIn->pipeSwizzle,
+                                          pIn->bankSwizzle,
+                                          &pCopy->layout);
+
+   if (returnCode != ADDR_OK) {
+      return returnCode;
+   }
+
+   pCopy->pTiled = static_cast<uint8_t *>(pIn->pTiled);
+   pCopy->pLinear = static_cast<uint8_t *>(pIn->pLinear);
+   pCopy->elemBytes = pIn->bpp / 8;
+   pCopy->linearPitch = pIn->linearPitch ? pIn->linearPitch : pCopy->region.width * pCopy->elemBytes;
+   pCopy->linearSliceSize = pIn->linearSliceSize ? pIn->linearSliceSize : static_cast<uint64_t>(pCopy->linearPitch) * pCopy->region.height;
+   pCopy->tiledToLinear = tiledToLinear;
+   pCopy->pPixelIndex = GetPixelIndexTable(0, pIn->bpp, pIn->tileMode, pCopy->layout.tileType);
+   pCopy->pKernel = GetMicroTileKernel(pIn->bpp, pCopy->layout.tileType, tiledToLinear);
+   pCopy->numPlanes = 0;
+
+   return ADDR_OK;
+}
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::CopySurfaceTask
+*
+*   @brief
+*       Copies the macro tile rows of one task, every slice of the region is split into bands
+*       of bandHeight rows and each task gets an equal run of the bands of all slices. The
+*       samples of a band are copied in order by the same task as they can share memory.
+*
+*   @return
+*       N/A
+***************************************************************************************************
+*/
+void
+R600AddrLib::CopySurfaceTask(const R600SurfaceCopyTasks *pTasks,
+                             uint32_t taskIndex) const
+{
+   auto pCopy = pTasks->pCopy;
+   auto &layout = pCopy->layout;
+   auto &region = pCopy->region;
+   auto firstBand = pTasks->numBands * taskIndex / pTasks->numTasks;
+   auto lastBand = pTasks->numBands * (taskIndex + 1) / pTasks->numTasks;
+
+   for (auto band = firstBand; band < lastBand; ++band) {
+      auto slice = region.slice + static_cast<uint32_t>(band / pTasks->bandsPerSlice);
+      auto bandY = (pTasks->firstBandY + static_cast<uint32_t>(band % pTasks->bandsPerSlice)) * pTasks->bandHeight;
+      auto y0 = std::max(region.y, bandY);
+      auto y1 = std::min(region.y + region.height, bandY + pTasks->bandHeight);
+
+      if (pCopy->numPlanes) {
+         CopyDepthPlanesRect(pCopy, slice, pTasks->firstSample, region.x, y0, region.width, y1 - y0);
+         continue;
+      }
+
+      for (auto sample = pTasks->firstSample; sample < layout.numSamples; ++sample) {
+         CopySurfaceRect(pCopy, slice, sample, region.x, y0, region.width, y1 - y0);
+      }
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   RunSurfaceCopyTask
+*
+*   @brief
+*       ADDR_COPY_TASK entry of a bulk surface copy task
+*
+*   @return
+*       N/A
+***************************************************************************************************
+*/
+static void
+RunSurfaceCopyTask(void *pTaskData,
+                   uint32_t taskIndex)
+{
+   auto pTasks = static_cast<const R600SurfaceCopyTasks *>(pTaskData);
+   pTasks->pLib->CopySurfaceTask(pTasks, taskIndex);
+}
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::RunSurfaceCopy
+*
+*   @brief
+*       Runs a bulk surface copy, split along macro tile rows (micro tile rows for 1D tiled and
+*       linear surfaces) into pIn->numThreads tasks which write disjoint memory
+*
+*   @return
+*       N/A
+***************************************************************************************************
+*/
+void
+R600AddrLib::RunSurfaceCopy(const R600SurfaceCopy *pCopy,
+                            const ADDR_COPY_SURFACE_INPUT *pIn) const
+{
+   auto &layout = pCopy->layout;
+   auto &region = pCopy->region;
+   R600SurfaceCopyTasks tasks;
+
+   tasks.pLib = this;
+   tasks.pCopy = pCopy;
+   tasks.firstSample = 0;
+   tasks.bandHeight = MicroTileHeight;
+
+   if (IsMacroTiled(layout.tileMode)) {
+      tasks.bandHeight = static_cast<uint32_t>(layout.macroTileHeight);
+   } else if (layout.tileMode != ADDR_TM_LINEAR_GENERAL && layout.tileMode != ADDR_TM_LINEAR_ALIGNED && !pCopy->tiledToLinear) {
+      // Every sample of a 1D tiled surface shares the same memory, only the last one written is kept
+      tasks.firstSample = layout.numSamples - 1;
+   }
+
+   tasks.firstBandY = region.y / tasks.bandHeight;
+   tasks.bandsPerSlice = 0;
+
+   if (region.width && region.height) {
+      tasks.bandsPerSlice = (region.y + region.height + tasks.bandHeight - 1) / tasks.bandHeight - tasks.firstBandY;
+   }
+
+   tasks.numBands = static_cast<uint64_t>(tasks.bandsPerSlice) * region.depth;
+   tasks.numTasks = static_cast<uint32_t>(std::min<uint64_t>(std::max(pIn->numThreads, 1u), tasks.numBands));
+
+   if (tasks.numTasks <= 1) {
+      for (auto task = 0u; task < tasks.numTasks; ++task) {
+         CopySurfaceTask(&tasks, task);
+      }
+   } else if (pIn->pExecutor) {
+      pIn->pExecutor(pIn->pExecutorData, RunSurfaceCopyTask, &tasks, tasks.numTasks);
+   } else {
+      std::vector<std::thread> threads;
+      auto task = 1u;
+
+      try {
+         threads.reserve(tasks.numTasks - 1);
+
+         for (; task < tasks.numTasks; ++task) {
+            threads.emplace_back(RunSurfaceCopyTask, &tasks, task);
+         }
+      } catch (...) {
+         // Run whatever could not get a thread on this one
+      }
+
+      for (auto remaining = task; remaining < tasks.numTasks; ++remaining) {
+         CopySurfaceTask(&tasks, remaining);
+      }
+
+      CopySurfaceTask(&tasks, 0);
+
+      for (auto &thread : threads) {
+         thread.join();
+      }
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::HwlCopySurfaceTiledToLinear
+*
+*   @brief
+*       Entry of R600AddrLib CopySurfaceTiledToLinear
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+R600AddrLib::HwlCopySurfaceTiledToLinear(const ADDR_COPY_SURFACE_INPUT *pIn) const
+{
+   R600SurfaceCopy copy;
+   auto returnCode = SetupSurfaceCopy(pIn, true, &copy);
+
+   if (returnCode == ADDR_OK) {
+      RunSurfaceCopy(&copy, pIn);
+   }
+
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::HwlCopySurfaceLinearToTiled
+*
+*   @brief
+*       Entry of R600AddrLib CopySurfaceLinearToTiled
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+R600AddrLib::HwlCopySurfaceLinearToTiled(const ADDR_COPY_SURFACE_INPUT *pIn) const
+{
+   R600SurfaceCopy copy;
+   auto returnCode = SetupSurfaceCopy(pIn, false, &copy);
+
+   if (returnCode == ADDR_OK) {
+      RunSurfaceCopy(&copy, pIn);
+   }
+
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   GetDepthPlaneElement
+*
+*   @brief
+*       Returns the address of an element of a depth plane copy in the plane's linear buffer
+*
+*   @return
+*       Pointer into the linear buffer
+***************************************************************************************************
+*/
+static inline uint8_t *
+GetDepthPlaneElement(const R600SurfaceCopy *pCopy,
+                     const R600DepthPlaneCopy *pPlane,
+                     uint32_t x,
+                     uint32_t y,
+                     uint32_t slice,
+                     uint32_t sample)
+{
+   auto &region = pCopy->region;
+   auto image = static_cast<uint64_t>(slice - region.slice) + static_cast<uint64_t>(sample) * region.depth;
+
+   return pPlane->pLinear
+      + image * pPlane->linearSliceSize
+      + static_cast<uint64_t>(y - region.y) * pPlane->linearPitch
+      + static_cast<uint64_t>(x - region.x) * pPlane->elemBytes;
+}
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::CopyDepthPlanesRect
+*
+*   @brief
+*       Copies a rectangle of one slice of every plane and sample from firstSample of a depth
+*       plane copy, a micro tile at a time
+*
+*   @note
+*       The planes are interleaved within the micro tile and their elements need not be
+*       aligned, every element is copied on its own, matching ComputeSurfaceAddrFromCoord.
+*
+*   @return
+*       N/A
+***************************************************************************************************
+*/
+void
+R600AddrLib::CopyDepthPlanesRect(const R600SurfaceCopy *pCopy,
+                                 uint32_t slice,
+                                 uint32_t firstSample,
+                                 uint32_t x,
+                                 uint32_t y,
+                                 uint32_t width,
+                                 uint32_t height) const
+{
+   auto &layout = pCopy->layout;
+   auto macroTiled = IsMacroTiled(layout.tileMode);
+   auto bankPipeShift = Log2(mBanks) + Log2(mPipes);
+   uint64_t groupMask = mPipeInterleaveBytes - 1;
+   uint64_t zIndex = ComputePixelIndexWithinMicroTile(0, 0, slice, layout.bpp, layout.tileMode, layout.tileType);
+   uint64_t sliceOffset = (slice / layout.thickness) * layout.sliceBytes;
+
+   for (auto tileY = y & ~(MicroTileHeight - 1); tileY < y + height; tileY += MicroTileHeight) {
+      auto y0 = std::max(y, tileY);
+      auto y1 = std::min(y + height, tileY + MicroTileHeight);
+
+      for (auto tileX = x & ~(MicroTileWidth - 1); tileX < x + width; tileX += MicroTileWidth) {
+         auto x0 = std::max(x, tileX);
+         auto x1 = std::min(x + width, tileX + MicroTileWidth);
+         uint8_t *pTile = nullptr;
+         uint64_t bankPipeBits[8];
+         uint64_t base[8];
+
+         if (macroTiled) {
+            for (auto i = 0u; i < layout.numSampleSplits; ++i) {
+               base[i] = ComputeMacroTileBase(&layout, tileX, tileY, slice, i, &bankPipeBits[i]);
+            }
+         } else {
+            uint64_t microTileIndex = (tileX / MicroTileWidth) + (tileY / MicroTileHeight) * layout.microTilesPerRow;
+            pTile = pCopy->pTiled + sliceOffset + microTileIndex * layout.microTileBytes;
+         }
+
+         // Every plane and sample of the micro tile while it is in cache
+         for (auto plane = 0u; plane < pCopy->numPlanes; ++plane) {
+            auto pPlane = &pCopy->planes[plane];
+            auto elemBytes = pPlane->elemBytes;
+
+            for (auto sample = firstSample; sample < layout.numSamples; ++sample) {
+               uint64_t sampleBits = pPlane->tileBase + sample * pPlane->sampleBits;
+
+               for (auto j = y0; j < y1; ++j) {
+                  auto pRow = GetDepthPlaneElement(pCopy, pPlane, x0, j, slice, sample);
+
+                  for (auto i = x0; i < x1; ++i) {
+                     uint64_t pixelIndex = pCopy->pPixelIndex[(j - tileY) * MicroTileWidth + (i - tileX)] + zIndex;
+                     uint64_t elemBits = sampleBits + pixelIndex * pPlane->pixelBits;
+                     uint8_t *pTiled;
+
+                     if (macroTiled) {
+                        uint32_t sampleSlice = 0;
+
+                        if (layout.numSampleSplits > 1) {
+                           sampleSlice = static_cast<uint32_t>(elemBits / layout.tileSliceBits);
+                           elemBits %= layout.tileSliceBits;
+                        }
+
+                        auto offset = base[sampleSlice] + elemBits / 8;
+                        pTiled = pCopy->pTiled + InterleaveMacroTileOffset(offset, bankPipeBits[sampleSlice], groupMask, bankPipeShift);
+                     } else {
+                        pTiled = pTile + elemBits / 8;
+                     }
+
+                     if (pCopy->tiledToLinear) {
+                        std::memcpy(pRow + static_cast<uint64_t>(i - x0) * elemBytes, pTiled, elemBytes);
+                     } else {
+                        std::memcpy(pTiled, pRow + static_cast<uint64_t>(i - x0) * elemBytes, elemBytes);
+                     }
+                  }
+               }
+            }
+         }
+      }
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::SetupDepthPlanesCopy
+*
+*   @brief
+*       Validates a bulk depth plane copy request and computes its state, reusing the whole
+*       surface copy setup for the surface and region
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+R600AddrLib::SetupDepthPlanesCopy(const ADDR_COPY_DEPTH_PLANES_INPUT *pIn,
+                                  bool tiledToLinear,
+                                  ADDR_COPY_SURFACE_INPUT *pSurfaceIn,
+                                  R600SurfaceCopy *pCopy) const
+{
+   std::memset(pSurfaceIn, 0, sizeof(ADDR_COPY_SURFACE_INPUT));
+   pSurfaceIn->size = sizeof(ADDR_COPY_SURFACE_INPUT);
+   pSurfaceIn->bpp = pIn->bpp;
+   pSurfaceIn->pitch = pIn->pitch;
+   pSurfaceIn->height = pIn->height;
+   pSurfaceIn->numSlices = pIn->numSlices;
+   pSurfaceIn->numSamples = pIn->numSamples;
+   pSurfaceIn->tileMode = pIn->tileMode;
+   pSurfaceIn->isDepth = true;
+   pSurfaceIn->compBits = pIn->bpp;
+   pSurfaceIn->pipeSwizzle = pIn->pipeSwizzle;
+   pSurfaceIn->bankSwizzle = pIn->bankSwizzle;
+   pSurfaceIn->pTiled = pIn->pTiled;
+   pSurfaceIn->pLinear = pIn->pPlanes[0].pLinear;
+   pSurfaceIn->pRegion = pIn->pRegion;
+   pSurfaceIn->numThreads = pIn->numThreads;
+   pSurfaceIn->pExecutor = pIn->pExecutor;
+   pSurfaceIn->pExecutorData = pIn->pExecutorData;
+
+   auto returnCode = SetupSurfaceCopy(pSurfaceIn, tiledToLinear, pCopy);
+
+   if (returnCode != ADDR_OK) {
+      return returnCode;
+   }
+
+   auto &layout = pCopy->layout;
+   auto &region = pCopy->region;
+   auto macroTiled = IsMacroTiled(layout.tileMode);
+
+   if (layout.tileMode == ADDR_TM_LINEAR_GENERAL || layout.tileMode == ADDR_TM_LINEAR_ALIGNED) {
+      return ADDR_NOTSUPPORTED;
+   }
+
+   for (auto plane = 0u; plane < pIn->numPlanes; ++plane) {
+      auto &inPlane = pIn->pPlanes[plane];
+      auto pPlane = &pCopy->planes[plane];
+      uint64_t tileBase = inPlane.tileBase;
+      uint64_t compBits = inPlane.compBits;
+
+      if (!inPlane.pLinear) {
+         return ADDR_INVALIDPARAMS;
+      }
+
+      if (compBits == 0 || compBits == layout.bpp) {
+         tileBase = 0;
+         compBits = layout.bpp;
+      }
+
+      if ((compBits % 8) || (tileBase % 8)) {
+         return ADDR_NOTSUPPORTED;
+      }
+
+      pPlane->tileBase = tileBase;
+      pPlane->sampleBits = macroTiled ? compBits : 0;
+      pPlane->pixelBits = macroTiled ? layout.numSamples * compBits : compBits;
+
+      // The last element of the plane has to end within the micro tile
+      auto lastBits = tileBase
+         + (layout.numSamples - 1) * pPlane->sampleBits
+         + (MicroTilePixels * layout.thickness - 1) * pPlane->pixelBits
+         + compBits;
+
+      if (lastBits > layout.microTileBits) {
+         return ADDR_INVALIDPARAMS;
+      }
+
+      pPlane->pLinear = static_cast<uint8_t *>(inPlane.pLinear);
+      pPlane->elemBytes = static_cast<uint32_t>(compBits / 8);
+      pPlane->linearPitch = inPlane.linearPitch ? inPlane.linearPitch : region.width * pPlane->elemBytes;
+      pPlane->linearSliceSize = inPlane.linearSliceSize ? inPlane.linearSliceSize : static_cast<uint64_t>(pPlane->linearPitch) * region.height;
+   }
+
+   pCopy->numPlanes = pIn->numPlanes;
+
+   return ADDR_OK;
+}
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::HwlCopyDepthPlanesToLinear
+*
+*   @brief
+*       Entry of R600AddrLib CopyDepthPlanesToLinear
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+R600AddrLib::HwlCopyDepthPlanesToLinear(const ADDR_COPY_DEPTH_PLANES_INPUT *pIn) const
+{
+   ADDR_COPY_SURFACE_INPUT surfaceIn;
+   R600SurfaceCopy copy;
+   auto returnCode = SetupDepthPlanesCopy(pIn, true, &surfaceIn, &copy);
+
+   if (returnCode == ADDR_OK) {
+      RunSurfaceCopy(&copy, &surfaceIn);
+   }
+
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::HwlCopyLinearToDepthPlanes
+*
+*   @brief
+*       Entry of R600AddrLib CopyLinearToDepthPlanes
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+R600AddrLib::HwlCopyLinearToDepthPlanes(const ADDR_COPY_DEPTH_PLANES_INPUT *pIn) const
+{
+   ADDR_COPY_SURFACE_INPUT surfaceIn;
+   R600SurfaceCopy copy;
+   auto returnCode = SetupDepthPlanesCopy(pIn, false, &surfaceIn, &copy);
+
+   if (returnCode == ADDR_OK) {
+      RunSurfaceCopy(&copy, &surfaceIn);
+   }
+
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   GetBatchCoord
+*
+*   @brief
+*       Returns a coordinate of a batch, optional coordinate arrays default to 0
+*
+*   @return
+*       The coordinate
+***************************************************************************************************
+*/
+static inline uint32_t
+GetBatchCoord(const uint32_t *pCoords,
+              uint32_t index)
+{
+   return pCoords ? pCoords[index] : 0;
+}
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::ComputeSurfaceAddrFromCoordBatchLinear
+*
+*   @brief
+*       Batch version of ComputeSurfaceAddrFromCoordLinear
+*
+*   @return
+*       N/A
+***************************************************************************************************
+*/
+void
+R600AddrLib::ComputeSurfaceAddrFromCoordBatchLinear(const ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_INPUT *pIn,
+                                                    ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_OUTPUT *pOut) const
+{
+   uint64_t bpp = pIn->bpp;
+   uint64_t pitch = pIn->pitch;
+   uint64_t sliceSize = pitch * pIn->height;
+   uint64_t numSlices = pIn->numSlices;
+
+   for (auto i = 0u; i < pIn->numCoords; ++i) {
+      uint64_t image = GetBatchCoord(pIn->pSlice, i) + GetBatchCoord(pIn->pSample, i) * numSlices;
+      uint64_t bits = (image * sliceSize + pIn->pY[i] * pitch + pIn->pX[i]) * bpp;
+
+      pOut->pAddr[i] = bits / 8;
+
+      if (pOut->pBitPosition) {
+         pOut->pBitPosition[i] = static_cast<uint32_t>(bits % 8);
+      }
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::ComputeSurfaceAddrFromCoordBatchMicroTiled
+*
+*   @brief
+*       Batch version of ComputeSurfaceAddrFromCoordMicroTiled
+*
+*   @return
+*       N/A
+***************************************************************************************************
+*/
+void
+R600AddrLib::ComputeSurfaceAddrFromCoordBatchMicroTiled(const R600SurfaceLayout *pLayout,
+                                                        const ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_INPUT *pIn,
+                                                        ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_OUTPUT *pOut) const
+{
+   auto pPixelIndex = GetPixelIndexTable(0, pLayout->bpp, pLayout->tileMode, pLayout->tileType);
+   auto thicknessShift = Log2(pLayout->thickness);
+   auto microTileBytes = pLayout->microTileBytes;
+   auto microTilesPerRow = pLayout->microTilesPerRow;
+   auto sliceBytes = pLayout->sliceBytes;
+   uint64_t elemBits = pLayout->bpp;
+   uint64_t baseBits = 0;
+
+   if (pLayout->isDepth && pLayout->compBits && pLayout->compBits != pLayout->bpp) {
+      elemBits = pLayout->compBits;
+      baseBits = pLayout->tileBase;
+   }
+
+   for (auto i = 0u; i < pIn->numCoords; ++i) {
+      uint32_t x = pIn->pX[i];
+      uint32_t y = pIn->pY[i];
+      uint32_t slice = GetBatchCoord(pIn->pSlice, i);
+      uint64_t pixelIndex = pPixelIndex[(slice % XThickTileThickness) * MicroTilePixels
+                                        + (y % MicroTileHeight) * MicroTileWidth
+                                        + (x % MicroTileWidth)];
+      uint64_t bits = baseBits + elemBits * pixelIndex;
+      uint64_t microTileOffset = microTileBytes * (x / MicroTileWidth + (y / MicroTileHeight) * microTilesPerRow);
+
+      pOut->pAddr[i] = bits / 8 + microTileOffset + (slice >> thicknessShift) * sliceBytes;
+
+      if (pOut->pBitPosition) {
+         pOut->pBitPosition[i] = static_cast<uint32_t>(bits % 8);
+      }
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::ComputeSurfaceAddrFromCoordBatchMacroTiled
+*
+*   @brief
+*       Batch version of ComputeSurfaceAddrFromCoordMacroTiled
+*
+*   @return
+*       N/A
+***************************************************************************************************
+*/
+void
+R600AddrLib::ComputeSurfaceAddrFromCoordBatchMacroTiled(const R600SurfaceLayout *pLayout,
+                                                        const ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_INPUT *pIn,
+                                                        ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_OUTPUT *pOut) const
+{
+   static const uint32_t ChunkSize = 256;
+   auto pPixelIndex = GetPixelIndexTable(0, pLayout->bpp, pLayout->tileMode, pLayout->tileType);
+   uint32_t bankPipe[ChunkSize];
+
+   for (auto chunk = 0u; chunk < pIn->numCoords; chunk += ChunkSize) {
+      auto count = std::min(ChunkSize, pIn->numCoords - chunk);
+
+      ComputeBankPipeFromCoordWoRotationBatch(pIn->pX + chunk, pIn->pY + chunk, count, bankPipe);
+
+      for (auto j = 0u; j < count; ++j) {
+         auto i = chunk + j;
+         uint32_t bitPosition;
+
+         pOut->pAddr[i] = ComputeLayoutAddrFromCoordMacroTiled(pLayout,
+                                                               pPixelIndex,
+                                                               bankPipe[j],
+                                                               pIn->pX[i],
+                                                               pIn->pY[i],
+                                                               GetBatchCoord(pIn->pSlice, i),
+                                                               GetBatchCoord(pIn->pSample, i),
+                                                               &bitPosition);
+
+         if (pOut->pBitPosition) {
+            pOut->pBitPosition[i] = bitPosition;
+         }
+      }
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::HwlComputeSurfaceAddrFromCoordBatch
+*
+*   @brief
+*       Entry of R600AddrLib ComputeSurfaceAddrFromCoordBatch, validates the batch and computes
+*       the surface layout once for all of its coordinates
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+R600AddrLib::HwlComputeSurfaceAddrFromCoordBatch(const ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_INPUT *pIn,
+                                                 ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_OUTPUT *pOut) const
+{
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+   auto outOfRange = false;
+
+   for (auto i = 0u; i < pIn->numCoords; ++i) {
+      outOfRange |= (pIn->pX[i] > pIn->pitch) | (pIn->pY[i] > pIn->height);
+   }
+
+   if (pIn->pipeSwizzle >= mPipes
+    || pIn->bankSwizzle >= mBanks
+    || pIn->numSamples > 8
+    || outOfRange) {
+      returnCode = ADDR_INVALIDPARAMS;
+   }
+
+   R600SurfaceLayout layout;
+
+   if (returnCode == ADDR_OK) {
+      returnCode = ComputeSurfaceLayout(pIn->tileMode,
+                                        pIn->bpp,
+                                        pIn->pitch,
+                                        pIn->height,
+                                        pIn->numSlices,
+                                        pIn->numSamples,
+                                        pIn->isDepth,
+                                        pIn->tileBase,
+                                        pIn->compBits,
+                                        pIn->pipeSwizzle,
+                                        pIn->bankSwizzle,
+                                        &layout);
+   }
+
+   if (returnCode == ADDR_OK) {
+      switch (pIn->tileMode) {
+      case ADDR_TM_LINEAR_GENERAL:
+      case ADDR_TM_LINEAR_ALIGNED:
+         ComputeSurfaceAddrFromCoordBatchLinear(pIn, pOut);
+         break;
+      case ADDR_TM_1D_TILED_THIN1:
+      case ADDR_TM_1D_TILED_THICK:
+         ComputeSurfaceAddrFromCoordBatchMicroTiled(&layout, pIn, pOut);
+         break;
+      case ADDR_TM_2D_TILED_THIN1:
+      case ADDR_TM_2D_TILED_THIN2:
+      case ADDR_TM_2D_TILED_THIN4:
+      case ADDR_TM_2D_TILED_THICK:
+      case ADDR_TM_2B_TILED_THIN1:
+      case ADDR_TM_2B_TILED_THIN2:
+      case ADDR_TM_2B_TILED_THIN4:
+      case ADDR_TM_2B_TILED_THICK:
+      case ADDR_TM_3D_TILED_THIN1:
+      case ADDR_TM_3D_TILED_THICK:
+      case ADDR_TM_3B_TILED_THIN1:
+      case ADDR_TM_3B_TILED_THICK:
+         ComputeSurfaceAddrFromCoordBatchMacroTiled(&layout, pIn, pOut);
+         break;
+      default:
+         std::fill(pOut->pAddr, pOut->pAddr + pIn->numCoords, uint64_t { 0 });
+
+         if (pOut->pBitPosition) {
+            std::fill(pOut->pBitPosition, pOut->pBitPosition + pIn->numCoords, 0u);
+         }
+      }
+
+      if (layout.bankSwapWidth && GetStatsCounters()) {
+         GetStatsCounters()->AddCounter(ADDR_STATS_BANK_SWAPPED_LOOKUPS, pIn->numCoords);
+      }
+   }
+
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::SetupCoordFromAddrLayout
+*
+*   @brief
+*       Validates the surface of an address to coordinate request and computes its layout.
+*       Tiled surfaces have to be padded to whole micro or macro tiles and the samples have to
+*       split evenly, otherwise several coordinates share the same address.
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+R600AddrLib::SetupCoordFromAddrLayout(AddrTileMode tileMode,
+                                      uint32_t bpp,
+                                      uint32_t pitch,
+                                      uint32_t height,
+                                      uint32_t numSlices,
+                                      uint32_t numSamples,
+                                      bool isDepth,
+                                      uint32_t tileBase,
+                                      uint32_t compBits,
+                                      uint32_t pipeSwizzle,
+                                      uint32_t bankSwizzle,
+                                      R600SurfaceLayout *pLayout) const
+{
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+
+   if (pipeSwizzle >= mPipes
+    || bankSwizzle >= mBanks
+    || numSamples > 8
+    || bpp == 0
+    || pitch == 0
+    || height == 0) {
+      returnCode = ADDR_INVALIDPARAMS;
+   }
+
+   if (returnCode == ADDR_OK) {
+      returnCode = ComputeSurfaceLayout(tileMode,
+                                        bpp,
+                                        pitch,
+                                        height,
+                                        numSlices,
+                                        numSamples,
+                                        isDepth,
+                                        tileBase,
+                                        compBits,
+                                        pipeSwizzle,
+                                        bankSwizzle,
+                                        pLayout);
+   }
+
+   if (returnCode == ADDR_OK) {
+      switch (tileMode) {
+      case ADDR_TM_LINEAR_GENERAL:
+      case ADDR_TM_LINEAR_ALIGNED:
+         break;
+      case ADDR_TM_1D_TILED_THIN1:
+      case ADDR_TM_1D_TILED_THICK:
+         if (pitch % MicroTileWidth || height % MicroTileHeight) {
+            returnCode = ADDR_INVALIDPARAMS;
+         }
+         break;
+      case ADDR_TM_2D_TILED_THIN1:
+      case ADDR_TM_2D_TILED_THIN2:
+      case ADDR_TM_2D_TILED_THIN4:
+      case ADDR_TM_2D_TILED_THICK:
+      case ADDR_TM_2B_TILED_THIN1:
+      case ADDR_TM_2B_TILED_THIN2:
+      case ADDR_TM_2B_TILED_THIN4:
+      case ADDR_TM_2B_TILED_THICK:
+      case ADDR_TM_3D_TILED_THIN1:
+      case ADDR_TM_3D_TILED_THICK:
+      case ADDR_TM_3B_TILED_THIN1:
+      case ADDR_TM_3B_TILED_THICK:
+         if (pitch % pLayout->macroTilePitch
+          || height % pLayout->macroTileHeight
+          || pLayout->macroTileBytes * 8 != pLayout->tileSliceBits * mPipes * mBanks) {
+            returnCode = ADDR_INVALIDPARAMS;
+         }
+         break;
+      default:
+         returnCode = ADDR_INVALIDPARAMS;
+      }
+   }
+
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::ComputeLayoutBytes
+*
+*   @brief
+*       Computes the number of bytes addressed by every slice and sample of a surface layout
+*
+*   @return
+*       Size in bytes
+***************************************************************************************************
+*/
+uint64_t
+R600AddrLib::ComputeLayoutBytes(const R600SurfaceLayout *pLayout) const
+{
+   uint64_t numSlices = pLayout->numSlices;
+   uint64_t thickness = pLayout->thickness;
+
+   switch (pLayout->tileMode) {
+   case ADDR_TM_LINEAR_GENERAL:
+   case ADDR_TM_LINEAR_ALIGNED:
+      return BITS_TO_BYTES(static_cast<uint64_t>(pLayout->pitch) * pLayout->height * numSlices * pLayout->numSamples * pLayout->bpp);
+   case ADDR_TM_1D_TILED_THIN1:
+   case ADDR_TM_1D_TILED_THICK:
+      return pLayout->sliceBytes * ((numSlices + thickness - 1) / thickness);
+   default:
+      return pLayout->sliceBytes * ((pLayout->numSampleSplits * numSlices - 1) / thickness + 1);
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::ComputeLayoutCoordFromAddrLinear
+*
+*   @brief
+*       Inverse of ComputeSurfaceAddrFromCoordLinear
+*
+*   @return
+*       False if the address is outside of the surface
+***************************************************************************************************
+*/
+bool
+R600AddrLib::ComputeLayoutCoordFromAddrLinear(const R600SurfaceLayout *pLayout,
+                                              uint64_t addr,
+                                              uint32_t bitPosition,
+                                              R600ElementCoord *pCoord,
+                                              uint64_t *pElemBytes) const
+{
+   uint64_t bpp = pLayout->bpp;
+   uint64_t elem = (addr * 8 + bitPosition) / bpp;
+   uint64_t row = elem / pLayout->pitch;
+   uint64_t image = row / pLayout->height;
+   uint64_t sample = image / pLayout->numSlices;
+
+   if (sample >= pLayout->numSamples) {
+      return false;
+   }
+
+   pCoord->x = static_cast<uint32_t>(elem % pLayout->pitch);
+   pCoord->y = static_cast<uint32_t>(row % pLayout->height);
+   pCoord->slice = static_cast<uint32_t>(image % pLayout->numSlices);
+   pCoord->sample = static_cast<uint32_t>(sample);
+
+   *pElemBytes = ((elem + 1) * bpp - 1) / 8 + 1 - addr;
+   return true;
+}
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::ComputeLayoutCoordFromAddrMicroTiled
+*
+*   @brief
+*       Inverse of ComputeSurfaceAddrFromCoordMicroTiled, every sample of a 1D tiled surface
+*       shares the same memory so sample 0 is returned
+*
+*   @return
+*       False if the address is outside of the surface
+***************************************************************************************************
+*/
+bool
+R600AddrLib::ComputeLayoutCoordFromAddrMicroTiled(const R600SurfaceLayout *pLayout,
+                                                  const uint16_t *pPixelCoord,
+                                                  uint64_t addr,
+                                                  uint32_t bitPosition,
+                                                  R600ElementCoord *pCoord,
+                                                  uint64_t *pElemBytes) const
+{
+   uint64_t thickness = pLayout->thickness;
+   uint64_t sliceIndex = addr / pLayout->sliceBytes;
+   uint64_t microTile = (addr % pLayout->sliceBytes) / pLayout->microTileBytes;
+   uint64_t tileOffset = (addr % pLayout->sliceBytes) % pLayout->microTileBytes;
+   uint64_t unitBits = pLayout->bpp;
+   uint64_t baseBits = 0;
+   uint64_t bits = tileOffset * 8 + bitPosition;
+
+   if (pLayout->isDepth && pLayout->compBits && pLayout->compBits != pLayout->bpp) {
+      unitBits = pLayout->compBits;
+      baseBits = pLayout->tileBase;
+   }
+
+   if (bits < baseBits) {
+      return false;
+   }
+
+   uint64_t pixelIndex = (bits - baseBits) / unitBits;
+
+   if (pixelIndex >= MicroTilePixels * thickness || pPixelCoord[pixelIndex] == PixelCoordInvalid) {
+      return false;
+   }
+
+   uint32_t packed = pPixelCoord[pixelIndex];
+   uint64_t x = (microTile % pLayout->microTilesPerRow) * MicroTileWidth + (packed & 7);
+   uint64_t y = (microTile / pLayout->microTilesPerRow) * MicroTileHeight + ((packed >> 3) & 7);
+   uint64_t slice = sliceIndex * thickness + (packed >> 6);
+
+   if (y >= pLayout->height || slice >= pLayout->numSlices) {
+      return false;
+   }
+
+   pCoord->x = static_cast<uint32_t>(x);
+   pCoord->y = static_cast<uint32_t>(y);
+   pCoord->slice = static_cast<uint32_t>(slice);
+   pCoord->sample = 0;
+
+   *pElemBytes = (baseBits + (pixelIndex + 1) * unitBits - 1) / 8 + 1 - tileOffset;
+   return true;
+}
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::FindMacroTileMicroTile
+*
+*   @brief
+*       Finds which micro tile of a macro tile the pipe and bank of an address select. The
+*       pipe and bank of every micro tile of the macro tile are computed once and kept in
+*       pCache for the following addresses of the same macro tile.
+*
+*   @return
+*       False if no micro tile of the macro tile uses that pipe and bank
+***************************************************************************************************
+*/
+bool
+R600AddrLib::FindMacroTileMicroTile(const R600SurfaceLayout *pLayout,
+                                    uint64_t macroTileX,
+                                    uint64_t macroTileY,
+                                    uint32_t slice,
+                                    uint32_t sampleSlice,
+                                    uint32_t bankPipe,
+                                    R600CoordFromAddrCache *pCache,
+                                    uint32_t *pMicroTileX,
+                                    uint32_t *pMicroTileY) const
+{
+   auto microTilesX = static_cast<uint32_t>(pLayout->macroTilePitch / MicroTileWidth);
+   auto microTilesY = static_cast<uint32_t>(pLayout->macroTileHeight / MicroTileHeight);
+
+   if (!pCache->valid
+    || pCache->macroTileX != macroTileX
+    || pCache->macroTileY != macroTileY
+    || pCache->slice != slice
+    || pCache->sampleSlice != sampleSlice) {
+      auto groupBits = Log2(mPipeInterleaveBytes);
+
+      std::memset(pCache->microTile, 0xFF, sizeof(pCache->microTile));
+
+      for (auto tileY = 0u; tileY < microTilesY; ++tileY) {
+         for (auto tileX = 0u; tileX < microTilesX; ++tileX) {
+            auto x = static_cast<uint32_t>(macroTileX * pLayout->macroTilePitch) + tileX * MicroTileWidth;
+            auto y = static_cast<uint32_t>(macroTileY * pLayout->macroTileHeight) + tileY * MicroTileHeight;
+            uint64_t bankPipeBits;
+
+            ComputeMacroTileBase(pLayout, x, y, slice, sampleSlice, &bankPipeBits);
+
+            auto &microTile = pCache->microTile[bankPipeBits >> groupBits];
+
+            if (microTile == 0xFF) {
+               microTile = static_cast<uint8_t>(tileY * microTilesX + tileX);
+            }
+         }
+      }
+
+      pCache->valid = true;
+      pCache->macroTileX = macroTileX;
+      pCache->macroTileY = macroTileY;
+      pCache->slice = slice;
+      pCache->sampleSlice = sampleSlice;
+   }
+
+   auto microTile = pCache->microTile[bankPipe];
+
+   if (microTile == 0xFF) {
+      return false;
+   }
+
+   *pMicroTileX = microTile % microTilesX;
+   *pMicroTileY = microTile / microTilesX;
+   return true;
+}
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::ComputeLayoutCoordFromAddrMacroTiled
+*
+*   @brief
+*       Inverse of ComputeSurfaceAddrFromCoordMacroTiled. The pipe and bank bits are removed
+*       to get the offset within the pipe and bank, which gives the slice, the macro tile and
+*       the offset within the micro tile. The micro tile is then the one of the macro tile
+*       the pipe and bank select after rotation, swizzle and bank swapping.
+*
+*   @return
+*       False if the address is outside of the surface
+***************************************************************************************************
+*/
+bool
+R600AddrLib::ComputeLayoutCoordFromAddrMacroTiled(const R600SurfaceLayout *pLayout,
+                                                  const uint16_t *pPixelCoord,
+                                                  uint64_t addr,
+                                                  uint32_t bitPosition,
+                                                  R600CoordFromAddrCache *pCache,
+                                                  R600ElementCoord *pCoord,
+                                                  uint64_t *pElemBytes) const
+{
+   uint64_t groupBits = Log2(mPipeInterleaveBytes);
+   uint64_t bankPipeBits = Log2(mPipes) + Log2(mBanks);
+   uint64_t groupMask = mPipeInterleaveBytes - 1;
+   auto bankPipe = static_cast<uint32_t>((addr >> groupBits) & ((1ull << bankPipeBits) - 1));
+   uint64_t total = ((addr >> (groupBits + bankPipeBits)) << groupBits) | (addr & groupMask);
+
+   uint64_t thickness = pLayout->thickness;
+   uint64_t numSamples = pLayout->numSamples;
+   uint64_t numSampleSplits = pLayout->numSampleSplits;
+   uint64_t tileSliceBits = pLayout->tileSliceBits;
+   uint64_t tileSliceBytes = tileSliceBits / 8;
+   uint64_t macroTilesPerSlice = pLayout->sliceBytes / pLayout->macroTileBytes;
+   uint64_t tile = total / tileSliceBytes;
+   uint64_t tileOffset = total % tileSliceBytes;
+   uint64_t sliceIndex = tile / macroTilesPerSlice;
+   uint64_t macroTileX = (tile % macroTilesPerSlice) % pLayout->macroTilesPerRow;
+   uint64_t macroTileY = (tile % macroTilesPerSlice) / pLayout->macroTilesPerRow;
+   uint64_t tileBits = tileOffset * 8 + bitPosition;
+
+   for (auto sampleSlice = 0u; sampleSlice < numSampleSplits; ++sampleSlice) {
+      uint64_t bits = sampleSlice * tileSliceBits + tileBits;
+      uint64_t unitBits;
+      uint64_t startBits;
+      uint64_t pixelIndex;
+      uint64_t sample;
+
+      if (pLayout->isDepth) {
+         uint64_t baseBits = 0;
+         unitBits = pLayout->bpp;
+
+         if (pLayout->compBits && pLayout->compBits != pLayout->bpp) {
+            unitBits = pLayout->compBits;
+            baseBits = pLayout->tileBase;
+         }
+
+         if (bits < baseBits) {
+            continue;
+         }
+
+         pixelIndex = (bits - baseBits) / (numSamples * unitBits);
+         sample = ((bits - baseBits) % (numSamples * unitBits)) / unitBits;
+         startBits = baseBits + pixelIndex * numSamples * unitBits + sample * unitBits;
+      } else {
+         uint64_t sampleBits = pLayout->microTileBits / numSamples;
+         unitBits = pLayout->bpp;
+         sample = bits / sampleBits;
+         pixelIndex = (bits % sampleBits) / unitBits;
+         startBits = sample * sampleBits + pixelIndex * unitBits;
+      }
+
+      if (startBits / tileSliceBits != sampleSlice
+       || sample >= numSamples
+       || pixelIndex >= MicroTilePixels * thickness
+       || pPixelCoord[pixelIndex] == PixelCoordInvalid) {
+         continue;
+      }
+
+      // Slices which ComputeMacroTileBase places at this slice index
+      uint32_t packed = pPixelCoord[pixelIndex];
+      uint64_t firstSliceBits = thickness * sliceIndex;
+      uint64_t lastSliceBits = thickness * sliceIndex + thickness - 1;
+
+      if (lastSliceBits < sampleSlice) {
+         continue;
+      }
+
+      uint64_t firstSlice = (firstSliceBits > sampleSlice) ? (firstSliceBits - sampleSlice + numSampleSplits - 1) / numSampleSplits : 0;
+      uint64_t lastSlice = std::min<uint64_t>((lastSliceBits - sampleSlice) / numSampleSplits, pLayout->numSlices - 1);
+
+      for (auto slice = firstSlice; slice <= lastSlice; ++slice) {
+         uint32_t microTileX;
+         uint32_t microTileY;
+
+         if (slice % thickness != (packed >> 6u)
+          || !FindMacroTileMicroTile(pLayout, macroTileX, macroTileY, static_cast<uint32_t>(slice), sampleSlice,
+                                     bankPipe, pCache, &microTileX, &microTileY)) {
+            continue;
+         }
+
+         uint64_t x = macroTileX * pLayout->macroTilePitch + microTileX * MicroTileWidth + (packed & 7);
+         uint64_t y = macroTileY * pLayout->macroTileHeight + microTileY * MicroTileHeight + ((packed >> 3) & 7);
+
+         if (y >= pLayout->height) {
+            return false;
+         }
+
+         pCoord->x = static_cast<uint32_t>(x);
+         pCoord->y = static_cast<uint32_t>(y);
+         pCoord->slice = static_cast<uint32_t>(slice);
+         pCoord->sample = static_cast<uint32_t>(sample);
+
+         // Bytes left of the element before its end or the end of the pipe interleave group
+         uint64_t lastByte = (startBits - sampleSlice * tileSliceBits + unitBits - 1) / 8;
+         *pElemBytes = std::min(lastByte + 1 - tileOffset, mPipeInterleaveBytes - (total & groupMask));
+         return true;
+      }
+   }
+
+   return false;
+}
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::ComputeLayoutCoordFromAddr
+*
+*   @brief
+*       Computes the coordinate of the element at an address of a surface layout and how many
+*       bytes of that element follow the address contiguously
+*
+*   @return
+*       False if the address is outside of the surface
+***************************************************************************************************
+*/
+bool
+R600AddrLib::ComputeLayoutCoordFromAddr(const R600SurfaceLayout *pLayout,
+                                        const uint16_t *pPixelCoord,
+                                        uint64_t addr,
+                                        uint32_t bitPosition,
+                                        R600CoordFromAddrCache *pCache,
+                                        R600ElementCoord *pCoord,
+                                        uint64_t *pElemBytes) const
+{
+   switch (pLayout->tileMode) {
+   case ADDR_TM_LINEAR_GENERAL:
+   case ADDR_TM_LINEAR_ALIGNED:
+      return ComputeLayoutCoordFromAddrLinear(pLayout, addr, bitPosition, pCoord, pElemBytes);
+   case ADDR_TM_1D_TILED_THIN1:
+   case ADDR_TM_1D_TILED_THICK:
+      return ComputeLayoutCoordFromAddrMicroTiled(pLayout, pPixelCoord, addr, bitPosition, pCoord, pElemBytes);
+   default:
+      return ComputeLayoutCoordFromAddrMacroTiled(pLayout, pPixelCoord, addr, bitPosition, pCache, pCoord, pElemBytes);
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::HwlComputeSurfaceCoordFromAddr
+*
+*   @brief
+*       Entry of R600AddrLib ComputeSurfaceCoordFromAddr
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+R600AddrLib::HwlComputeSurfaceCoordFromAddr(const ADDR_COMPUTE_SURFACE_COORDFROMADDR_INPUT *pIn,
+                                            ADDR_COMPUTE_SURFACE_COORDFROMADDR_OUTPUT *pOut) const
+{
+   R600SurfaceLayout layout;
+   auto returnCode = SetupCoordFromAddrLayout(pIn->tileMode,
+                                              pIn->bpp,
+                                              pIn->pitch,
+                                              pIn->height,
+                                              pIn->numSlices,
+                                              pIn->numSamples,
+                                              pIn->isDepth,
+                                              pIn->tileBase,
+                                              pIn->compBits,
+                                              pIn->pipeSwizzle,
+                                              pIn->bankSwizzle,
+                                              &layout);
+
+   if (returnCode == ADDR_OK && pIn->bitPosition >= 8) {
+      returnCode = ADDR_INVALIDPARAMS;
+   }
+
+   if (returnCode == ADDR_OK) {
+      auto pPixelCoord = GetPixelCoordTable(layout.bpp, layout.tileMode, layout.tileType);
+      R600CoordFromAddrCache cache;
+      R600ElementCoord coord;
+      uint64_t elemBytes;
+
+      cache.valid = false;
+
+      if (ComputeLayoutCoordFromAddr(&layout, pPixelCoord, pIn->addr, pIn->bitPosition, &cache, &coord, &elemBytes)) {
+         pOut->x = coord.x;
+         pOut->y = coord.y;
+         pOut->slice = coord.slice;
+         pOut->sample = coord.sample;
+      } else {
+         returnCode = ADDR_INVALIDPARAMS;
+      }
+   }
+
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::HwlComputeSurfaceCoordFromAddrRange
+*
+*   @brief
+*       Entry of R600AddrLib ComputeSurfaceCoordFromAddrRange, walks the byte range one
+*       element piece at a time
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+R600AddrLib::HwlComputeSurfaceCoordFromAddrRange(const ADDR_COMPUTE_SURFACE_COORDFROMADDR_RANGE_INPUT *pIn,
+                                                 ADDR_COMPUTE_SURFACE_COORDFROMADDR_RANGE_OUTPUT *pOut) const
+{
+   R600SurfaceLayout layout;
+   auto returnCode = SetupCoordFromAddrLayout(pIn->tileMode,
+                                              pIn->bpp,
+                                              pIn->pitch,
+                                              pIn->height,
+                                              pIn->numSlices,
+                                              pIn->numSamples,
+                                              pIn->isDepth,
+                                              pIn->tileBase,
+                                              pIn->compBits,
+                                              pIn->pipeSwizzle,
+                                              pIn->bankSwizzle,
+                                              &layout);
+
+   if (returnCode == ADDR_OK) {
+      auto pPixelCoord = GetPixelCoordTable(layout.bpp, layout.tileMode, layout.tileType);
+      auto end = ComputeLayoutBytes(&layout);
+      auto numCoords = uint32_t { 0 };
+      auto prevValid = false;
+      R600CoordFromAddrCache cache;
+      R600ElementCoord prev;
+
+      if (pIn->addr < end && pIn->numBytes < end - pIn->addr) {
+         end = pIn->addr + pIn->numBytes;
+      }
+
+      cache.valid = false;
+
+      for (auto addr = pIn->addr; addr < end; ) {
+         R600ElementCoord coord;
+         uint64_t elemBytes;
+
+         if (!ComputeLayoutCoordFromAddr(&layout, pPixelCoord, addr, 0, &cache, &coord, &elemBytes)) {
+            addr++;
+            continue;
+         }
+
+         if (!prevValid || std::memcmp(&coord, &prev, sizeof(R600ElementCoord)) != 0) {
+            if (numCoords < pOut->maxCoords) {
+               pOut->pX[numCoords] = coord.x;
+               pOut->pY[numCoords] = coord.y;
+               pOut->pSlice[numCoords] = coord.slice;
+               pOut->pSample[numCoords] = coord.sample;
+            }
+
+            numCoords++;
+            prev = coord;
+            prevValid = true;
+         }
+
+         addr += elemBytes;
+      }
+
+      pOut->numCoords = numCoords;
+
+      if (numCoords > pOut->maxCoords) {
+         returnCode = ADDR_OUTOFMEMORY;
+      }
+   }
+
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   FlushDirtyRegion
+*
+*   @brief
+*       Writes the pending region of a dirty region list to the output, when it still fits
+***************************************************************************************************
+*/
+static void
+FlushDirtyRegion(R600DirtyRegionList *pList)
+{
+   if (pList->pendingValid) {
+      auto pOut = pList->pOut;
+
+      if (pList->numRegions < pOut->maxRegions) {
+         pOut->pRegions[pList->numRegions] = pList->pending;
+
+         if (pOut->pMipLevels) {
+            pOut->pMipLevels[pList->numRegions] = pList->pendingMipLevel;
+         }
+      }
+
+      pList->numRegions++;
+      pList->pendingValid = false;
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   AddDirtyRegion
+*
+*   @brief
+*       Adds a region to a dirty region list, merging it into the pending region when it is
+*       contained in it or extends it along x, y or the slices
+***************************************************************************************************
+*/
+static void
+AddDirtyRegion(R600DirtyRegionList *pList,
+               uint32_t mipLevel,
+               uint64_t x,
+               uint64_t y,
+               uint64_t slice,
+               uint64_t width,
+               uint64_t height,
+               uint64_t depth)
+{
+   auto &pending = pList->pending;
+
+   if (pList->pendingValid && pList->pendingMipLevel == mipLevel) {
+      auto sameX = (x == pending.x && width == pending.width);
+      auto sameY = (y == pending.y && height == pending.height);
+      auto sameSlice = (slice == pending.slice && depth == pending.depth);
+
+      if (x >= pending.x && x + width <= pending.x + pending.width
+       && y >= pending.y && y + height <= pending.y + pending.height
+       && slice >= pending.slice && slice + depth <= pending.slice + pending.depth) {
+         return;
+      }
+
+      if (sameY && sameSlice && x == pending.x + pending.width) {
+         pending.width += static_cast<uint32_t>(width);
+         return;
+      }
+
+      if (sameX && sameSlice && y == pending.y + pending.height) {
+         pending.height += static_cast<uint32_t>(height);
+         return;
+      }
+
+      if (sameX && sameY && slice == pending.slice + pending.depth) {
+         pending.depth += static_cast<uint32_t>(depth);
+         return;
+      }
+   }
+
+   FlushDirtyRegion(pList);
+
+   pList->pendingValid = true;
+   pList->pendingMipLevel = mipLevel;
+   pending.x = static_cast<uint32_t>(x);
+   pending.y = static_cast<uint32_t>(y);
+   pending.slice = static_cast<uint32_t>(slice);
+   pending.width = static_cast<uint32_t>(width);
+   pending.height = static_cast<uint32_t>(height);
+   pending.depth = static_cast<uint32_t>(depth);
+}
+
+
+/**
+***************************************************************************************************
+*   AddDirtySpan
+*
+*   @brief
+*       Adds the regions covering the units first to last of a row major run of units, at most
+*       a partial first row, the full rows and a partial last row
+***************************************************************************************************
+*/
+static void
+AddDirtySpan(R600DirtyRegionList *pList,
+             uint32_t mipLevel,
+             uint64_t first,
+             uint64_t last,
+             uint64_t unitsPerRow,
+             uint64_t unitWidth,
+             uint64_t unitHeight,
+             uint64_t slice,
+             uint64_t depth)
+{
+   uint64_t firstRow = first / unitsPerRow;
+   uint64_t lastRow = last / unitsPerRow;
+   uint64_t firstX = first % unitsPerRow;
+   uint64_t lastX = last % unitsPerRow;
+
+   if (firstRow == lastRow) {
+      AddDirtyRegion(pList, mipLevel, firstX * unitWidth, firstRow * unitHeight, slice,
+                     (lastX - firstX + 1) * unitWidth, unitHeight, depth);
+      return;
+   }
+
+   if (firstX) {
+      AddDirtyRegion(pList, mipLevel, firstX * unitWidth, firstRow * unitHeight, slice,
+                     (unitsPerRow - firstX) * unitWidth, unitHeight, depth);
+      firstRow++;
+   }
+
+   uint64_t fullRowsEnd = (lastX == unitsPerRow - 1) ? lastRow + 1 : lastRow;
+
+   if (firstRow < fullRowsEnd) {
+      AddDirtyRegion(pList, mipLevel, 0, firstRow * unitHeight, slice,
+                     unitsPerRow * unitWidth, (fullRowsEnd - firstRow) * unitHeight, depth);
+   }
+
+   if (lastX != unitsPerRow - 1) {
+      AddDirtyRegion(pList, mipLevel, 0, lastRow * unitHeight, slice,
+                     (lastX + 1) * unitWidth, unitHeight, depth);
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::AddDirtyMacroTiles
+*
+*   @brief
+*       Adds the macro tiles holding the offsets totalBegin to totalEnd within a pipe and
+*       bank, or only their micro tile of bankPipe when allBankPipes is false
+***************************************************************************************************
+*/
+void
+R600AddrLib::AddDirtyMacroTiles(const R600SurfaceLayout *pLayout,
+                                uint32_t mipLevel,
+                                uint64_t totalBegin,
+                                uint64_t totalEnd,
+                                bool allBankPipes,
+                                uint32_t bankPipe,
+                                R600CoordFromAddrCache *pCache,
+                                R600DirtyRegionList *pList) const
+{
+   uint64_t thickness = pLayout->thickness;
+   uint64_t numSampleSplits = pLayout->numSampleSplits;
+   uint64_t tileSliceBytes = pLayout->tileSliceBits / 8;
+   uint64_t macroTilesPerSlice = pLayout->sliceBytes / pLayout->macroTileBytes;
+
+   for (auto tile = totalBegin / tileSliceBytes; tile <= (totalEnd - 1) / tileSliceBytes; ++tile) {
+      uint64_t sliceIndex = tile / macroTilesPerSlice;
+      uint64_t macroTileX = (tile % macroTilesPerSlice) % pLayout->macroTilesPerRow;
+      uint64_t macroTileY = (tile % macroTilesPerSlice) / pLayout->macroTilesPerRow;
+      uint64_t x = macroTileX * pLayout->macroTilePitch;
+      uint64_t y = macroTileY * pLayout->macroTileHeight;
+
+      for (auto sampleSlice = 0u; sampleSlice < numSampleSplits; ++sampleSlice) {
+         // Slices which ComputeMacroTileBase places at this slice index
+         uint64_t firstSliceBits = thickness * sliceIndex;
+         uint64_t lastSliceBits = thickness * sliceIndex + thickness - 1;
+
+         if (lastSliceBits < sampleSlice) {
+            continue;
+         }
+
+         uint64_t firstSlice = (firstSliceBits > sampleSlice) ? (firstSliceBits - sampleSlice + numSampleSplits - 1) / numSampleSplits : 0;
+         uint64_t lastSlice = std::min<uint64_t>((lastSliceBits - sampleSlice) / numSampleSplits, pLayout->numSlices - 1);
+
+         if (firstSlice > lastSlice) {
+            continue;
+         }
+
+         if (allBankPipes) {
+            AddDirtyRegion(pList, mipLevel, x, y, firstSlice, pLayout->macroTilePitch, pLayout->macroTileHeight,
+                           lastSlice - firstSlice + 1);
+            continue;
+         }
+
+         for (auto slice = firstSlice; slice <= lastSlice; ++slice) {
+            uint32_t microTileX;
+            uint32_t microTileY;
+
+            if (FindMacroTileMicroTile(pLayout, macroTileX, macroTileY, static_cast<uint32_t>(slice), sampleSlice,
+                                       bankPipe, pCache, &microTileX, &microTileY)) {
+               AddDirtyRegion(pList, mipLevel, x + microTileX * MicroTileWidth, y + microTileY * MicroTileHeight,
+                              slice, MicroTileWidth, MicroTileHeight, 1);
+            }
+         }
+      }
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::AddDirtyPartialRound
+*
+*   @brief
+*       Adds the micro tiles of the bytes first to last of a single round over the pipes and
+*       banks, one pipe interleave group at a time
+***************************************************************************************************
+*/
+void
+R600AddrLib::AddDirtyPartialRound(const R600SurfaceLayout *pLayout,
+                                  uint32_t mipLevel,
+                                  uint64_t first,
+                                  uint64_t last,
+                                  R600CoordFromAddrCache *pCache,
+                                  R600DirtyRegionList *pList) const
+{
+   uint64_t groupBits = Log2(mPipeInterleaveBytes);
+   uint64_t bankPipeBits = Log2(mPipes) + Log2(mBanks);
+   uint64_t groupMask = mPipeInterleaveBytes - 1;
+
+   for (auto addr = first; addr < last; ) {
+      auto groupEnd = std::min(last, (addr | groupMask) + 1);
+      auto bankPipe = static_cast<uint32_t>((addr >> groupBits) & ((1ull << bankPipeBits) - 1));
+      uint64_t total = ((addr >> (groupBits + bankPipeBits)) << groupBits) | (addr & groupMask);
+
+      AddDirtyMacroTiles(pLayout, mipLevel, total, total + (groupEnd - addr), false, bankPipe, pCache, pList);
+      addr = groupEnd;
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::ComputeLayoutDirtyRegions
+*
+*   @brief
+*       Adds the regions of a surface layout touched by the bytes begin to end, which must lie
+*       within ComputeLayoutBytes.
+*
+*       Every pipe interleave group of a full round over the pipes and banks of a macro tiled
+*       surface holds the same offsets of the same macro tiles, so full rounds dirty whole
+*       macro tiles. The partial rounds at the ends of the range only dirty the micro tiles
+*       their pipes and banks select.
+***************************************************************************************************
+*/
+void
+R600AddrLib::ComputeLayoutDirtyRegions(const R600SurfaceLayout *pLayout,
+                                       uint32_t mipLevel,
+                                       uint64_t begin,
+                                       uint64_t end,
+                                       R600DirtyRegionList *pList) const
+{
+   if (pLayout->tileMode == ADDR_TM_LINEAR_GENERAL || pLayout->tileMode == ADDR_TM_LINEAR_ALIGNED) {
+      uint64_t firstElem = begin * 8 / pLayout->bpp;
+      uint64_t lastElem = (end * 8 - 1) / pLayout->bpp;
+      uint64_t imageElems = static_cast<uint64_t>(pLayout->pitch) * pLayout->height;
+
+      for (auto image = firstElem / imageElems; image <= lastElem / imageElems; ++image) {
+         uint64_t base = image * imageElems;
+
+         AddDirtySpan(pList, mipLevel,
+                      std::max(firstElem, base) - base,
+                      std::min(lastElem, base + imageElems - 1) - base,
+                      pLayout->pitch, 1, 1, image % pLayout->numSlices, 1);
+      }
+   } else if (pLayout->tileMode == ADDR_TM_1D_TILED_THIN1 || pLayout->tileMode == ADDR_TM_1D_TILED_THICK) {
+      for (auto sliceIndex = begin / pLayout->sliceBytes; sliceIndex <= (end - 1) / pLayout->sliceBytes; ++sliceIndex) {
+         uint64_t base = sliceIndex * pLayout->sliceBytes;
+         uint64_t slice = sliceIndex * pLayout->thickness;
+
+         AddDirtySpan(pList, mipLevel,
+                      (std::max(begin, base) - base) / pLayout->microTileBytes,
+                      (std::min(end, base + pLayout->sliceBytes) - 1 - base) / pLayout->microTileBytes,
+                      pLayout->microTilesPerRow, MicroTileWidth, MicroTileHeight,
+                      slice, std::min<uint64_t>(pLayout->thickness, pLayout->numSlices - slice));
+      }
+   } else {
+      uint64_t roundBytes = static_cast<uint64_t>(mPipeInterleaveBytes) * mPipes * mBanks;
+      uint64_t firstRound = (begin + roundBytes - 1) / roundBytes;
+      uint64_t endRound = end / roundBytes;
+      R600CoordFromAddrCache cache;
+
+      cache.valid = false;
+
+      if (firstRound >= endRound) {
+         AddDirtyPartialRound(pLayout, mipLevel, begin, end, &cache, pList);
+      } else {
+         AddDirtyPartialRound(pLayout, mipLevel, begin, firstRound * roundBytes, &cache, pList);
+         AddDirtyMacroTiles(pLayout, mipLevel, firstRound * mPipeInterleaveBytes, endRound * mPipeInterleaveBytes,
+                            true, 0, &cache, pList);
+         AddDirtyPartialRound(pLayout, mipLevel, endRound * roundBytes, end, &cache, pList);
+      }
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::HwlComputeSurfaceDirtyRegions
+*
+*   @brief
+*       Entry of R600AddrLib ComputeSurfaceDirtyRegions
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+R600AddrLib::HwlComputeSurfaceDirtyRegions(const ADDR_COMPUTE_SURFACE_DIRTY_REGIONS_INPUT *pIn,
+                                           ADDR_COMPUTE_SURFACE_DIRTY_REGIONS_OUTPUT *pOut) const
+{
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+   auto numMipLevels = pIn->pMipInfo ? pIn->numMipLevels : 1u;
+   auto rangeEnd = pIn->addr + std::min(pIn->numBytes, ~pIn->addr);
+   R600DirtyRegionList list;
+
+   list.pOut = pOut;
+   list.numRegions = 0;
+   list.pendingValid = false;
+
+   for (auto level = 0u; level < numMipLevels && returnCode == ADDR_OK; ++level) {
+      auto pitch = pIn->pitch;
+      auto height = pIn->height;
+      auto numSlices = pIn->numSlices;
+      auto tileMode = pIn->tileMode;
+      auto offset = uint64_t { 0 };
+      R600SurfaceLayout layout;
+
+      if (pIn->pMipInfo) {
+         pitch = pIn->pMipInfo[level].pitch;
+         height = pIn->pMipInfo[level].height;
+         numSlices = pIn->pMipInfo[level].depth;
+         tileMode = pIn->pMipInfo[level].tileMode;
+         offset = pIn->pMipInfo[level].offset;
+      }
+
+      returnCode = SetupCoordFromAddrLayout(tileMode,
+                                            pIn->bpp,
+                                            pitch,
+                                            height,
+                                            numSlices,
+                                            pIn->numSamples,
+                                            pIn->isDepth,
+                                            pIn->tileBase,
+                                            pIn->compBits,
+                                            pIn->pipeSwizzle,
+                                            pIn->bankSwizzle,
+                                            &layout);
+
+      if (returnCode == ADDR_OK) {
+         auto begin = std::max(pIn->addr, offset);
+         auto end = std::min(rangeEnd, offset + ComputeLayoutBytes(&layout));
+
+         if (begin < end) {
+            ComputeLayoutDirtyRegions(&layout, level, begin - offset, end - offset, &list);
+         }
+      }
+   }
+
+   if (returnCode == ADDR_OK) {
+      FlushDirtyRegion(&list);
+      pOut->numRegions = list.numRegions;
+
+      if (list.numRegions > pOut->maxRegions) {
+         returnCode = ADDR_OUTOFMEMORY;
+      }
+   }
+
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   R600AddrLib::HwlCreateSurfacePlan
+*
+*   @brief
+*       Entry of R600AddrLib CreateSurfacePlan
+*
+*   @return
+*       ADDR_E_RETURNCODE
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+R600AddrLib::HwlCreateSurfacePlan(const ADDR_CREATE_SURFACE_PLAN_INPUT *pIn,
+                                  AddrSurfacePlan **ppPlan) const
+{
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+
+   if (pIn->pipeSwizzle >= mPipes
+    || pIn->bankSwizzle >= mBanks
+    || pIn->numSamples > 8
+    || pIn->bpp == 0
+    || pIn->tileMode > ADDR_TM_3B_TILED_THICK) {
+      returnCode = ADDR_INVALIDPARAMS;
+   }
+
+   R600SurfaceLayout layout;
+
+   if (returnCode == ADDR_OK) {
+      returnCode = ComputeSurfaceLayout(pIn->tileMode,
+                                        pIn->bpp,
+                                        pIn->pitch,
+                                        pIn->height,
+                                        pIn->numSlices,
+                                        pIn->numSamples,
+                                        pIn->isDepth,
+                                        pIn->tileBase,
+                                        pIn->compBits,
+                                        pIn->pipeSwizzle,
+                                        pIn->bankSwizzle,
+                                        &layout);
+   }
+
+   if (returnCode == ADDR_OK) {
+      auto memory = AddrObject::ClientAlloc(sizeof(R600SurfacePlan), &mClient);
+
+      if (memory) {
+         auto pPixelIndex = GetPixelIndexTable(0, layout.bpp, layout.tileMode, layout.tileType);
+         *ppPlan = new (memory) R600SurfacePlan(&mClient, this, &layout, pPixelIndex);
+      } else {
+         returnCode = ADDR_OUTOFMEMORY;
+      }
+   }
+
+   return returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   R600SurfacePlan::R600SurfacePlan
+*
+*   @brief
+*       Constructor for the R600SurfacePlan class, computes the per surface terms and picks
+*       the kernel of the tile mode
+***************************************************************************************************
+*/
+R600SurfacePlan::R600SurfacePlan(const AddrClient *pClient,
+                                 const R600AddrLib *pLib,
+                                 const R600SurfaceLayout *pLayout,
+                                 const uint16_t *pPixelIndex) :
+   AddrSurfacePlan(pClient)
+{
+   uint32_t numPipes = pLib->mPipes;
+   uint32_t numBanks = pLib->mBanks;
+   uint32_t groupBytes = pLib->mPipeInterleaveBytes;
+   uint64_t elemBits = pLayout->bpp;
+   auto &terms = mTerms;
+
+   terms.pLib = pLib;
+   terms.layout = *pLayout;
+   terms.pPixelIndex = pPixelIndex;
+   terms.baseBits = 0;
+
+   if (pLayout->isDepth && pLayout->compBits && pLayout->compBits != pLayout->bpp) {
+      elemBits = pLayout->compBits;
+      terms.baseBits = pLayout->tileBase;
+   }
+
+   if (pLayout->tileMode == ADDR_TM_1D_TILED_THIN1 || pLayout->tileMode == ADDR_TM_1D_TILED_THICK) {
+      // Every sample of a 1D tiled surface aliases the same element
+      terms.sampleBits = 0;
+      terms.pixelBits = elemBits;
+   } else if (pLayout->isDepth) {
+      // Depth samples of a pixel are next to each other
+      terms.sampleBits = elemBits;
+      terms.pixelBits = elemBits * pLayout->numSamples;
+   } else {
+      // Colour samples are planes of the micro tile
+      terms.sampleBits = pLayout->microTileBits / pLayout->numSamples;
+      terms.pixelBits = elemBits;
+   }
+
+   terms.imageElems = static_cast<uint64_t>(pLayout->pitch) * pLayout->height;
+   terms.thicknessShift = Log2(pLayout->thickness);
+   terms.rotationSliceShift = pLib->IsThickMacroTiled(pLayout->tileMode) ? Log2(ThickTileThickness) : 0;
+   terms.macroTilePitchShift = pLayout->macroTilePitch ? Log2(pLayout->macroTilePitch) : 0;
+   terms.macroTileHeightShift = pLayout->macroTileHeight ? Log2(pLayout->macroTileHeight) : 0;
+   terms.numPipes = numPipes;
+   terms.numBanks = numBanks;
+   terms.pipeBits = Log2(numPipes);
+   terms.groupBits = Log2(groupBytes);
+   terms.bankPipeShift = Log2(numPipes) + Log2(numBanks);
+   terms.bankPipeMask = numPipes * numBanks - 1;
+   terms.groupMask = groupBytes - 1;
+   terms.swizzle = pLayout->pipeSwizzle + numPipes * pLayout->bankSwizzle;
+   terms.sampleSliceSwizzle = numPipes * ((numBanks >> 1) + 1);
+
+   mKernel = pLib->mPlanAddrKernels[pLayout->tileMode];
+}
+
+
+/**
+***************************************************************************************************
+*   R600SurfacePlan::ComputeAddrFromCoord
+*
+*   @brief
+*       Computes the surface address and bit position of a coordinate
+*
+*   @return
+*       The byte address
+***************************************************************************************************
+*/
+uint64_t
+R600SurfacePlan::ComputeAddrFromCoord(uint32_t x,
+                                      uint32_t y,
+                                      uint32_t slice,
+                                      uint32_t sample,
+                                      uint32_t *pBitPosition) const
+{
+   return mKernel(&mTerms, x, y, slice, sample, pBitPosition);
+}
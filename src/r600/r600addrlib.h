@@ -86,6 +86,231 @@ union GB_TILING_CONFIG
 };
 
 
+static const uint32_t BankSwapOrder[] = { 0, 1, 3, 2, 6, 7, 5, 4, 0, 0 };
+
+// The pipe and bank equations only read bits 3 - 6 of x and bits 3 - 8 of y, so they repeat
+// every BankPipeTableWidth by BankPipeTableHeight micro tiles
+static const uint32_t BankPipeTableWidth = 16;
+static const uint32_t BankPipeTableHeight = 64;
+
+// Padding so 32 bit gathers of the last byte stay inside the table
+static const uint32_t BankPipeTablePadding = 3;
+
+
+/**
+***************************************************************************************************
+*   GetBankPipeTableIndex
+*
+*   @brief
+*       Returns the index of the micro tile holding (x, y) in the bank pipe table
+***************************************************************************************************
+*/
+static inline uint32_t
+GetBankPipeTableIndex(uint32_t x, uint32_t y)
+{
+   return ((y / MicroTileHeight) % BankPipeTableHeight) * BankPipeTableWidth
+      + (x / MicroTileWidth) % BankPipeTableWidth;
+}
+
+
+/**
+***************************************************************************************************
+* @brief Per-surface values needed to walk a surface one micro tile at a time, these are the
+*        coordinate independent terms of ComputeSurfaceAddrFromCoordMacroTiled.
+***************************************************************************************************
+*/
+struct R600SurfaceLayout
+{
+   AddrTileMode tileMode;
+   AddrTileType tileType;
+   uint32_t bpp;
+   uint32_t pitch;
+   uint32_t height;
+   uint32_t numSlices;
+   uint32_t numSamples;
+   bool isDepth;
+   uint32_t tileBase;
+   uint32_t compBits;
+   uint32_t pipeSwizzle;
+   uint32_t bankSwizzle;
+   uint32_t thickness;
+   uint64_t microTileBits;
+   uint64_t microTileBytes;
+   uint64_t microTilesPerRow;
+   uint64_t sliceBytes;
+   uint64_t numSampleSplits;
+   uint64_t tileSliceBits;
+   uint64_t macroTilePitch;
+   uint64_t macroTileHeight;
+   uint64_t macroTilesPerRow;
+   uint64_t macroTileBytes;
+   uint64_t bankSwapWidth;
+   uint64_t rotation;
+};
+
+
+/**
+***************************************************************************************************
+* @brief Plane of a depth plane copy, the element of pixel i and sample s of a micro tile
+*        starts at bit tileBase + s * sampleBits + i * pixelBits.
+***************************************************************************************************
+*/
+struct R600DepthPlaneCopy
+{
+   uint8_t *pLinear;
+   uint32_t linearPitch;
+   uint64_t linearSliceSize;
+   uint32_t elemBytes;
+   uint64_t tileBase;
+   uint64_t sampleBits;
+   uint64_t pixelBits;
+};
+
+
+/**
+***************************************************************************************************
+* @brief State shared by every micro tile of a bulk surface copy. A depth plane copy has
+*        numPlanes planes instead of the single linear buffer.
+***************************************************************************************************
+*/
+struct R600SurfaceCopy
+{
+   R600SurfaceLayout layout;
+   ADDR_COPY_REGION region;
+   uint8_t *pTiled;
+   uint8_t *pLinear;
+   uint32_t linearPitch;
+   uint64_t linearSliceSize;
+   uint32_t elemBytes;
+   const uint16_t *pPixelIndex;
+   AddrMicroTileKernel pKernel;
+   bool tiledToLinear;
+   uint32_t numPlanes;
+   R600DepthPlaneCopy planes[ADDR_MAX_DEPTH_PLANES];
+};
+
+
+class R600AddrLib;
+
+/**
+***************************************************************************************************
+* @brief Split of a bulk surface copy into tasks of whole macro tile rows.
+***************************************************************************************************
+*/
+struct R600SurfaceCopyTasks
+{
+   const R600AddrLib *pLib;
+   const R600SurfaceCopy *pCopy;
+   uint32_t firstSample;
+   uint32_t bandHeight;
+   uint32_t firstBandY;
+   uint32_t bandsPerSlice;
+   uint64_t numBands;
+   uint32_t numTasks;
+};
+
+
+/**
+***************************************************************************************************
+* @brief Coordinate of a surface element.
+***************************************************************************************************
+*/
+struct R600ElementCoord
+{
+   uint32_t x;
+   uint32_t y;
+   uint32_t slice;
+   uint32_t sample;
+};
+
+
+/**
+***************************************************************************************************
+* @brief Micro tile of every pipe and bank of the last macro tile an address was mapped back in,
+*        indexed by (bank << pipeBits) | pipe.
+***************************************************************************************************
+*/
+struct R600CoordFromAddrCache
+{
+   bool valid;
+   uint64_t macroTileX;
+   uint64_t macroTileY;
+   uint32_t slice;
+   uint32_t sampleSlice;
+   uint8_t microTile[64];
+};
+
+
+/**
+***************************************************************************************************
+* @brief Dirty regions found so far, the last one is kept back while the following regions
+*        can still be merged into it.
+***************************************************************************************************
+*/
+struct R600DirtyRegionList
+{
+   ADDR_COMPUTE_SURFACE_DIRTY_REGIONS_OUTPUT *pOut;
+   uint32_t numRegions;
+   bool pendingValid;
+   uint32_t pendingMipLevel;
+   ADDR_COPY_REGION pending;
+};
+
+
+/**
+***************************************************************************************************
+* @brief Surface layout of a surface plan with the per surface terms of
+*        ComputeSurfaceAddrFromCoord reduced to shifts, masks and strides.
+***************************************************************************************************
+*/
+struct R600SurfacePlanTerms
+{
+   const R600AddrLib *pLib;
+   R600SurfaceLayout layout;
+   const uint16_t *pPixelIndex;
+
+   // Element offset in bits within a micro tile is
+   // baseBits + sample * sampleBits + pixelIndex * pixelBits
+   uint64_t baseBits;
+   uint64_t sampleBits;
+   uint64_t pixelBits;
+
+   uint64_t imageElems;
+   uint32_t thicknessShift;
+   uint32_t rotationSliceShift;
+   uint32_t macroTilePitchShift;
+   uint32_t macroTileHeightShift;
+   uint32_t numPipes;
+   uint32_t numBanks;
+   uint32_t pipeBits;
+   uint32_t groupBits;
+   uint32_t bankPipeShift;
+   uint32_t bankPipeMask;
+   uint64_t groupMask;
+   uint32_t swizzle;
+   uint32_t sampleSliceSwizzle;
+};
+
+
+/**
+***************************************************************************************************
+* @brief Computes the address of a coordinate of the surface of a plan
+***************************************************************************************************
+*/
+typedef uint64_t (*R600PlanAddrKernel)(const R600SurfacePlanTerms *pTerms,
+                                       uint32_t x,
+                                       uint32_t y,
+                                       uint32_t slice,
+                                       uint32_t sample,
+                                       uint32_t *pBitPosition);
+
+
+const R600PlanAddrKernel *
+R600SelectPlanAddrKernels(uint32_t numPipes,
+                          uint32_t numBanks,
+                          uint32_t groupBytes);
+
+
 /**
 ***************************************************************************************************
 * @brief This class is the R600 specific address library
@@ -95,11 +320,11 @@ union GB_TILING_CONFIG
 class R600AddrLib : public AddrLib
 {
 public:
-   R600AddrLib(ADDR_CLIENT_HANDLE hClient);
+   R600AddrLib(const AddrClient *pClient);
    virtual ~R600AddrLib() = default;
 
    static R600AddrLib *
-   CreateObj(ADDR_CLIENT_HANDLE hClient);
+   CreateObj(const AddrClient *pClient, void *pMemory);
 
    bool
    DecodeGbRegs(const ADDR_REGISTER_VALUE* pRegValue);
@@ -193,6 +418,11 @@ public:
    bool
    IsThickMacroTiled(AddrTileMode tileMode) const;
 
+   bool
+   IsSampleLargerThanSplit(AddrTileMode tileMode,
+                           uint32_t bpp,
+                           uint32_t numSamples) const;
+
    bool
    IsBankSwappedTileMode(AddrTileMode tileMode) const;
 
@@ -241,6 +471,15 @@ public:
    uint32_t
    ComputeBankFromCoordWoRotation(uint32_t x, uint32_t y) const;
 
+   uint32_t
+   ComputeBankPipeFromCoordWoRotation(uint32_t x, uint32_t y) const;
+
+   void
+   ComputeBankPipeFromCoordWoRotationBatch(const uint32_t *pX,
+                                           const uint32_t *pY,
+                                           uint32_t count,
+                                           uint32_t *pBankPipe) const;
+
    uint64_t
    ComputeSurfaceAddrFromCoordMacroTiled(uint32_t x,
                                          uint32_t y,
@@ -296,11 +535,308 @@ public:
                         uint32_t numSlices,
                         uint32_t baseAlign) const override;
 
+   virtual uint32_t
+   HwlComputePipeFromCoord(uint32_t x,
+                           uint32_t y) const override;
+
+   virtual uint32_t
+   HwlComputeFmaskBits(uint32_t numSamples,
+                       uint32_t numFrags,
+                       uint32_t *pBitsPerSample) const override;
+
    virtual ADDR_E_RETURNCODE
    HwlComputeSliceTileSwizzle(const ADDR_COMPUTE_SLICESWIZZLE_INPUT *pIn,
                               ADDR_COMPUTE_SLICESWIZZLE_OUTPUT *pOut) const override;
 
+   ADDR_E_RETURNCODE
+   ComputeSurfaceLayout(AddrTileMode tileMode,
+                        uint32_t bpp,
+                        uint32_t pitch,
+                        uint32_t height,
+                        uint32_t numSlices,
+                        uint32_t numSamples,
+                        bool isDepth,
+                        uint32_t tileBase,
+                        uint32_t compBits,
+                        uint32_t pipeSwizzle,
+                        uint32_t bankSwizzle,
+                        R600SurfaceLayout *pLayout) const;
+
+   uint64_t
+   ComputeMacroTileBase(const R600SurfaceLayout *pLayout,
+                        uint32_t x,
+                        uint32_t y,
+                        uint32_t slice,
+                        uint32_t sampleSlice,
+                        uint64_t *pBankPipeBits) const;
+
+   uint64_t
+   ComputeMacroTileBase(const R600SurfaceLayout *pLayout,
+                        uint32_t bankPipe,
+                        uint32_t x,
+                        uint32_t y,
+                        uint32_t slice,
+                        uint32_t sampleSlice,
+                        uint64_t *pBankPipeBits) const;
+
+   uint64_t
+   ComputeLayoutAddrFromCoordMacroTiled(const R600SurfaceLayout *pLayout,
+                                        const uint16_t *pPixelIndex,
+                                        uint32_t bankPipe,
+                                        uint32_t x,
+                                        uint32_t y,
+                                        uint32_t slice,
+                                        uint32_t sample,
+                                        uint32_t *pBitPosition) const;
+
+   void
+   CopySurfaceRectLinear(const R600SurfaceCopy *pCopy,
+                         uint32_t slice,
+                         uint32_t sample,
+                         uint32_t x,
+                         uint32_t y,
+                         uint32_t width,
+                         uint32_t height) const;
+
+   void
+   CopySurfaceRectMicroTiled(const R600SurfaceCopy *pCopy,
+                             uint32_t slice,
+                             uint32_t sample,
+                             uint32_t x,
+                             uint32_t y,
+                             uint32_t width,
+                             uint32_t height) const;
+
+   void
+   CopySurfaceRectMacroTiled(const R600SurfaceCopy *pCopy,
+                             uint32_t slice,
+                             uint32_t sample,
+                             uint32_t x,
+                             uint32_t y,
+                             uint32_t width,
+                             uint32_t height) const;
+
+   void
+   CopySurfaceRect(const R600SurfaceCopy *pCopy,
+                   uint32_t slice,
+                   uint32_t sample,
+                   uint32_t x,
+                   uint32_t y,
+                   uint32_t width,
+                   uint32_t height) const;
+
+   ADDR_E_RETURNCODE
+   SetupSurfaceCopy(const ADDR_COPY_SURFACE_INPUT *pIn,
+                    bool tiledToLinear,
+                    R600SurfaceCopy *pCopy) const;
+
+   void
+   CopySurfaceTask(const R600SurfaceCopyTasks *pTasks,
+                   uint32_t taskIndex) const;
+
+   void
+   RunSurfaceCopy(const R600SurfaceCopy *pCopy,
+                  const ADDR_COPY_SURFACE_INPUT *pIn) const;
+
+   virtual ADDR_E_RETURNCODE
+   HwlCopySurfaceTiledToLinear(const ADDR_COPY_SURFACE_INPUT *pIn) const override;
+
+   virtual ADDR_E_RETURNCODE
+   HwlCopySurfaceLinearToTiled(const ADDR_COPY_SURFACE_INPUT *pIn) const override;
+
+   void
+   CopyDepthPlanesRect(const R600SurfaceCopy *pCopy,
+                       uint32_t slice,
+                       uint32_t firstSample,
+                       uint32_t x,
+                       uint32_t y,
+                       uint32_t width,
+                       uint32_t height) const;
+
+   ADDR_E_RETURNCODE
+   SetupDepthPlanesCopy(const ADDR_COPY_DEPTH_PLANES_INPUT *pIn,
+                        bool tiledToLinear,
+                        ADDR_COPY_SURFACE_INPUT *pSurfaceIn,
+                        R600SurfaceCopy *pCopy) const;
+
+   virtual ADDR_E_RETURNCODE
+   HwlCopyDepthPlanesToLinear(const ADDR_COPY_DEPTH_PLANES_INPUT *pIn) const override;
+
+   virtual ADDR_E_RETURNCODE
+   HwlCopyLinearToDepthPlanes(const ADDR_COPY_DEPTH_PLANES_INPUT *pIn) const override;
+
+   void
+   ComputeSurfaceAddrFromCoordBatchLinear(const ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_INPUT *pIn,
+                                          ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_OUTPUT *pOut) const;
+
+   void
+   ComputeSurfaceAddrFromCoordBatchMicroTiled(const R600SurfaceLayout *pLayout,
+                                              const ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_INPUT *pIn,
+                                              ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_OUTPUT *pOut) const;
+
+   void
+   ComputeSurfaceAddrFromCoordBatchMacroTiled(const R600SurfaceLayout *pLayout,
+                                              const ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_INPUT *pIn,
+                                              ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_OUTPUT *pOut) const;
+
+   virtual ADDR_E_RETURNCODE
+   HwlComputeSurfaceAddrFromCoordBatch(const ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_INPUT *pIn,
+                                       ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_OUTPUT *pOut) const override;
+
+   ADDR_E_RETURNCODE
+   SetupCoordFromAddrLayout(AddrTileMode tileMode,
+                            uint32_t bpp,
+                            uint32_t pitch,
+                            uint32_t height,
+                            uint32_t numSlices,
+                            uint32_t numSamples,
+                            bool isDepth,
+                            uint32_t tileBase,
+                            uint32_t compBits,
+                            uint32_t pipeSwizzle,
+                            uint32_t bankSwizzle,
+                            R600SurfaceLayout *pLayout) const;
+
+   uint64_t
+   ComputeLayoutBytes(const R600SurfaceLayout *pLayout) const;
+
+   bool
+   ComputeLayoutCoordFromAddrLinear(const R600SurfaceLayout *pLayout,
+                                    uint64_t addr,
+                                    uint32_t bitPosition,
+                                    R600ElementCoord *pCoord,
+                                    uint64_t *pElemBytes) const;
+
+   bool
+   ComputeLayoutCoordFromAddrMicroTiled(const R600SurfaceLayout *pLayout,
+                                        const uint16_t *pPixelCoord,
+                                        uint64_t addr,
+                                        uint32_t bitPosition,
+                                        R600ElementCoord *pCoord,
+                                        uint64_t *pElemBytes) const;
+
+   bool
+   FindMacroTileMicroTile(const R600SurfaceLayout *pLayout,
+                          uint64_t macroTileX,
+                          uint64_t macroTileY,
+                          uint32_t slice,
+                          uint32_t sampleSlice,
+                          uint32_t bankPipe,
+                          R600CoordFromAddrCache *pCache,
+                          uint32_t *pMicroTileX,
+                          uint32_t *pMicroTileY) const;
+
+   bool
+   ComputeLayoutCoordFromAddrMacroTiled(const R600SurfaceLayout *pLayout,
+                                        const uint16_t *pPixelCoord,
+                                        uint64_t addr,
+                                        uint32_t bitPosition,
+                                        R600CoordFromAddrCache *pCache,
+                                        R600ElementCoord *pCoord,
+                                        uint64_t *pElemBytes) const;
+
+   bool
+   ComputeLayoutCoordFromAddr(const R600SurfaceLayout *pLayout,
+                              const uint16_t *pPixelCoord,
+                              uint64_t addr,
+                              uint32_t bitPosition,
+                              R600CoordFromAddrCache *pCache,
+                              R600ElementCoord *pCoord,
+                              uint64_t *pElemBytes) const;
+
+   virtual ADDR_E_RETURNCODE
+   HwlComputeSurfaceCoordFromAddr(const ADDR_COMPUTE_SURFACE_COORDFROMADDR_INPUT *pIn,
+                                  ADDR_COMPUTE_SURFACE_COORDFROMADDR_OUTPUT *pOut) const override;
+
+   virtual ADDR_E_RETURNCODE
+   HwlComputeSurfaceCoordFromAddrRange(const ADDR_COMPUTE_SURFACE_COORDFROMADDR_RANGE_INPUT *pIn,
+                                       ADDR_COMPUTE_SURFACE_COORDFROMADDR_RANGE_OUTPUT *pOut) const override;
+
+   void
+   AddDirtyMacroTiles(const R600SurfaceLayout *pLayout,
+                      uint32_t mipLevel,
+                      uint64_t totalBegin,
+                      uint64_t totalEnd,
+                      bool allBankPipes,
+                      uint32_t bankPipe,
+                      R600CoordFromAddrCache *pCache,
+                      R600DirtyRegionList *pList) const;
+
+   void
+   AddDirtyPartialRound(const R600SurfaceLayout *pLayout,
+                        uint32_t mipLevel,
+                        uint64_t first,
+                        uint64_t last,
+                        R600CoordFromAddrCache *pCache,
+                        R600DirtyRegionList *pList) const;
+
+   void
+   ComputeLayoutDirtyRegions(const R600SurfaceLayout *pLayout,
+                             uint32_t mipLevel,
+                             uint64_t begin,
+                             uint64_t end,
+                             R600DirtyRegionList *pList) const;
+
+   virtual ADDR_E_RETURNCODE
+   HwlComputeSurfaceDirtyRegions(const ADDR_COMPUTE_SURFACE_DIRTY_REGIONS_INPUT *pIn,
+                                 ADDR_COMPUTE_SURFACE_DIRTY_REGIONS_OUTPUT *pOut) const override;
+
+   virtual ADDR_E_RETURNCODE
+   HwlCreateSurfacePlan(const ADDR_CREATE_SURFACE_PLAN_INPUT *pIn,
+                        AddrSurfacePlan **ppPlan) const override;
+
+   virtual uint64_t
+   HwlVerifyLookupTables(uint64_t *pNumChecks,
+                         uint32_t *pFirstX,
+                         uint32_t *pFirstY) const override;
+
 private:
+   friend class R600SurfacePlan;
+
    uint32_t mSwapSize;
    uint32_t mSplitSize;
+
+   // Surface plan kernels indexed by tile mode, specialised for the pipes, banks and pipe
+   // interleave of the GPU when R600SelectPlanAddrKernels has them
+   const R600PlanAddrKernel *mPlanAddrKernels;
+
+   // pipe + numPipes * bank before rotation of every micro tile in one period of the pipe
+   // and bank equations, indexed by GetBankPipeTableIndex
+   uint8_t mBankPipeTable[BankPipeTableWidth * BankPipeTableHeight + BankPipeTablePadding];
+   uint32_t mPipeBits;
+
+   uint32_t
+   ComputePipeEquation(uint32_t x, uint32_t y) const;
+
+   uint32_t
+   ComputeBankEquation(uint32_t x, uint32_t y) const;
+
+   void
+   BuildBankPipeTable();
+};
+
+
+/**
+***************************************************************************************************
+* @brief R600 surface plan, computes addresses with the kernel of its tile mode
+***************************************************************************************************
+*/
+class R600SurfacePlan : public AddrSurfacePlan
+{
+public:
+   R600SurfacePlan(const AddrClient *pClient,
+                   const R600AddrLib *pLib,
+                   const R600SurfaceLayout *pLayout,
+                   const uint16_t *pPixelIndex);
+
+   virtual uint64_t
+   ComputeAddrFromCoord(uint32_t x,
+                        uint32_t y,
+                        uint32_t slice,
+                        uint32_t sample,
+                        uint32_t *pBitPosition) const override;
+
+protected:
+   R600SurfacePlanTerms mTerms;
+   R600PlanAddrKernel mKernel;
 };
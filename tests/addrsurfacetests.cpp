@@ -0,0 +1,536 @@
+/*
+ * Copyright  2014 Advanced Micro Devices, Inc.
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sub license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON-INFRINGEMENT. IN NO EVENT SHALL THE COPYRIGHT HOLDERS, AUTHORS
+ * AND/OR ITS SUPPLIERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ */
+
+/**
+***************************************************************************************************
+* @file  addrsurfacetests.cpp
+* @brief Regression tests of the surface layouts, built against the public interface only.
+***************************************************************************************************
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_set>
+#include "addrlib/addrinterface.h"
+
+static const uint32_t TestConfigs[] = { 0x0, 0x4814, 0x44902 };
+static const uint32_t TestBpps[] = { 8, 16, 32, 64, 128 };
+static const uint32_t TestSamples[] = { 1, 2, 4, 8 };
+static const AddrTileMode TestTileModes[] = {
+   ADDR_TM_1D_TILED_THICK,
+   ADDR_TM_2D_TILED_THIN1,
+   ADDR_TM_2D_TILED_THICK,
+   ADDR_TM_2B_TILED_THICK,
+   ADDR_TM_3D_TILED_THICK,
+   ADDR_TM_3B_TILED_THICK,
+};
+
+static uint32_t gNumFailures = 0;
+
+
+/**
+***************************************************************************************************
+*   GetTestSplitBytes
+*
+*   @brief
+*       Returns the sample split size of a GB_ADDR_CONFIG value
+***************************************************************************************************
+*/
+static uint32_t
+GetTestSplitBytes(uint32_t gbAddrConfig)
+{
+   return 1024u << ((gbAddrConfig >> 14) & 0x3);
+}
+
+
+/**
+***************************************************************************************************
+*   IsTestThickMode
+*
+*   @brief
+*       Returns true for the macro tiled modes with 4 slices per micro tile
+***************************************************************************************************
+*/
+static bool
+IsTestThickMode(AddrTileMode tileMode)
+{
+   return tileMode == ADDR_TM_2D_TILED_THICK || tileMode == ADDR_TM_2B_TILED_THICK
+       || tileMode == ADDR_TM_3D_TILED_THICK || tileMode == ADDR_TM_3B_TILED_THICK;
+}
+
+
+/**
+***************************************************************************************************
+*   TestAllocSysMem
+*
+*   @brief
+*       System memory callback of the test library instances
+***************************************************************************************************
+*/
+static void *
+TestAllocSysMem(const ADDR_ALLOCSYSMEM_INPUT *pInput)
+{
+   return malloc(pInput->sizeInBytes);
+}
+
+
+/**
+***************************************************************************************************
+*   TestFreeSysMem
+*
+*   @brief
+*       System memory callback of the test library instances
+***************************************************************************************************
+*/
+static ADDR_E_RETURNCODE
+TestFreeSysMem(const ADDR_FREESYSMEM_INPUT *pInput)
+{
+   free(pInput->pVirtAddr);
+   return ADDR_OK;
+}
+
+
+/**
+***************************************************************************************************
+*   CreateTestLib
+*
+*   @brief
+*       Create a Wii U library instance with the given GB_ADDR_CONFIG value
+*
+*   @return
+*       Handle of the instance, nullptr on failure
+***************************************************************************************************
+*/
+static ADDR_HANDLE
+CreateTestLib(uint32_t gbAddrConfig)
+{
+   ADDR_CREATE_INPUT input;
+   ADDR_CREATE_OUTPUT output;
+   memset(&input, 0, sizeof(input));
+   memset(&output, 0, sizeof(output));
+   input.size = sizeof(input);
+   input.chipEngine = CIASICIDGFXENGINE_R600;
+   input.chipFamily = 0x51;
+   input.chipRevision = 71;
+   input.createFlags.fillSizeFields = 1;
+   input.regValue.gbAddrConfig = gbAddrConfig;
+   input.callbacks.allocSysMem = TestAllocSysMem;
+   input.callbacks.freeSysMem = TestFreeSysMem;
+   output.size = sizeof(output);
+
+   if (AddrCreate(&input, &output) != ADDR_OK) {
+      return nullptr;
+   }
+
+   return output.hLib;
+}
+
+
+/**
+***************************************************************************************************
+*   ReportFailure
+*
+*   @brief
+*       Print a failed check of the given surface
+***************************************************************************************************
+*/
+static void
+ReportFailure(const char *pTest,
+              uint32_t gbAddrConfig,
+              AddrTileMode tileMode,
+              uint32_t bpp,
+              uint32_t numSamples,
+              const char *pReason)
+{
+   printf("FAIL %s: config 0x%x tile mode %u bpp %u samples %u: %s\n",
+          pTest, gbAddrConfig, static_cast<uint32_t>(tileMode), bpp, numSamples, pReason);
+   ++gNumFailures;
+}
+
+
+/**
+***************************************************************************************************
+*   TestUniqueAddresses
+*
+*   @brief
+*       Check every element of a surface picked by AddrComputeSurfaceInfo gets its own address
+*       inside the surface. The samples of a 1D tiled surface share the same memory, and so do
+*       the sample slices of a thick micro tile split by sample, so only sample 0 is checked
+*       there. A thick sample larger than the split size has no layout and must be rejected.
+***************************************************************************************************
+*/
+static void
+TestUniqueAddresses(ADDR_HANDLE hLib,
+                    uint32_t gbAddrConfig,
+                    AddrTileMode tileMode,
+                    uint32_t bpp,
+                    uint32_t numSamples)
+{
+   ADDR_COMPUTE_SURFACE_INFO_INPUT infoIn;
+   ADDR_COMPUTE_SURFACE_INFO_OUTPUT infoOut;
+   memset(&infoIn, 0, sizeof(infoIn));
+   memset(&infoOut, 0, sizeof(infoOut));
+   infoIn.size = sizeof(infoIn);
+   infoIn.tileMode = tileMode;
+   infoIn.bpp = bpp;
+   infoIn.width = 64;
+   infoIn.height = 64;
+   infoIn.numSlices = 8;
+   infoIn.numSamples = numSamples;
+   infoIn.tileIndex = -1;
+   infoIn.flags.inputBaseMap = 1;
+   infoIn.flags.volume = 1;
+   infoOut.size = sizeof(infoOut);
+
+   if (AddrComputeSurfaceInfo(hLib, &infoIn, &infoOut) != ADDR_OK) {
+      ReportFailure("unique addresses", gbAddrConfig, tileMode, bpp, numSamples, "surface info failed");
+      return;
+   }
+
+   auto numCheckedSamples = numSamples;
+   auto splitBytes = GetTestSplitBytes(gbAddrConfig);
+   auto isThickSplit = numSamples > 1 && IsTestThickMode(infoOut.tileMode) && 32 * bpp * numSamples > splitBytes;
+   auto isSampleTooLarge = isThickSplit && 32 * bpp > splitBytes;
+
+   if (infoOut.tileMode == ADDR_TM_1D_TILED_THIN1 || infoOut.tileMode == ADDR_TM_1D_TILED_THICK || isThickSplit) {
+      numCheckedSamples = 1;
+   }
+
+   std::unordered_set<uint64_t> addresses;
+   ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_INPUT addrIn;
+   ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_OUTPUT addrOut;
+   memset(&addrIn, 0, sizeof(addrIn));
+   memset(&addrOut, 0, sizeof(addrOut));
+   addrIn.size = sizeof(addrIn);
+   addrIn.bpp = bpp;
+   addrIn.pitch = infoOut.pitch;
+   addrIn.height = infoOut.height;
+   addrIn.numSlices = infoOut.depth;
+   addrIn.numSamples = numSamples;
+   addrIn.tileMode = infoOut.tileMode;
+   addrIn.tileIndex = -1;
+   addrOut.size = sizeof(addrOut);
+
+   for (uint32_t slice = 0; slice < infoOut.depth; ++slice) {
+      for (uint32_t sample = 0; sample < numCheckedSamples; ++sample) {
+         for (uint32_t y = 0; y < infoOut.height; ++y) {
+            for (uint32_t x = 0; x < infoOut.pitch; ++x) {
+               addrIn.x = x;
+               addrIn.y = y;
+               addrIn.slice = slice;
+               addrIn.sample = sample;
+
+               auto returnCode = AddrComputeSurfaceAddrFromCoord(hLib, &addrIn, &addrOut);
+
+               if (isSampleTooLarge) {
+                  if (returnCode != ADDR_NOTSUPPORTED) {
+                     ReportFailure("unique addresses", gbAddrConfig, infoOut.tileMode, bpp, numSamples,
+                                   "sample larger than the split size not rejected");
+                  }
+
+                  return;
+               }
+
+               if (returnCode != ADDR_OK) {
+                  ReportFailure("unique addresses", gbAddrConfig, infoOut.tileMode, bpp, numSamples,
+                                "address from coord failed");
+                  return;
+               }
+
+               if (addrOut.addr + bpp / 8 > infoOut.surfSize) {
+                  ReportFailure("unique addresses", gbAddrConfig, infoOut.tileMode, bpp, numSamples,
+                                "address outside of the surface");
+                  return;
+               }
+
+               if (!addresses.insert(addrOut.addr).second) {
+                  ReportFailure("unique addresses", gbAddrConfig, infoOut.tileMode, bpp, numSamples,
+                                "duplicate address");
+                  return;
+               }
+            }
+         }
+      }
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   TestSampleLargerThanSplit
+*
+*   @brief
+*       Check a thick macro tiled surface whose samples are each larger than the split size is
+*       rejected by the address, copy and plan entry points, no sample fits in a sample slice
+***************************************************************************************************
+*/
+static void
+TestSampleLargerThanSplit(ADDR_HANDLE hLib,
+                          uint32_t gbAddrConfig)
+{
+   ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_INPUT addrIn;
+   ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_OUTPUT addrOut;
+   memset(&addrIn, 0, sizeof(addrIn));
+   memset(&addrOut, 0, sizeof(addrOut));
+   addrIn.size = sizeof(addrIn);
+   addrIn.bpp = 128;
+   addrIn.pitch = 256;
+   addrIn.height = 256;
+   addrIn.numSlices = 8;
+   addrIn.numSamples = 8;
+   addrIn.tileMode = ADDR_TM_2D_TILED_THICK;
+   addrIn.tileIndex = -1;
+   addrOut.size = sizeof(addrOut);
+
+   if (AddrComputeSurfaceAddrFromCoord(hLib, &addrIn, &addrOut) != ADDR_NOTSUPPORTED) {
+      ReportFailure("sample larger than split", gbAddrConfig, addrIn.tileMode, addrIn.bpp, addrIn.numSamples,
+                    "address from coord did not return ADDR_NOTSUPPORTED");
+   }
+
+   uint8_t tiled[16] = { };
+   uint8_t linear[16] = { };
+   ADDR_COPY_SURFACE_INPUT copyIn;
+   memset(&copyIn, 0, sizeof(copyIn));
+   copyIn.size = sizeof(copyIn);
+   copyIn.bpp = addrIn.bpp;
+   copyIn.pitch = addrIn.pitch;
+   copyIn.height = addrIn.height;
+   copyIn.numSlices = addrIn.numSlices;
+   copyIn.numSamples = addrIn.numSamples;
+   copyIn.tileMode = addrIn.tileMode;
+   copyIn.tileIndex = -1;
+   copyIn.pTiled = tiled;
+   copyIn.pLinear = linear;
+
+   if (AddrCopySurfaceTiledToLinear(hLib, &copyIn) != ADDR_NOTSUPPORTED) {
+      ReportFailure("sample larger than split", gbAddrConfig, addrIn.tileMode, addrIn.bpp, addrIn.numSamples,
+                    "copy did not return ADDR_NOTSUPPORTED");
+   }
+
+   ADDR_CREATE_SURFACE_PLAN_INPUT planIn;
+   ADDR_CREATE_SURFACE_PLAN_OUTPUT planOut;
+   memset(&planIn, 0, sizeof(planIn));
+   memset(&planOut, 0, sizeof(planOut));
+   planIn.size = sizeof(planIn);
+   planIn.bpp = addrIn.bpp;
+   planIn.pitch = addrIn.pitch;
+   planIn.height = addrIn.height;
+   planIn.numSlices = addrIn.numSlices;
+   planIn.numSamples = addrIn.numSamples;
+   planIn.tileMode = addrIn.tileMode;
+   planIn.tileIndex = -1;
+   planOut.size = sizeof(planOut);
+
+   if (AddrCreateSurfacePlan(hLib, &planIn, &planOut) != ADDR_NOTSUPPORTED) {
+      ReportFailure("sample larger than split", gbAddrConfig, addrIn.tileMode, addrIn.bpp, addrIn.numSamples,
+                    "plan did not return ADDR_NOTSUPPORTED");
+      AddrDestroySurfacePlan(hLib, planOut.hPlan);
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   TestThickSampleSplit
+*
+*   @brief
+*       Check the copy and plan entry points agree with AddrComputeSurfaceAddrFromCoord on a
+*       thick macro tiled surface whose micro tiles are split by sample. A multisampled 1D
+*       thick surface is the one picking such a layout.
+***************************************************************************************************
+*/
+static void
+TestThickSampleSplit(ADDR_HANDLE hLib,
+                     uint32_t gbAddrConfig)
+{
+   const uint32_t bpp = 32;
+   const uint32_t numSamples = 4;
+   const uint32_t elemBytes = bpp / 8;
+
+   ADDR_COMPUTE_SURFACE_INFO_INPUT infoIn;
+   ADDR_COMPUTE_SURFACE_INFO_OUTPUT infoOut;
+   memset(&infoIn, 0, sizeof(infoIn));
+   memset(&infoOut, 0, sizeof(infoOut));
+   infoIn.size = sizeof(infoIn);
+   infoIn.tileMode = ADDR_TM_1D_TILED_THICK;
+   infoIn.bpp = bpp;
+   infoIn.numSamples = numSamples;
+   infoIn.width = 64;
+   infoIn.height = 64;
+   infoIn.numSlices = 8;
+   infoIn.tileIndex = -1;
+   infoOut.size = sizeof(infoOut);
+
+   if (AddrComputeSurfaceInfo(hLib, &infoIn, &infoOut) != ADDR_OK) {
+      ReportFailure("thick sample split", gbAddrConfig, infoIn.tileMode, bpp, numSamples,
+                    "surface info failed");
+      return;
+   }
+
+   if (infoOut.tileMode != ADDR_TM_2D_TILED_THICK) {
+      ReportFailure("thick sample split", gbAddrConfig, infoIn.tileMode, bpp, numSamples,
+                    "surface info did not pick 2D thick");
+      return;
+   }
+
+   auto linearPitch = infoOut.pitch * elemBytes;
+   auto linearSliceSize = static_cast<uint64_t>(linearPitch) * infoOut.height;
+   auto linearBytes = linearSliceSize * infoOut.depth * numSamples;
+   auto pTiled = static_cast<uint8_t *>(malloc(static_cast<size_t>(infoOut.surfSize)));
+   auto pLinear = static_cast<uint8_t *>(malloc(static_cast<size_t>(linearBytes)));
+
+   if (!pTiled || !pLinear) {
+      free(pTiled);
+      free(pLinear);
+      ReportFailure("thick sample split", gbAddrConfig, infoOut.tileMode, bpp, numSamples,
+                    "out of memory");
+      return;
+   }
+
+   for (auto i = 0ull; i < infoOut.surfSize; ++i) {
+      pTiled[i] = static_cast<uint8_t>(i * 7 + (i >> 8));
+   }
+
+   memset(pLinear, 0, static_cast<size_t>(linearBytes));
+
+   ADDR_COPY_SURFACE_INPUT copyIn;
+   memset(&copyIn, 0, sizeof(copyIn));
+   copyIn.size = sizeof(copyIn);
+   copyIn.bpp = bpp;
+   copyIn.pitch = infoOut.pitch;
+   copyIn.height = infoOut.height;
+   copyIn.numSlices = infoOut.depth;
+   copyIn.numSamples = numSamples;
+   copyIn.tileMode = infoOut.tileMode;
+   copyIn.tileIndex = -1;
+   copyIn.pTiled = pTiled;
+   copyIn.pLinear = pLinear;
+
+   ADDR_CREATE_SURFACE_PLAN_INPUT planIn;
+   ADDR_CREATE_SURFACE_PLAN_OUTPUT planOut;
+   memset(&planIn, 0, sizeof(planIn));
+   memset(&planOut, 0, sizeof(planOut));
+   planIn.size = sizeof(planIn);
+   planIn.bpp = bpp;
+   planIn.pitch = infoOut.pitch;
+   planIn.height = infoOut.height;
+   planIn.numSlices = infoOut.depth;
+   planIn.numSamples = numSamples;
+   planIn.tileMode = infoOut.tileMode;
+   planIn.tileIndex = -1;
+   planOut.size = sizeof(planOut);
+
+   if (AddrCopySurfaceTiledToLinear(hLib, &copyIn) != ADDR_OK) {
+      ReportFailure("thick sample split", gbAddrConfig, infoOut.tileMode, bpp, numSamples,
+                    "copy failed");
+   } else if (AddrCreateSurfacePlan(hLib, &planIn, &planOut) != ADDR_OK) {
+      ReportFailure("thick sample split", gbAddrConfig, infoOut.tileMode, bpp, numSamples,
+                    "plan failed");
+   } else {
+      ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_INPUT addrIn;
+      ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_OUTPUT addrOut;
+      memset(&addrIn, 0, sizeof(addrIn));
+      memset(&addrOut, 0, sizeof(addrOut));
+      addrIn.size = sizeof(addrIn);
+      addrIn.bpp = bpp;
+      addrIn.pitch = infoOut.pitch;
+      addrIn.height = infoOut.height;
+      addrIn.numSlices = infoOut.depth;
+      addrIn.numSamples = numSamples;
+      addrIn.tileMode = infoOut.tileMode;
+      addrIn.tileIndex = -1;
+      addrOut.size = sizeof(addrOut);
+
+      auto mismatch = static_cast<const char *>(nullptr);
+
+      for (auto sample = 0u; sample < numSamples && !mismatch; ++sample) {
+         for (auto slice = 0u; slice < infoOut.depth && !mismatch; ++slice) {
+            for (auto y = 0u; y < infoOut.height && !mismatch; ++y) {
+               for (auto x = 0u; x < infoOut.pitch && !mismatch; ++x) {
+                  uint32_t bitPosition = 0;
+                  addrIn.x = x;
+                  addrIn.y = y;
+                  addrIn.slice = slice;
+                  addrIn.sample = sample;
+
+                  if (AddrComputeSurfaceAddrFromCoord(hLib, &addrIn, &addrOut) != ADDR_OK) {
+                     mismatch = "address from coord failed";
+                  } else if (AddrPlanAddrFromCoord(planOut.hPlan, x, y, slice, sample, &bitPosition) != addrOut.addr) {
+                     mismatch = "plan address differs from address from coord";
+                  } else if (memcmp(pLinear + (slice + sample * infoOut.depth) * linearSliceSize + y * linearPitch + x * elemBytes,
+                                    pTiled + addrOut.addr, elemBytes) != 0) {
+                     mismatch = "copied element differs from address from coord";
+                  }
+               }
+            }
+         }
+      }
+
+      if (mismatch) {
+         ReportFailure("thick sample split", gbAddrConfig, infoOut.tileMode, bpp, numSamples, mismatch);
+      }
+
+      AddrDestroySurfacePlan(hLib, planOut.hPlan);
+   }
+
+   free(pTiled);
+   free(pLinear);
+}
+
+
+int
+main()
+{
+   for (auto gbAddrConfig : TestConfigs) {
+      auto hLib = CreateTestLib(gbAddrConfig);
+
+      if (!hLib) {
+         printf("FAIL: could not create a library instance for config 0x%x\n", gbAddrConfig);
+         return EXIT_FAILURE;
+      }
+
+      for (auto tileMode : TestTileModes) {
+         for (auto bpp : TestBpps) {
+            for (auto numSamples : TestSamples) {
+               TestUniqueAddresses(hLib, gbAddrConfig, tileMode, bpp, numSamples);
+            }
+         }
+      }
+
+      TestSampleLargerThanSplit(hLib, gbAddrConfig);
+      TestThickSampleSplit(hLib, gbAddrConfig);
+      AddrDestroy(hLib);
+   }
+
+   if (gNumFailures) {
+      printf("%u checks failed\n", gNumFailures);
+      return EXIT_FAILURE;
+   }
+
+   printf("all checks passed\n");
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,214 @@
+/*
+ * Copyright  2014 Advanced Micro Devices, Inc.
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sub license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON-INFRINGEMENT. IN NO EVENT SHALL THE COPYRIGHT HOLDERS, AUTHORS
+ * AND/OR ITS SUPPLIERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ */
+
+/**
+***************************************************************************************************
+* @file  addrverifytests.cpp
+* @brief Compares the fast address paths against the per element reference at every kernel tier.
+***************************************************************************************************
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include "addrtools.h"
+
+// Wii U configuration followed by ones with other pipe, bank, row and split settings
+static const uint32_t VerifyConfigs[] = { 0x44902, 0x0, 0x4814, 0x8D14, 0xDF56 };
+static const uint32_t VerifyNumSurfaces = 16;
+static const uint32_t VerifySeed = 1;
+static const uint32_t VerifyMaxMismatches = 16;
+
+static const char *const VerifyPathNames[ADDR_VERIFY_PATH_COUNT] = {
+   "lookup tables",
+   "surface plan",
+   "batch address from coord",
+   "copy tiled to linear",
+   "copy linear to tiled",
+};
+
+
+/**
+***************************************************************************************************
+* @brief Kernel tier forced through the create flags, a tier the CPU lacks runs the best one
+*        it has
+***************************************************************************************************
+*/
+struct VerifyTier
+{
+   const char *pName;
+   bool noSse2;
+   bool noAvx2;
+   bool noAvx512;
+};
+
+static const VerifyTier VerifyTiers[] = {
+   { "scalar", true, true, true },
+   { "SSE2", false, true, true },
+   { "AVX2", false, false, true },
+   { "AVX-512", false, false, false },
+};
+
+
+/**
+***************************************************************************************************
+*   VerifyAllocSysMem
+*
+*   @brief
+*       System memory callback of the verified library instances
+***************************************************************************************************
+*/
+static void *
+VerifyAllocSysMem(const ADDR_ALLOCSYSMEM_INPUT *pInput)
+{
+   return malloc(pInput->sizeInBytes);
+}
+
+
+/**
+***************************************************************************************************
+*   VerifyFreeSysMem
+*
+*   @brief
+*       System memory callback of the verified library instances
+***************************************************************************************************
+*/
+static ADDR_E_RETURNCODE
+VerifyFreeSysMem(const ADDR_FREESYSMEM_INPUT *pInput)
+{
+   free(pInput->pVirtAddr);
+   return ADDR_OK;
+}
+
+
+/**
+***************************************************************************************************
+*   VerifyTierPaths
+*
+*   @brief
+*       Run AddrVerifyAddressPaths with the kernels of one tier and print every stored mismatch
+*
+*   @return
+*       true if every path matched the reference
+***************************************************************************************************
+*/
+static bool
+VerifyTierPaths(const VerifyTier *pTier,
+                bool allConfigs,
+                uint32_t numSurfaces)
+{
+   ADDR_CREATE_INPUT createIn;
+   memset(&createIn, 0, sizeof(createIn));
+   createIn.size = sizeof(createIn);
+   createIn.chipEngine = CIASICIDGFXENGINE_R600;
+   createIn.chipFamily = 0x51;
+   createIn.chipRevision = 71;
+   createIn.createFlags.fillSizeFields = 1;
+   createIn.createFlags.noSse2 = pTier->noSse2;
+   createIn.createFlags.noAvx2 = pTier->noAvx2;
+   createIn.createFlags.noAvx512 = pTier->noAvx512;
+   createIn.callbacks.allocSysMem = VerifyAllocSysMem;
+   createIn.callbacks.freeSysMem = VerifyFreeSysMem;
+
+   ADDR_ADDRESS_MISMATCH mismatches[VerifyMaxMismatches];
+   ADDR_VERIFY_ADDRESS_PATHS_INPUT input;
+   ADDR_VERIFY_ADDRESS_PATHS_OUTPUT output;
+   memset(&input, 0, sizeof(input));
+   memset(&output, 0, sizeof(output));
+   input.size = sizeof(input);
+   input.pCreateIn = &createIn;
+   input.numConfigs = allConfigs ? 0 : sizeof(VerifyConfigs) / sizeof(VerifyConfigs[0]);
+   input.pGbAddrConfigs = allConfigs ? nullptr : VerifyConfigs;
+   input.numSurfaces = numSurfaces;
+   input.seed = VerifySeed;
+   input.numThreads = std::thread::hardware_concurrency();
+   output.size = sizeof(output);
+   output.maxMismatches = VerifyMaxMismatches;
+   output.pMismatches = mismatches;
+
+   auto returnCode = AddrVerifyAddressPaths(&input, &output);
+
+   if (returnCode != ADDR_OK) {
+      printf("FAIL %s: verification returned %d\n", pTier->pName, returnCode);
+      return false;
+   }
+
+   printf("%s: %u configs, %llu surfaces, %llu checks, %llu mismatches\n", pTier->pName, output.numConfigs,
+          static_cast<unsigned long long>(output.numSurfaces), static_cast<unsigned long long>(output.numChecks),
+          static_cast<unsigned long long>(output.numMismatches));
+
+   for (auto i = 0u; i < output.numStoredMismatches; ++i) {
+      const auto &mismatch = mismatches[i];
+      printf("FAIL %s: config 0x%x %s tile mode %u bpp %u %ux%ux%u samples %u at (%u, %u, %u, %u): "
+             "reference 0x%llx.%u fast 0x%llx.%u\n",
+             pTier->pName, mismatch.gbAddrConfig, VerifyPathNames[mismatch.path],
+             static_cast<uint32_t>(mismatch.tileMode), mismatch.bpp, mismatch.pitch, mismatch.height,
+             mismatch.numSlices, mismatch.numSamples, mismatch.x, mismatch.y, mismatch.slice, mismatch.sample,
+             static_cast<unsigned long long>(mismatch.refAddr), mismatch.refBitPosition,
+             static_cast<unsigned long long>(mismatch.fastAddr), mismatch.fastBitPosition);
+   }
+
+   return output.numMismatches == 0;
+}
+
+
+/**
+***************************************************************************************************
+*   main
+*
+*   @brief
+*       addrverifytests [--all [numSurfaces]]
+*
+*       Checks a few tiling configurations at every kernel tier, --all sweeps every valid
+*       tiling configuration instead.
+***************************************************************************************************
+*/
+int
+main(int argc, char **argv)
+{
+   auto allConfigs = argc > 1 && strcmp(argv[1], "--all") == 0;
+   auto numSurfaces = argc > 2 ? static_cast<uint32_t>(strtoul(argv[2], nullptr, 0)) : VerifyNumSurfaces;
+
+   if (argc > 3 || (argc > 1 && !allConfigs)) {
+      fprintf(stderr, "usage: %s [--all [numSurfaces]]\n", argv[0]);
+      return EXIT_FAILURE;
+   }
+
+   auto passed = true;
+
+   for (const auto &tier : VerifyTiers) {
+      passed = VerifyTierPaths(&tier, allConfigs, numSurfaces) && passed;
+   }
+
+   if (!passed) {
+      printf("address paths differ from the reference\n");
+      return EXIT_FAILURE;
+   }
+
+   printf("all address paths match the reference\n");
+   return EXIT_SUCCESS;
+}
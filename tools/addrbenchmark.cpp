@@ -0,0 +1,519 @@
+/*
+ * Copyright  2014 Advanced Micro Devices, Inc.
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sub license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON-INFRINGEMENT. IN NO EVENT SHALL THE COPYRIGHT HOLDERS, AUTHORS
+ * AND/OR ITS SUPPLIERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ */
+
+/**
+***************************************************************************************************
+* @file  addrbenchmark.cpp
+* @brief Contains the AddrRunBenchmark sweep of the public entry points.
+***************************************************************************************************
+*/
+
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <new>
+#include "addrtools.h"
+
+static const uint32_t BenchmarkDefaultIterations = 1000;
+static const uint32_t BenchmarkDefaultCopyIterations = 4;
+static const uint32_t BenchmarkDefaultMaxSize = 1024;
+static const uint32_t BenchmarkMinSize = 64;
+
+static const uint32_t BenchmarkBpps[] = { 8, 16, 32, 64, 128 };
+static const uint32_t BenchmarkSamples[] = { 1, 2, 4, 8 };
+
+// Sum of every result returned by the timed calls, keeps them from being optimised out
+static volatile uint64_t BenchmarkChecksum;
+
+
+/**
+***************************************************************************************************
+* @brief State shared by the entry points of one AddrRunBenchmark sweep
+***************************************************************************************************
+*/
+struct AddrBenchmarkSweep
+{
+   ADDR_HANDLE hLib;
+   ADDR_RUN_BENCHMARK_OUTPUT *pOut;
+   uint32_t iterations;
+   uint32_t copyIterations;
+   uint32_t maxSize;
+   uint64_t checksum;
+};
+
+
+/**
+***************************************************************************************************
+*   GetBenchmarkTime
+*
+*   @brief
+*       Returns a monotonic time stamp in nanoseconds
+*
+*   @return
+*       Time stamp
+***************************************************************************************************
+*/
+static uint64_t
+GetBenchmarkTime()
+{
+   auto now = std::chrono::steady_clock::now().time_since_epoch();
+   return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+}
+
+
+/**
+***************************************************************************************************
+*   AddBenchmarkResult
+*
+*   @brief
+*       Appends a result to the client array if it has room left and counts it either way
+*
+*   @return
+*       N/A
+***************************************************************************************************
+*/
+static void
+AddBenchmarkResult(AddrBenchmarkSweep *pSweep,
+                   AddrBenchmarkEntry entry,
+                   AddrTileMode tileMode,
+                   uint32_t bpp,
+                   uint32_t numSamples,
+                   uint32_t width,
+                   uint32_t height,
+                   uint64_t calls,
+                   uint64_t elapsed,
+                   uint64_t bytesPerCall)
+{
+   auto pOut = pSweep->pOut;
+
+   if (pOut->numResults < pOut->maxResults) {
+      auto pResult = &pOut->pResults[pOut->numResults];
+
+      pResult->entry = entry;
+      pResult->tileMode = tileMode;
+      pResult->bpp = bpp;
+      pResult->numSamples = numSamples;
+      pResult->width = width;
+      pResult->height = height;
+      pResult->calls = calls;
+      pResult->nsPerCall = calls ? static_cast<double>(elapsed) / calls : 0.0;
+      pResult->gbPerSecond = elapsed ? static_cast<double>(bytesPerCall) * calls / elapsed : 0.0;
+   }
+
+   pOut->numResults++;
+}
+
+
+/**
+***************************************************************************************************
+*   ComputeBenchmarkSurface
+*
+*   @brief
+*       Computes the padded surface of a point of the sweep
+*
+*   @return
+*       ADDR_E_RETURNCODE of AddrComputeSurfaceInfo
+***************************************************************************************************
+*/
+static ADDR_E_RETURNCODE
+ComputeBenchmarkSurface(ADDR_HANDLE hLib,
+                        AddrTileMode tileMode,
+                        uint32_t bpp,
+                        uint32_t numSamples,
+                        uint32_t size,
+                        ADDR_COMPUTE_SURFACE_INFO_INPUT *pIn,
+                        ADDR_COMPUTE_SURFACE_INFO_OUTPUT *pOut)
+{
+   std::memset(pIn, 0, sizeof(ADDR_COMPUTE_SURFACE_INFO_INPUT));
+   std::memset(pOut, 0, sizeof(ADDR_COMPUTE_SURFACE_INFO_OUTPUT));
+   pIn->size = sizeof(ADDR_COMPUTE_SURFACE_INFO_INPUT);
+   pIn->tileMode = tileMode;
+   pIn->bpp = bpp;
+   pIn->numSamples = numSamples;
+   pIn->width = size;
+   pIn->height = size;
+   pIn->numSlices = 1;
+   pIn->flags.inputBaseMap = 1;
+   pIn->tileIndex = -1;
+   pOut->size = sizeof(ADDR_COMPUTE_SURFACE_INFO_OUTPUT);
+
+   return AddrComputeSurfaceInfo(hLib, pIn, pOut);
+}
+
+
+/**
+***************************************************************************************************
+*   BenchmarkSurfaceInfo
+*
+*   @brief
+*       Times AddrComputeSurfaceInfo on one surface of the sweep
+*
+*   @return
+*       N/A
+***************************************************************************************************
+*/
+static void
+BenchmarkSurfaceInfo(AddrBenchmarkSweep *pSweep,
+                     const ADDR_COMPUTE_SURFACE_INFO_INPUT *pSurfIn)
+{
+   ADDR_COMPUTE_SURFACE_INFO_OUTPUT output;
+   auto start = GetBenchmarkTime();
+
+   for (auto i = 0u; i < pSweep->iterations; ++i) {
+      ADDR_COMPUTE_SURFACE_INFO_INPUT input = *pSurfIn;
+
+      std::memset(&output, 0, sizeof(ADDR_COMPUTE_SURFACE_INFO_OUTPUT));
+      output.size = sizeof(ADDR_COMPUTE_SURFACE_INFO_OUTPUT);
+      AddrComputeSurfaceInfo(pSweep->hLib, &input, &output);
+      pSweep->checksum += output.surfSize;
+   }
+
+   AddBenchmarkResult(pSweep, ADDR_BENCHMARK_SURFACE_INFO, pSurfIn->tileMode, pSurfIn->bpp, pSurfIn->numSamples,
+                      pSurfIn->width, pSurfIn->height, pSweep->iterations, GetBenchmarkTime() - start, 0);
+}
+
+
+/**
+***************************************************************************************************
+*   BenchmarkSurfaceAddrFromCoord
+*
+*   @brief
+*       Times AddrComputeSurfaceAddrFromCoord over the coordinates of one surface of the sweep
+*
+*   @return
+*       N/A
+***************************************************************************************************
+*/
+static void
+BenchmarkSurfaceAddrFromCoord(AddrBenchmarkSweep *pSweep,
+                              const ADDR_COMPUTE_SURFACE_INFO_INPUT *pSurfIn,
+                              const ADDR_COMPUTE_SURFACE_INFO_OUTPUT *pSurfOut)
+{
+   ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_INPUT input;
+   ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_OUTPUT output;
+
+   std::memset(&input, 0, sizeof(ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_INPUT));
+   std::memset(&output, 0, sizeof(ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_OUTPUT));
+   input.size = sizeof(ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_INPUT);
+   input.bpp = pSurfOut->bpp;
+   input.pitch = pSurfOut->pitch;
+   input.height = pSurfOut->height;
+   input.numSlices = pSurfOut->depth;
+   input.numSamples = pSurfIn->numSamples;
+   input.tileMode = pSurfOut->tileMode;
+   input.tileIndex = -1;
+   output.size = sizeof(ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_OUTPUT);
+
+   auto start = GetBenchmarkTime();
+
+   // Strides coprime with the power of two surface sizes visit scattered micro tiles
+   for (auto i = 0u; i < pSweep->iterations; ++i) {
+      input.x = (i * 61) % pSurfIn->width;
+      input.y = (i * 97) % pSurfIn->height;
+      input.sample = i % pSurfIn->numSamples;
+      AddrComputeSurfaceAddrFromCoord(pSweep->hLib, &input, &output);
+      pSweep->checksum += output.addr;
+   }
+
+   AddBenchmarkResult(pSweep, ADDR_BENCHMARK_SURFACE_ADDRFROMCOORD, pSurfIn->tileMode, pSurfIn->bpp, pSurfIn->numSamples,
+                      pSurfIn->width, pSurfIn->height, pSweep->iterations, GetBenchmarkTime() - start, 0);
+}
+
+
+/**
+***************************************************************************************************
+*   BenchmarkCopySurface
+*
+*   @brief
+*       Times AddrCopySurfaceTiledToLinear or AddrCopySurfaceLinearToTiled on one surface of
+*       the sweep
+*
+*   @return
+*       N/A
+***************************************************************************************************
+*/
+static void
+BenchmarkCopySurface(AddrBenchmarkSweep *pSweep,
+                     bool tiledToLinear,
+                     const ADDR_COMPUTE_SURFACE_INFO_INPUT *pSurfIn,
+                     const ADDR_COMPUTE_SURFACE_INFO_OUTPUT *pSurfOut)
+{
+   uint64_t linearBytes = (static_cast<uint64_t>(pSurfOut->pitch) * pSurfOut->height * pSurfOut->depth
+                           * pSurfIn->numSamples * pSurfOut->bpp + 7) / 8;
+   auto entry = tiledToLinear ? ADDR_BENCHMARK_COPY_TILED_TO_LINEAR : ADDR_BENCHMARK_COPY_LINEAR_TO_TILED;
+   std::unique_ptr<uint8_t[]> pTiled { new (std::nothrow) uint8_t[pSurfOut->surfSize] };
+   std::unique_ptr<uint8_t[]> pLinear { new (std::nothrow) uint8_t[linearBytes] };
+
+   if (pTiled && pLinear) {
+      ADDR_COPY_SURFACE_INPUT input;
+
+      std::memset(pTiled.get(), 0, static_cast<size_t>(pSurfOut->surfSize));
+      std::memset(pLinear.get(), 0, static_cast<size_t>(linearBytes));
+      std::memset(&input, 0, sizeof(ADDR_COPY_SURFACE_INPUT));
+      input.size = sizeof(ADDR_COPY_SURFACE_INPUT);
+      input.bpp = pSurfOut->bpp;
+      input.pitch = pSurfOut->pitch;
+      input.height = pSurfOut->height;
+      input.numSlices = pSurfOut->depth;
+      input.numSamples = pSurfIn->numSamples;
+      input.tileMode = pSurfOut->tileMode;
+      input.tileIndex = -1;
+      input.pTiled = pTiled.get();
+      input.pLinear = pLinear.get();
+
+      auto start = GetBenchmarkTime();
+
+      for (auto i = 0u; i < pSweep->copyIterations; ++i) {
+         if (tiledToLinear) {
+            AddrCopySurfaceTiledToLinear(pSweep->hLib, &input);
+         } else {
+            AddrCopySurfaceLinearToTiled(pSweep->hLib, &input);
+         }
+      }
+
+      AddBenchmarkResult(pSweep, entry, pSurfIn->tileMode, pSurfIn->bpp, pSurfIn->numSamples, pSurfIn->width,
+                         pSurfIn->height, pSweep->copyIterations, GetBenchmarkTime() - start, linearBytes);
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   BenchmarkHtileInfo
+*
+*   @brief
+*       Times AddrComputeHtileInfo for one depth surface size of the sweep
+*
+*   @return
+*       N/A
+***************************************************************************************************
+*/
+static void
+BenchmarkHtileInfo(AddrBenchmarkSweep *pSweep,
+                   bool isLinear,
+                   uint32_t size)
+{
+   ADDR_COMPUTE_HTILE_INFO_INPUT input;
+   ADDR_COMPUTE_HTILE_INFO_OUTPUT output;
+
+   std::memset(&input, 0, sizeof(ADDR_COMPUTE_HTILE_INFO_INPUT));
+   std::memset(&output, 0, sizeof(ADDR_COMPUTE_HTILE_INFO_OUTPUT));
+   input.size = sizeof(ADDR_COMPUTE_HTILE_INFO_INPUT);
+   input.pitch = size;
+   input.height = size;
+   input.numSlices = 1;
+   input.isLinear = isLinear;
+   input.blockWidth = ADDR_HTILE_BLOCKSIZE_8;
+   input.blockHeight = ADDR_HTILE_BLOCKSIZE_8;
+   input.tileIndex = -1;
+   output.size = sizeof(ADDR_COMPUTE_HTILE_INFO_OUTPUT);
+
+   auto start = GetBenchmarkTime();
+
+   for (auto i = 0u; i < pSweep->iterations; ++i) {
+      AddrComputeHtileInfo(pSweep->hLib, &input, &output);
+      pSweep->checksum += output.htileBytes;
+   }
+
+   AddBenchmarkResult(pSweep, ADDR_BENCHMARK_HTILE_INFO, isLinear ? ADDR_TM_LINEAR_GENERAL : ADDR_TM_2D_TILED_THIN1, 0, 1,
+                      size, size, pSweep->iterations, GetBenchmarkTime() - start, 0);
+}
+
+
+/**
+***************************************************************************************************
+*   BenchmarkExtractBankPipeSwizzle
+*
+*   @brief
+*       Times AddrExtractBankPipeSwizzle over a range of base addresses
+*
+*   @return
+*       N/A
+***************************************************************************************************
+*/
+static void
+BenchmarkExtractBankPipeSwizzle(AddrBenchmarkSweep *pSweep)
+{
+   ADDR_EXTRACT_BANKPIPE_SWIZZLE_INPUT input;
+   ADDR_EXTRACT_BANKPIPE_SWIZZLE_OUTPUT output;
+
+   std::memset(&input, 0, sizeof(ADDR_EXTRACT_BANKPIPE_SWIZZLE_INPUT));
+   std::memset(&output, 0, sizeof(ADDR_EXTRACT_BANKPIPE_SWIZZLE_OUTPUT));
+   input.size = sizeof(ADDR_EXTRACT_BANKPIPE_SWIZZLE_INPUT);
+   input.tileIndex = -1;
+   output.size = sizeof(ADDR_EXTRACT_BANKPIPE_SWIZZLE_OUTPUT);
+
+   auto start = GetBenchmarkTime();
+
+   for (auto i = 0u; i < pSweep->iterations; ++i) {
+      input.base256b = i;
+      AddrExtractBankPipeSwizzle(pSweep->hLib, &input, &output);
+      pSweep->checksum += output.bankSwizzle + output.pipeSwizzle;
+   }
+
+   AddBenchmarkResult(pSweep, ADDR_BENCHMARK_EXTRACT_BANKPIPE_SWIZZLE, ADDR_TM_LINEAR_GENERAL, 0, 0, 0, 0,
+                      pSweep->iterations, GetBenchmarkTime() - start, 0);
+}
+
+
+/**
+***************************************************************************************************
+*   BenchmarkSliceSwizzle
+*
+*   @brief
+*       Times AddrComputeSliceSwizzle over a range of slices of one tile mode
+*
+*   @return
+*       N/A
+***************************************************************************************************
+*/
+static void
+BenchmarkSliceSwizzle(AddrBenchmarkSweep *pSweep,
+                      AddrTileMode tileMode)
+{
+   ADDR_COMPUTE_SLICESWIZZLE_INPUT input;
+   ADDR_COMPUTE_SLICESWIZZLE_OUTPUT output;
+
+   std::memset(&input, 0, sizeof(ADDR_COMPUTE_SLICESWIZZLE_INPUT));
+   std::memset(&output, 0, sizeof(ADDR_COMPUTE_SLICESWIZZLE_OUTPUT));
+   input.size = sizeof(ADDR_COMPUTE_SLICESWIZZLE_INPUT);
+   input.tileMode = tileMode;
+   input.tileIndex = -1;
+   output.size = sizeof(ADDR_COMPUTE_SLICESWIZZLE_OUTPUT);
+
+   auto start = GetBenchmarkTime();
+
+   for (auto i = 0u; i < pSweep->iterations; ++i) {
+      input.slice = i;
+      AddrComputeSliceSwizzle(pSweep->hLib, &input, &output);
+      pSweep->checksum += output.tileSwizzle;
+   }
+
+   AddBenchmarkResult(pSweep, ADDR_BENCHMARK_SLICE_SWIZZLE, tileMode, 0, 0, 0, 0,
+                      pSweep->iterations, GetBenchmarkTime() - start, 0);
+}
+
+
+/**
+***************************************************************************************************
+*   AddrRunBenchmark
+*
+*   @brief
+*       Time the public entry points over a sweep of tile modes, bpp, sample counts and
+*       surface sizes
+*
+*   @return
+*       ADDR_OK if no error
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrRunBenchmark(ADDR_HANDLE hLib,
+                 const ADDR_RUN_BENCHMARK_INPUT *pIn,
+                 ADDR_RUN_BENCHMARK_OUTPUT *pOut)
+{
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+
+   if (!hLib) {
+      returnCode = ADDR_ERROR;
+   } else if (pIn->size != sizeof(ADDR_RUN_BENCHMARK_INPUT) || pOut->size != sizeof(ADDR_RUN_BENCHMARK_OUTPUT)) {
+      returnCode = ADDR_PARAMSIZEMISMATCH;
+   }
+
+   if (pOut->maxResults && !pOut->pResults) {
+      returnCode = ADDR_INVALIDPARAMS;
+   }
+
+   if (returnCode == ADDR_OK) {
+      AddrBenchmarkSweep sweep;
+      auto entryMask = pIn->entryMask ? pIn->entryMask : (1u << ADDR_BENCHMARK_ENTRY_COUNT) - 1;
+      auto copyMask = (1u << ADDR_BENCHMARK_COPY_TILED_TO_LINEAR) | (1u << ADDR_BENCHMARK_COPY_LINEAR_TO_TILED);
+      auto surfaceMask = (1u << ADDR_BENCHMARK_SURFACE_INFO) | (1u << ADDR_BENCHMARK_SURFACE_ADDRFROMCOORD) | copyMask;
+
+      sweep.hLib = hLib;
+      sweep.pOut = pOut;
+      sweep.iterations = pIn->iterations ? pIn->iterations : BenchmarkDefaultIterations;
+      sweep.copyIterations = pIn->copyIterations ? pIn->copyIterations : BenchmarkDefaultCopyIterations;
+      sweep.maxSize = pIn->maxSize ? pIn->maxSize : BenchmarkDefaultMaxSize;
+      sweep.checksum = 0;
+      pOut->numResults = 0;
+
+      for (auto mode = 0u; (entryMask & surfaceMask) && mode <= ADDR_TM_3B_TILED_THICK; ++mode) {
+         auto tileMode = static_cast<AddrTileMode>(mode);
+
+         for (auto bpp : BenchmarkBpps) {
+            for (auto numSamples : BenchmarkSamples) {
+               for (auto size = BenchmarkMinSize; size <= sweep.maxSize; size *= 4) {
+                  ADDR_COMPUTE_SURFACE_INFO_INPUT surfIn;
+                  ADDR_COMPUTE_SURFACE_INFO_OUTPUT surfOut;
+
+                  // Surfaces the library rejects are left out of the sweep
+                  if (ComputeBenchmarkSurface(hLib, tileMode, bpp, numSamples, size, &surfIn, &surfOut) != ADDR_OK) {
+                     continue;
+                  }
+
+                  if (entryMask & (1u << ADDR_BENCHMARK_SURFACE_INFO)) {
+                     BenchmarkSurfaceInfo(&sweep, &surfIn);
+                  }
+
+                  if (entryMask & (1u << ADDR_BENCHMARK_SURFACE_ADDRFROMCOORD)) {
+                     BenchmarkSurfaceAddrFromCoord(&sweep, &surfIn, &surfOut);
+                  }
+
+                  // Multisampled copies would only repeat the single sample copy per sample
+                  if (numSamples == 1 && (entryMask & (1u << ADDR_BENCHMARK_COPY_TILED_TO_LINEAR))) {
+                     BenchmarkCopySurface(&sweep, true, &surfIn, &surfOut);
+                  }
+
+                  if (numSamples == 1 && (entryMask & (1u << ADDR_BENCHMARK_COPY_LINEAR_TO_TILED))) {
+                     BenchmarkCopySurface(&sweep, false, &surfIn, &surfOut);
+                  }
+               }
+            }
+         }
+      }
+
+      if (entryMask & (1u << ADDR_BENCHMARK_HTILE_INFO)) {
+         for (auto size = BenchmarkMinSize; size <= sweep.maxSize; size *= 4) {
+            BenchmarkHtileInfo(&sweep, false, size);
+            BenchmarkHtileInfo(&sweep, true, size);
+         }
+      }
+
+      if (entryMask & (1u << ADDR_BENCHMARK_EXTRACT_BANKPIPE_SWIZZLE)) {
+         BenchmarkExtractBankPipeSwizzle(&sweep);
+      }
+
+      if (entryMask & (1u << ADDR_BENCHMARK_SLICE_SWIZZLE)) {
+         for (auto mode = 0u; mode <= ADDR_TM_3B_TILED_THICK; ++mode) {
+            BenchmarkSliceSwizzle(&sweep, static_cast<AddrTileMode>(mode));
+         }
+      }
+
+      BenchmarkChecksum = sweep.checksum;
+   }
+
+   return returnCode;
+}
@@ -0,0 +1,178 @@
+/*
+ * Copyright  2014 Advanced Micro Devices, Inc.
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sub license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON-INFRINGEMENT. IN NO EVENT SHALL THE COPYRIGHT HOLDERS, AUTHORS
+ * AND/OR ITS SUPPLIERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ */
+
+/**
+***************************************************************************************************
+* @file  addrbenchmarkmain.cpp
+* @brief Command line front end of AddrRunBenchmark writing its results as CSV.
+***************************************************************************************************
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "addrtools.h"
+
+static const uint32_t BenchmarkDefaultGbAddrConfig = 0x44902;
+
+static const char *const BenchmarkEntryNames[ADDR_BENCHMARK_ENTRY_COUNT] = {
+   "SurfaceInfo",
+   "SurfaceAddrFromCoord",
+   "HtileInfo",
+   "ExtractBankPipeSwizzle",
+   "SliceSwizzle",
+   "CopyTiledToLinear",
+   "CopyLinearToTiled",
+};
+
+
+/**
+***************************************************************************************************
+*   BenchmarkAllocSysMem
+*
+*   @brief
+*       System memory callback of the benchmarked library instance
+***************************************************************************************************
+*/
+static void *
+BenchmarkAllocSysMem(const ADDR_ALLOCSYSMEM_INPUT *pInput)
+{
+   return malloc(pInput->sizeInBytes);
+}
+
+
+/**
+***************************************************************************************************
+*   BenchmarkFreeSysMem
+*
+*   @brief
+*       System memory callback of the benchmarked library instance
+***************************************************************************************************
+*/
+static ADDR_E_RETURNCODE
+BenchmarkFreeSysMem(const ADDR_FREESYSMEM_INPUT *pInput)
+{
+   free(pInput->pVirtAddr);
+   return ADDR_OK;
+}
+
+
+/**
+***************************************************************************************************
+*   GetMaxBenchmarkResults
+*
+*   @brief
+*       Returns an upper bound of the number of results of a sweep up to maxSize, one per
+*       entry point, tile mode, bpp, sample count and surface size
+***************************************************************************************************
+*/
+static uint32_t
+GetMaxBenchmarkResults(uint32_t maxSize)
+{
+   auto numSizes = 1u;
+
+   for (auto size = 64u; size < maxSize; size *= 4) {
+      numSizes++;
+   }
+
+   return ADDR_BENCHMARK_ENTRY_COUNT * (ADDR_TM_3B_TILED_THICK + 1) * 5 * 4 * numSizes;
+}
+
+
+/**
+***************************************************************************************************
+*   main
+*
+*   @brief
+*       addrbenchmark [gbAddrConfig [maxSize [iterations]]]
+*
+*       Runs the sweep on a Wii U library instance and writes one CSV line per result to
+*       stdout, in the fixed order of AddrRunBenchmark so runs of two builds can be diffed.
+***************************************************************************************************
+*/
+int
+main(int argc, char **argv)
+{
+   auto gbAddrConfig = argc > 1 ? static_cast<uint32_t>(strtoul(argv[1], nullptr, 0)) : BenchmarkDefaultGbAddrConfig;
+   auto maxSize = argc > 2 ? static_cast<uint32_t>(strtoul(argv[2], nullptr, 0)) : 1024u;
+   auto iterations = argc > 3 ? static_cast<uint32_t>(strtoul(argv[3], nullptr, 0)) : 0u;
+
+   if (argc > 4 || maxSize == 0) {
+      fprintf(stderr, "usage: %s [gbAddrConfig [maxSize [iterations]]]\n", argv[0]);
+      return EXIT_FAILURE;
+   }
+
+   ADDR_CREATE_INPUT createIn;
+   ADDR_CREATE_OUTPUT createOut;
+   memset(&createIn, 0, sizeof(createIn));
+   memset(&createOut, 0, sizeof(createOut));
+   createIn.size = sizeof(createIn);
+   createIn.chipEngine = CIASICIDGFXENGINE_R600;
+   createIn.chipFamily = 0x51;
+   createIn.chipRevision = 71;
+   createIn.createFlags.fillSizeFields = 1;
+   createIn.regValue.gbAddrConfig = gbAddrConfig;
+   createIn.callbacks.allocSysMem = BenchmarkAllocSysMem;
+   createIn.callbacks.freeSysMem = BenchmarkFreeSysMem;
+   createOut.size = sizeof(createOut);
+
+   if (AddrCreate(&createIn, &createOut) != ADDR_OK) {
+      fprintf(stderr, "could not create a library instance for config 0x%x\n", gbAddrConfig);
+      return EXIT_FAILURE;
+   }
+
+   std::vector<ADDR_BENCHMARK_RESULT> results(GetMaxBenchmarkResults(maxSize));
+   ADDR_RUN_BENCHMARK_INPUT benchIn;
+   ADDR_RUN_BENCHMARK_OUTPUT benchOut;
+   memset(&benchIn, 0, sizeof(benchIn));
+   memset(&benchOut, 0, sizeof(benchOut));
+   benchIn.size = sizeof(benchIn);
+   benchIn.iterations = iterations;
+   benchIn.maxSize = maxSize;
+   benchOut.size = sizeof(benchOut);
+   benchOut.maxResults = static_cast<uint32_t>(results.size());
+   benchOut.pResults = results.data();
+
+   auto returnCode = AddrRunBenchmark(createOut.hLib, &benchIn, &benchOut);
+   AddrDestroy(createOut.hLib);
+
+   if (returnCode != ADDR_OK) {
+      fprintf(stderr, "benchmark failed with %d\n", returnCode);
+      return EXIT_FAILURE;
+   }
+
+   printf("entry,tileMode,bpp,numSamples,width,height,calls,nsPerCall,gbPerSecond\n");
+
+   for (auto i = 0u; i < benchOut.numResults && i < benchOut.maxResults; ++i) {
+      const auto &result = results[i];
+      printf("%s,%u,%u,%u,%u,%u,%llu,%.3f,%.3f\n", BenchmarkEntryNames[result.entry], result.tileMode,
+             result.bpp, result.numSamples, result.width, result.height,
+             static_cast<unsigned long long>(result.calls), result.nsPerCall, result.gbPerSecond);
+   }
+
+   return EXIT_SUCCESS;
+}
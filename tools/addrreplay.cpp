@@ -0,0 +1,1434 @@
+/*
+ * Copyright  2014 Advanced Micro Devices, Inc.
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sub license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON-INFRINGEMENT. IN NO EVENT SHALL THE COPYRIGHT HOLDERS, AUTHORS
+ * AND/OR ITS SUPPLIERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ */
+
+/**
+***************************************************************************************************
+* @file  addrreplay.cpp
+* @brief Contains AddrReplayTrace, which replays, times and verifies the calls of a recorded
+*        trace.
+***************************************************************************************************
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "addrtools.h"
+
+
+/**
+***************************************************************************************************
+* @brief Output arrays of one replay worker, grown to the largest call it replayed
+***************************************************************************************************
+*/
+struct AddrReplayScratch
+{
+   std::vector<ADDR_MIP_LEVEL_INFO> mipInfo;
+   std::vector<uint64_t> addr;
+   std::vector<uint32_t> bitPosition;
+   std::vector<uint32_t> coords[4];
+   std::vector<ADDR_COPY_REGION> regions;
+   std::vector<uint32_t> mipLevels;
+   ADDR_QBSTEREOINFO stereoInfo;
+};
+
+
+/**
+***************************************************************************************************
+* @brief Results of one replay worker
+***************************************************************************************************
+*/
+struct AddrReplayWorkerResult
+{
+   std::vector<uint64_t> ns[ADDR_STATS_ENTRY_COUNT];
+   uint64_t mismatches[ADDR_STATS_ENTRY_COUNT];
+   uint64_t firstMismatch[ADDR_STATS_ENTRY_COUNT];
+   AddrReplayScratch scratch;
+};
+
+
+/**
+***************************************************************************************************
+* @brief State shared by the workers of one AddrReplayTrace call
+***************************************************************************************************
+*/
+struct AddrReplayTasks
+{
+   ADDR_HANDLE hLib;
+   const ADDR_TRACE_RECORD *pRecords;
+   uint64_t numRecords;
+   uint32_t iterations;
+   uint32_t numWorkers;
+   AddrReplayWorkerResult *pResults;
+};
+
+
+/**
+***************************************************************************************************
+* @brief Records of a trace collected by AddrReadTrace, and the number it could not replay
+***************************************************************************************************
+*/
+struct AddrReplayRecords
+{
+   std::vector<ADDR_TRACE_RECORD> records;
+   uint64_t numSkipped;
+};
+
+
+/**
+***************************************************************************************************
+*   ReplaySegmentIs
+*
+*   @brief
+*       Checks that segment of a record holds one T
+*
+*   @return
+*       true if it does
+***************************************************************************************************
+*/
+template<typename T>
+static bool
+ReplaySegmentIs(const ADDR_TRACE_RECORD *pRecord,
+                uint32_t segment)
+{
+   return segment < pRecord->numSegments && pRecord->segmentBytes[segment] == sizeof(T);
+}
+
+
+/**
+***************************************************************************************************
+*   ReplayArrayFits
+*
+*   @brief
+*       Checks that segment of a record is empty or holds count elements of elemBytes
+*
+*   @return
+*       true if it does
+***************************************************************************************************
+*/
+static bool
+ReplayArrayFits(const ADDR_TRACE_RECORD *pRecord,
+                uint32_t segment,
+                uint64_t count,
+                uint64_t elemBytes)
+{
+   return segment < pRecord->numSegments &&
+          (pRecord->segmentBytes[segment] == 0 || pRecord->segmentBytes[segment] == count * elemBytes);
+}
+
+
+/**
+***************************************************************************************************
+*   GetReplayArrayBytes
+*
+*   @brief
+*       Returns the bytes the trace records for an array, nullptr arrays are recorded empty
+*
+*   @return
+*       Size of the recorded segment
+***************************************************************************************************
+*/
+static uint64_t
+GetReplayArrayBytes(const void *pData,
+                    uint64_t count,
+                    uint64_t elemBytes)
+{
+   return pData ? count * elemBytes : 0;
+}
+
+
+/**
+***************************************************************************************************
+*   ReplayArrayMatches
+*
+*   @brief
+*       Compares a recorded output array with the replayed one, recorded the way
+*       the trace records it
+*
+*   @return
+*       true if they are equal
+***************************************************************************************************
+*/
+static bool
+ReplayArrayMatches(const ADDR_TRACE_RECORD *pRecord,
+                   uint32_t segment,
+                   const void *pData,
+                   uint64_t count,
+                   uint64_t elemBytes)
+{
+   auto replayedBytes = GetReplayArrayBytes(pData, count, elemBytes);
+
+   return pRecord->segmentBytes[segment] == replayedBytes &&
+          (!replayedBytes || std::memcmp(pRecord->pSegments[segment], pData, replayedBytes) == 0);
+}
+
+
+/**
+***************************************************************************************************
+*   IsReplayable
+*
+*   @brief
+*       Checks that a record has the segments its entry point records, and that its arrays fit
+*       the counts of its structures
+*
+*   @note
+*       Plan lookups and plan destruction are not recorded, so a replayed plan record only
+*       times AddrCreateSurfacePlan and destroys the plan right away
+*
+*   @return
+*       true if the record can be replayed
+***************************************************************************************************
+*/
+static bool
+IsReplayable(const ADDR_TRACE_RECORD *pRecord)
+{
+   auto replayable = false;
+
+   switch (pRecord->entry) {
+   case ADDR_STATS_SURFACE_INFO:
+      replayable = ReplaySegmentIs<ADDR_COMPUTE_SURFACE_INFO_INPUT>(pRecord, 0) &&
+                   ReplaySegmentIs<ADDR_COMPUTE_SURFACE_INFO_OUTPUT>(pRecord, 1);
+      break;
+   case ADDR_STATS_MIPCHAIN_INFO:
+      replayable = ReplaySegmentIs<ADDR_COMPUTE_MIPCHAIN_INFO_INPUT>(pRecord, 0) &&
+                   ReplaySegmentIs<ADDR_COMPUTE_MIPCHAIN_INFO_OUTPUT>(pRecord, 1) &&
+                   pRecord->numSegments == 3;
+      break;
+   case ADDR_STATS_SURFACE_ADDRFROMCOORD:
+      replayable = ReplaySegmentIs<ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_INPUT>(pRecord, 0) &&
+                   ReplaySegmentIs<ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_OUTPUT>(pRecord, 1);
+      break;
+   case ADDR_STATS_SURFACE_ADDRFROMCOORD_BATCH:
+      replayable = ReplaySegmentIs<ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_INPUT>(pRecord, 0) &&
+                   ReplaySegmentIs<ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_OUTPUT>(pRecord, 1) &&
+                   pRecord->numSegments == 8;
+
+      if (replayable) {
+         auto numCoords = static_cast<const ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_INPUT *>(pRecord->pSegments[0])->numCoords;
+
+         for (auto segment = 2u; segment < 6; ++segment) {
+            replayable = replayable && ReplayArrayFits(pRecord, segment, numCoords, sizeof(uint32_t));
+         }
+      }
+      break;
+   case ADDR_STATS_CMASK_INFO:
+      replayable = ReplaySegmentIs<ADDR_COMPUTE_CMASK_INFO_INPUT>(pRecord, 0) &&
+                   ReplaySegmentIs<ADDR_COMPUTE_CMASK_INFO_OUTPUT>(pRecord, 1);
+      break;
+   case ADDR_STATS_CMASK_ADDRFROMCOORD:
+      replayable = ReplaySegmentIs<ADDR_COMPUTE_CMASK_ADDRFROMCOORD_INPUT>(pRecord, 0) &&
+                   ReplaySegmentIs<ADDR_COMPUTE_CMASK_ADDRFROMCOORD_OUTPUT>(pRecord, 1);
+      break;
+   case ADDR_STATS_CREATE_SURFACE_PLAN:
+      replayable = ReplaySegmentIs<ADDR_CREATE_SURFACE_PLAN_INPUT>(pRecord, 0) &&
+                   ReplaySegmentIs<ADDR_CREATE_SURFACE_PLAN_OUTPUT>(pRecord, 1);
+      break;
+   case ADDR_STATS_SURFACE_COORDFROMADDR:
+      replayable = ReplaySegmentIs<ADDR_COMPUTE_SURFACE_COORDFROMADDR_INPUT>(pRecord, 0) &&
+                   ReplaySegmentIs<ADDR_COMPUTE_SURFACE_COORDFROMADDR_OUTPUT>(pRecord, 1);
+      break;
+   case ADDR_STATS_SURFACE_COORDFROMADDR_RANGE:
+      replayable = ReplaySegmentIs<ADDR_COMPUTE_SURFACE_COORDFROMADDR_RANGE_INPUT>(pRecord, 0) &&
+                   ReplaySegmentIs<ADDR_COMPUTE_SURFACE_COORDFROMADDR_RANGE_OUTPUT>(pRecord, 1) &&
+                   pRecord->numSegments == 6;
+      break;
+   case ADDR_STATS_SURFACE_DIRTY_REGIONS:
+      replayable = ReplaySegmentIs<ADDR_COMPUTE_SURFACE_DIRTY_REGIONS_INPUT>(pRecord, 0) &&
+                   ReplaySegmentIs<ADDR_COMPUTE_SURFACE_DIRTY_REGIONS_OUTPUT>(pRecord, 1) &&
+                   pRecord->numSegments == 5;
+
+      if (replayable) {
+         auto numMipLevels = static_cast<const ADDR_COMPUTE_SURFACE_DIRTY_REGIONS_INPUT *>(pRecord->pSegments[0])->numMipLevels;
+         replayable = ReplayArrayFits(pRecord, 2, numMipLevels, sizeof(ADDR_MIP_LEVEL_INFO));
+      }
+      break;
+   case ADDR_STATS_EXTRACT_BANKPIPE_SWIZZLE:
+      replayable = ReplaySegmentIs<ADDR_EXTRACT_BANKPIPE_SWIZZLE_INPUT>(pRecord, 0) &&
+                   ReplaySegmentIs<ADDR_EXTRACT_BANKPIPE_SWIZZLE_OUTPUT>(pRecord, 1);
+      break;
+   case ADDR_STATS_HTILE_INFO:
+      replayable = ReplaySegmentIs<ADDR_COMPUTE_HTILE_INFO_INPUT>(pRecord, 0) &&
+                   ReplaySegmentIs<ADDR_COMPUTE_HTILE_INFO_OUTPUT>(pRecord, 1);
+      break;
+   case ADDR_STATS_SLICE_SWIZZLE:
+      replayable = ReplaySegmentIs<ADDR_COMPUTE_SLICESWIZZLE_INPUT>(pRecord, 0) &&
+                   ReplaySegmentIs<ADDR_COMPUTE_SLICESWIZZLE_OUTPUT>(pRecord, 1);
+      break;
+   case ADDR_STATS_PIXEL_INDEX_TABLE:
+      replayable = ReplaySegmentIs<ADDR_COMPUTE_PIXEL_INDEX_TABLE_INPUT>(pRecord, 0) &&
+                   ReplaySegmentIs<ADDR_COMPUTE_PIXEL_INDEX_TABLE_OUTPUT>(pRecord, 1);
+      break;
+   case ADDR_STATS_HTILE_ADDRFROMCOORD:
+      replayable = ReplaySegmentIs<ADDR_COMPUTE_HTILE_ADDRFROMCOORD_INPUT>(pRecord, 0) &&
+                   ReplaySegmentIs<ADDR_COMPUTE_HTILE_ADDRFROMCOORD_OUTPUT>(pRecord, 1);
+      break;
+   case ADDR_STATS_FMASK_INFO:
+      replayable = ReplaySegmentIs<ADDR_COMPUTE_FMASK_INFO_INPUT>(pRecord, 0) &&
+                   ReplaySegmentIs<ADDR_COMPUTE_FMASK_INFO_OUTPUT>(pRecord, 1);
+      break;
+   case ADDR_STATS_FMASK_ADDRFROMCOORD:
+      replayable = ReplaySegmentIs<ADDR_COMPUTE_FMASK_ADDRFROMCOORD_INPUT>(pRecord, 0) &&
+                   ReplaySegmentIs<ADDR_COMPUTE_FMASK_ADDRFROMCOORD_OUTPUT>(pRecord, 1);
+      break;
+   case ADDR_STATS_FMASK_ADDRFROMCOORD_BATCH:
+      replayable = ReplaySegmentIs<ADDR_COMPUTE_FMASK_ADDRFROMCOORD_BATCH_INPUT>(pRecord, 0) &&
+                   ReplaySegmentIs<ADDR_COMPUTE_FMASK_ADDRFROMCOORD_BATCH_OUTPUT>(pRecord, 1) &&
+                   pRecord->numSegments == 8;
+
+      if (replayable) {
+         auto numCoords = static_cast<const ADDR_COMPUTE_FMASK_ADDRFROMCOORD_BATCH_INPUT *>(pRecord->pSegments[0])->numCoords;
+
+         for (auto segment = 2u; segment < 6; ++segment) {
+            replayable = replayable && ReplayArrayFits(pRecord, segment, numCoords, sizeof(uint32_t));
+         }
+      }
+      break;
+   default:
+      // The copies need the surface contents, which are not recorded
+      replayable = false;
+   }
+
+   return replayable;
+}
+
+
+/**
+***************************************************************************************************
+*   CollectReplayRecord
+*
+*   @brief
+*       ADDR_TRACE_RECORD_CALLBACK keeping the replayable records
+*
+*   @return
+*       true to keep reading
+***************************************************************************************************
+*/
+static bool
+CollectReplayRecord(void *pRecordData,
+                    const ADDR_TRACE_RECORD *pRecord)
+{
+   auto pRecords = static_cast<AddrReplayRecords *>(pRecordData);
+
+   if (IsReplayable(pRecord)) {
+      pRecords->records.push_back(*pRecord);
+   } else {
+      pRecords->numSkipped++;
+   }
+
+   return true;
+}
+
+
+/**
+***************************************************************************************************
+*   IsReplayRecordEarlier
+*
+*   @brief
+*       Orders records by start time
+*
+*   @return
+*       true if a started before b
+***************************************************************************************************
+*/
+static bool
+IsReplayRecordEarlier(const ADDR_TRACE_RECORD &a,
+                      const ADDR_TRACE_RECORD &b)
+{
+   return a.startNs < b.startNs;
+}
+
+
+/**
+***************************************************************************************************
+*   GetReplayNs
+*
+*   @brief
+*       Returns the nanoseconds since start
+***************************************************************************************************
+*/
+static uint64_t
+GetReplayNs(std::chrono::steady_clock::time_point start)
+{
+   auto elapsed = std::chrono::steady_clock::now() - start;
+   return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+}
+
+
+/**
+***************************************************************************************************
+*   MipLevelsMatch
+*
+*   @brief
+*       Compares mip level infos field by field, their padding is not part of the output
+*
+*   @return
+*       true if they are equal
+***************************************************************************************************
+*/
+static bool
+MipLevelsMatch(const ADDR_TRACE_RECORD *pRecord,
+               uint32_t segment,
+               const ADDR_MIP_LEVEL_INFO *pMipInfo,
+               uint32_t numMipLevels)
+{
+   auto pRecorded = static_cast<const ADDR_MIP_LEVEL_INFO *>(pRecord->pSegments[segment]);
+   auto match = pRecord->segmentBytes[segment] == GetReplayArrayBytes(pMipInfo, numMipLevels, sizeof(ADDR_MIP_LEVEL_INFO));
+
+   for (auto level = 0u; match && pMipInfo && level < numMipLevels; ++level) {
+      auto a = &pRecorded[level];
+      auto b = &pMipInfo[level];
+
+      match = a->pitch == b->pitch && a->height == b->height && a->depth == b->depth &&
+              a->tileMode == b->tileMode && a->baseAlign == b->baseAlign &&
+              a->pitchAlign == b->pitchAlign && a->heightAlign == b->heightAlign &&
+              a->depthAlign == b->depthAlign && a->pixelPitch == b->pixelPitch &&
+              a->pixelHeight == b->pixelHeight && a->sliceSize == b->sliceSize &&
+              a->surfSize == b->surfSize && a->offset == b->offset;
+   }
+
+   return match;
+}
+
+
+/**
+***************************************************************************************************
+*   ReplaySurfaceInfo
+*
+*   @brief
+*       Replays an AddrComputeSurfaceInfo record
+*
+*   @return
+*       true if the outputs match the recorded ones
+***************************************************************************************************
+*/
+static bool
+ReplaySurfaceInfo(ADDR_HANDLE hLib,
+                  const ADDR_TRACE_RECORD *pRecord,
+                  AddrReplayScratch *pScratch,
+                  uint64_t *pNs)
+{
+   auto pRecorded = static_cast<const ADDR_COMPUTE_SURFACE_INFO_OUTPUT *>(pRecord->pSegments[1]);
+   ADDR_COMPUTE_SURFACE_INFO_INPUT input;
+   ADDR_COMPUTE_SURFACE_INFO_OUTPUT output;
+
+   std::memcpy(&input, pRecord->pSegments[0], sizeof(input));
+   input.pTileInfo = nullptr;
+   std::memset(&output, 0, sizeof(output));
+   output.size = pRecorded->size;
+   output.pStereoInfo = pRecorded->pStereoInfo ? &pScratch->stereoInfo : nullptr;
+
+   auto start = std::chrono::steady_clock::now();
+   auto returnCode = AddrComputeSurfaceInfo(hLib, &input, &output);
+   *pNs = GetReplayNs(start);
+
+   return returnCode == pRecord->returnCode &&
+          (returnCode != ADDR_OK ||
+           (output.pitch == pRecorded->pitch && output.height == pRecorded->height &&
+            output.depth == pRecorded->depth && output.surfSize == pRecorded->surfSize &&
+            output.tileMode == pRecorded->tileMode && output.baseAlign == pRecorded->baseAlign &&
+            output.pitchAlign == pRecorded->pitchAlign && output.heightAlign == pRecorded->heightAlign &&
+            output.depthAlign == pRecorded->depthAlign && output.bpp == pRecorded->bpp &&
+            output.pixelPitch == pRecorded->pixelPitch && output.pixelHeight == pRecorded->pixelHeight &&
+            output.pixelBits == pRecorded->pixelBits && output.sliceSize == pRecorded->sliceSize &&
+            output.pitchTileMax == pRecorded->pitchTileMax && output.heightTileMax == pRecorded->heightTileMax &&
+            output.sliceTileMax == pRecorded->sliceTileMax && output.tileType == pRecorded->tileType &&
+            output.tileIndex == pRecorded->tileIndex));
+}
+
+
+/**
+***************************************************************************************************
+*   ReplayMipChainInfo
+*
+*   @brief
+*       Replays an AddrComputeMipChainInfo record
+*
+*   @return
+*       true if the outputs match the recorded ones
+***************************************************************************************************
+*/
+static bool
+ReplayMipChainInfo(ADDR_HANDLE hLib,
+                   const ADDR_TRACE_RECORD *pRecord,
+                   AddrReplayScratch *pScratch,
+                   uint64_t *pNs)
+{
+   auto pRecorded = static_cast<const ADDR_COMPUTE_MIPCHAIN_INFO_OUTPUT *>(pRecord->pSegments[1]);
+   ADDR_COMPUTE_MIPCHAIN_INFO_INPUT input;
+   ADDR_COMPUTE_MIPCHAIN_INFO_OUTPUT output;
+
+   std::memcpy(&input, pRecord->pSegments[0], sizeof(input));
+   input.pTileInfo = nullptr;
+   std::memset(&output, 0, sizeof(output));
+   output.size = pRecorded->size;
+
+   if (pRecorded->pMipInfo) {
+      pScratch->mipInfo.resize(std::max<size_t>(pScratch->mipInfo.size(), input.numMipLevels));
+      output.pMipInfo = pScratch->mipInfo.data();
+   }
+
+   auto start = std::chrono::steady_clock::now();
+   auto returnCode = AddrComputeMipChainInfo(hLib, &input, &output);
+   *pNs = GetReplayNs(start);
+
+   return returnCode == pRecord->returnCode &&
+          (returnCode != ADDR_OK ||
+           (output.mipChainSize == pRecorded->mipChainSize && output.baseAlign == pRecorded->baseAlign &&
+            MipLevelsMatch(pRecord, 2, output.pMipInfo, input.numMipLevels)));
+}
+
+
+/**
+***************************************************************************************************
+*   ReplaySurfaceAddrFromCoord
+*
+*   @brief
+*       Replays an AddrComputeSurfaceAddrFromCoord record
+*
+*   @return
+*       true if the outputs match the recorded ones
+***************************************************************************************************
+*/
+static bool
+ReplaySurfaceAddrFromCoord(ADDR_HANDLE hLib,
+                           const ADDR_TRACE_RECORD *pRecord,
+                           uint64_t *pNs)
+{
+   auto pRecorded = static_cast<const ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_OUTPUT *>(pRecord->pSegments[1]);
+   ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_INPUT input;
+   ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_OUTPUT output;
+
+   std::memcpy(&input, pRecord->pSegments[0], sizeof(input));
+   input.pTileInfo = nullptr;
+   std::memset(&output, 0, sizeof(output));
+   output.size = pRecorded->size;
+
+   auto start = std::chrono::steady_clock::now();
+   auto returnCode = AddrComputeSurfaceAddrFromCoord(hLib, &input, &output);
+   *pNs = GetReplayNs(start);
+
+   return returnCode == pRecord->returnCode &&
+          (returnCode != ADDR_OK ||
+           (output.addr == pRecorded->addr && output.bitPosition == pRecorded->bitPosition));
+}
+
+
+/**
+***************************************************************************************************
+*   ReplaySurfaceAddrFromCoordBatch
+*
+*   @brief
+*       Replays an AddrComputeSurfaceAddrFromCoordBatch record
+*
+*   @return
+*       true if the outputs match the recorded ones
+***************************************************************************************************
+*/
+static bool
+ReplaySurfaceAddrFromCoordBatch(ADDR_HANDLE hLib,
+                                const ADDR_TRACE_RECORD *pRecord,
+                                AddrReplayScratch *pScratch,
+                                uint64_t *pNs)
+{
+   auto pRecorded = static_cast<const ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_OUTPUT *>(pRecord->pSegments[1]);
+   ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_INPUT input;
+   ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_OUTPUT output;
+
+   std::memcpy(&input, pRecord->pSegments[0], sizeof(input));
+   input.pTileInfo = nullptr;
+   input.pX = static_cast<const uint32_t *>(pRecord->segmentBytes[2] ? pRecord->pSegments[2] : nullptr);
+   input.pY = static_cast<const uint32_t *>(pRecord->segmentBytes[3] ? pRecord->pSegments[3] : nullptr);
+   input.pSlice = static_cast<const uint32_t *>(pRecord->segmentBytes[4] ? pRecord->pSegments[4] : nullptr);
+   input.pSample = static_cast<const uint32_t *>(pRecord->segmentBytes[5] ? pRecord->pSegments[5] : nullptr);
+   std::memset(&output, 0, sizeof(output));
+   output.size = pRecorded->size;
+
+   if (pRecorded->pAddr) {
+      pScratch->addr.resize(std::max<size_t>(pScratch->addr.size(), input.numCoords));
+      output.pAddr = pScratch->addr.data();
+   }
+
+   if (pRecorded->pBitPosition) {
+      pScratch->bitPosition.resize(std::max<size_t>(pScratch->bitPosition.size(), input.numCoords));
+      output.pBitPosition = pScratch->bitPosition.data();
+   }
+
+   auto start = std::chrono::steady_clock::now();
+   auto returnCode = AddrComputeSurfaceAddrFromCoordBatch(hLib, &input, &output);
+   *pNs = GetReplayNs(start);
+
+   auto numOutCoords = returnCode == ADDR_OK ? input.numCoords : 0;
+
+   return returnCode == pRecord->returnCode &&
+          ReplayArrayMatches(pRecord, 6, output.pAddr, numOutCoords, sizeof(uint64_t)) &&
+          ReplayArrayMatches(pRecord, 7, output.pBitPosition, numOutCoords, sizeof(uint32_t));
+}
+
+
+/**
+***************************************************************************************************
+*   ReplayCreateSurfacePlan
+*
+*   @brief
+*       Replays an AddrCreateSurfacePlan record, destroying the plan right away
+*
+*   @return
+*       true if the return code matches the recorded one
+***************************************************************************************************
+*/
+static bool
+ReplayCreateSurfacePlan(ADDR_HANDLE hLib,
+                        const ADDR_TRACE_RECORD *pRecord,
+                        uint64_t *pNs)
+{
+   auto pRecorded = static_cast<const ADDR_CREATE_SURFACE_PLAN_OUTPUT *>(pRecord->pSegments[1]);
+   ADDR_CREATE_SURFACE_PLAN_INPUT input;
+   ADDR_CREATE_SURFACE_PLAN_OUTPUT output;
+
+   std::memcpy(&input, pRecord->pSegments[0], sizeof(input));
+   input.pTileInfo = nullptr;
+   std::memset(&output, 0, sizeof(output));
+   output.size = pRecorded->size;
+
+   auto start = std::chrono::steady_clock::now();
+   auto returnCode = AddrCreateSurfacePlan(hLib, &input, &output);
+   *pNs = GetReplayNs(start);
+
+   if (returnCode == ADDR_OK) {
+      AddrDestroySurfacePlan(hLib, output.hPlan);
+   }
+
+   return returnCode == pRecord->returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   ReplaySurfaceCoordFromAddr
+*
+*   @brief
+*       Replays an AddrComputeSurfaceCoordFromAddr record
+*
+*   @return
+*       true if the outputs match the recorded ones
+***************************************************************************************************
+*/
+static bool
+ReplaySurfaceCoordFromAddr(ADDR_HANDLE hLib,
+                           const ADDR_TRACE_RECORD *pRecord,
+                           uint64_t *pNs)
+{
+   auto pRecorded = static_cast<const ADDR_COMPUTE_SURFACE_COORDFROMADDR_OUTPUT *>(pRecord->pSegments[1]);
+   ADDR_COMPUTE_SURFACE_COORDFROMADDR_INPUT input;
+   ADDR_COMPUTE_SURFACE_COORDFROMADDR_OUTPUT output;
+
+   std::memcpy(&input, pRecord->pSegments[0], sizeof(input));
+   input.pTileInfo = nullptr;
+   std::memset(&output, 0, sizeof(output));
+   output.size = pRecorded->size;
+
+   auto start = std::chrono::steady_clock::now();
+   auto returnCode = AddrComputeSurfaceCoordFromAddr(hLib, &input, &output);
+   *pNs = GetReplayNs(start);
+
+   return returnCode == pRecord->returnCode &&
+          (returnCode != ADDR_OK ||
+           (output.x == pRecorded->x && output.y == pRecorded->y &&
+            output.slice == pRecorded->slice && output.sample == pRecorded->sample));
+}
+
+
+/**
+***************************************************************************************************
+*   ReplaySurfaceCoordFromAddrRange
+*
+*   @brief
+*       Replays an AddrComputeSurfaceCoordFromAddrRange record
+*
+*   @return
+*       true if the outputs match the recorded ones
+***************************************************************************************************
+*/
+static bool
+ReplaySurfaceCoordFromAddrRange(ADDR_HANDLE hLib,
+                                const ADDR_TRACE_RECORD *pRecord,
+                                AddrReplayScratch *pScratch,
+                                uint64_t *pNs)
+{
+   auto pRecorded = static_cast<const ADDR_COMPUTE_SURFACE_COORDFROMADDR_RANGE_OUTPUT *>(pRecord->pSegments[1]);
+   ADDR_COMPUTE_SURFACE_COORDFROMADDR_RANGE_INPUT input;
+   ADDR_COMPUTE_SURFACE_COORDFROMADDR_RANGE_OUTPUT output;
+   uint32_t *pCoords[4];
+
+   std::memcpy(&input, pRecord->pSegments[0], sizeof(input));
+   input.pTileInfo = nullptr;
+   std::memset(&output, 0, sizeof(output));
+   output.size = pRecorded->size;
+   output.maxCoords = pRecorded->maxCoords;
+
+   for (auto i = 0u; i < 4; ++i) {
+      pScratch->coords[i].resize(std::max<size_t>(pScratch->coords[i].size(), output.maxCoords));
+      pCoords[i] = pScratch->coords[i].data();
+   }
+
+   output.pX = pRecorded->pX ? pCoords[0] : nullptr;
+   output.pY = pRecorded->pY ? pCoords[1] : nullptr;
+   output.pSlice = pRecorded->pSlice ? pCoords[2] : nullptr;
+   output.pSample = pRecorded->pSample ? pCoords[3] : nullptr;
+
+   auto start = std::chrono::steady_clock::now();
+   auto returnCode = AddrComputeSurfaceCoordFromAddrRange(hLib, &input, &output);
+   *pNs = GetReplayNs(start);
+
+   auto numOutCoords = returnCode == ADDR_OK ? output.numCoords : 0;
+
+   return returnCode == pRecord->returnCode &&
+          (returnCode != ADDR_OK || output.numCoords == pRecorded->numCoords) &&
+          ReplayArrayMatches(pRecord, 2, output.pX, numOutCoords, sizeof(uint32_t)) &&
+          ReplayArrayMatches(pRecord, 3, output.pY, numOutCoords, sizeof(uint32_t)) &&
+          ReplayArrayMatches(pRecord, 4, output.pSlice, numOutCoords, sizeof(uint32_t)) &&
+          ReplayArrayMatches(pRecord, 5, output.pSample, numOutCoords, sizeof(uint32_t));
+}
+
+
+/**
+***************************************************************************************************
+*   ReplaySurfaceDirtyRegions
+*
+*   @brief
+*       Replays an AddrComputeSurfaceDirtyRegions record
+*
+*   @return
+*       true if the outputs match the recorded ones
+***************************************************************************************************
+*/
+static bool
+ReplaySurfaceDirtyRegions(ADDR_HANDLE hLib,
+                          const ADDR_TRACE_RECORD *pRecord,
+                          AddrReplayScratch *pScratch,
+                          uint64_t *pNs)
+{
+   auto pRecorded = static_cast<const ADDR_COMPUTE_SURFACE_DIRTY_REGIONS_OUTPUT *>(pRecord->pSegments[1]);
+   ADDR_COMPUTE_SURFACE_DIRTY_REGIONS_INPUT input;
+   ADDR_COMPUTE_SURFACE_DIRTY_REGIONS_OUTPUT output;
+
+   std::memcpy(&input, pRecord->pSegments[0], sizeof(input));
+   input.pTileInfo = nullptr;
+   input.pMipInfo = static_cast<const ADDR_MIP_LEVEL_INFO *>(pRecord->segmentBytes[2] ? pRecord->pSegments[2] : nullptr);
+   std::memset(&output, 0, sizeof(output));
+   output.size = pRecorded->size;
+   output.maxRegions = pRecorded->maxRegions;
+
+   if (pRecorded->pRegions) {
+      pScratch->regions.resize(std::max<size_t>(pScratch->regions.size(), output.maxRegions));
+      output.pRegions = pScratch->regions.data();
+   }
+
+   if (pRecorded->pMipLevels) {
+      pScratch->mipLevels.resize(std::max<size_t>(pScratch->mipLevels.size(), output.maxRegions));
+      output.pMipLevels = pScratch->mipLevels.data();
+   }
+
+   auto start = std::chrono::steady_clock::now();
+   auto returnCode = AddrComputeSurfaceDirtyRegions(hLib, &input, &output);
+   *pNs = GetReplayNs(start);
+
+   auto numOutRegions = returnCode == ADDR_OK ? output.numRegions : 0;
+
+   return returnCode == pRecord->returnCode &&
+          (returnCode != ADDR_OK || output.numRegions == pRecorded->numRegions) &&
+          ReplayArrayMatches(pRecord, 3, output.pRegions, numOutRegions, sizeof(ADDR_COPY_REGION)) &&
+          ReplayArrayMatches(pRecord, 4, output.pMipLevels, numOutRegions, sizeof(uint32_t));
+}
+
+
+/**
+***************************************************************************************************
+*   ReplayExtractBankPipeSwizzle
+*
+*   @brief
+*       Replays an AddrExtractBankPipeSwizzle record
+*
+*   @return
+*       true if the outputs match the recorded ones
+***************************************************************************************************
+*/
+static bool
+ReplayExtractBankPipeSwizzle(ADDR_HANDLE hLib,
+                             const ADDR_TRACE_RECORD *pRecord,
+                             uint64_t *pNs)
+{
+   auto pRecorded = static_cast<const ADDR_EXTRACT_BANKPIPE_SWIZZLE_OUTPUT *>(pRecord->pSegments[1]);
+   ADDR_EXTRACT_BANKPIPE_SWIZZLE_INPUT input;
+   ADDR_EXTRACT_BANKPIPE_SWIZZLE_OUTPUT output;
+
+   std::memcpy(&input, pRecord->pSegments[0], sizeof(input));
+   input.pTileInfo = nullptr;
+   std::memset(&output, 0, sizeof(output));
+   output.size = pRecorded->size;
+
+   auto start = std::chrono::steady_clock::now();
+   auto returnCode = AddrExtractBankPipeSwizzle(hLib, &input, &output);
+   *pNs = GetReplayNs(start);
+
+   return returnCode == pRecord->returnCode &&
+          (returnCode != ADDR_OK ||
+           (output.bankSwizzle == pRecorded->bankSwizzle && output.pipeSwizzle == pRecorded->pipeSwizzle));
+}
+
+
+/**
+***************************************************************************************************
+*   ReplayHtileInfo
+*
+*   @brief
+*       Replays an AddrComputeHtileInfo record
+*
+*   @return
+*       true if the outputs match the recorded ones
+***************************************************************************************************
+*/
+static bool
+ReplayHtileInfo(ADDR_HANDLE hLib,
+                const ADDR_TRACE_RECORD *pRecord,
+                uint64_t *pNs)
+{
+   auto pRecorded = static_cast<const ADDR_COMPUTE_HTILE_INFO_OUTPUT *>(pRecord->pSegments[1]);
+   ADDR_COMPUTE_HTILE_INFO_INPUT input;
+   ADDR_COMPUTE_HTILE_INFO_OUTPUT output;
+
+   std::memcpy(&input, pRecord->pSegments[0], sizeof(input));
+   input.pTileInfo = nullptr;
+   std::memset(&output, 0, sizeof(output));
+   output.size = pRecorded->size;
+
+   auto start = std::chrono::steady_clock::now();
+   auto returnCode = AddrComputeHtileInfo(hLib, &input, &output);
+   *pNs = GetReplayNs(start);
+
+   return returnCode == pRecord->returnCode &&
+          (returnCode != ADDR_OK ||
+           (output.pitch == pRecorded->pitch && output.height == pRecorded->height &&
+            output.htileBytes == pRecorded->htileBytes && output.baseAlign == pRecorded->baseAlign &&
+            output.bpp == pRecorded->bpp && output.macroWidth == pRecorded->macroWidth &&
+            output.macroHeight == pRecorded->macroHeight));
+}
+
+
+/**
+***************************************************************************************************
+*   ReplayHtileAddrFromCoord
+*
+*   @brief
+*       Replays an AddrComputeHtileAddrFromCoord record
+*
+*   @return
+*       true if the outputs match the recorded ones
+***************************************************************************************************
+*/
+static bool
+ReplayHtileAddrFromCoord(ADDR_HANDLE hLib,
+                         const ADDR_TRACE_RECORD *pRecord,
+                         uint64_t *pNs)
+{
+   auto pRecorded = static_cast<const ADDR_COMPUTE_HTILE_ADDRFROMCOORD_OUTPUT *>(pRecord->pSegments[1]);
+   ADDR_COMPUTE_HTILE_ADDRFROMCOORD_INPUT input;
+   ADDR_COMPUTE_HTILE_ADDRFROMCOORD_OUTPUT output;
+
+   std::memcpy(&input, pRecord->pSegments[0], sizeof(input));
+   input.pTileInfo = nullptr;
+   std::memset(&output, 0, sizeof(output));
+   output.size = pRecorded->size;
+
+   auto start = std::chrono::steady_clock::now();
+   auto returnCode = AddrComputeHtileAddrFromCoord(hLib, &input, &output);
+   *pNs = GetReplayNs(start);
+
+   return returnCode == pRecord->returnCode &&
+          (returnCode != ADDR_OK ||
+           (output.addr == pRecorded->addr && output.bitPosition == pRecorded->bitPosition));
+}
+
+
+/**
+***************************************************************************************************
+*   ReplayFmaskInfo
+*
+*   @brief
+*       Replays an AddrComputeFmaskInfo record
+*
+*   @return
+*       true if the outputs match the recorded ones
+***************************************************************************************************
+*/
+static bool
+ReplayFmaskInfo(ADDR_HANDLE hLib,
+                const ADDR_TRACE_RECORD *pRecord,
+                uint64_t *pNs)
+{
+   auto pRecorded = static_cast<const ADDR_COMPUTE_FMASK_INFO_OUTPUT *>(pRecord->pSegments[1]);
+   ADDR_COMPUTE_FMASK_INFO_INPUT input;
+   ADDR_COMPUTE_FMASK_INFO_OUTPUT output;
+
+   std::memcpy(&input, pRecord->pSegments[0], sizeof(input));
+   input.pTileInfo = nullptr;
+   std::memset(&output, 0, sizeof(output));
+   output.size = pRecorded->size;
+
+   auto start = std::chrono::steady_clock::now();
+   auto returnCode = AddrComputeFmaskInfo(hLib, &input, &output);
+   *pNs = GetReplayNs(start);
+
+   return returnCode == pRecord->returnCode &&
+          (returnCode != ADDR_OK ||
+           (output.pitch == pRecorded->pitch && output.height == pRecorded->height &&
+            output.numSlices == pRecorded->numSlices && output.fmaskBytes == pRecorded->fmaskBytes &&
+            output.baseAlign == pRecorded->baseAlign && output.pitchAlign == pRecorded->pitchAlign &&
+            output.heightAlign == pRecorded->heightAlign && output.bpp == pRecorded->bpp &&
+            output.bitsPerSample == pRecorded->bitsPerSample && output.tileMode == pRecorded->tileMode));
+}
+
+
+/**
+***************************************************************************************************
+*   ReplayFmaskAddrFromCoord
+*
+*   @brief
+*       Replays an AddrComputeFmaskAddrFromCoord record
+*
+*   @return
+*       true if the outputs match the recorded ones
+***************************************************************************************************
+*/
+static bool
+ReplayFmaskAddrFromCoord(ADDR_HANDLE hLib,
+                         const ADDR_TRACE_RECORD *pRecord,
+                         uint64_t *pNs)
+{
+   auto pRecorded = static_cast<const ADDR_COMPUTE_FMASK_ADDRFROMCOORD_OUTPUT *>(pRecord->pSegments[1]);
+   ADDR_COMPUTE_FMASK_ADDRFROMCOORD_INPUT input;
+   ADDR_COMPUTE_FMASK_ADDRFROMCOORD_OUTPUT output;
+
+   std::memcpy(&input, pRecord->pSegments[0], sizeof(input));
+   input.pTileInfo = nullptr;
+   std::memset(&output, 0, sizeof(output));
+   output.size = pRecorded->size;
+
+   auto start = std::chrono::steady_clock::now();
+   auto returnCode = AddrComputeFmaskAddrFromCoord(hLib, &input, &output);
+   *pNs = GetReplayNs(start);
+
+   return returnCode == pRecord->returnCode &&
+          (returnCode != ADDR_OK ||
+           (output.addr == pRecorded->addr && output.bitPosition == pRecorded->bitPosition));
+}
+
+
+/**
+***************************************************************************************************
+*   ReplayFmaskAddrFromCoordBatch
+*
+*   @brief
+*       Replays an AddrComputeFmaskAddrFromCoordBatch record
+*
+*   @return
+*       true if the outputs match the recorded ones
+***************************************************************************************************
+*/
+static bool
+ReplayFmaskAddrFromCoordBatch(ADDR_HANDLE hLib,
+                              const ADDR_TRACE_RECORD *pRecord,
+                              AddrReplayScratch *pScratch,
+                              uint64_t *pNs)
+{
+   auto pRecorded = static_cast<const ADDR_COMPUTE_FMASK_ADDRFROMCOORD_BATCH_OUTPUT *>(pRecord->pSegments[1]);
+   ADDR_COMPUTE_FMASK_ADDRFROMCOORD_BATCH_INPUT input;
+   ADDR_COMPUTE_FMASK_ADDRFROMCOORD_BATCH_OUTPUT output;
+
+   std::memcpy(&input, pRecord->pSegments[0], sizeof(input));
+   input.pTileInfo = nullptr;
+   input.pX = static_cast<const uint32_t *>(pRecord->segmentBytes[2] ? pRecord->pSegments[2] : nullptr);
+   input.pY = static_cast<const uint32_t *>(pRecord->segmentBytes[3] ? pRecord->pSegments[3] : nullptr);
+   input.pSlice = static_cast<const uint32_t *>(pRecord->segmentBytes[4] ? pRecord->pSegments[4] : nullptr);
+   input.pSample = static_cast<const uint32_t *>(pRecord->segmentBytes[5] ? pRecord->pSegments[5] : nullptr);
+   std::memset(&output, 0, sizeof(output));
+   output.size = pRecorded->size;
+
+   if (pRecorded->pAddr) {
+      pScratch->addr.resize(std::max<size_t>(pScratch->addr.size(), input.numCoords));
+      output.pAddr = pScratch->addr.data();
+   }
+
+   if (pRecorded->pBitPosition) {
+      pScratch->bitPosition.resize(std::max<size_t>(pScratch->bitPosition.size(), input.numCoords));
+      output.pBitPosition = pScratch->bitPosition.data();
+   }
+
+   auto start = std::chrono::steady_clock::now();
+   auto returnCode = AddrComputeFmaskAddrFromCoordBatch(hLib, &input, &output);
+   *pNs = GetReplayNs(start);
+
+   auto numOutCoords = returnCode == ADDR_OK ? input.numCoords : 0;
+
+   return returnCode == pRecord->returnCode &&
+          ReplayArrayMatches(pRecord, 6, output.pAddr, numOutCoords, sizeof(uint64_t)) &&
+          ReplayArrayMatches(pRecord, 7, output.pBitPosition, numOutCoords, sizeof(uint32_t));
+}
+
+
+/**
+***************************************************************************************************
+*   ReplayCmaskInfo
+*
+*   @brief
+*       Replays an AddrComputeCmaskInfo record
+*
+*   @return
+*       true if the outputs match the recorded ones
+***************************************************************************************************
+*/
+static bool
+ReplayCmaskInfo(ADDR_HANDLE hLib,
+                const ADDR_TRACE_RECORD *pRecord,
+                uint64_t *pNs)
+{
+   auto pRecorded = static_cast<const ADDR_COMPUTE_CMASK_INFO_OUTPUT *>(pRecord->pSegments[1]);
+   ADDR_COMPUTE_CMASK_INFO_INPUT input;
+   ADDR_COMPUTE_CMASK_INFO_OUTPUT output;
+
+   std::memcpy(&input, pRecord->pSegments[0], sizeof(input));
+   input.pTileInfo = nullptr;
+   std::memset(&output, 0, sizeof(output));
+   output.size = pRecorded->size;
+
+   auto start = std::chrono::steady_clock::now();
+   auto returnCode = AddrComputeCmaskInfo(hLib, &input, &output);
+   *pNs = GetReplayNs(start);
+
+   return returnCode == pRecord->returnCode &&
+          (returnCode != ADDR_OK ||
+           (output.pitch == pRecorded->pitch && output.height == pRecorded->height &&
+            output.cmaskBytes == pRecorded->cmaskBytes && output.baseAlign == pRecorded->baseAlign &&
+            output.blockMax == pRecorded->blockMax && output.bpp == pRecorded->bpp &&
+            output.macroWidth == pRecorded->macroWidth && output.macroHeight == pRecorded->macroHeight));
+}
+
+
+/**
+***************************************************************************************************
+*   ReplayCmaskAddrFromCoord
+*
+*   @brief
+*       Replays an AddrComputeCmaskAddrFromCoord record
+*
+*   @return
+*       true if the outputs match the recorded ones
+***************************************************************************************************
+*/
+static bool
+ReplayCmaskAddrFromCoord(ADDR_HANDLE hLib,
+                         const ADDR_TRACE_RECORD *pRecord,
+                         uint64_t *pNs)
+{
+   auto pRecorded = static_cast<const ADDR_COMPUTE_CMASK_ADDRFROMCOORD_OUTPUT *>(pRecord->pSegments[1]);
+   ADDR_COMPUTE_CMASK_ADDRFROMCOORD_INPUT input;
+   ADDR_COMPUTE_CMASK_ADDRFROMCOORD_OUTPUT output;
+
+   std::memcpy(&input, pRecord->pSegments[0], sizeof(input));
+   input.pTileInfo = nullptr;
+   std::memset(&output, 0, sizeof(output));
+   output.size = pRecorded->size;
+
+   auto start = std::chrono::steady_clock::now();
+   auto returnCode = AddrComputeCmaskAddrFromCoord(hLib, &input, &output);
+   *pNs = GetReplayNs(start);
+
+   return returnCode == pRecord->returnCode &&
+          (returnCode != ADDR_OK ||
+           (output.addr == pRecorded->addr && output.bitPosition == pRecorded->bitPosition));
+}
+
+
+/**
+***************************************************************************************************
+*   ReplaySliceTileSwizzle
+*
+*   @brief
+*       Replays an AddrComputeSliceSwizzle record
+*
+*   @return
+*       true if the outputs match the recorded ones
+***************************************************************************************************
+*/
+static bool
+ReplaySliceTileSwizzle(ADDR_HANDLE hLib,
+                       const ADDR_TRACE_RECORD *pRecord,
+                       uint64_t *pNs)
+{
+   auto pRecorded = static_cast<const ADDR_COMPUTE_SLICESWIZZLE_OUTPUT *>(pRecord->pSegments[1]);
+   ADDR_COMPUTE_SLICESWIZZLE_INPUT input;
+   ADDR_COMPUTE_SLICESWIZZLE_OUTPUT output;
+
+   std::memcpy(&input, pRecord->pSegments[0], sizeof(input));
+   input.pTileInfo = nullptr;
+   std::memset(&output, 0, sizeof(output));
+   output.size = pRecorded->size;
+
+   auto start = std::chrono::steady_clock::now();
+   auto returnCode = AddrComputeSliceSwizzle(hLib, &input, &output);
+   *pNs = GetReplayNs(start);
+
+   return returnCode == pRecord->returnCode &&
+          (returnCode != ADDR_OK || output.tileSwizzle == pRecorded->tileSwizzle);
+}
+
+
+/**
+***************************************************************************************************
+*   ReplayPixelIndexTable
+*
+*   @brief
+*       Replays an AddrComputePixelIndexTable record, the table pointer is not comparable
+*
+*   @return
+*       true if the return code matches the recorded one
+***************************************************************************************************
+*/
+static bool
+ReplayPixelIndexTable(ADDR_HANDLE hLib,
+                      const ADDR_TRACE_RECORD *pRecord,
+                      uint64_t *pNs)
+{
+   auto pRecorded = static_cast<const ADDR_COMPUTE_PIXEL_INDEX_TABLE_OUTPUT *>(pRecord->pSegments[1]);
+   ADDR_COMPUTE_PIXEL_INDEX_TABLE_INPUT input;
+   ADDR_COMPUTE_PIXEL_INDEX_TABLE_OUTPUT output;
+
+   std::memcpy(&input, pRecord->pSegments[0], sizeof(input));
+   std::memset(&output, 0, sizeof(output));
+   output.size = pRecorded->size;
+
+   auto start = std::chrono::steady_clock::now();
+   auto returnCode = AddrComputePixelIndexTable(hLib, &input, &output);
+   *pNs = GetReplayNs(start);
+
+   return returnCode == pRecord->returnCode;
+}
+
+
+/**
+***************************************************************************************************
+*   ReplayRecord
+*
+*   @brief
+*       Replays one record and times its call
+*
+*   @return
+*       true if the outputs match the recorded ones
+***************************************************************************************************
+*/
+static bool
+ReplayRecord(ADDR_HANDLE hLib,
+             const ADDR_TRACE_RECORD *pRecord,
+             AddrReplayScratch *pScratch,
+             uint64_t *pNs)
+{
+   auto match = false;
+
+   switch (pRecord->entry) {
+   case ADDR_STATS_SURFACE_INFO:
+      match = ReplaySurfaceInfo(hLib, pRecord, pScratch, pNs);
+      break;
+   case ADDR_STATS_MIPCHAIN_INFO:
+      match = ReplayMipChainInfo(hLib, pRecord, pScratch, pNs);
+      break;
+   case ADDR_STATS_SURFACE_ADDRFROMCOORD:
+      match = ReplaySurfaceAddrFromCoord(hLib, pRecord, pNs);
+      break;
+   case ADDR_STATS_SURFACE_ADDRFROMCOORD_BATCH:
+      match = ReplaySurfaceAddrFromCoordBatch(hLib, pRecord, pScratch, pNs);
+      break;
+   case ADDR_STATS_CREATE_SURFACE_PLAN:
+      match = ReplayCreateSurfacePlan(hLib, pRecord, pNs);
+      break;
+   case ADDR_STATS_SURFACE_COORDFROMADDR:
+      match = ReplaySurfaceCoordFromAddr(hLib, pRecord, pNs);
+      break;
+   case ADDR_STATS_SURFACE_COORDFROMADDR_RANGE:
+      match = ReplaySurfaceCoordFromAddrRange(hLib, pRecord, pScratch, pNs);
+      break;
+   case ADDR_STATS_SURFACE_DIRTY_REGIONS:
+      match = ReplaySurfaceDirtyRegions(hLib, pRecord, pScratch, pNs);
+      break;
+   case ADDR_STATS_EXTRACT_BANKPIPE_SWIZZLE:
+      match = ReplayExtractBankPipeSwizzle(hLib, pRecord, pNs);
+      break;
+   case ADDR_STATS_HTILE_INFO:
+      match = ReplayHtileInfo(hLib, pRecord, pNs);
+      break;
+   case ADDR_STATS_HTILE_ADDRFROMCOORD:
+      match = ReplayHtileAddrFromCoord(hLib, pRecord, pNs);
+      break;
+   case ADDR_STATS_FMASK_INFO:
+      match = ReplayFmaskInfo(hLib, pRecord, pNs);
+      break;
+   case ADDR_STATS_FMASK_ADDRFROMCOORD:
+      match = ReplayFmaskAddrFromCoord(hLib, pRecord, pNs);
+      break;
+   case ADDR_STATS_FMASK_ADDRFROMCOORD_BATCH:
+      match = ReplayFmaskAddrFromCoordBatch(hLib, pRecord, pScratch, pNs);
+      break;
+   case ADDR_STATS_CMASK_INFO:
+      match = ReplayCmaskInfo(hLib, pRecord, pNs);
+      break;
+   case ADDR_STATS_CMASK_ADDRFROMCOORD:
+      match = ReplayCmaskAddrFromCoord(hLib, pRecord, pNs);
+      break;
+   case ADDR_STATS_SLICE_SWIZZLE:
+      match = ReplaySliceTileSwizzle(hLib, pRecord, pNs);
+      break;
+   case ADDR_STATS_PIXEL_INDEX_TABLE:
+      match = ReplayPixelIndexTable(hLib, pRecord, pNs);
+      break;
+   default:
+      *pNs = 0;
+   }
+
+   return match;
+}
+
+
+/**
+***************************************************************************************************
+*   RunReplayWorker
+*
+*   @brief
+*       Replays every numWorkers-th record of every iteration, checking outputs in the first
+*
+*   @return
+*       N/A
+***************************************************************************************************
+*/
+static void
+RunReplayWorker(const AddrReplayTasks *pTasks,
+                uint32_t worker)
+{
+   auto pResult = &pTasks->pResults[worker];
+
+   for (auto iteration = 0u; iteration < pTasks->iterations; ++iteration) {
+      for (auto i = uint64_t { worker }; i < pTasks->numRecords; i += pTasks->numWorkers) {
+         auto pRecord = &pTasks->pRecords[i];
+         auto ns = uint64_t { 0 };
+         auto match = ReplayRecord(pTasks->hLib, pRecord, &pResult->scratch, &ns);
+
+         pResult->ns[pRecord->entry].push_back(ns);
+
+         if (!match && iteration == 0) {
+            if (!pResult->mismatches[pRecord->entry]++) {
+               pResult->firstMismatch[pRecord->entry] = i;
+            }
+         }
+      }
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   RunReplayTask
+*
+*   @brief
+*       ADDR_COPY_TASK entry running one replay worker
+*
+*   @return
+*       N/A
+***************************************************************************************************
+*/
+static void
+RunReplayTask(void *pTaskData,
+              uint32_t taskIndex)
+{
+   RunReplayWorker(static_cast<const AddrReplayTasks *>(pTaskData), taskIndex);
+}
+
+
+/**
+***************************************************************************************************
+*   GetReplayPercentile
+*
+*   @brief
+*       Nearest rank percentile of sorted latencies
+*
+*   @return
+*       Latency in nanoseconds
+***************************************************************************************************
+*/
+static uint64_t
+GetReplayPercentile(const std::vector<uint64_t> &ns,
+                    uint32_t percentile)
+{
+   auto rank = (ns.size() * percentile + 99) / 100;
+   return ns[rank ? rank - 1 : 0];
+}
+
+
+/**
+***************************************************************************************************
+*   AddrReplayTrace
+*
+*   @brief
+*       Replay the calls of a trace recorded by AddrStartTrace against hLib, time them and
+*       compare their outputs with the recorded ones
+*
+*   @return
+*       ADDR_OK if the trace was replayed, whether or not outputs mismatched
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrReplayTrace(ADDR_HANDLE hLib,
+                const ADDR_REPLAY_TRACE_INPUT *pIn,
+                ADDR_REPLAY_TRACE_OUTPUT *pOut)
+{
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+   AddrReplayRecords records;
+
+   if (!hLib) {
+      returnCode = ADDR_ERROR;
+   } else if (pIn->size != sizeof(ADDR_REPLAY_TRACE_INPUT) || pOut->size != sizeof(ADDR_REPLAY_TRACE_OUTPUT)) {
+      returnCode = ADDR_PARAMSIZEMISMATCH;
+   }
+
+   if (returnCode == ADDR_OK) {
+      ADDR_READ_TRACE_INPUT readIn;
+      ADDR_READ_TRACE_OUTPUT readOut;
+
+      std::memset(&readIn, 0, sizeof(readIn));
+      std::memset(&readOut, 0, sizeof(readOut));
+      readIn.size = sizeof(readIn);
+      readIn.pData = pIn->pData;
+      readIn.dataSize = pIn->dataSize;
+      readIn.pfnRecord = CollectReplayRecord;
+      readIn.pRecordData = &records;
+      readOut.size = sizeof(readOut);
+      records.numSkipped = 0;
+
+      returnCode = AddrReadTrace(&readIn, &readOut);
+   }
+
+   if (returnCode == ADDR_OK) {
+      std::stable_sort(records.records.begin(), records.records.end(), IsReplayRecordEarlier);
+   }
+
+   if (returnCode == ADDR_OK) {
+      AddrReplayTasks tasks;
+
+      tasks.hLib = hLib;
+      tasks.pRecords = records.records.data();
+      tasks.numRecords = records.records.size();
+      tasks.iterations = std::max(pIn->iterations, 1u);
+      tasks.numWorkers = std::max(pIn->numThreads, 1u);
+
+      std::vector<AddrReplayWorkerResult> results(tasks.numWorkers);
+      tasks.pResults = results.data();
+
+      for (auto &result : results) {
+         std::fill(std::begin(result.mismatches), std::end(result.mismatches), 0);
+         std::fill(std::begin(result.firstMismatch), std::end(result.firstMismatch), ~uint64_t { 0 });
+      }
+
+      auto start = std::chrono::steady_clock::now();
+
+      if (pIn->pExecutor) {
+         pIn->pExecutor(pIn->pExecutorData, RunReplayTask, &tasks, tasks.numWorkers);
+      } else {
+         std::vector<std::thread> threads;
+         auto worker = 1u;
+
+         try {
+            threads.reserve(tasks.numWorkers - 1);
+
+            for (; worker < tasks.numWorkers; ++worker) {
+               threads.emplace_back(RunReplayWorker, &tasks, worker);
+            }
+         } catch (...) {
+            // Run whatever could not get a thread on this one
+         }
+
+         for (auto remaining = worker; remaining < tasks.numWorkers; ++remaining) {
+            RunReplayWorker(&tasks, remaining);
+         }
+
+         RunReplayWorker(&tasks, 0);
+
+         for (auto &thread : threads) {
+            thread.join();
+         }
+      }
+
+      auto wallNs = GetReplayNs(start);
+      auto numCalls = uint64_t { 0 };
+
+      pOut->numRecords = tasks.numRecords;
+      pOut->numSkipped = records.numSkipped;
+      pOut->numMismatches = 0;
+      pOut->wallSeconds = wallNs / 1e9;
+
+      for (auto entry = 0u; entry < ADDR_STATS_ENTRY_COUNT; ++entry) {
+         auto pEntry = &pOut->entries[entry];
+         std::vector<uint64_t> ns;
+         auto totalNs = uint64_t { 0 };
+
+         pEntry->mismatches = 0;
+         pEntry->firstMismatch = ~uint64_t { 0 };
+
+         for (auto &result : results) {
+            ns.insert(ns.end(), result.ns[entry].begin(), result.ns[entry].end());
+            pEntry->mismatches += result.mismatches[entry];
+            pEntry->firstMismatch = std::min(pEntry->firstMismatch, result.firstMismatch[entry]);
+         }
+
+         std::sort(ns.begin(), ns.end());
+
+         for (auto callNs : ns) {
+            totalNs += callNs;
+         }
+
+         pEntry->calls = ns.size();
+         pEntry->callsPerSecond = totalNs ? ns.size() * 1e9 / totalNs : 0.0;
+         pEntry->p50Ns = ns.empty() ? 0 : GetReplayPercentile(ns, 50);
+         pEntry->p90Ns = ns.empty() ? 0 : GetReplayPercentile(ns, 90);
+         pEntry->p99Ns = ns.empty() ? 0 : GetReplayPercentile(ns, 99);
+         pEntry->maxNs = ns.empty() ? 0 : ns.back();
+
+         numCalls += pEntry->calls;
+         pOut->numMismatches += pEntry->mismatches;
+      }
+
+      pOut->callsPerSecond = wallNs ? numCalls * 1e9 / wallNs : 0.0;
+   }
+
+   return returnCode;
+}
@@ -0,0 +1,249 @@
+/*
+ * Copyright  2014 Advanced Micro Devices, Inc.
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sub license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON-INFRINGEMENT. IN NO EVENT SHALL THE COPYRIGHT HOLDERS, AUTHORS
+ * AND/OR ITS SUPPLIERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ */
+
+/**
+***************************************************************************************************
+* @file  addrreplaymain.cpp
+* @brief Command line front end of AddrReplayTrace printing the results of every entry point.
+***************************************************************************************************
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "addrtools.h"
+
+static const char *const ReplayEntryNames[ADDR_STATS_ENTRY_COUNT] = {
+   "SurfaceInfo",
+   "MipChainInfo",
+   "SurfaceAddrFromCoord",
+   "SurfaceAddrFromCoordBatch",
+   "CreateSurfacePlan",
+   "SurfaceCoordFromAddr",
+   "SurfaceCoordFromAddrRange",
+   "SurfaceDirtyRegions",
+   "ExtractBankPipeSwizzle",
+   "HtileInfo",
+   "SliceSwizzle",
+   "PixelIndexTable",
+   "CopyTiledToLinear",
+   "CopyLinearToTiled",
+   "HtileAddrFromCoord",
+   "CopyHtileToLinear",
+   "CopyLinearToHtile",
+   "FmaskInfo",
+   "FmaskAddrFromCoord",
+   "FmaskAddrFromCoordBatch",
+   "CopyFmaskToLinear",
+   "CopyLinearToFmask",
+   "CmaskInfo",
+   "CmaskAddrFromCoord",
+   "CopyCmaskToLinear",
+   "CopyLinearToCmask",
+   "CopyDepthPlanesToLinear",
+   "CopyLinearToDepthPlanes",
+};
+
+
+/**
+***************************************************************************************************
+*   ReplayAllocSysMem
+*
+*   @brief
+*       System memory callback of the replaying library instance
+***************************************************************************************************
+*/
+static void *
+ReplayAllocSysMem(const ADDR_ALLOCSYSMEM_INPUT *pInput)
+{
+   return malloc(pInput->sizeInBytes);
+}
+
+
+/**
+***************************************************************************************************
+*   ReplayFreeSysMem
+*
+*   @brief
+*       System memory callback of the replaying library instance
+***************************************************************************************************
+*/
+static ADDR_E_RETURNCODE
+ReplayFreeSysMem(const ADDR_FREESYSMEM_INPUT *pInput)
+{
+   free(pInput->pVirtAddr);
+   return ADDR_OK;
+}
+
+
+/**
+***************************************************************************************************
+*   ReadTraceFile
+*
+*   @brief
+*       Read a whole trace file into 8 byte aligned storage
+*
+*   @return
+*       true if the file was read, *pDataSize is then its size in bytes
+***************************************************************************************************
+*/
+static bool
+ReadTraceFile(const char *pPath,
+              std::vector<uint64_t> *pData,
+              uint64_t *pDataSize)
+{
+   auto pFile = fopen(pPath, "rb");
+
+   if (!pFile) {
+      return false;
+   }
+
+   auto read = true;
+   long fileSize = -1;
+
+   if (fseek(pFile, 0, SEEK_END) == 0) {
+      fileSize = ftell(pFile);
+   }
+
+   if (fileSize < 0 || fseek(pFile, 0, SEEK_SET) != 0) {
+      read = false;
+   } else {
+      pData->resize((static_cast<size_t>(fileSize) + 7) / 8);
+      read = fread(pData->data(), 1, static_cast<size_t>(fileSize), pFile) == static_cast<size_t>(fileSize);
+      *pDataSize = static_cast<uint64_t>(fileSize);
+   }
+
+   fclose(pFile);
+   return read;
+}
+
+
+/**
+***************************************************************************************************
+*   main
+*
+*   @brief
+*       addrreplay traceFile [numThreads [iterations]]
+*
+*       Replays a trace recorded by AddrStartTrace on a library created from its recorded
+*       ADDR_CREATE_INPUT and prints the calls, latency percentiles and mismatches of every
+*       replayed entry point. Returns non-zero when an output differs from the recorded one.
+***************************************************************************************************
+*/
+int
+main(int argc, char **argv)
+{
+   if (argc < 2 || argc > 4) {
+      fprintf(stderr, "usage: %s traceFile [numThreads [iterations]]\n", argv[0]);
+      return EXIT_FAILURE;
+   }
+
+   std::vector<uint64_t> data;
+   uint64_t dataSize = 0;
+
+   if (!ReadTraceFile(argv[1], &data, &dataSize)) {
+      fprintf(stderr, "could not read %s\n", argv[1]);
+      return EXIT_FAILURE;
+   }
+
+   ADDR_READ_TRACE_INPUT readIn;
+   ADDR_READ_TRACE_OUTPUT readOut;
+   memset(&readIn, 0, sizeof(readIn));
+   memset(&readOut, 0, sizeof(readOut));
+   readIn.size = sizeof(readIn);
+   readIn.pData = data.data();
+   readIn.dataSize = dataSize;
+   readOut.size = sizeof(readOut);
+
+   if (AddrReadTrace(&readIn, &readOut) != ADDR_OK) {
+      fprintf(stderr, "%s is not a valid trace\n", argv[1]);
+      return EXIT_FAILURE;
+   }
+
+   // The recorded callbacks, client handle and tile config pointer belong to the recording
+   // process
+   ADDR_CREATE_INPUT createIn = *readOut.pCreateIn;
+   ADDR_CREATE_OUTPUT createOut;
+   memset(&createIn.callbacks, 0, sizeof(createIn.callbacks));
+   memset(&createOut, 0, sizeof(createOut));
+   createIn.hClient = nullptr;
+   createIn.regValue.pTileConfig = nullptr;
+   createIn.regValue.noOfEntries = 0;
+   createIn.callbacks.allocSysMem = ReplayAllocSysMem;
+   createIn.callbacks.freeSysMem = ReplayFreeSysMem;
+   createOut.size = sizeof(createOut);
+
+   if (AddrCreate(&createIn, &createOut) != ADDR_OK) {
+      fprintf(stderr, "could not create a library instance from the recorded input\n");
+      return EXIT_FAILURE;
+   }
+
+   ADDR_REPLAY_TRACE_INPUT replayIn;
+   ADDR_REPLAY_TRACE_OUTPUT replayOut;
+   memset(&replayIn, 0, sizeof(replayIn));
+   memset(&replayOut, 0, sizeof(replayOut));
+   replayIn.size = sizeof(replayIn);
+   replayIn.pData = data.data();
+   replayIn.dataSize = dataSize;
+   replayIn.numThreads = argc > 2 ? static_cast<uint32_t>(strtoul(argv[2], nullptr, 0)) : 1u;
+   replayIn.iterations = argc > 3 ? static_cast<uint32_t>(strtoul(argv[3], nullptr, 0)) : 1u;
+   replayOut.size = sizeof(replayOut);
+
+   auto returnCode = AddrReplayTrace(createOut.hLib, &replayIn, &replayOut);
+   AddrDestroy(createOut.hLib);
+
+   if (returnCode != ADDR_OK) {
+      fprintf(stderr, "replay failed with %d\n", returnCode);
+      return EXIT_FAILURE;
+   }
+
+   printf("%llu records, %llu skipped, %llu mismatches, %.3f s, %.0f calls/s\n",
+          static_cast<unsigned long long>(replayOut.numRecords), static_cast<unsigned long long>(replayOut.numSkipped),
+          static_cast<unsigned long long>(replayOut.numMismatches), replayOut.wallSeconds, replayOut.callsPerSecond);
+   printf("%-26s %10s %12s %8s %8s %8s %8s %10s\n", "entry", "calls", "calls/s", "p50 ns", "p90 ns", "p99 ns",
+          "max ns", "mismatches");
+
+   for (auto i = 0u; i < ADDR_STATS_ENTRY_COUNT; ++i) {
+      const auto &entry = replayOut.entries[i];
+
+      if (!entry.calls) {
+         continue;
+      }
+
+      printf("%-26s %10llu %12.0f %8llu %8llu %8llu %8llu %10llu\n", ReplayEntryNames[i],
+             static_cast<unsigned long long>(entry.calls), entry.callsPerSecond,
+             static_cast<unsigned long long>(entry.p50Ns), static_cast<unsigned long long>(entry.p90Ns),
+             static_cast<unsigned long long>(entry.p99Ns), static_cast<unsigned long long>(entry.maxNs),
+             static_cast<unsigned long long>(entry.mismatches));
+
+      if (entry.mismatches) {
+         printf("%-26s first mismatch at record %llu\n", "", static_cast<unsigned long long>(entry.firstMismatch));
+      }
+   }
+
+   return replayOut.numMismatches ? EXIT_FAILURE : EXIT_SUCCESS;
+}
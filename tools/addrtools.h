@@ -0,0 +1,372 @@
+/*
+ * Copyright  2014 Advanced Micro Devices, Inc.
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sub license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON-INFRINGEMENT. IN NO EVENT SHALL THE COPYRIGHT HOLDERS, AUTHORS
+ * AND/OR ITS SUPPLIERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ */
+
+/**
+***************************************************************************************************
+* @file  addrtools.h
+* @brief Contains the benchmark and verification tools built on top of the addrlib interface
+* @note  The tools are not part of the library, they link against it and fill the size fields
+*        of their own structures. Their own buffers and threads come from the C++ runtime, not
+*        from the ADDR_CALLBACKS of the library instances they use.
+***************************************************************************************************
+*/
+
+#pragma once
+#include "addrlib/addrinterface.h"
+
+
+/**
+***************************************************************************************************
+*   AddrBenchmarkEntry
+*
+*   @brief
+*       Entry points measured by AddrRunBenchmark, bit (1 << entry) of
+*       ADDR_RUN_BENCHMARK_INPUT::entryMask selects an entry point
+***************************************************************************************************
+*/
+enum AddrBenchmarkEntry : uint32_t
+{
+   ADDR_BENCHMARK_SURFACE_INFO = 0x0,
+   ADDR_BENCHMARK_SURFACE_ADDRFROMCOORD = 0x1,
+   ADDR_BENCHMARK_HTILE_INFO = 0x2,
+   ADDR_BENCHMARK_EXTRACT_BANKPIPE_SWIZZLE = 0x3,
+   ADDR_BENCHMARK_SLICE_SWIZZLE = 0x4,
+   ADDR_BENCHMARK_COPY_TILED_TO_LINEAR = 0x5,
+   ADDR_BENCHMARK_COPY_LINEAR_TO_TILED = 0x6,
+   ADDR_BENCHMARK_ENTRY_COUNT = 0x7,
+};
+
+
+/**
+***************************************************************************************************
+*   AddrVerifyPath
+*
+*   @brief
+*       Fast paths AddrVerifyAddressPaths compares against the per element
+*       AddrComputeSurfaceAddrFromCoord
+***************************************************************************************************
+*/
+enum AddrVerifyPath : uint32_t
+{
+   ADDR_VERIFY_LOOKUP_TABLES = 0x0,
+   ADDR_VERIFY_SURFACE_PLAN = 0x1,
+   ADDR_VERIFY_ADDRFROMCOORD_BATCH = 0x2,
+   ADDR_VERIFY_COPY_TILED_TO_LINEAR = 0x3,
+   ADDR_VERIFY_COPY_LINEAR_TO_TILED = 0x4,
+   ADDR_VERIFY_PATH_COUNT = 0x5,
+};
+
+
+/**
+***************************************************************************************************
+*   ADDR_RUN_BENCHMARK_INPUT
+*
+*   @brief
+*       Input structure for AddrRunBenchmark
+*   @note
+*       entryMask selects the AddrBenchmarkEntry entry points to measure, 0 measures all of
+*       them. iterations is the number of calls timed per result of the per call entry points
+*       and copyIterations the number of copies timed per result of the bulk copies, 0 picks
+*       1000 and 4. Surfaces are swept from 64x64 up to maxSize x maxSize in steps of 4x,
+*       0 picks 1024.
+***************************************************************************************************
+*/
+struct ADDR_RUN_BENCHMARK_INPUT
+{
+   uint32_t size;
+   uint32_t entryMask;
+   uint32_t iterations;
+   uint32_t copyIterations;
+   uint32_t maxSize;
+};
+
+
+/**
+***************************************************************************************************
+*   ADDR_BENCHMARK_RESULT
+*
+*   @brief
+*       Timing of one entry point for one surface of the AddrRunBenchmark sweep
+*   @note
+*       Fields which do not apply to an entry point are 0, gbPerSecond is only set for the
+*       bulk copies and counts the bytes of the linear image.
+***************************************************************************************************
+*/
+struct ADDR_BENCHMARK_RESULT
+{
+   AddrBenchmarkEntry entry;
+   AddrTileMode tileMode;
+   uint32_t bpp;
+   uint32_t numSamples;
+   uint32_t width;
+   uint32_t height;
+   uint64_t calls;
+   double nsPerCall;
+   double gbPerSecond;
+};
+
+
+/**
+***************************************************************************************************
+*   ADDR_RUN_BENCHMARK_OUTPUT
+*
+*   @brief
+*       Output structure for AddrRunBenchmark
+*   @note
+*       The client provides the maxResults entries long pResults array, numResults returns
+*       how many results the sweep has even when that is more than maxResults. Results come
+*       in a fixed order for a given input so runs of different builds can be compared
+*       entry by entry.
+***************************************************************************************************
+*/
+struct ADDR_RUN_BENCHMARK_OUTPUT
+{
+   uint32_t size;
+   uint32_t maxResults;
+   ADDR_BENCHMARK_RESULT *pResults;
+   uint32_t numResults;
+};
+
+
+/**
+***************************************************************************************************
+*   AddrRunBenchmark
+*
+*   @brief
+*       Time the public entry points over a sweep of tile modes, bpp, sample counts and
+*       surface sizes
+*   @return
+*       ADDR_OK if no error
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrRunBenchmark(ADDR_HANDLE hLib, const ADDR_RUN_BENCHMARK_INPUT *pIn, ADDR_RUN_BENCHMARK_OUTPUT *pOut);
+
+
+/**
+***************************************************************************************************
+*   ADDR_VERIFY_ADDRESS_PATHS_INPUT
+*
+*   @brief
+*       Input structure for AddrVerifyAddressPaths
+*   @note
+*       Every configuration is created from *pCreateIn with its gbAddrConfig replaced by one
+*       of the numConfigs pGbAddrConfigs, or by every valid tiling configuration of the chip
+*       engine when pGbAddrConfigs is nullptr.
+*
+*       numSurfaces random surfaces, 0 picks 8, of every configuration are checked at every
+*       element, slice and sample. The same seed checks the same surfaces.
+*
+*       Configurations are split into tasks which run on pExecutor when one is given,
+*       otherwise on numThreads threads created by the library.
+***************************************************************************************************
+*/
+struct ADDR_VERIFY_ADDRESS_PATHS_INPUT
+{
+   uint32_t size;
+   const ADDR_CREATE_INPUT *pCreateIn;
+   uint32_t numConfigs;
+   const uint32_t *pGbAddrConfigs;
+   uint32_t numSurfaces;
+   uint32_t seed;
+   uint32_t numThreads;
+   ADDR_COPY_EXECUTOR pExecutor;
+   void *pExecutorData;
+};
+
+
+/**
+***************************************************************************************************
+*   ADDR_ADDRESS_MISMATCH
+*
+*   @brief
+*       Element whose fast path address differs from AddrComputeSurfaceAddrFromCoord
+*   @note
+*       For the bulk copies fastAddr is the byte offset of the element in the linear buffer
+*       and fastBitPosition is 0. Lookup table mismatches only set gbAddrConfig, path, x and y.
+***************************************************************************************************
+*/
+struct ADDR_ADDRESS_MISMATCH
+{
+   uint32_t gbAddrConfig;
+   AddrVerifyPath path;
+   AddrTileMode tileMode;
+   uint32_t bpp;
+   uint32_t pitch;
+   uint32_t height;
+   uint32_t numSlices;
+   uint32_t numSamples;
+   bool isDepth;
+   uint32_t pipeSwizzle;
+   uint32_t bankSwizzle;
+   uint32_t x;
+   uint32_t y;
+   uint32_t slice;
+   uint32_t sample;
+   uint64_t refAddr;
+   uint32_t refBitPosition;
+   uint64_t fastAddr;
+   uint32_t fastBitPosition;
+};
+
+
+/**
+***************************************************************************************************
+*   ADDR_VERIFY_ADDRESS_PATHS_OUTPUT
+*
+*   @brief
+*       Output structure for AddrVerifyAddressPaths
+*   @note
+*       pMismatches is provided by the client and holds up to maxMismatches entries, it gets
+*       the first mismatch of every path of every failing configuration in configuration order.
+*       numMismatches counts every mismatching element.
+***************************************************************************************************
+*/
+struct ADDR_VERIFY_ADDRESS_PATHS_OUTPUT
+{
+   uint32_t size;
+   uint32_t maxMismatches;
+   ADDR_ADDRESS_MISMATCH *pMismatches;
+   uint32_t numConfigs;
+   uint32_t numFailedConfigs;
+   uint64_t numSurfaces;
+   uint64_t numChecks;
+   uint64_t numMismatches;
+   uint32_t numStoredMismatches;
+};
+
+
+/**
+***************************************************************************************************
+*   AddrVerifyAddressPaths
+*
+*   @brief
+*       Compare the lookup tables, surface plans, batch lookups and bulk copies against the
+*       per element AddrComputeSurfaceAddrFromCoord over random surfaces of many tiling
+*       configurations
+*   @return
+*       ADDR_OK if no error, the comparison results are in pOut
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrVerifyAddressPaths(const ADDR_VERIFY_ADDRESS_PATHS_INPUT *pIn, ADDR_VERIFY_ADDRESS_PATHS_OUTPUT *pOut);
+
+
+/**
+***************************************************************************************************
+*   ADDR_REPLAY_TRACE_INPUT
+*
+*   @brief
+*       Input structure for AddrReplayTrace
+*   @note
+*       The records of the pData stream are replayed in start time order, iterations times,
+*       0 picks 1. pTileInfo pointers are not recorded, so they are replayed as nullptr.
+*       Copies are skipped since the trace does not hold the surface contents.
+*
+*       Record i of an iteration runs on worker i % numThreads, numThreads 0 picks 1. The
+*       workers run on pExecutor when one is given, otherwise on threads created by the
+*       library.
+***************************************************************************************************
+*/
+struct ADDR_REPLAY_TRACE_INPUT
+{
+   uint32_t size;
+   const void *pData;            ///< Whole stream, 8 byte aligned
+   uint64_t dataSize;
+   uint32_t iterations;
+   uint32_t numThreads;
+   ADDR_COPY_EXECUTOR pExecutor;
+   void *pExecutorData;
+};
+
+
+/**
+***************************************************************************************************
+*   ADDR_REPLAY_ENTRY_RESULT
+*
+*   @brief
+*       Replay results of one entry point
+*   @note
+*       Latencies are of single calls over every iteration and include reading the clock.
+*       callsPerSecond is per thread, calls divided by the summed latency. Mismatches are
+*       checked in the first iteration, firstMismatch is the index of the first mismatching
+*       record in start time order, ~0 if there is none.
+***************************************************************************************************
+*/
+struct ADDR_REPLAY_ENTRY_RESULT
+{
+   uint64_t calls;
+   double callsPerSecond;
+   uint64_t p50Ns;
+   uint64_t p90Ns;
+   uint64_t p99Ns;
+   uint64_t maxNs;
+   uint64_t mismatches;
+   uint64_t firstMismatch;
+};
+
+
+/**
+***************************************************************************************************
+*   ADDR_REPLAY_TRACE_OUTPUT
+*
+*   @brief
+*       Output structure for AddrReplayTrace
+*   @note
+*       A record mismatches when its return code or any recorded output differs from the
+*       replayed one. callsPerSecond counts the calls of every thread over wallSeconds.
+***************************************************************************************************
+*/
+struct ADDR_REPLAY_TRACE_OUTPUT
+{
+   uint32_t size;
+   uint64_t numRecords;          ///< Records replayed per iteration
+   uint64_t numSkipped;          ///< Records which cannot be replayed
+   uint64_t numMismatches;
+   double wallSeconds;
+   double callsPerSecond;
+   ADDR_REPLAY_ENTRY_RESULT entries[ADDR_STATS_ENTRY_COUNT];
+};
+
+
+/**
+***************************************************************************************************
+*   AddrReplayTrace
+*
+*   @brief
+*       Replay the calls of a trace recorded by AddrStartTrace against hLib, time them and
+*       compare their outputs with the recorded ones
+*
+*   @note
+*       hLib is usually created from the ADDR_CREATE_INPUT AddrReadTrace returns, with the
+*       callbacks of the replaying client.
+*
+*   @return
+*       ADDR_OK if the trace was replayed, whether or not outputs mismatched
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrReplayTrace(ADDR_HANDLE hLib, const ADDR_REPLAY_TRACE_INPUT *pIn, ADDR_REPLAY_TRACE_OUTPUT *pOut);
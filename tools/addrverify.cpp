@@ -0,0 +1,734 @@
+/*
+ * Copyright  2014 Advanced Micro Devices, Inc.
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sub license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON-INFRINGEMENT. IN NO EVENT SHALL THE COPYRIGHT HOLDERS, AUTHORS
+ * AND/OR ITS SUPPLIERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ */
+
+/**
+***************************************************************************************************
+* @file  addrverify.cpp
+* @brief Contains AddrVerifyAddressPaths, which checks the fast address paths against the per
+*        element AddrComputeSurfaceAddrFromCoord.
+***************************************************************************************************
+*/
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "addrtools.h"
+
+// The lookup tables and the tiling configurations are not reachable through the interface
+#include "core/addrlib.h"
+
+static const uint32_t VerifyDefaultSurfaces = 8;
+static const uint32_t VerifyMaxSize = 128;
+static const uint32_t VerifyMaxSlices = 4;
+
+static const uint32_t VerifyBpps[] = { 8, 16, 24, 32, 48, 64, 96, 128 };
+
+
+/**
+***************************************************************************************************
+* @brief Results of the verification of one tiling configuration
+***************************************************************************************************
+*/
+struct AddrVerifyConfigResult
+{
+   bool created;
+   uint64_t numSurfaces;
+   uint64_t numChecks;
+   uint64_t numMismatches[ADDR_VERIFY_PATH_COUNT];
+   ADDR_ADDRESS_MISMATCH firstMismatch[ADDR_VERIFY_PATH_COUNT];
+};
+
+
+/**
+***************************************************************************************************
+* @brief State shared by the tasks of one AddrVerifyAddressPaths call
+***************************************************************************************************
+*/
+struct AddrVerifyTasks
+{
+   const ADDR_VERIFY_ADDRESS_PATHS_INPUT *pIn;
+   const uint32_t *pConfigs;
+   uint32_t numConfigs;
+   uint32_t numWorkers;
+   AddrVerifyConfigResult *pResults;
+};
+
+
+/**
+***************************************************************************************************
+* @brief Surface under verification and the reference address of each of its elements
+***************************************************************************************************
+*/
+struct AddrVerifySurface
+{
+   ADDR_ADDRESS_MISMATCH desc;
+   uint64_t surfSize;
+   std::vector<uint64_t> refAddr;
+   std::vector<uint8_t> refBitPosition;
+};
+
+
+/**
+***************************************************************************************************
+*   NextVerifyRandom
+*
+*   @brief
+*       xorshift64* step of the surface generator
+*
+*   @return
+*       32 random bits
+***************************************************************************************************
+*/
+static uint32_t
+NextVerifyRandom(uint64_t *pState)
+{
+   *pState ^= *pState >> 12;
+   *pState ^= *pState << 25;
+   *pState ^= *pState >> 27;
+   return static_cast<uint32_t>((*pState * 0x2545F4914F6CDD1Dull) >> 32);
+}
+
+
+/**
+***************************************************************************************************
+*   GetVerifyElementIndex
+*
+*   @brief
+*       Returns the index of an element in the reference arrays, which are laid out like the
+*       linear buffer of a bulk copy
+*
+*   @return
+*       Element index
+***************************************************************************************************
+*/
+static inline uint64_t
+GetVerifyElementIndex(const ADDR_ADDRESS_MISMATCH *pDesc,
+                      uint32_t x,
+                      uint32_t y,
+                      uint32_t slice,
+                      uint32_t sample)
+{
+   auto image = static_cast<uint64_t>(slice) + static_cast<uint64_t>(sample) * pDesc->numSlices;
+   return (image * pDesc->height + y) * pDesc->pitch + x;
+}
+
+
+/**
+***************************************************************************************************
+*   AddVerifyMismatch
+*
+*   @brief
+*       Counts a mismatching element and keeps the first one of its path
+*
+*   @return
+*       N/A
+***************************************************************************************************
+*/
+static void
+AddVerifyMismatch(AddrVerifyConfigResult *pResult,
+                  const AddrVerifySurface *pSurface,
+                  AddrVerifyPath path,
+                  uint64_t index,
+                  uint64_t fastAddr,
+                  uint32_t fastBitPosition)
+{
+   if (pResult->numMismatches[path]++ == 0) {
+      auto pDesc = &pSurface->desc;
+      auto pMismatch = &pResult->firstMismatch[path];
+      auto imageSize = static_cast<uint64_t>(pDesc->pitch) * pDesc->height;
+      auto image = index / imageSize;
+
+      *pMismatch = *pDesc;
+      pMismatch->path = path;
+      pMismatch->x = static_cast<uint32_t>(index % pDesc->pitch);
+      pMismatch->y = static_cast<uint32_t>(index / pDesc->pitch % pDesc->height);
+      pMismatch->slice = static_cast<uint32_t>(image % pDesc->numSlices);
+      pMismatch->sample = static_cast<uint32_t>(image / pDesc->numSlices);
+      pMismatch->refAddr = pSurface->refAddr[index];
+      pMismatch->refBitPosition = pSurface->refBitPosition[index];
+      pMismatch->fastAddr = fastAddr;
+      pMismatch->fastBitPosition = fastBitPosition;
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   CreateVerifySurface
+*
+*   @brief
+*       Picks a random surface, pads it with AddrComputeSurfaceInfo and computes the reference
+*       address of every element with AddrComputeSurfaceAddrFromCoord
+*
+*   @return
+*       false when the library rejects the surface
+***************************************************************************************************
+*/
+static bool
+CreateVerifySurface(ADDR_HANDLE hLib,
+                    uint64_t *pRandom,
+                    AddrVerifySurface *pSurface)
+{
+   ADDR_COMPUTE_SURFACE_INFO_INPUT infoIn;
+   ADDR_COMPUTE_SURFACE_INFO_OUTPUT infoOut;
+   ADDR_EXTRACT_BANKPIPE_SWIZZLE_INPUT swizzleIn;
+   ADDR_EXTRACT_BANKPIPE_SWIZZLE_OUTPUT swizzleOut;
+   auto pDesc = &pSurface->desc;
+
+   std::memset(&infoIn, 0, sizeof(ADDR_COMPUTE_SURFACE_INFO_INPUT));
+   std::memset(&infoOut, 0, sizeof(ADDR_COMPUTE_SURFACE_INFO_OUTPUT));
+   infoIn.size = sizeof(ADDR_COMPUTE_SURFACE_INFO_INPUT);
+   infoIn.tileMode = static_cast<AddrTileMode>(NextVerifyRandom(pRandom) % (ADDR_TM_3B_TILED_THICK + 1));
+   infoIn.bpp = VerifyBpps[NextVerifyRandom(pRandom) % (sizeof(VerifyBpps) / sizeof(VerifyBpps[0]))];
+   infoIn.numSamples = 1u << (NextVerifyRandom(pRandom) % 4);
+   infoIn.width = 1 + NextVerifyRandom(pRandom) % VerifyMaxSize;
+   infoIn.height = 1 + NextVerifyRandom(pRandom) % VerifyMaxSize;
+   infoIn.numSlices = 1 + NextVerifyRandom(pRandom) % VerifyMaxSlices;
+   infoIn.flags.depth = (NextVerifyRandom(pRandom) % 4) == 0;
+   infoIn.flags.volume = infoIn.numSlices > 1;
+   infoIn.flags.inputBaseMap = 1;
+   infoIn.tileIndex = -1;
+   infoOut.size = sizeof(ADDR_COMPUTE_SURFACE_INFO_OUTPUT);
+
+   std::memset(&swizzleIn, 0, sizeof(ADDR_EXTRACT_BANKPIPE_SWIZZLE_INPUT));
+   std::memset(&swizzleOut, 0, sizeof(ADDR_EXTRACT_BANKPIPE_SWIZZLE_OUTPUT));
+   swizzleIn.size = sizeof(ADDR_EXTRACT_BANKPIPE_SWIZZLE_INPUT);
+   swizzleIn.base256b = NextVerifyRandom(pRandom);
+   swizzleIn.tileIndex = -1;
+   swizzleOut.size = sizeof(ADDR_EXTRACT_BANKPIPE_SWIZZLE_OUTPUT);
+
+   if (AddrComputeSurfaceInfo(hLib, &infoIn, &infoOut) != ADDR_OK
+    || AddrExtractBankPipeSwizzle(hLib, &swizzleIn, &swizzleOut) != ADDR_OK) {
+      return false;
+   }
+
+   std::memset(pDesc, 0, sizeof(ADDR_ADDRESS_MISMATCH));
+   pDesc->tileMode = infoOut.tileMode;
+   pDesc->bpp = infoOut.bpp;
+   pDesc->pitch = infoOut.pitch;
+   pDesc->height = infoOut.height;
+   pDesc->numSlices = infoOut.depth;
+   pDesc->numSamples = infoIn.numSamples;
+   pDesc->isDepth = infoIn.flags.depth;
+   pDesc->pipeSwizzle = swizzleOut.pipeSwizzle;
+   pDesc->bankSwizzle = swizzleOut.bankSwizzle;
+   pSurface->surfSize = infoOut.surfSize;
+
+   ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_INPUT addrIn;
+   ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_OUTPUT addrOut;
+   auto numElements = GetVerifyElementIndex(pDesc, 0, 0, 0, pDesc->numSamples);
+
+   std::memset(&addrIn, 0, sizeof(ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_INPUT));
+   std::memset(&addrOut, 0, sizeof(ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_OUTPUT));
+   addrIn.size = sizeof(ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_INPUT);
+   addrIn.bpp = pDesc->bpp;
+   addrIn.pitch = pDesc->pitch;
+   addrIn.height = pDesc->height;
+   addrIn.numSlices = pDesc->numSlices;
+   addrIn.numSamples = pDesc->numSamples;
+   addrIn.tileMode = pDesc->tileMode;
+   addrIn.isDepth = pDesc->isDepth;
+   addrIn.pipeSwizzle = pDesc->pipeSwizzle;
+   addrIn.bankSwizzle = pDesc->bankSwizzle;
+   addrIn.tileIndex = -1;
+   addrOut.size = sizeof(ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_OUTPUT);
+
+   pSurface->refAddr.resize(static_cast<size_t>(numElements));
+   pSurface->refBitPosition.resize(static_cast<size_t>(numElements));
+
+   for (auto index = uint64_t { 0 }; index < numElements; ++index) {
+      auto image = index / (static_cast<uint64_t>(pDesc->pitch) * pDesc->height);
+
+      addrIn.x = static_cast<uint32_t>(index % pDesc->pitch);
+      addrIn.y = static_cast<uint32_t>(index / pDesc->pitch % pDesc->height);
+      addrIn.slice = static_cast<uint32_t>(image % pDesc->numSlices);
+      addrIn.sample = static_cast<uint32_t>(image / pDesc->numSlices);
+
+      if (AddrComputeSurfaceAddrFromCoord(hLib, &addrIn, &addrOut) != ADDR_OK) {
+         return false;
+      }
+
+      pSurface->refAddr[index] = addrOut.addr;
+      pSurface->refBitPosition[index] = static_cast<uint8_t>(addrOut.bitPosition);
+   }
+
+   return true;
+}
+
+
+/**
+***************************************************************************************************
+*   VerifySurfacePlan
+*
+*   @brief
+*       Compares AddrPlanAddrFromCoord against the reference addresses
+*
+*   @return
+*       N/A
+***************************************************************************************************
+*/
+static void
+VerifySurfacePlan(ADDR_HANDLE hLib,
+                  const AddrVerifySurface *pSurface,
+                  AddrVerifyConfigResult *pResult)
+{
+   ADDR_CREATE_SURFACE_PLAN_INPUT planIn;
+   ADDR_CREATE_SURFACE_PLAN_OUTPUT planOut;
+   auto pDesc = &pSurface->desc;
+
+   std::memset(&planIn, 0, sizeof(ADDR_CREATE_SURFACE_PLAN_INPUT));
+   std::memset(&planOut, 0, sizeof(ADDR_CREATE_SURFACE_PLAN_OUTPUT));
+   planIn.size = sizeof(ADDR_CREATE_SURFACE_PLAN_INPUT);
+   planIn.bpp = pDesc->bpp;
+   planIn.pitch = pDesc->pitch;
+   planIn.height = pDesc->height;
+   planIn.numSlices = pDesc->numSlices;
+   planIn.numSamples = pDesc->numSamples;
+   planIn.tileMode = pDesc->tileMode;
+   planIn.isDepth = pDesc->isDepth;
+   planIn.pipeSwizzle = pDesc->pipeSwizzle;
+   planIn.bankSwizzle = pDesc->bankSwizzle;
+   planIn.tileIndex = -1;
+   planOut.size = sizeof(ADDR_CREATE_SURFACE_PLAN_OUTPUT);
+
+   if (AddrCreateSurfacePlan(hLib, &planIn, &planOut) != ADDR_OK) {
+      AddVerifyMismatch(pResult, pSurface, ADDR_VERIFY_SURFACE_PLAN, 0, 0, 0);
+      return;
+   }
+
+   for (auto index = uint64_t { 0 }; index < pSurface->refAddr.size(); ++index) {
+      auto image = index / (static_cast<uint64_t>(pDesc->pitch) * pDesc->height);
+      uint32_t bitPosition;
+      auto addr = AddrPlanAddrFromCoord(planOut.hPlan,
+                                        static_cast<uint32_t>(index % pDesc->pitch),
+                                        static_cast<uint32_t>(index / pDesc->pitch % pDesc->height),
+                                        static_cast<uint32_t>(image % pDesc->numSlices),
+                                        static_cast<uint32_t>(image / pDesc->numSlices),
+                                        &bitPosition);
+
+      if (addr != pSurface->refAddr[index] || bitPosition != pSurface->refBitPosition[index]) {
+         AddVerifyMismatch(pResult, pSurface, ADDR_VERIFY_SURFACE_PLAN, index, addr, bitPosition);
+      }
+   }
+
+   AddrDestroySurfacePlan(hLib, planOut.hPlan);
+   pResult->numChecks += pSurface->refAddr.size();
+}
+
+
+/**
+***************************************************************************************************
+*   VerifyAddrFromCoordBatch
+*
+*   @brief
+*       Compares one AddrComputeSurfaceAddrFromCoordBatch of every element against the
+*       reference addresses
+*
+*   @return
+*       N/A
+***************************************************************************************************
+*/
+static void
+VerifyAddrFromCoordBatch(ADDR_HANDLE hLib,
+                         const AddrVerifySurface *pSurface,
+                         AddrVerifyConfigResult *pResult)
+{
+   ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_INPUT batchIn;
+   ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_OUTPUT batchOut;
+   auto pDesc = &pSurface->desc;
+   auto numElements = pSurface->refAddr.size();
+   std::vector<uint32_t> coords(numElements * 4);
+   std::vector<uint64_t> addr(numElements);
+   std::vector<uint32_t> bitPosition(numElements);
+
+   for (auto index = size_t { 0 }; index < numElements; ++index) {
+      auto image = index / (static_cast<size_t>(pDesc->pitch) * pDesc->height);
+
+      coords[index] = static_cast<uint32_t>(index % pDesc->pitch);
+      coords[numElements + index] = static_cast<uint32_t>(index / pDesc->pitch % pDesc->height);
+      coords[2 * numElements + index] = static_cast<uint32_t>(image % pDesc->numSlices);
+      coords[3 * numElements + index] = static_cast<uint32_t>(image / pDesc->numSlices);
+   }
+
+   std::memset(&batchIn, 0, sizeof(ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_INPUT));
+   std::memset(&batchOut, 0, sizeof(ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_OUTPUT));
+   batchIn.size = sizeof(ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_INPUT);
+   batchIn.numCoords = static_cast<uint32_t>(numElements);
+   batchIn.pX = coords.data();
+   batchIn.pY = coords.data() + numElements;
+   batchIn.pSlice = coords.data() + 2 * numElements;
+   batchIn.pSample = coords.data() + 3 * numElements;
+   batchIn.bpp = pDesc->bpp;
+   batchIn.pitch = pDesc->pitch;
+   batchIn.height = pDesc->height;
+   batchIn.numSlices = pDesc->numSlices;
+   batchIn.numSamples = pDesc->numSamples;
+   batchIn.tileMode = pDesc->tileMode;
+   batchIn.isDepth = pDesc->isDepth;
+   batchIn.pipeSwizzle = pDesc->pipeSwizzle;
+   batchIn.bankSwizzle = pDesc->bankSwizzle;
+   batchIn.tileIndex = -1;
+   batchOut.size = sizeof(ADDR_COMPUTE_SURFACE_ADDRFROMCOORD_BATCH_OUTPUT);
+   batchOut.pAddr = addr.data();
+   batchOut.pBitPosition = bitPosition.data();
+
+   if (AddrComputeSurfaceAddrFromCoordBatch(hLib, &batchIn, &batchOut) != ADDR_OK) {
+      AddVerifyMismatch(pResult, pSurface, ADDR_VERIFY_ADDRFROMCOORD_BATCH, 0, 0, 0);
+      return;
+   }
+
+   for (auto index = size_t { 0 }; index < numElements; ++index) {
+      if (addr[index] != pSurface->refAddr[index] || bitPosition[index] != pSurface->refBitPosition[index]) {
+         AddVerifyMismatch(pResult, pSurface, ADDR_VERIFY_ADDRFROMCOORD_BATCH, index, addr[index], bitPosition[index]);
+      }
+   }
+
+   pResult->numChecks += numElements;
+}
+
+
+/**
+***************************************************************************************************
+*   VerifyCopySurface
+*
+*   @brief
+*       Checks that both bulk copies move every element between the linear buffer and the
+*       reference address of the tiled surface
+*
+*   @return
+*       N/A
+***************************************************************************************************
+*/
+static void
+VerifyCopySurface(ADDR_HANDLE hLib,
+                  const AddrVerifySurface *pSurface,
+                  AddrVerifyConfigResult *pResult)
+{
+   auto pDesc = &pSurface->desc;
+   auto elemBytes = pDesc->bpp / 8;
+   auto numElements = pSurface->refAddr.size();
+   std::vector<uint8_t> tiled(static_cast<size_t>(pSurface->surfSize));
+   std::vector<uint8_t> linear(numElements * elemBytes);
+   std::vector<uint8_t> numWriters(tiled.size() / elemBytes + 1);
+   ADDR_COPY_SURFACE_INPUT copyIn;
+
+   std::memset(&copyIn, 0, sizeof(ADDR_COPY_SURFACE_INPUT));
+   copyIn.size = sizeof(ADDR_COPY_SURFACE_INPUT);
+   copyIn.bpp = pDesc->bpp;
+   copyIn.pitch = pDesc->pitch;
+   copyIn.height = pDesc->height;
+   copyIn.numSlices = pDesc->numSlices;
+   copyIn.numSamples = pDesc->numSamples;
+   copyIn.tileMode = pDesc->tileMode;
+   copyIn.isDepth = pDesc->isDepth;
+   copyIn.pipeSwizzle = pDesc->pipeSwizzle;
+   copyIn.bankSwizzle = pDesc->bankSwizzle;
+   copyIn.tileIndex = -1;
+   copyIn.pTiled = tiled.data();
+   copyIn.pLinear = linear.data();
+
+   for (auto i = size_t { 0 }; i < tiled.size(); ++i) {
+      tiled[i] = static_cast<uint8_t>((i * 0x9E3779B1u) >> 24);
+   }
+
+   if (AddrCopySurfaceTiledToLinear(hLib, &copyIn) != ADDR_OK) {
+      AddVerifyMismatch(pResult, pSurface, ADDR_VERIFY_COPY_TILED_TO_LINEAR, 0, 0, 0);
+   } else {
+      for (auto index = size_t { 0 }; index < numElements; ++index) {
+         auto pTiled = &tiled[static_cast<size_t>(pSurface->refAddr[index])];
+
+         if (std::memcmp(pTiled, &linear[index * elemBytes], elemBytes) != 0) {
+            AddVerifyMismatch(pResult, pSurface, ADDR_VERIFY_COPY_TILED_TO_LINEAR, index, index * elemBytes, 0);
+         }
+      }
+
+      pResult->numChecks += numElements;
+   }
+
+   for (auto i = size_t { 0 }; i < linear.size(); ++i) {
+      linear[i] = static_cast<uint8_t>((i * 0x9E3779B1u) >> 24);
+   }
+
+   std::fill(tiled.begin(), tiled.end(), uint8_t { 0 });
+
+   if (AddrCopySurfaceLinearToTiled(hLib, &copyIn) != ADDR_OK) {
+      AddVerifyMismatch(pResult, pSurface, ADDR_VERIFY_COPY_LINEAR_TO_TILED, 0, 0, 0);
+   } else {
+      // Elements which share their tiled address, such as the samples of a 1D tiled surface,
+      // leave whichever the copy wrote last, so only uniquely addressed elements are checked
+      for (auto index = size_t { 0 }; index < numElements; ++index) {
+         auto &writers = numWriters[static_cast<size_t>(pSurface->refAddr[index] / elemBytes)];
+         writers = std::min(writers + 1, 2);
+      }
+
+      for (auto index = size_t { 0 }; index < numElements; ++index) {
+         auto pTiled = &tiled[static_cast<size_t>(pSurface->refAddr[index])];
+
+         if (numWriters[static_cast<size_t>(pSurface->refAddr[index] / elemBytes)] != 1) {
+            continue;
+         }
+
+         if (std::memcmp(pTiled, &linear[index * elemBytes], elemBytes) != 0) {
+            AddVerifyMismatch(pResult, pSurface, ADDR_VERIFY_COPY_LINEAR_TO_TILED, index, index * elemBytes, 0);
+         }
+
+         pResult->numChecks++;
+      }
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   VerifyConfig
+*
+*   @brief
+*       Creates a library for one tiling configuration and verifies its lookup tables and
+*       random surfaces
+*
+*   @return
+*       N/A
+***************************************************************************************************
+*/
+static void
+VerifyConfig(const AddrVerifyTasks *pTasks,
+             uint32_t configIndex)
+{
+   auto pIn = pTasks->pIn;
+   auto pResult = &pTasks->pResults[configIndex];
+   auto gbAddrConfig = pTasks->pConfigs[configIndex];
+   ADDR_CREATE_INPUT createIn = *pIn->pCreateIn;
+   ADDR_CREATE_OUTPUT createOut;
+
+   std::memset(pResult, 0, sizeof(AddrVerifyConfigResult));
+   std::memset(&createOut, 0, sizeof(ADDR_CREATE_OUTPUT));
+   createOut.size = sizeof(ADDR_CREATE_OUTPUT);
+   createIn.regValue.gbAddrConfig = gbAddrConfig;
+
+   // The lookups run with the checks of the surface entry points disabled
+   createIn.createFlags.fillSizeFields = 0;
+   createIn.createFlags.surfaceInfoCache = 0;
+
+   if (AddrCreate(&createIn, &createOut) != ADDR_OK) {
+      return;
+   }
+
+   auto hLib = createOut.hLib;
+   auto numSurfaces = pIn->numSurfaces ? pIn->numSurfaces : VerifyDefaultSurfaces;
+   uint64_t random = (static_cast<uint64_t>(pIn->seed) << 32) ^ gbAddrConfig ^ 0x9E3779B97F4A7C15ull;
+   uint64_t numTableChecks = 0;
+   uint32_t firstX = 0;
+   uint32_t firstY = 0;
+
+   pResult->created = true;
+   pResult->numMismatches[ADDR_VERIFY_LOOKUP_TABLES] = AddrLib::GetAddrLib(hLib)->HwlVerifyLookupTables(&numTableChecks, &firstX, &firstY);
+   pResult->numChecks += numTableChecks;
+
+   for (auto path = 0u; path < ADDR_VERIFY_PATH_COUNT; ++path) {
+      pResult->firstMismatch[path].gbAddrConfig = gbAddrConfig;
+   }
+
+   pResult->firstMismatch[ADDR_VERIFY_LOOKUP_TABLES].path = ADDR_VERIFY_LOOKUP_TABLES;
+   pResult->firstMismatch[ADDR_VERIFY_LOOKUP_TABLES].x = firstX;
+   pResult->firstMismatch[ADDR_VERIFY_LOOKUP_TABLES].y = firstY;
+
+   for (auto i = 0u; i < numSurfaces; ++i) {
+      AddrVerifySurface surface;
+
+      if (!CreateVerifySurface(hLib, &random, &surface)) {
+         continue;
+      }
+
+      surface.desc.gbAddrConfig = gbAddrConfig;
+      pResult->numSurfaces++;
+
+      VerifySurfacePlan(hLib, &surface, pResult);
+      VerifyAddrFromCoordBatch(hLib, &surface, pResult);
+
+      // Elements of other sizes can overlap, which leaves the copies nothing exact to check
+      if (surface.desc.bpp >= 8 && IsPow2(surface.desc.bpp)) {
+         VerifyCopySurface(hLib, &surface, pResult);
+      }
+   }
+
+   AddrDestroy(hLib);
+}
+
+
+/**
+***************************************************************************************************
+*   RunVerifyTask
+*
+*   @brief
+*       ADDR_COPY_TASK entry verifying one tiling configuration
+*
+*   @return
+*       N/A
+***************************************************************************************************
+*/
+static void
+RunVerifyTask(void *pTaskData,
+              uint32_t taskIndex)
+{
+   VerifyConfig(static_cast<const AddrVerifyTasks *>(pTaskData), taskIndex);
+}
+
+
+/**
+***************************************************************************************************
+*   RunVerifyWorker
+*
+*   @brief
+*       Thread entry verifying every numWorkers-th tiling configuration
+*
+*   @return
+*       N/A
+***************************************************************************************************
+*/
+static void
+RunVerifyWorker(const AddrVerifyTasks *pTasks,
+                uint32_t worker)
+{
+   for (auto config = worker; config < pTasks->numConfigs; config += pTasks->numWorkers) {
+      VerifyConfig(pTasks, config);
+   }
+}
+
+
+/**
+***************************************************************************************************
+*   AddrVerifyAddressPaths
+*
+*   @brief
+*       Compare the lookup tables, surface plans, batch lookups and bulk copies against the
+*       per element AddrComputeSurfaceAddrFromCoord over random surfaces of many tiling
+*       configurations
+*
+*   @return
+*       ADDR_OK if no error, the comparison results are in pOut
+***************************************************************************************************
+*/
+ADDR_E_RETURNCODE
+AddrVerifyAddressPaths(const ADDR_VERIFY_ADDRESS_PATHS_INPUT *pIn,
+                       ADDR_VERIFY_ADDRESS_PATHS_OUTPUT *pOut)
+{
+   ADDR_E_RETURNCODE returnCode = ADDR_OK;
+   std::vector<uint32_t> configs;
+
+   if (pIn->size != sizeof(ADDR_VERIFY_ADDRESS_PATHS_INPUT) || pOut->size != sizeof(ADDR_VERIFY_ADDRESS_PATHS_OUTPUT)) {
+      returnCode = ADDR_PARAMSIZEMISMATCH;
+   } else if (!pIn->pCreateIn || (pOut->maxMismatches && !pOut->pMismatches) || (pIn->numConfigs && !pIn->pGbAddrConfigs)) {
+      returnCode = ADDR_INVALIDPARAMS;
+   }
+
+   if (returnCode == ADDR_OK) {
+      if (pIn->pGbAddrConfigs) {
+         configs.assign(pIn->pGbAddrConfigs, pIn->pGbAddrConfigs + pIn->numConfigs);
+      } else if (pIn->pCreateIn->chipEngine == CIASICIDGFXENGINE_R600) {
+         configs.resize(AddrR600GetTilingConfigs(nullptr));
+         AddrR600GetTilingConfigs(configs.data());
+      } else {
+         returnCode = ADDR_NOTSUPPORTED;
+      }
+   }
+
+   if (returnCode == ADDR_OK) {
+      std::vector<AddrVerifyConfigResult> results(configs.size());
+      AddrVerifyTasks tasks;
+
+      tasks.pIn = pIn;
+      tasks.pConfigs = configs.data();
+      tasks.numConfigs = static_cast<uint32_t>(configs.size());
+      tasks.numWorkers = std::min(std::max(pIn->numThreads, 1u), std::max(tasks.numConfigs, 1u));
+      tasks.pResults = results.data();
+
+      if (pIn->pExecutor && tasks.numConfigs) {
+         pIn->pExecutor(pIn->pExecutorData, RunVerifyTask, &tasks, tasks.numConfigs);
+      } else {
+         std::vector<std::thread> threads;
+         auto worker = 1u;
+
+         try {
+            threads.reserve(tasks.numWorkers - 1);
+
+            for (; worker < tasks.numWorkers; ++worker) {
+               threads.emplace_back(RunVerifyWorker, &tasks, worker);
+            }
+         } catch (...) {
+            // Run whatever could not get a thread on this one
+         }
+
+         for (auto remaining = worker; remaining < tasks.numWorkers; ++remaining) {
+            RunVerifyWorker(&tasks, remaining);
+         }
+
+         RunVerifyWorker(&tasks, 0);
+
+         for (auto &thread : threads) {
+            thread.join();
+         }
+      }
+
+      pOut->numConfigs = 0;
+      pOut->numFailedConfigs = 0;
+      pOut->numSurfaces = 0;
+      pOut->numChecks = 0;
+      pOut->numMismatches = 0;
+      pOut->numStoredMismatches = 0;
+
+      for (auto &result : results) {
+         auto failed = false;
+
+         if (!result.created) {
+            continue;
+         }
+
+         pOut->numConfigs++;
+         pOut->numSurfaces += result.numSurfaces;
+         pOut->numChecks += result.numChecks;
+
+         for (auto path = 0u; path < ADDR_VERIFY_PATH_COUNT; ++path) {
+            if (!result.numMismatches[path]) {
+               continue;
+            }
+
+            if (pOut->numStoredMismatches < pOut->maxMismatches) {
+               pOut->pMismatches[pOut->numStoredMismatches++] = result.firstMismatch[path];
+            }
+
+            pOut->numMismatches += result.numMismatches[path];
+            failed = true;
+         }
+
+         if (failed) {
+            pOut->numFailedConfigs++;
+         }
+      }
+   }
+
+   return returnCode;
+}